@@ -20,6 +20,9 @@ compiler_define_if_found( HAVE_STRLCPY HAVE_STRLCPY )
 check_function_exists( fstatat HAVE_FSTATAT )
 compiler_define_if_found( HAVE_FSTATAT HAVE_FSTATAT )
 
+check_function_exists( preadv HAVE_PREADV )
+compiler_define_if_found( HAVE_PREADV HAVE_PREADV )
+
 check_function_exists( sigwaitinfo HAVE_SIGWTI )
 compiler_define_if_found( HAVE_SIGWTI HAVE_SIGWTI )
 if( NOT HAVE_SIGWTI )
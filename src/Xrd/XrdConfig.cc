@@ -145,6 +145,7 @@ XrdConfig::XrdConfig() : Log(&Logger, "Xrd"), Trace(&Log), Sched(&Log, &Trace),
    repDest[1] = 0;
    repInt     = 600;
    repOpts    = 0;
+   logAsync   = 0;
    NetTCPlep  = -1;
    NetADM     = 0;
    memset(NetTCP, 0, sizeof(NetTCP));
@@ -449,6 +450,12 @@ int XrdConfig::Configure(int argc, char **argv)
    temp = (NoGo ? " initialization failed." : " initialization completed.");
    sprintf(buff, "%s:%d", myInstance, PortTCP);
    Log.Say("------ ", buff, temp);
+
+// Switch to asynchronous logging now that we are fully configured. Doing it
+// this late assures that any configuration error is reliably recorded.
+//
+   if (!NoGo && logAsync && (retc = Log.logger()->setAsync(logAsync)))
+      Log.Emsg("Config", -retc, "enable asynchronous logging; using sync mode");
    if (logfn)
       {strcat(buff, " running.");
        Log.logger()->AddMsg(buff);
@@ -483,6 +490,7 @@ int XrdConfig::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError *eDest)
    {
    TS_Xeq("adminpath",     xapath);
    TS_Xeq("allow",         xallow);
+   TS_Xeq("log",           xlog);
    TS_Xeq("port",          xport);
    TS_Xeq("protocol",      xprot);
    TS_Xeq("report",        xrep);
@@ -1029,6 +1037,42 @@ int XrdConfig::xbuf(XrdSysError *eDest, XrdOucStream &Config)
     return 0;
 }
 
+/******************************************************************************/
+/*                                  x l o g                                   */
+/******************************************************************************/
+
+/* Function: xlog
+
+   Purpose:  To parse the directive: log {async [<bsz>] | sync}
+
+             async      messages are queued in per-thread buffers of <bsz>
+                        bytes (default 64k) and written by a background
+                        thread. Messages that do not fit are dropped and
+                        counted. This is enabled after initialization.
+             sync       messages are written as they are issued (default).
+
+   Output: 0 upon success or !0 upon failure.
+*/
+int XrdConfig::xlog(XrdSysError *eDest, XrdOucStream &Config)
+{
+    long long bsz = 65536;
+    char *val;
+
+    if (!(val = Config.GetWord()))
+       {eDest->Emsg("Config", "log mode not specified"); return 1;}
+
+    if (!strcmp(val, "sync")) {logAsync = 0; return 0;}
+    if ( strcmp(val, "async"))
+       {eDest->Emsg("Config", "invalid log mode -", val); return 1;}
+
+    if ((val = Config.GetWord()))
+       if (XrdOuca2x::a2sz(*eDest,"log buffer size",val,&bsz,4096,1024*1024*16))
+          return 1;
+
+    logAsync = static_cast<int>(bsz);
+    return 0;
+}
+
 /******************************************************************************/
 /*                                  x n e t                                   */
 /******************************************************************************/
@@ -114,6 +114,7 @@ int                 PortWAN;      // TCP port to listen on for WAN connections
 int                 NetTCPlep;
 int                 AdminMode;
 int                 repInt;
+int                 logAsync;     // Thread log buffer size when async logging
 char                repOpts;
 char                isProxy;
 };
@@ -166,6 +166,7 @@ void XrdLink::Reset()
   Protocol = 0; 
   ProtoAlt = 0;
   conTime  = time(0);
+  readyTime= 0;
   stallCnt = stallCntTot = 0;
   tardyCnt = tardyCntTot = 0;
   SfIntr   = 0;
@@ -118,6 +118,18 @@ static XrdLink *fd2link(int fd, unsigned int inst)
 
 static XrdLink *Find(int &curr, XrdLinkMatch *who=0);
 
+//-----------------------------------------------------------------------------
+//! Obtain the time the poller found the link ready and forget it, so that
+//! only the first request read after a poll is charged with the wait.
+//!
+//! @return The XrdSysTimer::Nanos() time or zero if the link was not polled
+//!         since the last call.
+//-----------------------------------------------------------------------------
+
+long long     getReadyTime() {long long rt = readyTime; readyTime = 0;
+                              return rt;
+                             }
+
        int    getIOStats(long long &inbytes, long long &outbytes,
                               int  &numstall,     int  &numtardy)
                         { inbytes = BytesIn + BytesInTot;
@@ -310,6 +322,7 @@ char               *Etext;
 int                 FD;
 unsigned int        Instance;
 time_t              conTime;
+long long           readyTime;      // Set by the poller
 int                 InUse;
 int                 doPost;
 char                LockReads;
@@ -28,21 +28,32 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 
 #include "XrdNet/XrdNetAddr.hh"
 #include "XrdNet/XrdNetOpts.hh"
 #include "XrdNet/XrdNetSocket.hh"
-#include "XrdOuc/XrdOucTokenizer.hh"
+#include "XrdOuc/XrdOucHash.hh"
+#include "XrdOuc/XrdOucString.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysLogger.hh"
 #include "XrdSys/XrdSysHeaders.hh"
 #include "XrdSys/XrdSysPlatform.hh"
 #include "XrdSys/XrdSysPthread.hh"
-  
+#include "XrdSys/XrdSysTimer.hh"
+
 /******************************************************************************/
 /*                      G l o b a l   V a r i a b l e s                       */
 /******************************************************************************/
@@ -58,6 +69,8 @@ static const int          addSender = 0x0001;
        int                Opts;
 
        int                Debug;
+
+       int                udpFD = -1;
 };
 
 using namespace XrdMpx;
@@ -68,7 +81,7 @@ using namespace XrdMpx;
 /******************************************************************************/
 /*                             X r d M p x V a r                              */
 /******************************************************************************/
-  
+
 class  XrdMpxVar
 {
 public:
@@ -94,7 +107,7 @@ static const int   vMax = 15;
 /******************************************************************************/
 /*                        X r d M p x V a r : : P o p                         */
 /******************************************************************************/
-  
+
 int XrdMpxVar::Pop(const char *vName)
 {
     if (Debug) cerr <<"Pop:  " <<(vName ? vName : "") <<"; var=" <<vBuff <<endl;
@@ -106,7 +119,7 @@ int XrdMpxVar::Pop(const char *vName)
 /******************************************************************************/
 /*                       X r d M p x V a r : : P u s h                        */
 /******************************************************************************/
-  
+
 int XrdMpxVar::Push(const char *vName)
 {
    int n = strlen(vName);
@@ -123,287 +136,1033 @@ int XrdMpxVar::Push(const char *vName)
 }
 
 /******************************************************************************/
-/*                             X r d M p x X m l                              */
+/*                            X r d M p x S i n k                             */
 /******************************************************************************/
-  
-class XrdMpxXml
+
+// A sink is handed the pieces of a summary record as the scanner encounters
+// them: first the attributes of the <statistics> header, then each value with
+// its fully qualified variable name, and finally the end of the record. Any
+// method may return zero to abandon the record.
+//
+class XrdMpxSink
 {
 public:
 
-enum fmtType {fmtCGI, fmtFlat, fmtXML};
+virtual int  End(const char *Toe) = 0;
 
-int Format(const char *Host, char *ibuff, char *obuff);
+virtual int  Hdr(const char *Var, const char *Val) = 0;
 
-    XrdMpxXml(fmtType ft) : fType(ft)
-                          {if (ft == fmtCGI) {vSep = '='; vSfx = '&';}
-                              else           {vSep = ' '; vSfx = '\n';}
-                          }
-   ~XrdMpxXml() {}
+virtual int  Val(const char *Var, const char *Val) = 0;
 
-private:
+             XrdMpxSink() {}
+virtual     ~XrdMpxSink() {}
+};
+
+/******************************************************************************/
+/*                            X r d M p x S c a n                             */
+/******************************************************************************/
+
+// The scanner makes a single pass over a summary record, terminating names
+// and values in place, and feeds them to a sink. Nothing is copied other than
+// the variable name that is being built.
+//
+class XrdMpxScan
+{
+public:
+
+static int   Numeric(const char *Val, double *dVal=0);
 
-struct VarInfo
-      {const char *Name;
-             char *Data;
-      };
+static int   Parse(char *ibuff, XrdMpxSink &Sink);
 
-char *Add(char *Buff, const char *Var, const char *Val);
-void  getVars(XrdOucTokenizer &Data, VarInfo Var[]);
-int   xmlErr(const char *t1, const char *t2=0, const char *t3=0);
+private:
+
+static const int isAttr = 0x01;
+static const int isEnd  = 0x02;
+static const int isShut = 0x04;
 
-fmtType fType;
-char    vSep;
-char    vSfx;
+static int   getAttr(char *&bP, char *&aName, char *&aVal);
+static int   xmlErr(const char *t1, const char *t2=0, const char *t3=0);
 };
 
 /******************************************************************************/
-/*                     X r d M p x X m l : : F o r m a t                      */
+/*                   X r d M p x S c a n : : N u m e r i c                    */
 /******************************************************************************/
-  
-int XrdMpxXml::Format(const char *Host, char *ibuff, char *obuff)
+
+// Returns 1 if the value is an integer, 2 if it is a floating point number,
+// and 0 otherwise. The value, if wanted, is returned in dVal.
+//
+int XrdMpxScan::Numeric(const char *Val, double *dVal)
 {
-   static const char *Hdr0 = "<statistics ";
+   const char *vP = (*Val == '-' ? Val+1 : Val);
+   char *eP;
+   double theVal;
+
+// Integers are by far the most common so handle those quickly
+//
+   if (!isdigit(*vP)) return 0;
+   while(isdigit(*vP)) vP++;
+   if (!*vP) {if (dVal) *dVal = strtod(Val, 0); return 1;}
+
+// Check for a floating point value
+//
+   if (strspn(vP, "0123456789.eE+-") != strlen(vP)) return 0;
+   theVal = strtod(Val, &eP);
+   if (*eP) return 0;
+   if (dVal) *dVal = theVal;
+   return 2;
+}
+
+/******************************************************************************/
+/*                     X r d M p x S c a n : : P a r s e                      */
+/******************************************************************************/
+
+int XrdMpxScan::Parse(char *ibuff, XrdMpxSink &Sink)
+{
+   static const char *Hdr0 = "<statistics";
    static const int   H0Len = strlen(Hdr0);
 
-   XrdMpxVar       xVar;
-   XrdOucTokenizer Data(ibuff);
-   VarInfo vHead[] = {{"tod", 0}, {"ver", 0}, {"src", 0}, {"tos", 0},
-                      {"pgm", 0}, {"ins", 0}, {"pid", 0}, {0, 0}};
-   VarInfo vStat[] = {{"id",  0}, {0, 0}};
-   VarInfo vTail[] = {{"toe", 0}, {0, 0}};
-   char *lP = ibuff, *oP = obuff, *tP, *vP;
-   int i, rc;
+   XrdMpxVar xVar;
+   char *bP = ibuff, *nP, *tEnd, *aName, *aVal, *sVal, c;
+   bool isStats;
+   int  rc;
 
-// Insert a newline for the first '>'
+// The stream better start with '<statistics'
 //
-   if (!(lP = (char *)index(lP, '>')))
-      return xmlErr("Invalid xml stream: ", ibuff);
-   *lP++ = '\n';
+   while(isspace(*bP)) bP++;
+   if (strncmp(Hdr0, bP, H0Len)
+   ||  (!isspace(*(bP+H0Len)) && *(bP+H0Len) != '>'))
+      return xmlErr("Stream does not start with '<statistics'.");
+   bP += H0Len;
 
-// Now make the input tokenizable
+// Pass along the attributes in the header
+//
+   do {if ((rc = getAttr(bP, aName, aVal)) < 0)
+          return xmlErr("Invalid xml stream: ", ibuff);
+       if (rc & isAttr && !Sink.Hdr(aName, aVal)) return 0;
+      } while(!(rc & isEnd));
+   if (rc & isShut) return Sink.End(0);
+
+// Now process the stats entries. Text is the value of the current variable
+// whose name is the path of element names (or stats ids) leading to it.
 //
-   while(*lP)
-        {if (*lP == '>' || (*lP == '<' && *(lP+1) == '/')) *lP = ' ';
-         lP++;
+   while(1)
+        {if (*bP != '<')
+            {if (!(nP = index(bP, '<'))) break;
+             tEnd = nP;
+             while(tEnd > bP && isspace(*(tEnd-1))) tEnd--;
+             while(bP < tEnd && isspace(*bP)) bP++;
+             if (bP < tEnd)
+                {if (*bP == '"' && tEnd-bP > 1 && *(tEnd-1) == '"')
+                    {bP++; tEnd--;}
+                 c = *tEnd; *tEnd = '\0';
+                 rc = Sink.Val(xVar.Var(), bP);
+                 *tEnd = c;
+                 if (!rc) return 0;
+                }
+             bP = nP;
+             continue;
+            }
+
+      // Handle an end tag. The end of the record may carry attributes.
+      //
+         if (*(bP+1) == '/')
+            {nP = bP += 2;
+             while(*bP && *bP != '>' && !isspace(*bP)) bP++;
+             c = *bP; *bP = '\0';
+             if (!strcmp(nP, "statistics"))
+                {*bP = c; sVal = 0;
+                 do {if ((rc = getAttr(bP, aName, aVal)) < 0)
+                        return xmlErr("Invalid xml stream trailer.");
+                     if (rc & isAttr && !strcmp(aName, "toe")) sVal = aVal;
+                    } while(!(rc & isEnd));
+                 return Sink.End(sVal);
+                }
+             if (!xVar.Pop(strcmp("stats", nP) ? nP : 0))
+                return xmlErr(nP-1, "invalid end for ", xVar.Var());
+             *bP = c;
+             if (!(bP = index(bP, '>'))) break;
+             bP++;
+             continue;
+            }
+
+      // Handle a start tag. The stats tag is named by its id attribute.
+      //
+         nP = ++bP;
+         while(*bP && *bP != '>' && *bP != '/' && !isspace(*bP)) bP++;
+         if (bP == nP) return xmlErr("Invalid xml element after ", xVar.Var());
+         c = *bP; *bP = '\0';
+         if (!(isStats = !strcmp("stats", nP)) && !xVar.Push(nP))
+            return xmlErr("Nesting too deep for ", xVar.Var());
+         *bP = c; sVal = 0;
+         do {if ((rc = getAttr(bP, aName, aVal)) < 0)
+                return xmlErr("Invalid xml element after ", xVar.Var());
+             if (isStats && rc & isAttr && !strcmp(aName, "id")) sVal = aVal;
+            } while(!(rc & isEnd));
+         if (isStats && !xVar.Push(sVal ? sVal : "stats"))
+            return xmlErr("Nesting too deep for ", xVar.Var());
+         if (rc & isShut) xVar.Pop(0);
         }
 
-// The first token better be '<statistics'
+// We ran out of stream
 //
-   if (!(lP = Data.GetLine()) || strncmp(Hdr0, lP, H0Len))
-      return xmlErr("Stream does not start with '<statistics'.");
-   Data.GetToken(); getVars(Data, vHead);
+   return xmlErr("Missing '</statistics>' in xml stream.");
+}
 
-// Output the vars in the headers as 'stats..var'
+/******************************************************************************/
+/*                   X r d M p x S c a n : : g e t A t t r                    */
+/******************************************************************************/
+
+// Returns isAttr with aName and aVal set when an attribute was found, possibly
+// or'd with isEnd if the value ended the tag. Otherwise, returns isEnd (with
+// isShut for '/>') at the end of the tag and -1 if the stream ended.
 //
-   for (i = 0; vHead[i].Name; i++)
-       {if (vHead[i].Data) oP = Add(oP, vHead[i].Name, vHead[i].Data);}
+int XrdMpxScan::getAttr(char *&bP, char *&aName, char *&aVal)
+{
+   char qChar;
 
-// Add in the host name, if supplied
+// Find the next attribute name, skipping anything that has no value
 //
-   if (Host) oP = Add(oP, "host", Host);
+   while(1)
+        {while(isspace(*bP)) bP++;
+         if (*bP == '>') {bP++; return isEnd;}
+         if (*bP == '/' && *(bP+1) == '>') {bP += 2; return isEnd|isShut;}
+         if (!*bP) return -1;
+         aName = bP;
+         while(*bP && *bP != '=' && *bP != '>' && *bP != '/' && !isspace(*bP))
+              bP++;
+         if (*bP == '=') break;
+         if (*bP == '/') bP++;
+        }
+   *bP++ = '\0';
+
+// Get the value, which is normally quoted
+//
+   if (*bP == '"' || *bP == '\'')
+      {qChar = *bP++; aVal = bP;
+       if (!(bP = index(bP, qChar))) return -1;
+       *bP++ = '\0';
+       return isAttr;
+      }
+   aVal = bP;
+   while(*bP && *bP != '>' && !isspace(*bP)) bP++;
+   if (*bP == '>') {*bP++ = '\0'; return isAttr|isEnd;}
+   if (*bP) *bP++ = '\0';
+   return isAttr;
+}
+
+/******************************************************************************/
+/*                    X r d M p x S c a n : : x m l E r r                     */
+/******************************************************************************/
+
+int XrdMpxScan::xmlErr(const char *t1, const char *t2, const char *t3)
+{
+   Say.Emsg(":", t1, t2, t3);
+   return 0;
+}
+
+/******************************************************************************/
+/*                             X r d M p x X m l                              */
+/******************************************************************************/
+
+class XrdMpxXml : public XrdMpxSink
+{
+public:
+
+enum fmtType {fmtCGI, fmtFlat, fmtLine, fmtXML};
+
+int  End(const char *Toe);
+
+int  Format(const char *Host, char *ibuff, char *obuff, int olen);
+
+int  Hdr(const char *Var, const char *Val);
 
-// Get the remainder
+int  Val(const char *Var, const char *Val);
+
+     XrdMpxXml(fmtType ft) : fType(ft)
+                           {if (ft == fmtCGI) {vSep = '='; vSfx = '&';}
+                               else           {vSep = ' '; vSfx = '\n';}
+                           }
+    ~XrdMpxXml() {}
+
+private:
+
+enum hdrVar {hTod = 0, hVer, hSrc, hTos, hPgm, hIns, hPid, hSite, hNum};
+
+int   Add(const char *Var, const char *Val);
+int   addEsc(const char *Data, const char *Esc);
+int   addField(const char *Var, const char *Val);
+int   addHead();
+int   Fill(const char *Data, int Dlen=-1);
+int   Full() {oFull = true; return 0;}
+
+static const char *hdrName[hNum];
+
+const char *hdrVal[hNum];
+const char *hName;
+char       *oBeg;
+char       *oP;
+char       *oEnd;
+int         nField;
+bool        inHead;
+bool        oFull;
+fmtType     fType;
+char        vSep;
+char        vSfx;
+};
+
+/******************************************************************************/
+/*                         S t a t i c   M e m b e r s                        */
+/******************************************************************************/
+
+const char *XrdMpxXml::hdrName[XrdMpxXml::hNum] =
+                      {"tod", "ver", "src", "tos", "pgm", "ins", "pid", "site"};
+
+/******************************************************************************/
+/*                        X r d M p x X m l : : E n d                         */
+/******************************************************************************/
+
+int XrdMpxXml::End(const char *Toe)
+{
+   const char *tod = hdrVal[hTod];
+
+// Make sure the header was output (a record may have no values)
 //
-   if (!Data.GetLine()) return xmlErr("Null xml stream after header.");
+   if (inHead && !addHead()) return 0;
 
-// The following segment reads all of the "stats" entries
+// Finish off a cgi or flat record
 //
-   while((tP = Data.GetToken()) && strcmp(tP, "/statistics"))
-        {     if (*tP == '/')
-                 {if (!xVar.Pop(strcmp("/stats", tP) ? tP+1 : 0))
-                     return xmlErr(tP, "invalid end for ", xVar.Var());
-                 }
-         else if (*tP == '<')
-                 {if (strcmp("<stats", tP)) rc = xVar.Push(tP+1);
-                     else {getVars(Data, vStat);
-                           rc = (vStat[0].Data ? xVar.Push(vStat[0].Data)
-                                               : xVar.Push(tP+1));
-                          }
-                  if (!rc) return xmlErr("Nesting too deep for ", xVar.Var());
-                 }
-         else    {if ((vP = index(tP, '<'))) *vP = '\0';
-                  if (*tP == '"')
-                     {i = strlen(tP)-1;
-                      if (*(tP+i) == '"') {*(tP+i) = '\0'; i = 1;}
-                     } else i = 0;
-                  oP = Add(oP, xVar.Var(), tP+i);
-                  if (vP) {*vP = '<';
-                           if (vP != tP) memset(tP, ' ', vP - tP);
-                           Data.RetToken();
-                          }
-                 }
-        }
-   if (!tP) return xmlErr("Missing '</statistics>' in xml stream.");
-   getVars(Data, vTail);
-   if (vTail[0].Data) oP = Add(oP, vTail[0].Name, vTail[0].Data);
-   if (*(oP-1) == '&') oP--;
-   *oP++ = '\n';
+   if (fType != fmtLine)
+      {if (Toe && !Add("toe", Toe)) return 0;
+       if (oP > oBeg && *(oP-1) == '&') oP--;
+       return Fill("\n", 1);
+      }
+
+// Finish off a line protocol record. It is timestamped in nanoseconds and
+// must have at least one field, else we simply drop it.
+//
+   if (Toe && !addField("toe", Toe)) return 0;
+   if (!nField) {oP = oBeg; return 1;}
+   if (tod && XrdMpxScan::Numeric(tod) == 1
+   &&  (!Fill(" ", 1) || !Fill(tod) || !Fill("000000000", 9))) return 0;
+   return Fill("\n", 1);
+}
+
+/******************************************************************************/
+/*                     X r d M p x X m l : : F o r m a t                      */
+/******************************************************************************/
+
+int XrdMpxXml::Format(const char *Host, char *ibuff, char *obuff, int olen)
+{
+   int i;
+
+// Initialize for this record
+//
+   for (i = 0; i < hNum; i++) hdrVal[i] = 0;
+   hName  = Host;
+   oBeg   = oP = obuff;
+   oEnd   = obuff + olen;
+   nField = 0;
+   inHead = true;
+   oFull  = false;
+
+// Scan the record feeding ourselves the pieces
+//
+   if (!XrdMpxScan::Parse(ibuff, *this))
+      {if (oFull) Say.Emsg(":", "Formatted record too long; record skipped.");
+       return 0;
+      }
    return oP - obuff;
 }
 
+/******************************************************************************/
+/*                        X r d M p x X m l : : H d r                         */
+/******************************************************************************/
+
+int XrdMpxXml::Hdr(const char *Var, const char *Val)
+{
+   int i;
+
+// Record the header variables we know about; the rest are ignored
+//
+   for (i = 0; i < hNum; i++)
+       if (!strcmp(hdrName[i], Var)) {hdrVal[i] = Val; break;}
+   return 1;
+}
+
+/******************************************************************************/
+/*                        X r d M p x X m l : : V a l                         */
+/******************************************************************************/
+
+int XrdMpxXml::Val(const char *Var, const char *Val)
+{
+   if (inHead && !addHead()) return 0;
+   return (fType == fmtLine ? addField(Var, Val) : Add(Var, Val));
+}
+
 /******************************************************************************/
 /*                        X r d M p x X m l : : A d d                         */
 /******************************************************************************/
-  
-char *XrdMpxXml::Add(char *Buff, const char *Var, const char *Val)
+
+int XrdMpxXml::Add(const char *Var, const char *Val)
 {
-   strcpy(Buff, Var); Buff += strlen(Var);
-   *Buff++ = vSep;
-   strcpy(Buff, Val); Buff += strlen(Val);
-   *Buff++ = vSfx;
-   return Buff;
+   int n1 = strlen(Var), n2 = strlen(Val);
+
+   if (oP + n1 + n2 + 2 > oEnd) return Full();
+   memcpy(oP, Var, n1); oP += n1;
+   *oP++ = vSep;
+   memcpy(oP, Val, n2); oP += n2;
+   *oP++ = vSfx;
+   return 1;
 }
 
 /******************************************************************************/
-/*                                                                            */
-/*                    X r d M p x X m l : : g e t V a r s                     */
-/*                                                                            */
+/*                     X r d M p x X m l : : a d d E s c                      */
+/******************************************************************************/
+
+int XrdMpxXml::addEsc(const char *Data, const char *Esc)
+{
+   while(*Data)
+        {if (oP + 2 > oEnd) return Full();
+         if (index(Esc, *Data)) *oP++ = '\\';
+         *oP++ = *Data++;
+        }
+   return 1;
+}
+
+/******************************************************************************/
+/*                   X r d M p x X m l : : a d d F i e l d                    */
+/******************************************************************************/
+
+int XrdMpxXml::addField(const char *Var, const char *Val)
+{
+// Add the field name (the first one is separated from the tags by a blank)
+//
+   if (!Fill((nField++ ? "," : " "), 1) || !addEsc(Var, ", =")
+   ||  !Fill("=", 1)) return 0;
+
+// Integers are suffixed with an 'i', strings are quoted
+//
+   switch(XrdMpxScan::Numeric(Val))
+         {case 1:  return Fill(Val) && Fill("i", 1);
+          case 2:  return Fill(Val);
+          default: break;
+         }
+   return Fill("\"", 1) && addEsc(Val, "\"\\") && Fill("\"", 1);
+}
+
+/******************************************************************************/
+/*                    X r d M p x X m l : : a d d H e a d                     */
 /******************************************************************************/
-  
-void XrdMpxXml::getVars(XrdOucTokenizer &Data, VarInfo Var[])
+
+int XrdMpxXml::addHead()
 {
-   char *tVar, *tVal;
+   static const hdrVar lpTag[] = {hSrc, hSite, hPgm, hIns};
+   static const hdrVar lpFld[] = {hVer, hTos, hPid};
+   static const int    lpTNum  = sizeof(lpTag)/sizeof(hdrVar);
+   static const int    lpFNum  = sizeof(lpFld)/sizeof(hdrVar);
+   const char *vP;
    int i;
 
-// Initialize the data pointers to null
+// The header is only output once
 //
-   i = 0;
-   while(Var[i].Name) Var[i++].Data = 0;
+   inHead = false;
 
-// Get all of the variables/values and return where possible
+// Output the vars in the headers as 'var' followed by the host, if supplied
 //
-   while((tVar = Data.GetToken()) && *tVar != '<' && *tVar != '/')
-        {if (!(tVal = (char *)index(tVar, '='))) continue;
-         *tVal++ = '\0';
-         if (*tVal == '"')
-            {tVal++, i = strlen(tVal);
-             if (*(tVal+i-1) == '"') *(tVal+i-1) = '\0';
-            }
-         i = 0;
-         while(Var[i].Name)
-              {if (!strcmp(Var[i].Name, tVar)) {Var[i].Data = tVal; break;}
-                  else i++;
-              }
-        }
-   if (tVar && (*tVar == '<' || *tVar == '/')) Data.RetToken();
+   if (fType != fmtLine)
+      {for (i = 0; i < hSite; i++)
+           if (hdrVal[i] && !Add(hdrName[i], hdrVal[i])) return 0;
+       return (hName ? Add("host", hName) : 1);
+      }
+
+// For line protocol the identifying header vars become tags (empty tags are
+// not allowed) and the descriptive ones become fields.
+//
+   if (!Fill("xrdstats", 8)) return 0;
+   for (i = 0; i < lpTNum; i++)
+       {if ((vP = hdrVal[lpTag[i]]) && *vP
+        &&  (!Fill(",", 1) || !Fill(hdrName[lpTag[i]]) || !Fill("=", 1)
+        ||   !addEsc(vP, ", ="))) return 0;
+       }
+   if (hName && (!Fill(",host=", 6) || !addEsc(hName, ", ="))) return 0;
+   for (i = 0; i < lpFNum; i++)
+       {if ((vP = hdrVal[lpFld[i]]) && !addField(hdrName[lpFld[i]], vP))
+           return 0;
+       }
+   return 1;
 }
 
 /******************************************************************************/
-/*                     X r d M p x X m l : : x m l E r r                      */
+/*                       X r d M p x X m l : : F i l l                        */
 /******************************************************************************/
-  
-int XrdMpxXml::xmlErr(const char *t1, const char *t2, const char *t3)
+
+int XrdMpxXml::Fill(const char *Data, int Dlen)
 {
-   Say.Emsg(":", t1, t2, t3);
-   return 0;
+   if (Dlen < 0) Dlen = strlen(Data);
+   if (oP + Dlen > oEnd) return Full();
+   memcpy(oP, Data, Dlen); oP += Dlen;
+   return 1;
 }
-  
+
 /******************************************************************************/
 /*                             X r d M p x O u t                              */
 /******************************************************************************/
-  
+
+class XrdMpxAgg;
+
 class XrdMpxOut
 {
 public:
 
 struct statsBuff
-      {statsBuff      *Next;
-       XrdNetSockAddr  From;
+      {XrdNetSockAddr  From;
        int             Dlen;
        char            Data[8190];
        char            Pad[2];
      };
 
-void       Add(statsBuff *sbP);
+void      *Run();
 
-statsBuff *getBuff();
+void       Write(const char *bP, int bLen);
 
-void      *Run(XrdMpxXml *xP);
+XrdMpxAgg         *Agg;
+XrdMpxXml::fmtType fType;
 
-           XrdMpxOut() : Ready(0), inQ(0), Free(0) {}
+           XrdMpxOut() : Agg(0), fType(XrdMpxXml::fmtXML) {}
           ~XrdMpxOut() {}
 
 private:
 
-XrdSysMutex     myMutex;
-XrdSysSemaphore Ready;
+const char *getHost(XrdOucHash<char> &hTab, XrdNetSockAddr &From);
+
+XrdSysMutex     outMutex;
+};
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+
+namespace XrdMpx
+{
+XrdMpxOut statsQ;
+};
+
+/******************************************************************************/
+/*                             X r d M p x A g g                              */
+/******************************************************************************/
+
+// The aggregator keeps the latest values of every numeric variable reported
+// by each source (a server instance) along with its rate of change. Sources
+// are spread over independently locked shards so that collectors rarely
+// contend. Periodically, the values are summed per site and over the whole
+// cluster and output in line protocol along with the rate percentiles.
+//
+class XrdMpxAgg
+{
+public:
+
+struct Item {const char *Name; double Val; int nOff;};
+
+void  Report();
+
+void *Run();
+
+void  Update(const char *Key, const char *Site, time_t Tod,
+             Item *iP, int iNum);
+
+      XrdMpxAgg(int ival) : Intvl(ival) {}
+     ~XrdMpxAgg() {}
+
+private:
+
+struct aggVal {char   *Name;
+               double  Val;
+               double  Rate;
+               bool    hasRate;
+              };
+
+struct aggSrc {char   *Site;
+               aggVal *Vals;
+               int     numVals;
+               int     maxVals;
+               time_t  Tod;
+               time_t  Seen;
+
+                       aggSrc(const char *site) : Site(strdup(site)), Vals(0),
+                                                  numVals(0), maxVals(0),
+                                                  Tod(0), Seen(0) {}
+                      ~aggSrc() {for (int i = 0; i < numVals; i++)
+                                     free(Vals[i].Name);
+                                 if (Vals) free(Vals);
+                                 free(Site);
+                                }
+              };
+
+struct aggSum {double  Sum;
+               double *Rate;
+               int     numRate;
+               int     maxRate;
+
+                       aggSum() : Sum(0.0), Rate(0), numRate(0), maxRate(0) {}
+                      ~aggSum() {if (Rate) free(Rate);}
+              };
+
+struct aggSite{XrdOucHash<aggSum> Vars;
+               int                numSrv;
+
+                                  aggSite() : numSrv(0) {}
+                                 ~aggSite() {}
+              };
+
+struct aggShard{XrdSysMutex        Mutex;
+                XrdOucHash<aggSrc> Srcs;
+               };
+
+struct aggWork{XrdOucHash<aggSite> *Sites;
+               aggSite             *All;
+               time_t               Old;
+              };
+
+struct aggOut {XrdOucString *Line;
+               const char   *Stat;
+               int           Pct;
+              };
+
+static int  addSrc(const char *Key, aggSrc *sP, void *Arg);
+static void addSum(aggSite *siteP, aggVal *vP);
+static int  cmpRate(const void *a, const void *b);
+static int  putSite(const char *Key, aggSite *siteP, void *Arg);
+static void putStat(XrdOucString &Line, const char *Pfx, aggSite *siteP,
+                    const char *Stat, int Pct);
+static int  putVal(const char *Key, aggSum *aP, void *Arg);
+
+static const int numShards = 16;
+
+aggShard Shard[numShards];
+int      Intvl;
+};
+
+/******************************************************************************/
+/*                    X r d M p x A g g : : R e p o r t                       */
+/******************************************************************************/
+
+void XrdMpxAgg::Report()
+{
+   XrdOucHash<aggSite> Sites;
+   aggWork      Work;
+   aggSite      All;
+   XrdOucString Line(65536);
+   int i;
+
+// Sources that have been silent for three intervals (but not less than five
+// minutes) are considered gone and are removed.
+//
+   Work.Sites = &Sites; Work.All = &All;
+   Work.Old   = time(0) - (Intvl*3 > 300 ? Intvl*3 : 300);
+
+// Sum up all of the sources by site and overall
+//
+   for (i = 0; i < numShards; i++)
+       {Shard[i].Mutex.Lock();
+        Shard[i].Srcs.Apply(addSrc, (void *)&Work);
+        Shard[i].Mutex.UnLock();
+       }
+
+// Output the per-site lines followed by the cluster lines
+//
+   Sites.Apply(putSite, (void *)&Line);
+   if (All.numSrv) putSite(0, &All, (void *)&Line);
+   if (Line.length()) statsQ.Write(Line.c_str(), Line.length());
+}
+
+/******************************************************************************/
+/*                       X r d M p x A g g : : R u n                          */
+/******************************************************************************/
+
+void *XrdMpxAgg::Run()
+{
+   while(1)
+        {XrdSysTimer::Snooze(Intvl);
+         Report();
+        }
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                    X r d M p x A g g : : U p d a t e                       */
+/******************************************************************************/
+
+void XrdMpxAgg::Update(const char *Key, const char *Site, time_t Tod,
+                       Item *iP, int iNum)
+{
+   const char *kP = Key;
+   unsigned int hVal = 2166136261U;
+   aggShard *shP;
+   aggSrc   *sP;
+   aggVal   *vP;
+   double    dT;
+   bool      isNew;
+   int       i, j, k;
+
+// Find the shard that holds this source
+//
+   while(*kP) {hVal ^= (unsigned char)*kP++; hVal *= 16777619U;}
+   shP = &Shard[hVal % numShards];
+
+// Find or add the source. Records that are older than the one we have are
+// out of order and are simply ignored.
+//
+   shP->Mutex.Lock();
+   if (!(sP = shP->Srcs.Find(Key)))
+      {sP = new aggSrc(Site);
+       shP->Srcs.Add(Key, sP);
+      } else if (strcmp(sP->Site, Site)) {free(sP->Site); sP->Site = strdup(Site);}
+   sP->Seen = time(0);
+   if (Tod <= sP->Tod) {shP->Mutex.UnLock(); return;}
+   dT = (sP->Tod ? static_cast<double>(Tod - sP->Tod) : 0.0);
+
+// A source reports the same variables in the same order each time so we
+// normally find the variable where we expect it to be.
+//
+   for (i = j = 0; i < iNum; i++)
+       {isNew = false;
+        if (j < sP->numVals && !strcmp(sP->Vals[j].Name, iP[i].Name)) k = j;
+           else {for (k = 0; k < sP->numVals; k++)
+                     if (!strcmp(sP->Vals[k].Name, iP[i].Name)) break;
+                 if (k >= sP->numVals)
+                    {if (sP->numVals >= sP->maxVals)
+                        {sP->maxVals = (sP->maxVals ? sP->maxVals*2 : 64);
+                         sP->Vals = (aggVal *)realloc(sP->Vals,
+                                             sP->maxVals*sizeof(aggVal));
+                        }
+                     sP->Vals[k].Name = strdup(iP[i].Name);
+                     sP->numVals++; isNew = true;
+                    }
+                }
+        vP = &(sP->Vals[k]); j = k+1;
+        if (!isNew && dT > 0.0 && iP[i].Val >= vP->Val)
+           {vP->Rate = (iP[i].Val - vP->Val) / dT; vP->hasRate = true;}
+           else vP->hasRate = false;
+        vP->Val = iP[i].Val;
+       }
+   sP->Tod = Tod;
+   shP->Mutex.UnLock();
+}
+
+/******************************************************************************/
+/*                    X r d M p x A g g : : a d d S r c                       */
+/******************************************************************************/
+
+int XrdMpxAgg::addSrc(const char *Key, aggSrc *sP, void *Arg)
+{
+   aggWork *wP = (aggWork *)Arg;
+   const char *Site = (*(sP->Site) ? sP->Site : "unknown");
+   aggSite *siteP;
+   int i;
+
+// Remove sources that have gone away
+//
+   if (sP->Seen < wP->Old) return -1;
+
+// Add this source to its site and to the cluster
+//
+   if (!(siteP = wP->Sites->Find(Site)))
+      {siteP = new aggSite; wP->Sites->Add(Site, siteP);}
+   siteP->numSrv++; wP->All->numSrv++;
+   for (i = 0; i < sP->numVals; i++)
+       {addSum(siteP,  &(sP->Vals[i]));
+        addSum(wP->All, &(sP->Vals[i]));
+       }
+   return 0;
+}
+
+/******************************************************************************/
+/*                    X r d M p x A g g : : a d d S u m                       */
+/******************************************************************************/
+
+void XrdMpxAgg::addSum(aggSite *siteP, aggVal *vP)
+{
+   aggSum *aP;
+
+   if (!(aP = siteP->Vars.Find(vP->Name)))
+      {aP = new aggSum; siteP->Vars.Add(vP->Name, aP);}
+   aP->Sum += vP->Val;
+   if (vP->hasRate)
+      {if (aP->numRate >= aP->maxRate)
+          {aP->maxRate = (aP->maxRate ? aP->maxRate*2 : 16);
+           aP->Rate = (double *)realloc(aP->Rate, aP->maxRate*sizeof(double));
+          }
+       aP->Rate[aP->numRate++] = vP->Rate;
+      }
+}
+
+/******************************************************************************/
+/*                   X r d M p x A g g : : c m p R a t e                      */
+/******************************************************************************/
+
+int XrdMpxAgg::cmpRate(const void *a, const void *b)
+{
+   double x = *(const double *)a, y = *(const double *)b;
+
+   return (x < y ? -1 : (x > y ? 1 : 0));
+}
+
+/******************************************************************************/
+/*                   X r d M p x A g g : : p u t S i t e                      */
+/******************************************************************************/
+
+// A null key means the cluster as a whole.
+//
+int XrdMpxAgg::putSite(const char *Key, aggSite *siteP, void *Arg)
+{
+   XrdOucString *lP = (XrdOucString *)Arg;
+   char pfx[512], *pP;
+   const char *kP = Key;
+   int n;
+
+// Construct the measurement and tags, escaping the site name
+//
+   if (!Key) strcpy(pfx, "xrdcluster");
+      else {strcpy(pfx, "xrdsite,site="); pP = pfx + strlen(pfx);
+            n = sizeof(pfx) - (pP - pfx) - 2;
+            while(*kP && n > 0)
+                 {if (index(", =", *kP)) {*pP++ = '\\'; n--;}
+                  *pP++ = *kP++; n--;
+                 }
+            *pP = '\0';
+           }
+
+// Output the sums followed by the rates
+//
+   putStat(*lP, pfx, siteP, "sum",  -1);
+   putStat(*lP, pfx, siteP, "rate",  0);
+   putStat(*lP, pfx, siteP, "p50",  50);
+   putStat(*lP, pfx, siteP, "p95",  95);
+   putStat(*lP, pfx, siteP, "max", 100);
+   return 0;
+}
+
+/******************************************************************************/
+/*                   X r d M p x A g g : : p u t S t a t                      */
+/******************************************************************************/
+
+void XrdMpxAgg::putStat(XrdOucString &Line, const char *Pfx, aggSite *siteP,
+                        const char *Stat, int Pct)
+{
+   aggOut Work = {&Line, Stat, Pct};
+   char buff[64];
+
+   Line += Pfx; Line += ",stat="; Line += Stat;
+   sprintf(buff, " servers=%di", siteP->numSrv);
+   Line += buff;
+   siteP->Vars.Apply(putVal, (void *)&Work);
+   sprintf(buff, " %lld000000000\n", static_cast<long long>(time(0)));
+   Line += buff;
+}
+
+/******************************************************************************/
+/*                     X r d M p x A g g : : p u t V a l                      */
+/******************************************************************************/
+
+int XrdMpxAgg::putVal(const char *Key, aggSum *aP, void *Arg)
+{
+   aggOut *wP = (aggOut *)Arg;
+   char buff[1100], *bP = buff, *bEnd = buff + sizeof(buff) - 40;
+   double theVal;
+   int k;
+
+// Compute the value. Sums are always present, rates only if we have them.
+//
+   if (wP->Pct < 0) theVal = aP->Sum;
+      else {if (!aP->numRate) return 0;
+            if (!wP->Pct)
+               {theVal = 0.0;
+                for (k = 0; k < aP->numRate; k++) theVal += aP->Rate[k];
+               } else {
+                if (wP->Pct == 50)
+                   qsort(aP->Rate, aP->numRate, sizeof(double), cmpRate);
+                k = static_cast<int>(ceil(aP->numRate*wP->Pct/100.0)) - 1;
+                theVal = aP->Rate[(k < 0 ? 0 : k)];
+               }
+           }
+
+// Format the field
+//
+   *bP++ = ',';
+   while(*Key && bP < bEnd)
+        {if (index(", =", *Key)) *bP++ = '\\';
+         *bP++ = *Key++;
+        }
+   sprintf(bP, "=%.15g", theVal);
+   *(wP->Line) += buff;
+   return 0;
+}
+
+/******************************************************************************/
+/*                             X r d M p x C o l                              */
+/******************************************************************************/
+
+// A collector is a sink that gathers the numeric values in a record and hands
+// them to the aggregator. Each receiving thread has its own collector.
+//
+class XrdMpxCol : public XrdMpxSink
+{
+public:
+
+int  Collect(char *ibuff);
 
-statsBuff      *inQ;
-statsBuff      *Free;
+int  End(const char *Toe);
+
+int  Hdr(const char *Var, const char *Val);
+
+int  Val(const char *Var, const char *Val);
+
+     XrdMpxCol(XrdMpxAgg &agg) : Agg(agg), Items(0), maxItems(0),
+                                 nBuff(0), nMax(0) {}
+    ~XrdMpxCol() {if (Items) free(Items); if (nBuff) free(nBuff);}
+
+private:
+
+XrdMpxAgg       &Agg;
+XrdMpxAgg::Item *Items;
+const char      *Ins;
+const char      *Pgm;
+const char      *Site;
+const char      *Src;
+const char      *Tod;
+int              numItems;
+int              maxItems;
+char            *nBuff;
+int              nLen;
+int              nMax;
 };
 
 /******************************************************************************/
-/*                        X r d M p x O u t : : A d d                         */
+/*                    X r d M p x C o l : : C o l l e c t                     */
 /******************************************************************************/
-  
-void XrdMpxOut::Add(statsBuff *sbP)
+
+int XrdMpxCol::Collect(char *ibuff)
 {
+   Ins = Pgm = Site = Src = Tod = "";
+   numItems = nLen = 0;
+   return XrdMpxScan::Parse(ibuff, *this);
+}
+
+/******************************************************************************/
+/*                        X r d M p x C o l : : E n d                         */
+/******************************************************************************/
 
-// Add this to the queue and signal the processing thread
+int XrdMpxCol::End(const char *Toe)
+{
+   char Key[1024];
+   time_t tod;
+   int i;
+
+// Sources are identified by their address, program and instance name
+//
+   if (!*Src) return 1;
+   snprintf(Key, sizeof(Key), "%s %s %s", Src, Pgm, Ins);
+   if (!(tod = static_cast<time_t>(atoll(Tod)))) tod = time(0);
+
+// Now that the names have been accumulated, resolve them
 //
-   myMutex.Lock();
-   sbP->Next = inQ;
-   inQ = sbP;
-   Ready.Post();
-   myMutex.UnLock();
+   for (i = 0; i < numItems; i++) Items[i].Name = nBuff + Items[i].nOff;
+   Agg.Update(Key, Site, tod, Items, numItems);
+   return 1;
+}
+
+/******************************************************************************/
+/*                        X r d M p x C o l : : H d r                         */
+/******************************************************************************/
+
+int XrdMpxCol::Hdr(const char *Var, const char *Val)
+{
+        if (!strcmp(Var, "src"))  Src  = Val;
+   else if (!strcmp(Var, "tod"))  Tod  = Val;
+   else if (!strcmp(Var, "site")) Site = Val;
+   else if (!strcmp(Var, "pgm"))  Pgm  = Val;
+   else if (!strcmp(Var, "ins"))  Ins  = Val;
+   return 1;
 }
 
 /******************************************************************************/
-/*                    X r d M p x O u t : : g e t B u f f                     */
+/*                        X r d M p x C o l : : V a l                         */
 /******************************************************************************/
-  
-XrdMpxOut::statsBuff *XrdMpxOut::getBuff()
+
+int XrdMpxCol::Val(const char *Var, const char *Val)
 {
-   statsBuff *sbP;
+   double theVal;
+   int n;
+
+// We only aggregate numeric values
+//
+   if (!XrdMpxScan::Numeric(Val, &theVal)) return 1;
 
-// Use an available buffer or allocate one
+// The variable name is transient, so copy it
 //
-   myMutex.Lock();
-   if ((sbP = Free)) Free = sbP->Next;
-      else sbP = new statsBuff;
-   myMutex.UnLock();
-   return sbP;
+   n = strlen(Var) + 1;
+   if (nLen + n > nMax)
+      {nMax = (nMax ? nMax*2 : 8192) + n;
+       nBuff = (char *)realloc(nBuff, nMax);
+      }
+   if (numItems >= maxItems)
+      {maxItems = (maxItems ? maxItems*2 : 256);
+       Items = (XrdMpxAgg::Item *)realloc(Items,maxItems*sizeof(XrdMpxAgg::Item));
+      }
+   strcpy(nBuff+nLen, Var);
+   Items[numItems].nOff = nLen;
+   Items[numItems].Val  = theVal;
+   numItems++; nLen += n;
+   return 1;
 }
 
 /******************************************************************************/
 /*                        X r d M p x O u t : : R u n                         */
 /******************************************************************************/
-  
-void *XrdMpxOut::Run(XrdMpxXml *xP)
+
+// Each receiving thread runs this method. Records are formatted into a thread
+// local buffer that is written out whenever there is nothing more to receive
+// or the buffer is close to full. Aggregated records are not written at all.
+//
+void *XrdMpxOut::Run()
 {
-   XrdNetAddr theAddr;
-   const char *Host = 0;
-   char *bP, obuff[sizeof(statsBuff)*2];
-   statsBuff *sbP;
-   int wLen, rc;
+   static const int oSize = 262144, oMin = 65536;
+   XrdOucHash<char> hTab;
+   XrdMpxXml *xP = (fType == XrdMpxXml::fmtXML ? 0 : new XrdMpxXml(fType));
+   XrdMpxCol *cP = (Agg ? new XrdMpxCol(*Agg) : 0);
+   statsBuff *sbP = new statsBuff;
+   const char *Host;
+   char *oBuff = (char *)malloc(oSize);
+   SOCKLEN_t fromLen;
+   int oLen = 0, retc;
 
-// Simply loop formating and outputing the buffers
+// Simply loop receiving, formating and outputing the records
 //
    while(1)
-        {Ready.Wait();
-         myMutex.Lock();
-         if ((sbP = inQ)) inQ = sbP->Next;
-         myMutex.UnLock();
-         if (!sbP) continue;
+        {fromLen = sizeof(sbP->From);
+         retc = recvfrom(udpFD, sbP->Data, sizeof(sbP->Data),
+                         (oLen ? MSG_DONTWAIT : 0), &sbP->From.Addr, &fromLen);
+         if (retc < 0)
+            {if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {Write(oBuff, oLen); oLen = 0;}
+                else if (errno != EINTR)
+                        {Say.Emsg(":", errno, "recv udp message"); exit(8);}
+             continue;
+            }
+         sbP->Dlen = retc; sbP->Data[retc] = '\0';
+
+         if (cP) {cP->Collect(sbP->Data); continue;}
+
          if (xP)
-            {if (!(Opts & addSender)) Host = 0;
-                else if (theAddr.Set(&(sbP->From.Addr))) Host = 0;
-                        else Host = theAddr.Name();
-             wLen = xP->Format(Host, sbP->Data, obuff);
-             bP = obuff;
+            {Host = (Opts & addSender ? getHost(hTab, sbP->From) : 0);
+             oLen += xP->Format(Host, sbP->Data, oBuff+oLen, oSize-oLen);
             } else {
-             bP = sbP->Data;
-             *(bP + sbP->Dlen) = '\n';
-             wLen = sbP->Dlen+1;
+             memcpy(oBuff+oLen, sbP->Data, retc);
+             oLen += retc;
+             oBuff[oLen++] = '\n';
             }
 
-         while(wLen > 0)
-              {do {rc = write(STDOUT_FILENO, bP, wLen);}
-                  while(rc < 0 && errno == EINTR);
-               wLen -= rc; bP += rc;
-              }
-
-         myMutex.Lock(); sbP->Next = Free; Free = sbP; myMutex.UnLock();
+         if (oSize - oLen < oMin) {Write(oBuff, oLen); oLen = 0;}
         }
 
 // Should never get here
@@ -412,72 +1171,218 @@ void *XrdMpxOut::Run(XrdMpxXml *xP)
 }
 
 /******************************************************************************/
-/*                        G l o b a l   O b j e c t s                         */
+/*                      X r d M p x O u t : : W r i t e                       */
 /******************************************************************************/
-  
-namespace XrdMpx
+
+void XrdMpxOut::Write(const char *bP, int bLen)
 {
-XrdMpxOut statsQ;
-};
+   int rc;
+
+// Output must be serialized so that records are never intermixed
+//
+   outMutex.Lock();
+   while(bLen > 0)
+        {do {rc = write(STDOUT_FILENO, bP, bLen);}
+            while(rc < 0 && errno == EINTR);
+         if (rc < 0) {Say.Emsg(":", errno, "write stats"); exit(8);}
+         bLen -= rc; bP += rc;
+        }
+   outMutex.UnLock();
+}
+
+/******************************************************************************/
+/*                    X r d M p x O u t : : g e t H o s t                     */
+/******************************************************************************/
+
+// Host names are cached as resolving the sender on each record is costly.
+//
+const char *XrdMpxOut::getHost(XrdOucHash<char> &hTab, XrdNetSockAddr &From)
+{
+   XrdNetAddr theAddr;
+   const char *hName;
+   char aBuff[128], *hP;
+
+   if (theAddr.Set(&From.Addr)
+   ||  !theAddr.Format(aBuff, sizeof(aBuff), XrdNetAddrInfo::fmtAddr,
+                                             XrdNetAddrInfo::noPort))
+      return 0;
+   if ((hP = hTab.Find(aBuff))) return hP;
+   if (!(hName = theAddr.Name())) return 0;
+   if (hTab.Num() >= 4096) hTab.Purge();
+   hP = strdup(hName);
+   hTab.Add(aBuff, hP, 0, Hash_dofree);
+   return hP;
+}
 
 /******************************************************************************/
 /*                     T h r e a d   I n t e r f a c e s                      */
 /******************************************************************************/
-  
-void *mainOutput(void *parg)
+
+void *mainAggr(void *parg)
+{
+    XrdMpxAgg *aP = static_cast<XrdMpxAgg *>(parg);
+    return aP->Run();
+}
+
+void *mainRecv(void *parg)
 {
-    XrdMpxXml *xP = static_cast<XrdMpxXml *>(parg);
-    return statsQ.Run(xP);
+    return statsQ.Run();
+}
+
+/******************************************************************************/
+/*                                R e p l a y                                 */
+/******************************************************************************/
+
+// Replay recorded summary records (i.e. the output of 'mpxstats -f xml') to
+// a running mpxstats as fast as possible. Each record is sent as if it came
+// from nSrv different servers by suffixing the src attribute, and the tod
+// attribute is set to the current time.
+//
+int Replay(const char *File, const char *Dest, int Port,
+           long long Count, int nSrv)
+{
+   XrdNetAddr destAddr;
+   FILE *rFile;
+   struct timeval tBeg, tEnd;
+   const char *eText, *lP, *eP, *hEnd;
+   char **rec = 0, lBuff[sizeof(XrdMpxOut::statsBuff::Data)+2];
+   char pBuff[sizeof(lBuff)+64], *pP, *pEnd = pBuff + sizeof(pBuff) - 32;
+   long long i, numErr = 0;
+   double eTime;
+   int n, numRec = 0, maxRec = 0, sFD;
+
+// Read in all of the recorded records
+//
+   if (!(rFile = fopen(File, "r")))
+      {Say.Emsg(":", errno, "open", File); return 4;}
+   while(fgets(lBuff, sizeof(lBuff), rFile))
+        {if ((n = strlen(lBuff)) && lBuff[n-1] == '\n') lBuff[--n] = '\0';
+         if (strncmp(lBuff, "<statistics", 11)) continue;
+         if (numRec >= maxRec)
+            {maxRec = (maxRec ? maxRec*2 : 256);
+             rec = (char **)realloc(rec, maxRec*sizeof(char *));
+            }
+         rec[numRec++] = strdup(lBuff);
+        }
+   fclose(rFile);
+   if (!numRec) {Say.Emsg(":", "No summary records found in", File); return 4;}
+   if (!Count) Count = static_cast<long long>(numRec) * nSrv;
+
+// Get the destination and a socket to send to it
+//
+   if ((eText = destAddr.Set(Dest, Port)))
+      {Say.Emsg(":", "Unable to use", Dest, eText); return 4;}
+   if ((sFD = socket(destAddr.Family(), SOCK_DGRAM, 0)) < 0)
+      {Say.Emsg(":", errno, "create udp socket"); return 4;}
+
+// Send the records
+//
+   gettimeofday(&tBeg, 0);
+   for (i = 0; i < Count; i++)
+       {lP = rec[i % numRec]; hEnd = index(lP, '>');
+        n  = static_cast<int>((i / numRec) % nSrv);
+        pP = pBuff;
+        while(*lP && pP < pEnd)
+             {if (lP < hEnd && *lP == ' ')
+                 {if (!strncmp(lP, " tod=\"", 6) && (eP = index(lP+6, '"')))
+                     {pP += sprintf(pP, " tod=\"%ld", static_cast<long>(time(0)));
+                      lP = eP;
+                      continue;
+                     }
+                  if (nSrv > 1 && !strncmp(lP, " src=\"", 6)
+                  && (eP = index(lP+6, '"')) && eP - lP < pEnd - pP)
+                     {memcpy(pP, lP, eP - lP); pP += eP - lP;
+                      pP += sprintf(pP, ".%d", n);
+                      lP = eP;
+                      continue;
+                     }
+                 }
+              *pP++ = *lP++;
+             }
+        if (sendto(sFD, pBuff, pP - pBuff, 0, destAddr.SockAddr(),
+                   destAddr.SockSize()) < 0) numErr++;
+       }
+   gettimeofday(&tEnd, 0);
+
+// Report what happened
+//
+   eTime = (tEnd.tv_sec - tBeg.tv_sec) + (tEnd.tv_usec - tBeg.tv_usec)/1.0e6;
+   if (eTime <= 0.0) eTime = 1.0e-6;
+   cerr <<"mpxstats: Sent " <<Count-numErr <<" records (" <<numErr
+        <<" failed) in " <<eTime <<" seconds; "
+        <<static_cast<long long>((Count-numErr)/eTime) <<" records/sec." <<endl;
+   close(sFD);
+   return (numErr ? 8 : 0);
 }
 
 /******************************************************************************/
 /*                                 U s a g e                                  */
 /******************************************************************************/
-  
+
 void Usage(int rc)
 {
-   cerr <<"\nUsage: mpxstats [-f {cgi|flat|xml}] -p <port> [-s]" <<endl;
+   cerr <<"\nUsage: mpxstats [-a <sec>] [-f {cgi|flat|line|xml}] -p <port> [-s] "
+          "[-t <threads>]"
+          "\n       mpxstats -r <file> -p <port> [-H <host>] [-n <num>] "
+          "[-v <servers>]" <<endl;
    exit(rc);
 }
 
 /******************************************************************************/
 /*                                  m a i n                                   */
 /******************************************************************************/
-  
+
 int main(int argc, char *argv[])
 {
    extern char *optarg;
    extern int opterr, optopt;
    sigset_t myset;
    pthread_t tid;
-   XrdMpxXml::fmtType fType = XrdMpxXml::fmtXML;
-   XrdMpxOut::statsBuff *sbP = 0;
    XrdNetSocket mySocket(&Say);
-   XrdMpxXml *xP = 0;
-   SOCKLEN_t fromLen;
-   int Port = 0, retc, udpFD;
+   XrdMpxAgg *aP = 0;
+   const char *rFile = 0, *rHost = "localhost";
+   long long rNum = 0;
+   int Port = 0, aggInt = 0, numThreads = 4, rSrv = 1, rbSize, i, retc;
    char buff[64], c;
 
 // Process the options
 //
    opterr = 0; Debug = 0; Opts = 0;
-   if (argc > 1 && '-' == *argv[1]) 
-      while ((c = getopt(argc,argv,"df:p:s")) && ((unsigned char)c != 0xff))
+   if (argc > 1 && '-' == *argv[1])
+      while ((c = getopt(argc,argv,"a:df:H:n:p:r:st:v:"))
+             && ((unsigned char)c != 0xff))
      { switch(c)
        {
+       case 'a': if ((aggInt = atoi(optarg)) <= 0)
+                    {Say.Emsg(":", "Invalid interval - ", optarg); Usage(1);}
+                 break;
        case 'd': Debug = 1;
                  break;
-       case 'f':      if (!strcmp(optarg, "cgi" )) fType = XrdMpxXml::fmtCGI;
-                 else if (!strcmp(optarg, "flat")) fType = XrdMpxXml::fmtFlat;
-                 else if (!strcmp(optarg, "xml" )) fType = XrdMpxXml::fmtXML;
+       case 'f':      if (!strcmp(optarg, "cgi" )) statsQ.fType = XrdMpxXml::fmtCGI;
+                 else if (!strcmp(optarg, "flat")) statsQ.fType = XrdMpxXml::fmtFlat;
+                 else if (!strcmp(optarg, "line")) statsQ.fType = XrdMpxXml::fmtLine;
+                 else if (!strcmp(optarg, "xml" )) statsQ.fType = XrdMpxXml::fmtXML;
                  else {Say.Emsg(":", "Invalid format - ", optarg); Usage(1);}
                  break;
        case 'h': Usage(0);
+       case 'H': rHost = optarg;
+                 break;
+       case 'n': if ((rNum = atoll(optarg)) <= 0)
+                    {Say.Emsg(":", "Invalid count - ", optarg); Usage(1);}
+                 break;
        case 'p': if (!(Port = atoi(optarg)))
                     {Say.Emsg(":", "Invalid port number - ", optarg); Usage(1);}
                  break;
+       case 'r': rFile = optarg;
+                 break;
        case 's': Opts |= addSender;
                  break;
+       case 't': if ((numThreads = atoi(optarg)) <= 0 || numThreads > 64)
+                    {Say.Emsg(":", "Invalid thread count - ", optarg); Usage(1);}
+                 break;
+       case 'v': if ((rSrv = atoi(optarg)) <= 0)
+                    {Say.Emsg(":", "Invalid server count - ", optarg); Usage(1);}
+                 break;
        default:  sprintf(buff,"'%c'", optopt);
                  if (c == ':') Say.Emsg(":", buff, "value not specified.");
                     else Say.Emsg(0, buff, "option is invalid");
@@ -489,6 +1394,10 @@ int main(int argc, char *argv[])
 //
    if (!Port) {Say.Emsg(":", "Port has not been specified."); Usage(1);}
 
+// If we are replaying records, do so now
+//
+   if (rFile) exit(Replay(rFile, rHost, Port, rNum, rSrv));
+
 // Turn off sigpipe and host a variety of others before we start any threads
 //
    signal(SIGPIPE, SIG_IGN);  // Solaris optimization
@@ -502,33 +1411,33 @@ int main(int argc, char *argv[])
    if (sizeof(long) > 4) XrdSysThread::setStackSize((size_t)1048576);
       else               XrdSysThread::setStackSize((size_t)786432);
 
-// Create a UDP socket and bind it to a port
+// Create a UDP socket and bind it to a port. Use a large receive buffer to
+// absorb bursts of records (the system may limit this further).
 //
    if (mySocket.Open(0, Port, XRDNET_SERVER|XRDNET_UDPSOCKET, 0) < 0)
       {Say.Emsg(":", -mySocket.LastError(), "create udp socket"); exit(4);}
    udpFD = mySocket.Detach();
+   rbSize = 8*1024*1024;
+   setsockopt(udpFD, SOL_SOCKET, SO_RCVBUF, (const void *)&rbSize,
+              sizeof(rbSize));
 
-// Establish format
+// If we are aggregating, start the reporting thread
 //
-   if (fType != XrdMpxXml::fmtXML) xP = new XrdMpxXml(fType);
-
-// Now run a thread to output whatever we get
+   if (aggInt)
+      {statsQ.Agg = aP = new XrdMpxAgg(aggInt);
+       if ((retc = XrdSysThread::Run(&tid, mainAggr, (void *)aP,
+                                     XRDSYSTHREAD_BIND, "Aggregator")))
+          {Say.Emsg(":", retc, "create aggregator thread"); exit(4);}
+      }
+
+// Now run the receiving threads, this thread being one of them
 //
-   if ((retc = XrdSysThread::Run(&tid, mainOutput, (void *)xP,
-                                 XRDSYSTHREAD_BIND, "Output")))
-      {Say.Emsg(":", retc, "create output thread"); exit(4);}
-
-// Now simply wait for the messages
-//
-   fromLen = sizeof(sbP->From);
-   while(1)
-        {sbP = statsQ.getBuff();
-         retc = recvfrom(udpFD, sbP->Data, sizeof(sbP->Data), 0,
-                               &sbP->From.Addr, &fromLen);
-         if (retc < 0) {Say.Emsg(":", retc, "recv udp message"); exit(8);}
-         sbP->Dlen = retc;
-         statsQ.Add(sbP);
-        }
+   for (i = 1; i < numThreads; i++)
+       {if ((retc = XrdSysThread::Run(&tid, mainRecv, 0,
+                                      XRDSYSTHREAD_BIND, "Receiver")))
+           {Say.Emsg(":", retc, "create receiver thread"); exit(4);}
+       }
+   statsQ.Run();
 
 // Should never get here
 //
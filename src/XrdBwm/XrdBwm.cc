@@ -96,6 +96,7 @@ XrdBwm::XrdBwm()
 //
    Authorization = 0;
    Authorize     = 0;
+   CgiVorg       = 0;
    AuthLib       = 0;
    AuthParm      = 0;
    Logger        = 0;
@@ -264,14 +265,20 @@ int XrdBwmFile::open(const char          *path,      // In
             info      - Opaque information:
                         bwm.src=<src  host>
                         bwm.dst=<dest host>
+                        bwm.size=<estimated bytes to transfer> (optional)
+                        bwm.vo=<virtual organization> (optional, used
+                               only when the client has no vorg and
+                               bwm.cgivo is in effect)
 
   Output:   Returns SFS_OK upon success, otherwise SFS_ERROR is returned.
 */
 {
    EPNAME("open");
    XrdBwmHandle *hP;
+   long long theSize = 0;
    int incomming;
    const char *miss, *theUsr, *theSrc, *theDst=0, *theLfn=0, *lclNode, *rmtNode;
+   const char *theVorg, *val;
    XrdOucEnv Open_Env(info);
 
 // Trace entry
@@ -318,9 +325,17 @@ int XrdBwmFile::open(const char          *path,      // In
            {incomming = 1; lclNode = theDst; rmtNode = theSrc;}
    else return XrdBwmFS.Emsg("open", error, EREMOTE, "open", path);
 
+// Get the optional scheduling hints. An authenticated vorg takes precedence
+// and the client's own claim is only believed when so configured.
+//
+   if ((val = Open_Env.Get("bwm.size"))) theSize = strtoll(val, 0, 10);
+   if (!client || !(theVorg = client->vorg))
+      theVorg = (XrdBwmFS.CgiVorg ? Open_Env.Get("bwm.vo") : 0);
+
 // Get a handle for this file.
 //
-   if (!(hP = XrdBwmHandle::Alloc(theUsr,theLfn,lclNode,rmtNode,incomming)))
+   if (!(hP = XrdBwmHandle::Alloc(theUsr,theLfn,lclNode,rmtNode,incomming,
+                                  theVorg, theSize)))
       return XrdBwmFS.Stall(error, 13, path);
 
 // All done
@@ -247,7 +247,8 @@ char *HostPref;       //    ->Our hostname with domain removed
 char *myDomain;       //    ->Our domain name
 int   myDomLen;       //
 char  Authorize;
-char  Reserved[7];
+char  CgiVorg;        //      Accept bwm.vo from clients without a vorg
+char  Reserved[6];
 
 /******************************************************************************/
 /*                       P r o t e c t e d   I t e m s                        */
@@ -157,6 +157,7 @@ int XrdBwm::ConfigXeq(char *var, XrdOucStream &Config,
 {
     TS_Bit("authorize",     Authorize, 1);
     TS_Xeq("authlib",       xalib);
+    TS_Bit("cgivo",         CgiVorg,   1);
     TS_Xeq("log",           xlog);
     TS_Xeq("policy",        xpol);
     TS_Xeq("trace",         xtrace);
@@ -259,6 +260,9 @@ int XrdBwm::xlog(XrdOucStream &Config, XrdSysError &Eroute)
              <num>     maximum number of slots available.
              <path>    if preceeded by lib, the path of the policy library to 
                        be used; otherwise, the file that describes policy.
+                       Specifying libXrdBwm.so selects the bundled policy
+                       that schedules by bytes with per-VO fair sharing
+                       (see XrdBwmPolicy2::Config() for its parms).
              <parms>   optional parms to be passed
 
   Output: 0 upon success or !0 upon failure.
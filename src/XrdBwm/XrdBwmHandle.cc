@@ -167,7 +167,8 @@ int XrdBwmHandle::Activate(XrdOucErrInfo &einfo)
   
 XrdBwmHandle *XrdBwmHandle::Alloc(const char *theUsr,  const char *thePath,
                                   const char *LclNode, const char *RmtNode,
-                                  int Incomming)
+                                  int Incomming, const char *theVorg,
+                                  long long theSize)
 {
    XrdBwmHandle *hP = Alloc();
 
@@ -180,6 +181,8 @@ XrdBwmHandle *XrdBwmHandle::Alloc(const char *theUsr,  const char *thePath,
        hP->Parms.RmtNode   = strdup(RmtNode);
        hP->Parms.Direction = (Incomming ? XrdBwmPolicy::Incomming
                                         : XrdBwmPolicy::Outgoing);
+       hP->Parms.Vorg      = (theVorg ? strdup(theVorg) : 0);
+       hP->Parms.Size      = theSize;
        hP->Status          = Idle;
        hP->qTime           = 0;
        hP->rTime           = 0;
@@ -366,6 +369,7 @@ void XrdBwmHandle::Retire()
    if (Parms.Lfn)     {free(Parms.Lfn);     Parms.Lfn = 0;}
    if (Parms.LclNode) {free(Parms.LclNode); Parms.LclNode = 0;}
    if (Parms.RmtNode) {free(Parms.RmtNode); Parms.RmtNode = 0;}
+   if (Parms.Vorg)    {free(Parms.Vorg);    Parms.Vorg    = 0;}
    Alloc(this);
 }
 
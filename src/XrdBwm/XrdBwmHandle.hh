@@ -50,7 +50,8 @@ enum HandleState {Idle = 0, Scheduled, Dispatched};
 
 static XrdBwmHandle *Alloc(const char *theUsr,  const char *thePath,
                            const char *lclNode, const char *rmtNode,
-                           int Incomming);
+                           int Incomming, const char *theVorg=0,
+                           long long theSize=0);
 
 static void         *Dispatch();
 
@@ -121,6 +121,8 @@ const char  *Tident;     // In: -> Client's trace identity
       char  *LclNode;    // In: -> Local  node involved in the request
       char  *RmtNode;    // In: -> Remote node involved in the request
       Flow   Direction;  // In: -> Data flow relative to Lclpoint (see enum)
+      char  *Vorg;       // In: -> Virtual organization of the client or 0
+ long long   Size;       // In: -> Estimated bytes to transfer, 0 if unknown
 };
 
 virtual int  Schedule(char *RespBuff, int RespSize, SchedParms &Parms) = 0;
@@ -72,8 +72,9 @@ class refSch
        int      maxSlots;
 
        void     Add(refReq *rP)
-                       {if ((rP->Next = Last)) Last = rP;
-                           else         First= Last = rP;
+                       {rP->Next = 0;
+                        if (Last) {Last->Next = rP; Last = rP;}
+                           else    First = Last = rP;
                         Num++;
                        }
 
@@ -0,0 +1,523 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d B w m P o l i c y 2 . c c                       */
+/*                                                                            */
+/* (c) 2008 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "XrdBwm/XrdBwmPolicy2.hh"
+#include "XrdOuc/XrdOuca2x.hh"
+#include "XrdOuc/XrdOucTokenizer.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+#define Max(x,y) (x > y ? x : y)
+
+/******************************************************************************/
+/*                       L o c a l   F u n c t i o n s                        */
+/******************************************************************************/
+
+namespace
+{
+long long usClock()
+{
+   struct timeval tNow;
+
+   gettimeofday(&tNow, 0);
+   return static_cast<long long>(tNow.tv_sec)*1000000 + tNow.tv_usec;
+}
+}
+
+/******************************************************************************/
+/*                        S t a t i c   O b j e c t s                         */
+/******************************************************************************/
+
+long long (*XrdBwmPolicy2::Clock)() = usClock;
+
+/******************************************************************************/
+/*                    X r d B w m P o l i c y O b j e c t                     */
+/******************************************************************************/
+
+// This makes the policy loadable via 'bwm.policy lib libXrdBwm.so <parms>'
+//
+extern "C"
+{
+XrdBwmPolicy *XrdBwmPolicyObject(XrdSysLogger *lp,
+                                 const char   *cfn,
+                                 const char   *parm)
+{
+   static XrdSysError eDest(0, "bwm_");
+   XrdBwmPolicy2 *pP;
+
+   eDest.logger(lp);
+   pP = new XrdBwmPolicy2(&eDest);
+   if (pP->Config(parm)) {delete pP; return 0;}
+   return pP;
+}
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdBwmPolicy2::XrdBwmPolicy2(XrdSysError *erp) : pCond(0), eDest(erp)
+{
+   int i;
+
+// Initialize values
+//
+   for (i = 0; i < rTabSize; i++) rTab[i] = 0;
+   for (i = 0; i < IO; i++)
+       {Vtime[i] = 0.0; maxSlots[i] = numXeq[i] = numQueued[i] = 0;}
+   voList    = 0;
+   defVo     = 0;
+   defSize   = 1024LL*1024LL*1024LL;
+   Burst     = 0;
+   defWeight = 1.0;
+   refID     = 1;
+   nextWay   = In;
+}
+
+/******************************************************************************/
+/*                  X r d B w m P o l i c y 2 : : V o I n f o                 */
+/******************************************************************************/
+
+XrdBwmPolicy2::VoInfo::VoInfo(const char *vName, double vWeight)
+              : Next(0), Name(strdup(vName)), Weight(vWeight)
+{
+   for (int i = 0; i < IO; i++) {Finish[i] = 0.0; First[i] = Last[i] = 0;}
+}
+
+/******************************************************************************/
+/*                                C o n f i g                                 */
+/******************************************************************************/
+
+/* Function: Config
+
+   Purpose:  To parse the policy parameters:
+
+             [in <rate>] [out <rate>] [burst <bytes>] [size <bytes>]
+             [slots <in> <out>] [weight <w>]
+             [vo <name> [weight <w>] [rate <rate>]] [...]
+
+             in        the incomming link bandwidth in bytes/sec (0 -> no limit)
+             out       the outgoing  link bandwidth in bytes/sec (0 -> no limit)
+             burst     the maximum unused bandwidth that may accumulate. The
+                       default is one second's worth.
+             size      the size assumed when a transfer's size is unknown.
+             slots     the maximum number of concurrent transfers in each
+                       direction (0 -> no limit).
+             weight    the share of VOs not otherwise specified (default 1).
+             vo        the share of the named VO and optionally the bandwidth
+                       it is limited to in each direction. Requests from VOs
+                       that are not named here are all queued together as
+                       VO '*', which may itself be named.
+
+  Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdBwmPolicy2::Config(const char *Parms)
+{
+   XrdOucTokenizer Toks(0);
+   VoInfo   *vP = 0;
+   char     *val, *pBuff;
+   long long rate;
+   int       num, NoGo = 0;
+
+// Parameters are optional
+//
+   if (!Parms || !*Parms) pBuff = 0;
+      else {pBuff = strdup(Parms); Toks.Attach(pBuff); Toks.GetLine();}
+
+// Process the parameters. VO options apply to the VO most recently named.
+//
+   while(pBuff && !NoGo && (val = Toks.GetToken()))
+        {     if (!strcmp("in", val) || !strcmp("out", val))
+                 {Flow xWay = (*val == 'i' ? In : Out);
+                  if (!(val = Toks.GetToken()))
+                     {eDest->Emsg("Config", "link rate not specified"); NoGo=1;}
+                     else NoGo = XrdOuca2x::a2sz(*eDest, "link rate", val,
+                                                 &Link[xWay].Rate, 0);
+                 }
+         else if (!strcmp("burst", val))
+                 {if (!(val = Toks.GetToken()))
+                     {eDest->Emsg("Config", "burst not specified"); NoGo=1;}
+                     else NoGo = XrdOuca2x::a2sz(*eDest, "burst", val,
+                                                 &Burst, 1);
+                 }
+         else if (!strcmp("size", val))
+                 {if (!(val = Toks.GetToken()))
+                     {eDest->Emsg("Config", "size not specified"); NoGo=1;}
+                     else NoGo = XrdOuca2x::a2sz(*eDest, "size", val,
+                                                 &defSize, 1);
+                 }
+         else if (!strcmp("slots", val))
+                 {if (!(val = Toks.GetToken()))
+                     {eDest->Emsg("Config", "in slots not specified"); NoGo=1;}
+                     else if (!(NoGo = XrdOuca2x::a2i(*eDest, "in slots", val,
+                                                      &maxSlots[In], 0)))
+                             {if (!(val = Toks.GetToken()))
+                                 {eDest->Emsg("Config", "out slots not specified");
+                                  NoGo = 1;
+                                 } else NoGo = XrdOuca2x::a2i(*eDest,
+                                               "out slots", val, &maxSlots[Out], 0);
+                             }
+                 }
+         else if (!strcmp("weight", val))
+                 {if (!(val = Toks.GetToken()))
+                     {eDest->Emsg("Config", "weight not specified"); NoGo=1;}
+                     else if (!(NoGo = XrdOuca2x::a2i(*eDest, "weight", val,
+                                                      &num, 1, 1000000)))
+                             {if (vP) vP->Weight = num;
+                                 else defWeight  = num;
+                             }
+                 }
+         else if (!strcmp("rate", val) && vP)
+                 {if (!(val = Toks.GetToken()))
+                     {eDest->Emsg("Config", "vo rate not specified"); NoGo=1;}
+                     else if (!(NoGo = XrdOuca2x::a2sz(*eDest, "vo rate", val,
+                                                       &rate, 0)))
+                             vP->Limit[In].Rate = vP->Limit[Out].Rate = rate;
+                 }
+         else if (!strcmp("vo", val))
+                 {if (!(val = Toks.GetToken()))
+                     {eDest->Emsg("Config", "vo name not specified"); NoGo=1;}
+                     else vP = addVo(val);
+                 }
+         else {eDest->Emsg("Config", "invalid policy parameter -", val);
+               NoGo = 1;
+              }
+        }
+   if (pBuff) free(pBuff);
+   if (NoGo) return 1;
+
+// Everything not named shares the default VO
+//
+   defVo = addVo("*");
+
+// Now that we know the burst size, fill all of the buckets
+//
+   setBucket(Link[In],  Link[In].Rate);
+   setBucket(Link[Out], Link[Out].Rate);
+   for (vP = voList; vP; vP = vP->Next)
+       {setBucket(vP->Limit[In],  vP->Limit[In].Rate);
+        setBucket(vP->Limit[Out], vP->Limit[Out].Rate);
+       }
+   return 0;
+}
+
+/******************************************************************************/
+/*                              D i s p a t c h                               */
+/******************************************************************************/
+
+int  XrdBwmPolicy2::Dispatch(char *RespBuff, int RespSize)
+{
+   long long When, Now;
+   int rID, wMS;
+
+// Wait for a request to become ready. When requests are waiting for tokens we
+// know when the earliest one may be ready; otherwise, we wait for a change.
+//
+   pCond.Lock();
+   do {When = -1;
+       if ((rID = Poll(RespBuff, RespSize, When))) break;
+       if (When < 0) pCond.Wait();
+          else {Now = Clock();
+                wMS = static_cast<int>((When - Now + 999) / 1000);
+                if (wMS > 0) pCond.WaitMS(wMS);
+               }
+      } while(1);
+   pCond.UnLock();
+   return rID;
+}
+
+/******************************************************************************/
+/*                                  D o n e                                   */
+/******************************************************************************/
+
+int  XrdBwmPolicy2::Done(int rHandle)
+{
+   Request *rP, *pP = 0;
+   VoInfo  *vP;
+   int i, rc = 0;
+
+// Make sure we have a positive value here
+//
+   if (rHandle < 0) rHandle = -rHandle;
+
+// Check if this is an active request. If so, it's slot becomes available.
+//
+   pCond.Lock();
+   rP = rTab[rHandle % rTabSize];
+   while(rP && rP->refID != rHandle) {pP = rP; rP = rP->Next;}
+   if (rP)
+      {if (pP) pP->Next = rP->Next;
+          else rTab[rHandle % rTabSize] = rP->Next;
+       numXeq[rP->Way]--;
+       if (numQueued[rP->Way]) pCond.Signal();
+       rc = 1;
+      } else {
+
+// Look for the request in the queues
+//
+       for (vP = voList; vP && !rP; vP = vP->Next)
+           for (i = 0; i < IO && !rP; i++)
+               {pP = 0; rP = vP->First[i];
+                while(rP && rP->refID != rHandle) {pP = rP; rP = rP->Next;}
+                if (rP)
+                   {if (pP) pP->Next = rP->Next;
+                       else vP->First[i] = rP->Next;
+                    if (vP->Last[i] == rP) vP->Last[i] = pP;
+                    numQueued[i]--;
+                    rc = -1;
+                   }
+               }
+      }
+   pCond.UnLock();
+
+// Delete the element and return
+//
+   if (rP) delete rP;
+   return rc;
+}
+
+/******************************************************************************/
+/*                                  P o l l                                   */
+/******************************************************************************/
+
+// Poll() returns the handle of the next queued request that may be dispatched
+// or zero if none can be. In the latter case, When is set to the time when a
+// request that is waiting for tokens may become ready or left unchanged if
+// no request is waiting for tokens. Dispatch() calls this method with the
+// condition variable locked; a simulator may call it directly.
+//
+int  XrdBwmPolicy2::Poll(char *RespBuff, int RespSize, long long &When)
+{
+   Request  *rP;
+   VoInfo   *vP, *bestVo;
+   long long Now = Clock();
+   int i, xWay;
+
+// Alternate between the two directions so that neither can starve the other
+//
+   *RespBuff = '\0';
+   for (i = 0; i < IO; i++)
+       {xWay = (nextWay + i) % IO;
+        if (!numQueued[xWay]
+        ||  (maxSlots[xWay] && numXeq[xWay] >= maxSlots[xWay])) continue;
+
+    // The link must have tokens for anything to go
+    //
+        Link[xWay].Fill(Now);
+        if (!Link[xWay].Ready())
+           {long long lWhen = Link[xWay].When(Now);
+            if (When < 0 || lWhen < When) When = lWhen;
+            continue;
+           }
+
+    // Select the request with the smallest start tag among the VOs that are
+    // not over their own limit.
+    //
+        bestVo = 0;
+        for (vP = voList; vP; vP = vP->Next)
+            {if (!(rP = vP->First[xWay])) continue;
+             vP->Limit[xWay].Fill(Now);
+             if (!vP->Limit[xWay].Ready())
+                {long long vWhen = vP->Limit[xWay].When(Now);
+                 if (When < 0 || vWhen < When) When = vWhen;
+                 continue;
+                }
+             if (!bestVo || rP->Start < bestVo->First[xWay]->Start) bestVo = vP;
+            }
+        if (!bestVo) continue;
+
+    // Dequeue the request, advance virtual time, and admit it
+    //
+        rP = bestVo->First[xWay];
+        if (!(bestVo->First[xWay] = rP->Next)) bestVo->Last[xWay] = 0;
+        numQueued[xWay]--;
+        Vtime[xWay] = rP->Start;
+        Admit(rP, Now);
+        nextWay = (xWay + 1) % IO;
+        return rP->refID;
+       }
+
+// Nothing can be dispatched at this point
+//
+   return 0;
+}
+
+/******************************************************************************/
+/*                              S c h e d u l e                               */
+/******************************************************************************/
+
+int  XrdBwmPolicy2::Schedule(char *RespBuff, int RespSize, SchedParms &Parms)
+{
+   Request  *rP;
+   VoInfo   *vP;
+   long long Now = Clock();
+   double    sTag;
+   int       myID;
+
+// Requests may not flow in a direction that has no bandwidth
+//
+   *RespBuff = '\0';
+   rP = new Request;
+   rP->Way  = (Parms.Direction == XrdBwmPolicy::Incomming ? In : Out);
+   rP->Size = (Parms.Size > 0 ? Parms.Size : defSize);
+   rP->Next = 0;
+
+// Get the global lock and generate a reference ID
+//
+   pCond.Lock();
+   if ((myID = ++refID) <= 0) myID = refID = 1;
+   rP->refID = myID;
+   rP->Vo    = vP = getVo(Parms.Vorg);
+
+// Compute the start tag: the later of now (in virtual time) or when this VO's
+// previous request finishes. The VO's next request starts at our finish.
+//
+   sTag = Max(Vtime[rP->Way], vP->Finish[rP->Way]);
+   rP->Start = sTag;
+   vP->Finish[rP->Way] = sTag + static_cast<double>(rP->Size) / vP->Weight;
+
+// If nothing is waiting and there are tokens and a slot, run it now.
+// Otherwise, queue the request and let the dispatcher know.
+//
+   Link[rP->Way].Fill(Now); vP->Limit[rP->Way].Fill(Now);
+   if (!numQueued[rP->Way] && Link[rP->Way].Ready()
+   &&  vP->Limit[rP->Way].Ready()
+   &&  (!maxSlots[rP->Way] || numXeq[rP->Way] < maxSlots[rP->Way]))
+      {Vtime[rP->Way] = sTag;
+       Admit(rP, Now);
+      } else {
+       if (vP->Last[rP->Way]) vP->Last[rP->Way]->Next = rP;
+          else vP->First[rP->Way] = rP;
+       vP->Last[rP->Way] = rP;
+       numQueued[rP->Way]++;
+       pCond.Signal();
+       myID = -myID;
+      }
+
+// All done
+//
+   pCond.UnLock();
+   return myID;
+}
+
+/******************************************************************************/
+/*                                S t a t u s                                 */
+/******************************************************************************/
+
+void XrdBwmPolicy2::Status(int &numqIn, int &numqOut, int &numXeqs)
+{
+
+// Get the global lock and return the values
+//
+   pCond.Lock();
+   numqIn  = numQueued[In];
+   numqOut = numQueued[Out];
+   numXeqs = numXeq[In] + numXeq[Out];
+   pCond.UnLock();
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 A d m i t                                  */
+/******************************************************************************/
+
+// Admitting a request debits its size from the buckets, possibly putting them
+// into debt, and adds it to the active table. The lock must be held.
+//
+void XrdBwmPolicy2::Admit(Request *rP, long long Now)
+{
+   int i = rP->refID % rTabSize;
+
+   if (Link[rP->Way].Rate)         Link[rP->Way].Tokens         -= rP->Size;
+   if (rP->Vo->Limit[rP->Way].Rate) rP->Vo->Limit[rP->Way].Tokens -= rP->Size;
+   numXeq[rP->Way]++;
+   rP->Next = rTab[i]; rTab[i] = rP;
+}
+
+/******************************************************************************/
+/*                                 a d d V o                                  */
+/******************************************************************************/
+
+// VOs are only added while configuring, so the list is bounded by what the
+// administrator named no matter what clients send.
+//
+XrdBwmPolicy2::VoInfo *XrdBwmPolicy2::addVo(const char *vName)
+{
+   VoInfo *vP = voList, *pP = 0;
+
+   while(vP && strcmp(vName, vP->Name)) {pP = vP; vP = vP->Next;}
+   if (vP) return vP;
+
+   vP = new VoInfo(vName, defWeight);
+   if (pP) pP->Next = vP;
+      else voList   = vP;
+   return vP;
+}
+
+/******************************************************************************/
+/*                                 g e t V o                                  */
+/******************************************************************************/
+
+// VOs not named in the configuration are mapped to the default VO. The lock
+// must be held.
+//
+XrdBwmPolicy2::VoInfo *XrdBwmPolicy2::getVo(const char *vName)
+{
+   VoInfo *vP;
+
+   if (!vName || !*vName) return defVo;
+   vP = voList;
+   while(vP && strcmp(vName, vP->Name)) vP = vP->Next;
+   return (vP ? vP : defVo);
+}
+
+/******************************************************************************/
+/*                             s e t B u c k e t                              */
+/******************************************************************************/
+
+void XrdBwmPolicy2::setBucket(Bucket &bkt, long long Rate)
+{
+   bkt.Rate   = Rate;
+   bkt.Burst  = (Burst ? Burst : Rate);
+   bkt.Tokens = static_cast<double>(bkt.Burst);
+   bkt.Last   = Clock();
+}
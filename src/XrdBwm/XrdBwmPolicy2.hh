@@ -0,0 +1,141 @@
+#ifndef __BWM_POLICY2_HH__
+#define __BWM_POLICY2_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d B w m P o l i c y 2 . h h                       */
+/*                                                                            */
+/* (c) 2008 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include "XrdBwm/XrdBwmPolicy.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+class XrdSysError;
+
+// This policy schedules transfers by bytes rather than by count. Each flow
+// direction (i.e. the site's link) has a token bucket that is debited by the
+// estimated size of a transfer when it is admitted. Optionally, each virtual
+// organization (VO) has its own bucket as well. Queued transfers are served in
+// start-time fair order across the configured VOs, weighted by their shares.
+//
+class XrdBwmPolicy2 : public XrdBwmPolicy
+{
+public:
+
+int  Config(const char *Parms);
+
+int  Dispatch(char *RespBuff, int RespSize);
+
+int  Done(int rHandle);
+
+int  Poll(char *RespBuff, int RespSize, long long &When);
+
+int  Schedule(char *RespBuff, int RespSize, SchedParms &Parms);
+
+void Status(int &numqIn, int &numqOut, int &numXeq);
+
+// The clock returns the time in microseconds. It may be replaced to drive the
+// policy in simulated time (see Poll()).
+//
+static long long (*Clock)();
+
+     XrdBwmPolicy2(XrdSysError *erp);
+    ~XrdBwmPolicy2() {} // Never deleted!
+
+private:
+
+enum Flow {In = 0, Out = 1, IO = 2};
+
+struct Bucket
+      {long long Rate;     // Bytes per second, 0 means unlimited
+       long long Burst;    // Maximum number of tokens
+       long long Last;     // Time of the last fill
+       double    Tokens;   // May be negative when in debt
+
+       void      Fill(long long Now)
+                     {if (Rate)
+                         {Tokens += (Now - Last) * (Rate / 1000000.0);
+                          if (Tokens > Burst) Tokens = Burst;
+                         }
+                      Last = Now;
+                     }
+
+       bool      Ready() {return !Rate || Tokens >= 0.0;}
+
+       long long When(long long Now)
+                     {return Now+static_cast<long long>(-Tokens*1000000.0/Rate)+1;}
+
+                 Bucket() : Rate(0), Burst(0), Last(0), Tokens(0.0) {}
+      };
+
+struct VoInfo;
+
+struct Request
+      {Request  *Next;
+       VoInfo   *Vo;
+       long long Size;
+       double    Start;
+       int       refID;
+       Flow      Way;
+      };
+
+struct VoInfo
+      {VoInfo   *Next;
+       char     *Name;
+       double    Weight;
+       double    Finish[IO];
+       Bucket    Limit[IO];
+       Request  *First[IO];
+       Request  *Last[IO];
+
+                 VoInfo(const char *vName, double vWeight);
+                ~VoInfo() {} // Never deleted!
+      };
+
+void     Admit(Request *rP, long long Now);
+VoInfo  *addVo(const char *vName);
+VoInfo  *getVo(const char *vName);
+void     setBucket(Bucket &bkt, long long Rate);
+
+static const int rTabSize = 256;
+
+XrdSysCondVar pCond;
+XrdSysError  *eDest;
+Request      *rTab[rTabSize];
+VoInfo       *voList;
+VoInfo       *defVo;
+Bucket        Link[IO];
+long long     defSize;
+long long     Burst;
+double        Vtime[IO];
+double        defWeight;
+int           maxSlots[IO];
+int           numXeq[IO];
+int           numQueued[IO];
+int           refID;
+int           nextWay;
+};
+#endif
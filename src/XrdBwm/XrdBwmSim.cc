@@ -0,0 +1,462 @@
+/******************************************************************************/
+/*                                                                            */
+/*                          X r d B w m S i m . c c                           */
+/*                                                                            */
+/* (c) 2008 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+/* This is a discrete event simulator for the bandwidth manager policies. It
+   replays a transfer trace against XrdBwmPolicy1 (slots) or XrdBwmPolicy2
+   (bytes) in simulated time and reports utilization and fairness. Fairness
+   is Jain's index of the bytes each VO was served while requests were
+   arriving relative to its weighted max-min fair share of the link given
+   what it requested. Each line of the trace describes a transfer request:
+
+   <arrival secs> <vo> <bytes> [in | out]
+
+   Blank lines and lines starting with '#' are ignored. The link is modeled
+   as capacity shared equally by the active transfers in each direction, each
+   possibly limited to a maximum rate.
+*/
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "XrdBwm/XrdBwmPolicy1.hh"
+#include "XrdBwm/XrdBwmPolicy2.hh"
+#include "XrdOuc/XrdOuca2x.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysLogger.hh"
+
+/******************************************************************************/
+/*                      G l o b a l   V a r i a b l e s                       */
+/******************************************************************************/
+
+namespace
+{
+XrdSysLogger Logger;
+
+XrdSysError  Say(&Logger, "bwmsim_");
+
+long long    simTime = 0;   // Microseconds
+
+long long    simClock() {return simTime;}
+
+struct Xfer
+      {double    Arrive;
+       double    Start;
+       double    Left;
+       long long Size;
+       int       Handle;
+       int       Vo;
+       int       Way;
+      };
+
+struct VoStat
+      {char      Name[64];
+       double    Weight;
+       double    Bytes;
+       double    Demand[2]; // Bytes requested while requests were arriving
+       double    Served[2]; // Bytes moved     while requests were arriving
+       double    Fair[2];   // Bytes a weighted max-min fair share would move
+       double    WaitSum;
+       double   *Waits;
+       int       numXfr;
+      };
+
+Xfer    *xTab   = 0;
+int      xNum   = 0;
+VoStat   voTab[64];
+int      voNum  = 0;
+}
+
+/******************************************************************************/
+/*                                 g e t V o                                  */
+/******************************************************************************/
+
+int getVo(const char *vName)
+{
+   int i;
+
+   for (i = 0; i < voNum; i++) if (!strcmp(vName, voTab[i].Name)) return i;
+   if (voNum >= (int)(sizeof(voTab)/sizeof(VoStat)))
+      {Say.Emsg("Sim", "Too many VOs; excess VOs lumped into", vName);
+       return voNum-1;
+      }
+   memset(&voTab[voNum], 0, sizeof(VoStat));
+   strncpy(voTab[voNum].Name, vName, sizeof(voTab[0].Name)-1);
+   voTab[voNum].Weight = 1.0;
+   return voNum++;
+}
+
+/******************************************************************************/
+/*                                  L o a d                                   */
+/******************************************************************************/
+
+int Load(const char *fn)
+{
+   FILE *tFile = (strcmp(fn, "-") ? fopen(fn, "r") : stdin);
+   char lBuff[1024], vName[64], wName[16];
+   double tArr;
+   long long tSize;
+   int n, xMax = 0;
+
+// Read the trace, it must be ordered by arrival time
+//
+   if (!tFile) {Say.Emsg("Sim", errno, "open", fn); return 0;}
+   while(fgets(lBuff, sizeof(lBuff), tFile))
+        {if (*lBuff == '#' || *lBuff == '\n') continue;
+         *wName = 0;
+         if ((n = sscanf(lBuff, "%lf %63s %lld %15s", &tArr, vName, &tSize,
+                         wName)) < 3 || tSize <= 0)
+            {Say.Emsg("Sim", "Invalid trace line:", lBuff); continue;}
+         if (xNum >= xMax)
+            {xMax = (xMax ? xMax*2 : 4096);
+             xTab = (Xfer *)realloc(xTab, xMax*sizeof(Xfer));
+            }
+         if (xNum && tArr < xTab[xNum-1].Arrive) tArr = xTab[xNum-1].Arrive;
+         xTab[xNum].Arrive = tArr;
+         xTab[xNum].Size   = tSize;
+         xTab[xNum].Left   = static_cast<double>(tSize);
+         xTab[xNum].Vo     = getVo(vName);
+         xTab[xNum].Way    = (!strcmp(wName, "out") ? 1 : 0);
+         xTab[xNum].Handle = 0;
+         xNum++;
+        }
+   if (tFile != stdin) fclose(tFile);
+   return xNum;
+}
+
+/******************************************************************************/
+/*                              S y n t h e s i z e                           */
+/******************************************************************************/
+
+// Generate a trace where one VO moves a few large files, one moves many small
+// files, and one moves medium sized files, at an offered load of 150% of the
+// link capacity.
+//
+void Synthesize(int Num, double Capacity, unsigned int Seed)
+{
+   static const struct {const char *Name; double minSz, maxSz;} Mix[] =
+                       {{"bigvo",   2.0e9, 1.0e10},
+                        {"smallvo", 1.0e7, 1.0e8},
+                        {"midvo",   2.0e8, 1.0e9}};
+   double meanSz = 0.0, tNow = 0.0, lambda;
+   int i, k;
+
+   srand48(Seed);
+   for (k = 0; k < 3; k++) meanSz += (Mix[k].minSz + Mix[k].maxSz) / 2.0;
+   meanSz /= 3.0;
+   lambda = 1.5 * Capacity / meanSz;
+
+   xTab = (Xfer *)malloc(Num * sizeof(Xfer));
+   for (i = 0; i < Num; i++)
+       {k = static_cast<int>(drand48() * 3);
+        tNow += -log(1.0 - drand48()) / lambda;
+        xTab[i].Arrive = tNow;
+        xTab[i].Size   = static_cast<long long>(Mix[k].minSz
+                       + drand48() * (Mix[k].maxSz - Mix[k].minSz));
+        xTab[i].Left   = static_cast<double>(xTab[i].Size);
+        xTab[i].Vo     = getVo(Mix[k].Name);
+        xTab[i].Way    = 0;
+        xTab[i].Handle = 0;
+       }
+   xNum = Num;
+}
+
+/******************************************************************************/
+/*                              F a i r S h a r e                             */
+/******************************************************************************/
+
+// Compute the weighted max-min fair share of the link (i.e. water filling)
+// in one direction given each VO's demand.
+//
+void FairShare(int Way, double Capacity)
+{
+   bool   isSet[64];
+   double Left = Capacity, wSum, Level = 0.0;
+   int    i, numSet = 0, done;
+
+   for (i = 0; i < voNum; i++)
+       {isSet[i] = (voTab[i].Demand[Way] <= 0.0);
+        voTab[i].Fair[Way] = 0.0;
+        if (isSet[i]) numSet++;
+       }
+
+   do {done = 1; wSum = 0.0;
+       for (i = 0; i < voNum; i++) if (!isSet[i]) wSum += voTab[i].Weight;
+       if (wSum <= 0.0) break;
+       Level = Left / wSum;
+       for (i = 0; i < voNum; i++)
+           {if (isSet[i] || voTab[i].Demand[Way] > Level*voTab[i].Weight)
+               continue;
+            voTab[i].Fair[Way] = voTab[i].Demand[Way];
+            Left -= voTab[i].Demand[Way];
+            isSet[i] = true; numSet++; done = 0;
+           }
+      } while(!done && numSet < voNum);
+
+   for (i = 0; i < voNum; i++)
+       if (!isSet[i]) voTab[i].Fair[Way] = Level * voTab[i].Weight;
+}
+
+/******************************************************************************/
+/*                                  U s a g e                                 */
+/******************************************************************************/
+
+void Usage(int rc)
+{
+   fprintf(stderr, "\nUsage: xrdbwmsim [-c <capacity>] [-m <maxrate>] "
+                   "{-f <trace> | -g <num> [-r <seed>]}\n"
+                   "                 {-p '<policy2 parms>' | -s <inslots> "
+                   "<outslots>}\n");
+   exit(rc);
+}
+
+/******************************************************************************/
+/*                                  m a i n                                   */
+/******************************************************************************/
+
+int main(int argc, char *argv[])
+{
+   extern char *optarg;
+   extern int optind;
+   XrdBwmPolicy::SchedParms Parms;
+   XrdBwmPolicy  *Policy;
+   XrdBwmPolicy2 *Pol2 = 0;
+   Xfer  **Active[2], **Queued;
+   const char *tFile = 0, *pParms = 0;
+   char rBuff[1024], lfn[] = "/sim", node[] = "sim", *tP;
+   long long capVal = 1024LL*1024LL*1024LL, maxVal = 0, When;
+   double Capacity, maxRate, tNow = 0.0, tNext, tEnd = 0.0, dt, share, busy[2];
+   double totBytes = 0.0, sumX = 0.0, sumX2 = 0.0, x, tWin, share2;
+   int numAct[2], numQ = 0, nextArr = 0, numDone = 0, numGen = 0, seed = 1;
+   int inSlots = -1, outSlots = 0, numX = 0, i, j, w, h, c;
+
+// Process the options
+//
+   while((c = getopt(argc, argv, "c:f:g:m:p:r:s:")) != -1)
+        {switch(c)
+               {case 'c': if (XrdOuca2x::a2sz(Say,"capacity",optarg,&capVal,1))
+                             Usage(1);
+                          break;
+                case 'f': tFile = optarg; break;
+                case 'g': numGen = atoi(optarg); break;
+                case 'm': if (XrdOuca2x::a2sz(Say,"max rate",optarg,&maxVal,0))
+                             Usage(1);
+                          break;
+                case 'p': pParms = optarg; break;
+                case 'r': seed = atoi(optarg); break;
+                case 's': inSlots = atoi(optarg);
+                          if (optind >= argc) Usage(1);
+                          outSlots = atoi(argv[optind++]);
+                          break;
+                default:  Usage(1);
+               }
+        }
+   if ((!tFile && numGen <= 0) || (!pParms && inSlots < 0)) Usage(1);
+   Capacity = static_cast<double>(capVal);
+   maxRate  = static_cast<double>(maxVal);
+
+// Get the transfers
+//
+   if (tFile) {if (!Load(tFile)) exit(1);}
+      else Synthesize(numGen, Capacity, seed);
+
+// Obtain the policy. The policy only distinguishes the VOs it was configured
+// with, so each VO in the trace is named after the supplied parameters
+// (naming a VO again leaves its settings alone).
+//
+   if (pParms)
+      {std::string allParms(pParms);
+       for (i = 0; i < voNum; i++)
+           {allParms += " vo "; allParms += voTab[i].Name;}
+       XrdBwmPolicy2::Clock = simClock;
+       Policy = Pol2 = new XrdBwmPolicy2(&Say);
+       if (Pol2->Config(allParms.c_str())) exit(1);
+      } else Policy = new XrdBwmPolicy1(inSlots, outSlots);
+
+// Pick up the VO weights from the policy parameters for the fairness index
+//
+   if (pParms)
+      {char *pBuff = strdup(pParms), *vP = 0;
+       for (tP = strtok(pBuff, " "); tP; tP = strtok(0, " "))
+           {if (!strcmp(tP, "vo")) vP = strtok(0, " ");
+               else if (!strcmp(tP, "weight") && vP && (tP = strtok(0, " ")))
+                       voTab[getVo(vP)].Weight = atof(tP);
+           }
+       free(pBuff);
+      }
+
+// Allocate the tracking tables
+//
+   Active[0] = (Xfer **)malloc(xNum * sizeof(Xfer *));
+   Active[1] = (Xfer **)malloc(xNum * sizeof(Xfer *));
+   Queued    = (Xfer **)malloc(xNum * sizeof(Xfer *));
+   for (i = 0; i < voNum; i++)
+       voTab[i].Waits = (double *)malloc(xNum * sizeof(double));
+   numAct[0] = numAct[1] = 0; busy[0] = busy[1] = 0.0;
+   tWin = xTab[xNum-1].Arrive;
+   for (i = 0; i < xNum; i++) voTab[xTab[i].Vo].Demand[xTab[i].Way] += xTab[i].Size;
+   Parms.Tident = "sim"; Parms.Lfn = lfn;
+   Parms.LclNode = Parms.RmtNode = node;
+
+// Run the simulation until all transfers have completed
+//
+   while(numDone < xNum)
+        {simTime = static_cast<long long>(tNow * 1000000.0);
+
+     // Schedule the arrivals
+     //
+         while(nextArr < xNum && xTab[nextArr].Arrive <= tNow)
+              {Xfer *xP = &xTab[nextArr++];
+               Parms.Direction = (xP->Way ? XrdBwmPolicy::Outgoing
+                                          : XrdBwmPolicy::Incomming);
+               Parms.Vorg = voTab[xP->Vo].Name;
+               Parms.Size = xP->Size;
+               if ((h = Policy->Schedule(rBuff, sizeof(rBuff), Parms)) > 0)
+                  {xP->Handle = h; xP->Start = tNow;
+                   Active[xP->Way][numAct[xP->Way]++] = xP;
+                  } else if (h < 0) {xP->Handle = -h; Queued[numQ++] = xP;}
+                            else {Say.Emsg("Sim", "Request rejected;", rBuff);
+                                  exit(4);
+                                 }
+              }
+
+     // Dispatch whatever the policy allows now
+     //
+         When = -1;
+         while(numQ)
+              {if (Pol2) {if (!(h = Pol2->Poll(rBuff, sizeof(rBuff), When)))
+                             break;
+                         }
+                  else {int qIn, qOut, qXeq;
+                        Policy->Status(qIn, qOut, qXeq);
+                        if (!(qIn  && numAct[0] < inSlots)
+                        &&  !(qOut && numAct[1] < outSlots)) break;
+                        h = Policy->Dispatch(rBuff, sizeof(rBuff));
+                       }
+               for (i = 0; i < numQ && Queued[i]->Handle != h; i++) {}
+               if (i >= numQ) {Say.Emsg("Sim", "Lost handle!"); exit(8);}
+               Xfer *xP = Queued[i]; Queued[i] = Queued[--numQ];
+               xP->Start = tNow;
+               Active[xP->Way][numAct[xP->Way]++] = xP;
+              }
+
+     // Determine the next event: an arrival, a completion, or a policy wakeup
+     //
+         tNext = (nextArr < xNum ? xTab[nextArr].Arrive : HUGE_VAL);
+         if (When >= 0 && When/1000000.0 < tNext) tNext = When/1000000.0;
+         for (w = 0; w < 2; w++)
+             {if (!numAct[w]) continue;
+              share = Capacity / numAct[w];
+              if (maxRate > 0.0 && share > maxRate) share = maxRate;
+              for (i = 0; i < numAct[w]; i++)
+                  if (tNow + Active[w][i]->Left / share < tNext)
+                     tNext = tNow + Active[w][i]->Left / share;
+             }
+         if (tNext == HUGE_VAL)
+            {Say.Emsg("Sim", "Simulation stalled with requests queued.");
+             exit(8);
+            }
+         if (tNext <= tNow) tNext = tNow + 1.0e-6;
+         dt = tNext - tNow;
+
+     // Advance the transfers and retire the completed ones
+     //
+         for (w = 0; w < 2; w++)
+             {if (!numAct[w]) continue;
+              share = Capacity / numAct[w];
+              if (maxRate > 0.0 && share > maxRate) share = maxRate;
+              busy[w] += dt * (share * numAct[w]) / Capacity;
+              share2 = (tNow < tWin ? share * ((tNext < tWin ? tNext : tWin) - tNow)
+                                    : 0.0);
+              for (i = 0; i < numAct[w]; )
+                  {Xfer *xP = Active[w][i];
+                   xP->Left -= share * dt;
+                   voTab[xP->Vo].Served[w] += share2;
+                   if (xP->Left > 1.0e-3) {i++; continue;}
+                   VoStat *vP = &voTab[xP->Vo];
+                   vP->Bytes   += xP->Size;
+                   vP->WaitSum += xP->Start - xP->Arrive;
+                   vP->Waits[vP->numXfr++] = xP->Start - xP->Arrive;
+                   totBytes += xP->Size;
+                   if (Policy->Done(xP->Handle) <= 0)
+                      {Say.Emsg("Sim", "Done() failed for an active request!");
+                       exit(8);
+                      }
+                   Active[w][i] = Active[w][--numAct[w]];
+                   numDone++;
+                  }
+             }
+         tNow = tEnd = tNext;
+        }
+
+// Report the results by VO
+//
+   FairShare(0, Capacity * tWin);
+   FairShare(1, Capacity * tWin);
+   printf("%-12s %8s %12s %10s %10s %7s %7s\n", "VO", "Xfers", "GBytes",
+          "AvgWait", "P95Wait", "Fair%", "Weight");
+   for (i = 0; i < voNum; i++)
+       {VoStat *vP = &voTab[i];
+        double p95 = 0.0, fair = 0.0;
+        if (vP->numXfr)
+           {for (j = 1; j < vP->numXfr; j++)     // Insertion sort is enough
+                {double v = vP->Waits[j]; int k = j - 1;
+                 while(k >= 0 && vP->Waits[k] > v)
+                      {vP->Waits[k+1] = vP->Waits[k]; k--;}
+                 vP->Waits[k+1] = v;
+                }
+            p95 = vP->Waits[static_cast<int>(ceil(vP->numXfr*0.95)) - 1];
+           }
+        for (w = 0; w < 2; w++)
+            {if (vP->Fair[w] <= 0.0) continue;
+             x = vP->Served[w] / vP->Fair[w];
+             sumX += x; sumX2 += x*x; numX++;
+             fair += x * 100.0 / ((vP->Fair[0] > 0.0) + (vP->Fair[1] > 0.0));
+            }
+        printf("%-12s %8d %12.1f %10.1f %10.1f %7.1f %7.1f\n", vP->Name,
+               vP->numXfr, vP->Bytes/1.0e9,
+               (vP->numXfr ? vP->WaitSum/vP->numXfr : 0.0), p95,
+               fair, vP->Weight);
+       }
+
+// Report the overall results
+//
+   printf("Makespan: %.1f secs; Bytes: %.1f GB\n", tEnd, totBytes/1.0e9);
+   printf("Utilization: %.1f%% (in) %.1f%% (out)\n",
+          (tEnd > 0.0 ? 100.0*busy[0]/tEnd : 0.0),
+          (tEnd > 0.0 ? 100.0*busy[1]/tEnd : 0.0));
+   printf("Fairness: %.3f\n", (sumX2 > 0.0 ? (sumX*sumX)/(numX*sumX2) : 1.0));
+   return 0;
+}
@@ -45,7 +45,7 @@ namespace XrdCl
     pConnectionTimeout( 0 ),
     pHeaderDone( false ),
     pOutMsgDone( false ),
-    pOutHandler( 0 ),
+    pOutBatchCur( 0 ),
     pIncMsgSize( 0 ),
     pOutMsgSize( 0 ),
     pSocketDomain( AF_INET6 )
@@ -56,6 +56,15 @@ namespace XrdCl
     env->GetInt( "TimeoutResolution", timeoutResolution );
     pTimeoutResolution = timeoutResolution;
 
+    int batchCount = DefaultWriteBatchCount;
+    int batchSize  = DefaultWriteBatchSize;
+    env->GetInt( "WriteBatchCount", batchCount );
+    env->GetInt( "WriteBatchSize",  batchSize );
+    if( batchCount < 1 )    batchCount = 1;
+    if( batchCount > 1024 ) batchCount = 1024;
+    pOutBatchCount = batchCount;
+    pOutBatchSize  = batchSize;
+
     pSocket = new Socket();
     pIncHandler = std::make_pair( (IncomingMsgHandler*)0, false );
   }
@@ -304,29 +313,47 @@ namespace XrdCl
   void AsyncSocketHandler::OnWrite()
   {
     //--------------------------------------------------------------------------
-    // Pick up a message if we're not in process of writing something
+    // Pick up messages if we're not in process of writing something. We take
+    // whatever is queued, within the limits, so that it all goes out with
+    // one system call. A message with a raw body ends the batch because the
+    // body is written by its handler.
     //--------------------------------------------------------------------------
-    if( !pOutgoing )
+    if( pOutBatch.empty() )
     {
-      pOutMsgDone = false;
-      std::pair<Message *, OutgoingMsgHandler *> toBeSent;
-      toBeSent = pStream->OnReadyToWrite( pSubStreamNum );
-      pOutgoing = toBeSent.first; pOutHandler = toBeSent.second;
+      pOutMsgDone  = false;
+      pOutMsgSize  = 0;
+      pOutBatchCur = 0;
+      uint32_t batchSize = 0;
 
-      if( !pOutgoing )
-        return;
+      while( pOutBatch.size() < pOutBatchCount && batchSize < pOutBatchSize )
+      {
+        std::pair<Message *, OutgoingMsgHandler *> toBeSent;
+        toBeSent = pStream->OnReadyToWrite( pSubStreamNum, !pOutBatch.empty() );
+        if( !toBeSent.first )
+          break;
+
+        toBeSent.first->SetCursor( 0 );
+        batchSize += toBeSent.first->GetSize();
+        pOutBatch.push_back( toBeSent );
+
+        if( toBeSent.second && toBeSent.second->IsRaw() )
+          break;
+      }
 
-      pOutgoing->SetCursor( 0 );
-      pOutMsgSize = pOutgoing->GetSize();
+      if( pOutBatch.empty() )
+        return;
     }
 
     //--------------------------------------------------------------------------
-    // Write the message if not already written
+    // Write the messages if not already written
     //--------------------------------------------------------------------------
     Status st;
+    Message            *last        = pOutBatch.back().first;
+    OutgoingMsgHandler *lastHandler = pOutBatch.back().second;
+    bool                lastRaw     = lastHandler && lastHandler->IsRaw();
     if( !pOutMsgDone )
     {
-      if( !(st = WriteCurrentMessage()).IsOK() )
+      if( !(st = WriteCurrentBatch()).IsOK() )
       {
         OnFault( st );
         return;
@@ -337,12 +364,12 @@ namespace XrdCl
 
       Log *log = DefaultEnv::GetLog();
 
-      if( pOutHandler && pOutHandler->IsRaw() )
+      if( lastRaw )
       {
         log->Dump( AsyncSockMsg,
                    "[%s] Will call raw handler to write payload for message: "
                    "%s.", pStreamName.c_str(),
-                   pOutgoing->GetDescription().c_str() );
+                   last->GetDescription().c_str() );
       }
 
       pOutMsgDone = true;
@@ -351,10 +378,10 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Check if the handler needs to be called
     //--------------------------------------------------------------------------
-    if( pOutHandler && pOutHandler->IsRaw() )
+    if( lastRaw )
     {
       uint32_t bytesWritten = 0;
-      st = pOutHandler->WriteMessageBody( pSocket->GetFD(), bytesWritten );
+      st = lastHandler->WriteMessageBody( pSocket->GetFD(), bytesWritten );
       pOutMsgSize += bytesWritten;
       if( !st.IsOK() )
       {
@@ -364,15 +391,17 @@ namespace XrdCl
 
       if( st.code == suRetry )
         return;
-    }
 
-    Log *log = DefaultEnv::GetLog();
-    log->Dump( AsyncSockMsg,
-               "[%s] successfully sent message: %s.", pStreamName.c_str(),
-               pOutgoing->GetDescription().c_str() );
+      Log *log = DefaultEnv::GetLog();
+      log->Dump( AsyncSockMsg,
+                 "[%s] successfully sent message: %s.", pStreamName.c_str(),
+                 last->GetDescription().c_str() );
 
-    pStream->OnMessageSent( pSubStreamNum, pOutgoing, pOutMsgSize );
-    pOutgoing = 0;
+      pStream->OnMessageSent( pSubStreamNum, last,
+                              last->GetSize() + pOutMsgSize );
+    }
+
+    pOutBatch.clear();
   }
 
   //----------------------------------------------------------------------------
@@ -448,6 +477,76 @@ namespace XrdCl
     return Status();
   }
 
+  //----------------------------------------------------------------------------
+  // Write the current batch of messages
+  //----------------------------------------------------------------------------
+  Status AsyncSocketHandler::WriteCurrentBatch()
+  {
+    Log   *log = DefaultEnv::GetLog();
+    iovec  iov[1024];
+
+    while( pOutBatchCur < pOutBatch.size() )
+    {
+      //------------------------------------------------------------------------
+      // Try to write down what is left of the batch
+      //------------------------------------------------------------------------
+      int iovcnt = 0;
+      for( size_t i = pOutBatchCur; i < pOutBatch.size(); ++i, ++iovcnt )
+      {
+        Message *msg = pOutBatch[i].first;
+        iov[iovcnt].iov_base = msg->GetBufferAtCursor();
+        iov[iovcnt].iov_len  = msg->GetSize()-msg->GetCursor();
+      }
+
+      ssize_t status = pSocket->Send( iov, iovcnt );
+      if( status <= 0 )
+      {
+        //----------------------------------------------------------------------
+        // Writing operation would block! So we are done for now, but we will
+        // return
+        //----------------------------------------------------------------------
+        if( errno == EAGAIN || errno == EWOULDBLOCK )
+          return Status( stOK, suRetry );
+
+        //----------------------------------------------------------------------
+        // Actual socket error error!
+        //----------------------------------------------------------------------
+        return Status( stError, errSocketError, errno );
+      }
+
+      //------------------------------------------------------------------------
+      // Advance the cursors and report the messages that are done with
+      //------------------------------------------------------------------------
+      uint32_t written = status;
+      for( ; pOutBatchCur < pOutBatch.size(); ++pOutBatchCur )
+      {
+        Message            *msg     = pOutBatch[pOutBatchCur].first;
+        OutgoingMsgHandler *handler = pOutBatch[pOutBatchCur].second;
+        uint32_t            left    = msg->GetSize()-msg->GetCursor();
+        if( written < left )
+        {
+          msg->AdvanceCursor( written );
+          break;
+        }
+        msg->AdvanceCursor( left );
+        written -= left;
+
+        log->Dump( AsyncSockMsg, "[%s] Wrote a message: %s, %d bytes",
+                   pStreamName.c_str(), msg->GetDescription().c_str(),
+                   msg->GetSize() );
+
+        if( handler && handler->IsRaw() )
+          continue;
+
+        log->Dump( AsyncSockMsg,
+                   "[%s] successfully sent message: %s.", pStreamName.c_str(),
+                   msg->GetDescription().c_str() );
+        pStream->OnMessageSent( pSubStreamNum, msg, msg->GetSize() );
+      }
+    }
+    return Status();
+  }
+
   //----------------------------------------------------------------------------
   // Got a read readiness event
   //----------------------------------------------------------------------------
@@ -667,7 +766,7 @@ namespace XrdCl
 
     pIncoming   = 0;
     pOutgoing   = 0;
-    pOutHandler = 0;
+    pOutBatch.clear();
 
     pStream->OnError( pSubStreamNum, st );
   }
@@ -27,6 +27,7 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <vector>
 
 namespace XrdCl
 {
@@ -146,6 +147,13 @@ namespace XrdCl
       //------------------------------------------------------------------------
       Status WriteCurrentMessage();
 
+      //------------------------------------------------------------------------
+      // Write the current batch of messages, the ones that have been written
+      // completely are reported to the stream, except for the one that has
+      // a raw body to be written
+      //------------------------------------------------------------------------
+      Status WriteCurrentBatch();
+
       //------------------------------------------------------------------------
       // Got a read readiness event
       //------------------------------------------------------------------------
@@ -207,7 +215,10 @@ namespace XrdCl
       bool                           pHeaderDone;
       std::pair<IncomingMsgHandler*, bool> pIncHandler;
       bool                           pOutMsgDone;
-      OutgoingMsgHandler            *pOutHandler;
+      std::vector<std::pair<Message*, OutgoingMsgHandler*> > pOutBatch;
+      size_t                         pOutBatchCur;
+      size_t                         pOutBatchCount;
+      uint32_t                       pOutBatchSize;
       uint32_t                       pIncMsgSize;
       uint32_t                       pOutMsgSize;
       int                            pSocketDomain;
@@ -19,6 +19,8 @@
 #ifndef __XRD_CL_BUFFER_HH__
 #define __XRD_CL_BUFFER_HH__
 
+#include "XrdCl/XrdClBufferPool.hh"
+
 #include <cstdlib>
 #include <stdint.h>
 #include <new>
@@ -28,7 +30,8 @@
 namespace XrdCl
 {
   //----------------------------------------------------------------------------
-  //! Binary blob representation
+  //! Binary blob representation, both the objects and their memory come from
+  //! the BufferPool
   //----------------------------------------------------------------------------
   class Buffer
   {
@@ -36,7 +39,8 @@ namespace XrdCl
       //------------------------------------------------------------------------
       //! Constructor
       //------------------------------------------------------------------------
-      Buffer( uint32_t size = 0 ): pBuffer(0), pSize(0), pCursor(0)
+      Buffer( uint32_t size = 0 ):
+        pBuffer(0), pSize(0), pCapacity(0), pCursor(0)
       {
         if( size )
         {
@@ -49,6 +53,26 @@ namespace XrdCl
       //------------------------------------------------------------------------
       virtual ~Buffer() { Free(); }
 
+      //------------------------------------------------------------------------
+      //! Allocate the object from the pool
+      //------------------------------------------------------------------------
+      static void *operator new( size_t size )
+      {
+        uint32_t  capacity;
+        void     *ptr = BufferPool::Allocate( size, capacity );
+        if( !ptr )
+          throw std::bad_alloc();
+        return ptr;
+      }
+
+      //------------------------------------------------------------------------
+      //! Return the object to the pool
+      //------------------------------------------------------------------------
+      static void operator delete( void *ptr, size_t size )
+      {
+        BufferPool::Free( (char *)ptr, size );
+      }
+
       //------------------------------------------------------------------------
       //! Get the message buffer
       //------------------------------------------------------------------------
@@ -66,14 +90,29 @@ namespace XrdCl
       }
 
       //------------------------------------------------------------------------
-      //! Reallocate the buffer to a new location of a given size
+      //! Resize the buffer, it moves to a new location only if it outgrows
+      //! its capacity
       //------------------------------------------------------------------------
       void ReAllocate( uint32_t size )
       {
-        pBuffer = (char *)realloc( pBuffer, size );
-        if( !pBuffer )
+        if( size <= pCapacity )
+        {
+          pSize = size;
+          return;
+        }
+
+        uint32_t  capacity;
+        char     *buffer = BufferPool::Allocate( size, capacity );
+        if( !buffer )
           throw std::bad_alloc();
-        pSize = size;
+        if( pBuffer )
+        {
+          memcpy( buffer, pBuffer, pSize < size ? pSize : size );
+          BufferPool::Free( pBuffer, pCapacity );
+        }
+        pBuffer   = buffer;
+        pSize     = size;
+        pCapacity = capacity;
       }
 
       //------------------------------------------------------------------------
@@ -81,10 +120,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void Free()
       {
-        free( pBuffer );
-        pBuffer = 0;
-        pSize   = 0;
-        pCursor = 0;
+        BufferPool::Free( pBuffer, pCapacity );
+        pBuffer   = 0;
+        pSize     = 0;
+        pCapacity = 0;
+        pCursor   = 0;
       }
 
       //------------------------------------------------------------------------
@@ -95,7 +135,7 @@ namespace XrdCl
         if( !size )
          return;
 
-        pBuffer = (char *)malloc( size );
+        pBuffer = BufferPool::Allocate( size, pCapacity );
         if( !pBuffer )
           throw std::bad_alloc();
         pSize = size;
@@ -206,7 +246,7 @@ namespace XrdCl
       }
 
       //------------------------------------------------------------------------
-      //! Grab a buffer allocated outside
+      //! Grab a buffer allocated outside with malloc
       //------------------------------------------------------------------------
       void Grab( char *buffer, uint32_t size )
       {
@@ -216,20 +256,22 @@ namespace XrdCl
       }
 
       //------------------------------------------------------------------------
-      //! Release the buffer
+      //! Release the buffer, it needs to be freed with free
       //------------------------------------------------------------------------
       char *Release()
       {
         char *buffer = pBuffer;
-        pBuffer = 0;
-        pSize   = 0;
-        pCursor = 0;
+        pBuffer   = 0;
+        pSize     = 0;
+        pCapacity = 0;
+        pCursor   = 0;
         return buffer;
       }
 
     private:
       char     *pBuffer;
       uint32_t  pSize;
+      uint32_t  pCapacity;
       uint32_t  pCursor;
   };
 }
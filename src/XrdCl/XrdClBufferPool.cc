@@ -0,0 +1,310 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+// Author: Lukasz Janyst <ljanyst@cern.ch>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClBufferPool.hh"
+
+#include <pthread.h>
+#include <cstdlib>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Size classes: 64 bytes to 64 KB
+  //----------------------------------------------------------------------------
+  const uint32_t MinShift   = 6;
+  const uint32_t MaxShift   = 16;
+  const uint32_t NumClasses = MaxShift-MinShift+1;
+
+  //----------------------------------------------------------------------------
+  // Free blocks are linked through their first bytes
+  //----------------------------------------------------------------------------
+  struct Block
+  {
+    Block *next;
+  };
+
+  //----------------------------------------------------------------------------
+  // Per-thread cache, the counters are only written by the owner
+  //----------------------------------------------------------------------------
+  struct ThreadCache
+  {
+    Block       *head[NumClasses];
+    uint32_t     count[NumClasses];
+    XrdCl::BufferPool::Stats stats;
+    ThreadCache *prev;
+    ThreadCache *next;
+  };
+
+  //----------------------------------------------------------------------------
+  // Shared pool, everything here is protected by sMutex
+  //----------------------------------------------------------------------------
+  struct SharedClass
+  {
+    Block    *head;
+    uint32_t  count;
+  };
+
+  pthread_mutex_t          sMutex = PTHREAD_MUTEX_INITIALIZER;
+  pthread_once_t           sOnce  = PTHREAD_ONCE_INIT;
+  pthread_key_t            sKey;
+  bool                     sKeyOk = false;
+  SharedClass              sShared[NumClasses];
+  ThreadCache             *sCaches = 0;
+  XrdCl::BufferPool::Stats sRetired;
+
+  //----------------------------------------------------------------------------
+  // Blocks kept by a thread: up to 32 KB worth, between 2 and 64 of them
+  //----------------------------------------------------------------------------
+  inline uint32_t ThreadDepth( uint32_t cls )
+  {
+    uint32_t depth = (32*1024) >> (cls+MinShift);
+    if( depth > 64 ) return 64;
+    if( depth < 2 )  return 2;
+    return depth;
+  }
+
+  //----------------------------------------------------------------------------
+  // Blocks kept in the shared pool: up to 4 MB worth, at least 64
+  //----------------------------------------------------------------------------
+  inline uint32_t SharedDepth( uint32_t cls )
+  {
+    uint32_t depth = (4*1024*1024) >> (cls+MinShift);
+    return depth < 64 ? 64 : depth;
+  }
+
+  //----------------------------------------------------------------------------
+  // Find the size class, -1 if the size is not pooled
+  //----------------------------------------------------------------------------
+  inline int SizeClass( uint32_t size )
+  {
+    if( !size || size > (1U << MaxShift) )
+      return -1;
+    uint32_t cls = 0;
+    while( (1U << (cls+MinShift)) < size )
+      ++cls;
+    return cls;
+  }
+
+  //----------------------------------------------------------------------------
+  // Move blocks from a thread cache to the shared pool, the ones that
+  // do not fit are freed
+  //----------------------------------------------------------------------------
+  void Flush( ThreadCache *tc, uint32_t cls, uint32_t n )
+  {
+    Block *first = tc->head[cls];
+    Block *last  = first;
+    for( uint32_t i = 1; i < n; ++i )
+      last = last->next;
+    tc->head[cls]   = last->next;
+    tc->count[cls] -= n;
+    last->next      = 0;
+
+    pthread_mutex_lock( &sMutex );
+    SharedClass &sc = sShared[cls];
+    if( sc.count + n <= SharedDepth( cls ) )
+    {
+      last->next = sc.head;
+      sc.head    = first;
+      sc.count  += n;
+      first      = 0;
+    }
+    pthread_mutex_unlock( &sMutex );
+
+    while( first )
+    {
+      Block *b = first;
+      first = first->next;
+      free( b );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Move a batch of blocks from the shared pool to a thread cache
+  //----------------------------------------------------------------------------
+  bool Refill( ThreadCache *tc, uint32_t cls )
+  {
+    uint32_t n = ThreadDepth( cls )/2;
+    pthread_mutex_lock( &sMutex );
+    SharedClass &sc = sShared[cls];
+    if( !sc.count )
+    {
+      pthread_mutex_unlock( &sMutex );
+      return false;
+    }
+    if( n > sc.count )
+      n = sc.count;
+    Block *first = sc.head;
+    Block *last  = first;
+    for( uint32_t i = 1; i < n; ++i )
+      last = last->next;
+    sc.head   = last->next;
+    sc.count -= n;
+    pthread_mutex_unlock( &sMutex );
+
+    last->next      = tc->head[cls];
+    tc->head[cls]   = first;
+    tc->count[cls] += n;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Hand the blocks of an exiting thread over to the shared pool
+  //----------------------------------------------------------------------------
+  void ReleaseCache( void *arg )
+  {
+    ThreadCache *tc = (ThreadCache*)arg;
+    for( uint32_t cls = 0; cls < NumClasses; ++cls )
+      if( tc->count[cls] )
+        Flush( tc, cls, tc->count[cls] );
+
+    pthread_mutex_lock( &sMutex );
+    sRetired.allocations += tc->stats.allocations;
+    sRetired.threadHits  += tc->stats.threadHits;
+    sRetired.poolHits    += tc->stats.poolHits;
+    sRetired.mallocs     += tc->stats.mallocs;
+    sRetired.frees       += tc->stats.frees;
+    if( tc->prev ) tc->prev->next = tc->next;
+    else           sCaches        = tc->next;
+    if( tc->next ) tc->next->prev = tc->prev;
+    pthread_mutex_unlock( &sMutex );
+    free( tc );
+  }
+
+  //----------------------------------------------------------------------------
+  // Make sure a forked child does not inherit a locked pool
+  //----------------------------------------------------------------------------
+  void LockPool()   { pthread_mutex_lock( &sMutex ); }
+  void UnlockPool() { pthread_mutex_unlock( &sMutex ); }
+
+  void InitPool()
+  {
+    sKeyOk = pthread_key_create( &sKey, ReleaseCache ) == 0;
+    pthread_atfork( LockPool, UnlockPool, UnlockPool );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the cache of the calling thread, 0 if it cannot have one
+  //----------------------------------------------------------------------------
+  ThreadCache *GetCache()
+  {
+    pthread_once( &sOnce, InitPool );
+    if( !sKeyOk )
+      return 0;
+
+    ThreadCache *tc = (ThreadCache*)pthread_getspecific( sKey );
+    if( tc )
+      return tc;
+
+    tc = (ThreadCache*)calloc( 1, sizeof( ThreadCache ) );
+    if( !tc )
+      return 0;
+    if( pthread_setspecific( sKey, tc ) )
+    {
+      free( tc );
+      return 0;
+    }
+
+    pthread_mutex_lock( &sMutex );
+    tc->next = sCaches;
+    if( sCaches ) sCaches->prev = tc;
+    sCaches = tc;
+    pthread_mutex_unlock( &sMutex );
+    return tc;
+  }
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Get a block of at least the given size
+  //----------------------------------------------------------------------------
+  char *BufferPool::Allocate( uint32_t size, uint32_t &capacity )
+  {
+    int          cls = SizeClass( size );
+    ThreadCache *tc  = GetCache();
+    capacity = cls < 0 ? size : 1U << (cls+MinShift);
+
+    if( tc )
+    {
+      ++tc->stats.allocations;
+      if( cls >= 0 )
+      {
+        if( tc->head[cls] )
+          ++tc->stats.threadHits;
+        else if( Refill( tc, cls ) )
+          ++tc->stats.poolHits;
+
+        Block *b = tc->head[cls];
+        if( b )
+        {
+          tc->head[cls] = b->next;
+          --tc->count[cls];
+          return (char*)b;
+        }
+      }
+      ++tc->stats.mallocs;
+    }
+
+    char *block = (char*)malloc( capacity );
+    if( !block )
+      capacity = 0;
+    return block;
+  }
+
+  //----------------------------------------------------------------------------
+  // Give a block back
+  //----------------------------------------------------------------------------
+  void BufferPool::Free( char *block, uint32_t capacity )
+  {
+    if( !block )
+      return;
+
+    int          cls = SizeClass( capacity );
+    ThreadCache *tc  = cls < 0 ? 0 : GetCache();
+    if( !tc )
+    {
+      free( block );
+      return;
+    }
+
+    ++tc->stats.frees;
+    Block *b = (Block*)block;
+    b->next  = tc->head[cls];
+    tc->head[cls] = b;
+    if( ++tc->count[cls] > ThreadDepth( cls ) )
+      Flush( tc, cls, tc->count[cls]/2 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the counters accumulated by all the threads
+  //----------------------------------------------------------------------------
+  void BufferPool::GetStats( Stats &stats )
+  {
+    pthread_mutex_lock( &sMutex );
+    stats = sRetired;
+    for( ThreadCache *tc = sCaches; tc; tc = tc->next )
+    {
+      stats.allocations += tc->stats.allocations;
+      stats.threadHits  += tc->stats.threadHits;
+      stats.poolHits    += tc->stats.poolHits;
+      stats.mallocs     += tc->stats.mallocs;
+      stats.frees       += tc->stats.frees;
+    }
+    pthread_mutex_unlock( &sMutex );
+  }
+}
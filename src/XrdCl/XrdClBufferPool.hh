@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+// Author: Lukasz Janyst <ljanyst@cern.ch>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_BUFFER_POOL_HH__
+#define __XRD_CL_BUFFER_POOL_HH__
+
+#include <stdint.h>
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  //! Recycles the memory of buffers and messages
+  //!
+  //! Requests are rounded up to a power of two between 64 bytes and 64 KB
+  //! and the freed blocks are kept in a small per-thread cache. Blocks
+  //! moving from the thread that frees them (typically a handler) to the one
+  //! that allocates them (typically the poller) go through a shared pool in
+  //! batches. Larger requests are passed to malloc. All the blocks come from
+  //! malloc, so a block may always be disposed of with free.
+  //----------------------------------------------------------------------------
+  class BufferPool
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Allocation counters
+      //------------------------------------------------------------------------
+      struct Stats
+      {
+        Stats(): allocations(0), threadHits(0), poolHits(0), mallocs(0),
+          frees(0) {}
+        uint64_t allocations; //!< blocks requested
+        uint64_t threadHits;  //!< served from the thread cache
+        uint64_t poolHits;    //!< served from the shared pool
+        uint64_t mallocs;     //!< served by malloc
+        uint64_t frees;       //!< pooled blocks given back
+      };
+
+      //------------------------------------------------------------------------
+      //! Get a block of at least the given size
+      //!
+      //! @param size     requested size
+      //! @param capacity actual size of the block
+      //! @return         the block or 0 if out of memory
+      //------------------------------------------------------------------------
+      static char *Allocate( uint32_t size, uint32_t &capacity );
+
+      //------------------------------------------------------------------------
+      //! Give a block back
+      //!
+      //! @param block    the block, may be 0
+      //! @param capacity the capacity or the requested size of the block,
+      //!                 0 for memory that was not obtained from the pool
+      //------------------------------------------------------------------------
+      static void Free( char *block, uint32_t capacity );
+
+      //------------------------------------------------------------------------
+      //! Get the counters accumulated by all the threads
+      //------------------------------------------------------------------------
+      static void GetStats( Stats &stats );
+  };
+}
+
+#endif // __XRD_CL_BUFFER_POOL_HH__
@@ -310,6 +310,14 @@ namespace XrdCl
       (*it)->Tick( now );
   }
 
+  //----------------------------------------------------------------------------
+  // Start connecting to the server ahead of the first request
+  //----------------------------------------------------------------------------
+  Status Channel::Connect()
+  {
+    return pStreams[0]->Connect();
+  }
+
   //----------------------------------------------------------------------------
   // Query the transport handler
   //----------------------------------------------------------------------------
@@ -152,6 +152,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void Tick( time_t now );
 
+      //------------------------------------------------------------------------
+      //! Start connecting to the server ahead of the first request
+      //------------------------------------------------------------------------
+      Status Connect();
+
     private:
 
       URL                    pUrl;
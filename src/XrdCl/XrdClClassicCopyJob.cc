@@ -24,6 +24,8 @@
 #include "XrdCl/XrdClMonitor.hh"
 #include "XrdCl/XrdClUtils.hh"
 #include "XrdCl/XrdClCheckSumManager.hh"
+#include "XrdCl/XrdClFileSystem.hh"
+#include "XrdCl/XrdClXtremeReader.hh"
 #include "XrdCks/XrdCksCalc.hh"
 
 #include <memory>
@@ -660,6 +662,94 @@ namespace
       std::queue<ChunkHandler *>  pChunks;
   };
 
+  //----------------------------------------------------------------------------
+  //! XRootD source reading from several replicas at once
+  //----------------------------------------------------------------------------
+  class XRootDXtremeSource: public Source
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor
+      //------------------------------------------------------------------------
+      XRootDXtremeSource( const XrdCl::URL              *url,
+                          const std::vector<XrdCl::URL> &replicas,
+                          uint32_t                       chunkSize,
+                          uint8_t                        parallelChunks ):
+        pUrl( url ),
+        pReader( new XrdCl::XtremeReader( replicas, chunkSize,
+                                          parallelChunks ) )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      //! Destructor - the reads still in flight finish in the background
+      //------------------------------------------------------------------------
+      virtual ~XRootDXtremeSource()
+      {
+        pReader->Release();
+      }
+
+      //------------------------------------------------------------------------
+      //! Initialize the source
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus Initialize()
+      {
+        return pReader->Initialize();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get size
+      //------------------------------------------------------------------------
+      virtual int64_t GetSize()
+      {
+        return pReader->GetSize();
+      }
+
+      //------------------------------------------------------------------------
+      //! Get a data chunk from the source, the chunks come out of order
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus GetChunk( XrdCl::ChunkInfo &ci )
+      {
+        XrdCl::XRootDStatus st = pReader->GetChunk( ci );
+        if( !st.IsOK() || st.code == XrdCl::suDone )
+          LogStats();
+        return st;
+      }
+
+      //------------------------------------------------------------------------
+      // Get check sum
+      //------------------------------------------------------------------------
+      virtual XrdCl::XRootDStatus GetCheckSum( std::string &checkSum,
+                                               std::string &checkSumType )
+      {
+        return XrdCl::Utils::GetRemoteCheckSum( checkSum, checkSumType,
+                                                pReader->GetDataServer(),
+                                                pUrl->GetPath() );
+      }
+
+    private:
+      //------------------------------------------------------------------------
+      // Report how much each of the replicas has contributed
+      //------------------------------------------------------------------------
+      void LogStats()
+      {
+        using namespace XrdCl;
+        Log *log = DefaultEnv::GetLog();
+        std::vector<XtremeReader::SourceStats> stats;
+        pReader->GetStats( stats );
+        for( uint32_t i = 0; i < stats.size(); ++i )
+          log->Info( UtilityMsg, "Source %s: %ld bytes in %d blocks at %s/s, "
+                     "%d stolen, %d wasted%s", stats[i].url.c_str(),
+                     stats[i].bytes, stats[i].blocks,
+                     Utils::BytesToString( (uint64_t)stats[i].rate ).c_str(),
+                     stats[i].stolen, stats[i].wasted,
+                     stats[i].failed ? ", failed" : "" );
+      }
+
+      const XrdCl::URL    *pUrl;
+      XrdCl::XtremeReader *pReader;
+  };
+
   //----------------------------------------------------------------------------
   //! Local destination
   //----------------------------------------------------------------------------
@@ -981,6 +1071,16 @@ namespace XrdCl
       src.reset( new LocalSource( &pJob->source ) );
     else if( pJob->source.GetProtocol() == "stdio" )
       src.reset( new StdInSource( pJob->checkSumType ) );
+    //--------------------------------------------------------------------------
+    // Chunks of a multi-source download arrive out of order so they cannot
+    // be streamed to stdout
+    //--------------------------------------------------------------------------
+    else if( pJob->sourceLimit > 1 && pJob->target.GetProtocol() != "stdio" &&
+             FindSources().IsOK() && pJob->sources.size() > 1 )
+      src.reset( new XRootDXtremeSource( &pJob->source,
+                                         pJob->sources,
+                                         pJob->chunkSize,
+                                         pJob->parallelChunks ) );
     else
       src.reset( new XRootDSource( &pJob->source,
                                    pJob->chunkSize,
@@ -1132,4 +1232,43 @@ namespace XrdCl
 
     return XRootDStatus();
   }
+
+  //----------------------------------------------------------------------------
+  // Locate the replicas of the source file
+  //----------------------------------------------------------------------------
+  XRootDStatus ClassicCopyJob::FindSources()
+  {
+    Log *log = DefaultEnv::GetLog();
+    pJob->sources.clear();
+
+    FileSystem    fs( pJob->source );
+    LocationInfo *locations = 0;
+    XRootDStatus  st = fs.DeepLocate( pJob->source.GetPath(), OpenFlags::None,
+                                      locations );
+    if( !st.IsOK() )
+    {
+      log->Debug( UtilityMsg, "Unable to locate the replicas of %s: %s",
+                  pJob->source.GetURL().c_str(), st.ToStr().c_str() );
+      return st;
+    }
+
+    LocationInfo::Iterator it;
+    for( it = locations->Begin(); it != locations->End(); ++it )
+    {
+      if( pJob->sources.size() >= pJob->sourceLimit )
+        break;
+      if( it->GetType() != LocationInfo::ServerOnline )
+        continue;
+
+      URL replica( pJob->source.GetProtocol() + "://" + it->GetAddress() +
+                   "/" + pJob->source.GetPathWithParams() );
+      if( !replica.IsValid() )
+        continue;
+      pJob->sources.push_back( replica );
+      log->Debug( UtilityMsg, "Replica #%d: %s", pJob->sources.size(),
+                  replica.GetURL().c_str() );
+    }
+    delete locations;
+    return XRootDStatus();
+  }
 }
@@ -39,6 +39,12 @@ namespace XrdCl
       //------------------------------------------------------------------------
       virtual XRootDStatus Run( CopyProgressHandler *progress = 0 );
 
+    private:
+      //------------------------------------------------------------------------
+      //! Locate up to sourceLimit replicas of the source and put them in the
+      //! job descriptor
+      //------------------------------------------------------------------------
+      XRootDStatus FindSources();
   };
 }
 
@@ -52,6 +52,14 @@ namespace XrdCl
   const int DefaultWorkerThreads        = 3;
   const int DefaultCPChunkSize          = 16777216;
   const int DefaultCPParallelChunks     = 4;
+  const int DefaultBulkWindow           = 64;
+  const int DefaultWriteBatchCount      = 64;
+  const int DefaultWriteBatchSize       = 262144;
+  const int DefaultDataServerTTL        = 300;
+  const int DefaultLoadBalancerTTL      = 1200;
+  const int DefaultPreConnectLimit      = 4;
+  const int DefaultMetaCacheTTL         = 0;
+  const int DefaultMetaCacheSize        = 10000;
 
   const char * const DefaultPollerPreference   = "built-in,libevent";
   const char * const DefaultNetworkStack       = "IPAll";
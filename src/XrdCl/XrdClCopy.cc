@@ -132,12 +132,6 @@ bool AllOptionsSupported( XrdCpConfig *config )
     return false;
   }
 
-  if( config->nSrcs != 1 )
-  {
-    std::cerr << "Multiple sources are not yet supported" << std::endl;
-    return false;
-  }
-
   if( config->Want( XrdCpConfig::DoServer ) )
   {
     std::cerr << "Running in server mode is not yet supported" << std::endl;
@@ -528,6 +522,7 @@ int main( int argc, char **argv )
 
     job->source               = source;
     job->target               = target;
+    job->sourceLimit          = config.nSrcs;
     job->force                = force;
     job->posc                 = posc;
     job->coerce               = coerce;
@@ -26,6 +26,8 @@
 #include "XrdCl/XrdClMonitor.hh"
 #include "XrdCl/XrdClCheckSumManager.hh"
 #include "XrdCl/XrdClTransportManager.hh"
+#include "XrdCl/XrdClBufferPool.hh"
+#include "XrdCl/XrdClMetaCache.hh"
 #include "XrdSys/XrdSysPlugin.hh"
 #include "XrdSys/XrdSysUtils.hh"
 
@@ -136,6 +138,7 @@ namespace XrdCl
   bool               DefaultEnv::sMonitorInitialized = false;
   CheckSumManager   *DefaultEnv::sCheckSumManager    = 0;
   TransportManager  *DefaultEnv::sTransportManager   = 0;
+  MetaCache         *DefaultEnv::sMetaCache          = 0;
 
   //----------------------------------------------------------------------------
   // Constructor
@@ -153,6 +156,14 @@ namespace XrdCl
     PutInt( "WorkerThreads",         DefaultWorkerThreads        );
     PutInt( "CPChunkSize",           DefaultCPChunkSize          );
     PutInt( "CPParallelChunks",      DefaultCPParallelChunks     );
+    PutInt( "BulkWindow",            DefaultBulkWindow           );
+    PutInt( "WriteBatchCount",       DefaultWriteBatchCount      );
+    PutInt( "WriteBatchSize",        DefaultWriteBatchSize       );
+    PutInt( "DataServerTTL",         DefaultDataServerTTL        );
+    PutInt( "LoadBalancerTTL",       DefaultLoadBalancerTTL      );
+    PutInt( "PreConnectLimit",       DefaultPreConnectLimit      );
+    PutInt( "MetaCacheTTL",          DefaultMetaCacheTTL         );
+    PutInt( "MetaCacheSize",         DefaultMetaCacheSize        );
     PutString( "PollerPreference",   DefaultPollerPreference     );
     PutString( "ClientMonitor",      DefaultClientMonitor        );
     PutString( "ClientMonitorParam", DefaultClientMonitorParam   );
@@ -169,6 +180,14 @@ namespace XrdCl
     ImportInt(    "WorkerThreads",        "XRD_WORKERTHREADS"        );
     ImportInt(    "CPChunkSize",          "XRD_CPCHUNKSIZE"          );
     ImportInt(    "CPParallelChunks",     "XRD_CPPARALLELCHUNKS"     );
+    ImportInt(    "BulkWindow",           "XRD_BULKWINDOW"           );
+    ImportInt(    "WriteBatchCount",      "XRD_WRITEBATCHCOUNT"      );
+    ImportInt(    "WriteBatchSize",       "XRD_WRITEBATCHSIZE"       );
+    ImportInt(    "DataServerTTL",        "XRD_DATASERVERTTL"        );
+    ImportInt(    "LoadBalancerTTL",      "XRD_LOADBALANCERTTL"      );
+    ImportInt(    "PreConnectLimit",      "XRD_PRECONNECTLIMIT"      );
+    ImportInt(    "MetaCacheTTL",         "XRD_METACACHETTL"         );
+    ImportInt(    "MetaCacheSize",        "XRD_METACACHESIZE"        );
     ImportString( "PollerPreference",     "XRD_POLLERPREFERENCE"     );
     ImportString( "ClientMonitor",        "XRD_CLIENTMONITOR"        );
     ImportString( "ClientMonitorParam",   "XRD_CLIENTMONITORPARAM"   );
@@ -391,6 +410,20 @@ namespace XrdCl
     return sTransportManager;
   }
 
+  //----------------------------------------------------------------------------
+  // Get the metadata cache
+  //----------------------------------------------------------------------------
+  MetaCache *DefaultEnv::GetMetaCache()
+  {
+    if( unlikely( !sMetaCache ) )
+    {
+      XrdSysMutexHelper scopedLock( sInitMutex );
+      if( !sMetaCache )
+        sMetaCache = new MetaCache();
+    }
+    return sMetaCache;
+  }
+
   //----------------------------------------------------------------------------
   // Initialize the environment
   //----------------------------------------------------------------------------
@@ -448,6 +481,21 @@ namespace XrdCl
       sPostMaster = 0;
     }
 
+    if( sLog )
+    {
+      BufferPool::Stats stats;
+      BufferPool::GetStats( stats );
+      sLog->Debug( UtilityMsg, "Buffer pool: %ld allocations, %ld from the "
+                   "thread caches, %ld from the shared pool, %ld from malloc, "
+                   "%ld returned", stats.allocations, stats.threadHits,
+                   stats.poolHits, stats.mallocs, stats.frees );
+    }
+
+    if( sMetaCache )
+      sMetaCache->Report();
+    delete sMetaCache;
+    sMetaCache = 0;
+
     delete sTransportManager;
     sTransportManager = 0;
 
@@ -34,6 +34,7 @@ namespace XrdCl
   class CheckSumManager;
   class TransportManager;
   class FileTimer;
+  class MetaCache;
 
   //----------------------------------------------------------------------------
   //! Default environment for the client. Responsible for setting/importing
@@ -127,6 +128,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       static TransportManager *GetTransportManager();
 
+      //------------------------------------------------------------------------
+      //! Get the metadata cache
+      //------------------------------------------------------------------------
+      static MetaCache *GetMetaCache();
+
       //------------------------------------------------------------------------
       //! Initialize the environment
       //------------------------------------------------------------------------
@@ -156,6 +162,7 @@ namespace XrdCl
       static bool               sMonitorInitialized;
       static CheckSumManager   *sCheckSumManager;
       static TransportManager  *sTransportManager;
+      static MetaCache         *sMetaCache;
   };
 }
 
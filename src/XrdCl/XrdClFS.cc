@@ -782,6 +782,146 @@ XRootDStatus DoStat( FileSystem                      *fs,
   return XRootDStatus();
 }
 
+//------------------------------------------------------------------------------
+// Stat or locate a list of paths read from the standard input
+//------------------------------------------------------------------------------
+XRootDStatus DoBulk( FileSystem                      *fs,
+                     Env                             *env,
+                     const FSExecutor::CommandParams &args )
+{
+  //----------------------------------------------------------------------------
+  // Check up the args
+  //----------------------------------------------------------------------------
+  Log         *log     = DefaultEnv::GetLog();
+  uint32_t     argc    = args.size();
+
+  OpenFlags::Flags flags = OpenFlags::None;
+  std::string op;
+  uint16_t    window       = 0;
+  bool        doDeepLocate = false;
+  for( uint32_t i = 1; i < argc; ++i )
+  {
+    if( args[i] == "-n" )
+      flags |= OpenFlags::NoWait;
+    else if( args[i] == "-r" )
+      flags |= OpenFlags::Refresh;
+    else if( args[i] == "-d" )
+      doDeepLocate = true;
+    else if( args[i] == "-w" && i+1 < argc )
+    {
+      char *result;
+      window = ::strtol( args[++i].c_str(), &result, 0 );
+      if( *result != 0 || !window )
+      {
+        log->Error( AppMsg, "Window parameter needs to be a positive integer" );
+        return XRootDStatus( stError, errInvalidArgs );
+      }
+    }
+    else if( op.empty() && (args[i] == "stat" || args[i] == "locate") )
+      op = args[i];
+    else
+    {
+      log->Error( AppMsg, "Invalid argument: %s.", args[i].c_str() );
+      return XRootDStatus( stError, errInvalidArgs );
+    }
+  }
+
+  if( op.empty() )
+  {
+    log->Error( AppMsg, "Wrong number of arguments." );
+    return XRootDStatus( stError, errInvalidArgs );
+  }
+
+  //----------------------------------------------------------------------------
+  // Read the paths in chunks so that we don't need to hold millions of them
+  // in memory, every chunk is sent as one bulk request
+  //----------------------------------------------------------------------------
+  const uint32_t chunkSize = 16384;
+  XRootDStatus   lastError;
+  std::string    line;
+  bool           eof = false;
+
+  while( !eof )
+  {
+    std::vector<std::string> paths;
+    while( paths.size() < chunkSize )
+    {
+      if( !std::getline( std::cin, line ) )
+      {
+        eof = true;
+        break;
+      }
+      if( line.empty() )
+        continue;
+
+      std::string fullPath;
+      if( line[0] == '*' && op == "locate" )
+        fullPath = line;
+      else if( !BuildPath( fullPath, env, line ).IsOK() )
+      {
+        log->Error( AppMsg, "Invalid path: %s.", line.c_str() );
+        lastError = XRootDStatus( stError, errInvalidArgs );
+        continue;
+      }
+      paths.push_back( fullPath );
+    }
+
+    if( paths.empty() )
+      continue;
+
+    //--------------------------------------------------------------------------
+    // Run the queries and print the results in the order of the input
+    //--------------------------------------------------------------------------
+    std::vector<XRootDStatus> status;
+
+    if( op == "stat" )
+    {
+      std::vector<StatInfo*> info;
+      fs->BulkStat( paths, status, info, window );
+      for( uint32_t i = 0; i < info.size(); ++i )
+      {
+        if( !status[i].IsOK() )
+        {
+          log->Error( AppMsg, "Unable stat %s: %s", paths[i].c_str(),
+                              status[i].ToStr().c_str() );
+          lastError = status[i];
+          continue;
+        }
+        std::cout << paths[i] << " " << info[i]->GetId() << " ";
+        std::cout << info[i]->GetSize() << " " << info[i]->GetFlags() << " ";
+        std::cout << info[i]->GetModTime() << std::endl;
+        delete info[i];
+      }
+    }
+    else
+    {
+      std::vector<LocationInfo*> info;
+      if( doDeepLocate )
+        fs->BulkDeepLocate( paths, flags, status, info, window );
+      else
+        fs->BulkLocate( paths, flags, status, info, window );
+      for( uint32_t i = 0; i < info.size(); ++i )
+      {
+        if( !status[i].IsOK() )
+        {
+          log->Error( AppMsg, "Unable locate %s: %s", paths[i].c_str(),
+                              status[i].ToStr().c_str() );
+          lastError = status[i];
+          continue;
+        }
+        std::cout << paths[i];
+        LocationInfo::Iterator it;
+        for( it = info[i]->Begin(); it != info[i]->End(); ++it )
+          std::cout << " " << it->GetAddress();
+        std::cout << std::endl;
+        delete info[i];
+      }
+    }
+  }
+
+  return lastError;
+}
+
 //------------------------------------------------------------------------------
 // Stat a VFS
 //------------------------------------------------------------------------------
@@ -945,6 +1085,11 @@ XRootDStatus PrintHelp( FileSystem *, Env *,
   printf( "   cd <path>\n"                                                  );
   printf( "     Change the current working directory\n\n"                   );
 
+  printf( "   bulk [-w <window>] [-n] [-r] [-d] stat|locate\n"             );
+  printf( "     Stat or locate the paths read from the standard input,\n"  );
+  printf( "     one per line, keeping up to <window> requests in flight.\n" );
+  printf( "     -n, -r and -d have the same meaning as for locate.\n\n"   );
+
   printf( "   chmod <path> <user><group><other>\n"                          );
   printf( "     Modify permissions. Permission string example:\n"           );
   printf( "     rwxr-x--x\n\n"                                              );
@@ -1001,6 +1146,7 @@ FSExecutor *CreateExecutor( const URL &url )
   Env *env = new Env();
   env->PutString( "CWD", "/" );
   FSExecutor *executor = new FSExecutor( url, env );
+  executor->AddCommand( "bulk",        DoBulk       );
   executor->AddCommand( "cd",          DoCD         );
   executor->AddCommand( "chmod",       DoChMod      );
   executor->AddCommand( "ls",          DoLS         );
@@ -30,6 +30,7 @@
 #include "XrdCl/XrdClFileTimer.hh"
 #include "XrdCl/XrdClResponseJob.hh"
 #include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClMetaCache.hh"
 
 #include <sstream>
 #include <sys/time.h>
@@ -47,9 +48,13 @@ namespace
       // Constructor
       //------------------------------------------------------------------------
       OpenHandler( XrdCl::FileStateHandler *stateHandler,
-                   XrdCl::ResponseHandler  *userHandler ):
+                   XrdCl::ResponseHandler  *userHandler,
+                   uint16_t                 timeout,
+                   bool                     fromCache ):
         pStateHandler( stateHandler ),
-        pUserHandler( userHandler )
+        pUserHandler( userHandler ),
+        pTimeout( timeout ),
+        pFromCache( fromCache )
       {
       }
 
@@ -62,6 +67,20 @@ namespace
       {
         using namespace XrdCl;
 
+        //----------------------------------------------------------------------
+        // The data server from the metadata cache did not work out, go
+        // through the original host
+        //----------------------------------------------------------------------
+        if( pFromCache && !status->IsOK() &&
+            pStateHandler->RetryOpen( status, pUserHandler, pTimeout ) )
+        {
+          delete status;
+          delete response;
+          delete hostList;
+          delete this;
+          return;
+        }
+
         //----------------------------------------------------------------------
         // Extract the statistics info
         //----------------------------------------------------------------------
@@ -94,6 +113,8 @@ namespace
     private:
       XrdCl::FileStateHandler *pStateHandler;
       XrdCl::ResponseHandler  *pUserHandler;
+      uint16_t                 pTimeout;
+      bool                     pFromCache;
   };
 
   //----------------------------------------------------------------------------
@@ -352,35 +373,37 @@ namespace XrdCl
     }
 
     //--------------------------------------------------------------------------
-    // Open the file
+    // Open the file, go straight to the data server if we have recently
+    // been redirected there for reading the same file
     //--------------------------------------------------------------------------
-    log->Debug( FileMsg, "[0x%x@%s] Sending an open command", this,
-                pFileUrl->GetURL().c_str() );
-
     pOpenMode  = mode;
     pOpenFlags = flags;
 
-    Message           *msg;
-    ClientOpenRequest *req;
-    std::string        path = pFileUrl->GetPathWithParams();
-    MessageUtils::CreateRequest( msg, req, path.length() );
+    MetaCache   *cache = DefaultEnv::GetMetaCache();
+    std::string  dataServer;
+    Status       st;
+    pCachedLoadBalancer.clear();
 
-    req->requestid = kXR_open;
-    req->mode      = mode;
-    req->options   = flags | kXR_async | kXR_retstat;
-    req->dlen      = path.length();
-    msg->Append( path.c_str(), path.length(), 24 );
+    if( cache->IsEnabled() && !IsReadOnly() )
+      cache->Invalidate( *pFileUrl, pFileUrl->GetPath() );
 
-    XRootDTransport::SetDescription( msg );
-    OpenHandler *openHandler = new OpenHandler( this, handler );
-    MessageSendParams params; params.timeout = timeout;
-    MessageUtils::ProcessSendParams( params );
-
-    Status st = MessageUtils::SendMessage( *pFileUrl, msg, openHandler, params );
+    if( cache->IsEnabled() && IsReadOnly() &&
+        cache->GetLocation( *pFileUrl, dataServer, pCachedLoadBalancer ) )
+    {
+      log->Debug( FileMsg, "[0x%x@%s] Sending an open command to %s from "
+                  "the metadata cache", this, pFileUrl->GetURL().c_str(),
+                  dataServer.c_str() );
+      st = SendOpen( URL( dataServer ), handler, timeout, true );
+    }
+    else
+    {
+      log->Debug( FileMsg, "[0x%x@%s] Sending an open command", this,
+                  pFileUrl->GetURL().c_str() );
+      st = SendOpen( *pFileUrl, handler, timeout, false );
+    }
 
     if( !st.IsOK() )
     {
-      delete openHandler;
       pStatus    = st;
       pFileState = Error;
       return st;
@@ -388,6 +411,25 @@ namespace XrdCl
     return st;
   }
 
+  //----------------------------------------------------------------------------
+  // Open the file at the original URL after the cached location has failed
+  //----------------------------------------------------------------------------
+  bool FileStateHandler::RetryOpen( const XRootDStatus *status,
+                                    ResponseHandler    *handler,
+                                    uint16_t            timeout )
+  {
+    Log *log = DefaultEnv::GetLog();
+    XrdSysMutexHelper scopedLock( pMutex );
+
+    log->Debug( FileMsg, "[0x%x@%s] Open at the cached location failed: %s, "
+                "retrying", this, pFileUrl->GetURL().c_str(),
+                status->ToStr().c_str() );
+
+    DefaultEnv::GetMetaCache()->LocationFailed( *pFileUrl );
+    pCachedLoadBalancer.clear();
+    return SendOpen( *pFileUrl, handler, timeout, false ).IsOK();
+  }
+
   //----------------------------------------------------------------------------
   // Close the file object
   //----------------------------------------------------------------------------
@@ -833,6 +875,13 @@ namespace XrdCl
     if( pDataServer )
       lastServer = pDataServer->GetHostId();
 
+    //--------------------------------------------------------------------------
+    // We went straight to the data server from the metadata cache, so we
+    // have to restore the load balancer for the recovery
+    //--------------------------------------------------------------------------
+    if( !pLoadBalancer && !pCachedLoadBalancer.empty() )
+      pLoadBalancer = new URL( pCachedLoadBalancer );
+
     log->Debug( FileMsg, "[0x%x@%s] Open has returned with status %s",
                 this, pFileUrl->GetURL().c_str(), status->ToStr().c_str() );
 
@@ -877,6 +926,28 @@ namespace XrdCl
         pStatInfo = new StatInfo( *openInfo->GetStatInfo() );
       }
 
+      //------------------------------------------------------------------------
+      // Remember where we have been redirected to and what we have learned
+      // about the file, the redirections with opaque information are not
+      // remembered because it may not be valid for long
+      //------------------------------------------------------------------------
+      MetaCache   *cache = DefaultEnv::GetMetaCache();
+      std::string  ds;
+      if( cache->IsEnabled() && IsReadOnly() )
+      {
+        if( MetaCache::GetRedirectTarget( hostList, ds ) )
+        {
+          std::string lb;
+          if( pLoadBalancer )
+            lb = pLoadBalancer->GetProtocol() + "://" +
+                 pLoadBalancer->GetHostId();
+          cache->PutLocation( *pFileUrl, ds, lb );
+        }
+
+        if( pStatInfo )
+          cache->PutStat( *pFileUrl, pFileUrl->GetPath(), *pStatInfo );
+      }
+
       log->Debug( FileMsg, "[0x%x@%s] successfully opened at %s, handle: 0x%x, "
                   "session id: %ld", this, pFileUrl->GetURL().c_str(),
                   pDataServer->GetHostId().c_str(), *((uint32_t*)pFileHandle),
@@ -924,6 +995,10 @@ namespace XrdCl
     MonitorClose( status );
     ResetMonitoringVars();
 
+    MetaCache *cache = DefaultEnv::GetMetaCache();
+    if( cache->IsEnabled() && !IsReadOnly() )
+      cache->Invalidate( *pFileUrl, pFileUrl->GetPath() );
+
     pStatus    = *status;
     pFileState = Closed;
   }
@@ -1287,6 +1362,37 @@ namespace XrdCl
     return st;
   }
 
+  //----------------------------------------------------------------------------
+  // Send the open request to the given server
+  //----------------------------------------------------------------------------
+  Status FileStateHandler::SendOpen( const URL       &url,
+                                     ResponseHandler *handler,
+                                     uint16_t         timeout,
+                                     bool             fromCache )
+  {
+    Message           *msg;
+    ClientOpenRequest *req;
+    std::string        path = pFileUrl->GetPathWithParams();
+    MessageUtils::CreateRequest( msg, req, path.length() );
+
+    req->requestid = kXR_open;
+    req->mode      = pOpenMode;
+    req->options   = pOpenFlags | kXR_async | kXR_retstat;
+    req->dlen      = path.length();
+    msg->Append( path.c_str(), path.length(), 24 );
+
+    XRootDTransport::SetDescription( msg );
+    OpenHandler *openHandler = new OpenHandler( this, handler, timeout,
+                                                fromCache );
+    MessageSendParams params; params.timeout = timeout;
+    MessageUtils::ProcessSendParams( params );
+
+    Status st = MessageUtils::SendMessage( url, msg, openHandler, params );
+    if( !st.IsOK() )
+      delete openHandler;
+    return st;
+  }
+
   //----------------------------------------------------------------------------
   // Re-open the current file at a given server
   //----------------------------------------------------------------------------
@@ -1315,7 +1421,7 @@ namespace XrdCl
     req->dlen      = path.length();
     msg->Append( path.c_str(), path.length(), 24 );
 
-    OpenHandler *openHandler = new OpenHandler( this, 0 );
+    OpenHandler *openHandler = new OpenHandler( this, 0, timeout, false );
     MessageSendParams params; params.timeout = timeout;
     MessageUtils::ProcessSendParams( params );
     XRootDTransport::SetDescription( msg );
@@ -190,6 +190,16 @@ namespace XrdCl
                    const OpenInfo     *openInfo,
                    const HostList     *hostList );
 
+      //------------------------------------------------------------------------
+      //! Open the file at the original URL after opening it at the data
+      //! server remembered in the metadata cache has failed
+      //!
+      //! @return true if the open request has been re-sent
+      //------------------------------------------------------------------------
+      bool RetryOpen( const XRootDStatus *status,
+                      ResponseHandler    *handler,
+                      uint16_t            timeout );
+
       //------------------------------------------------------------------------
       //! Process the results of the closing operation
       //------------------------------------------------------------------------
@@ -325,6 +335,14 @@ namespace XrdCl
       //------------------------------------------------------------------------
       bool IsReadOnly() const;
 
+      //------------------------------------------------------------------------
+      //! Send the open request to the given server
+      //------------------------------------------------------------------------
+      Status SendOpen( const URL       &url,
+                       ResponseHandler *handler,
+                       uint16_t         timeout,
+                       bool             fromCache );
+
       //------------------------------------------------------------------------
       //! Re-open the current file at a given server
       //------------------------------------------------------------------------
@@ -387,6 +405,7 @@ namespace XrdCl
       uint64_t                pSessionId;
       bool                    pDoRecoverRead;
       bool                    pDoRecoverWrite;
+      std::string             pCachedLoadBalancer;
 
       //------------------------------------------------------------------------
       // Monitoring variables
@@ -26,6 +26,10 @@
 #include "XrdCl/XrdClRequestSync.hh"
 #include "XrdCl/XrdClXRootDTransport.hh"
 #include "XrdCl/XrdClForkHandler.hh"
+#include "XrdCl/XrdClMetaCache.hh"
+#include "XrdCl/XrdClPostMaster.hh"
+#include "XrdCl/XrdClJobManager.hh"
+#include "XrdCl/XrdClResponseJob.hh"
 #include "XrdSys/XrdSysPthread.hh"
 
 #include <memory>
@@ -247,6 +251,341 @@ namespace
       uint32_t                  pIndex;
       XrdCl::RequestSync   *pSync;
   };
+
+  //----------------------------------------------------------------------------
+  // Put the stat results in the metadata cache and pass them to the user
+  //----------------------------------------------------------------------------
+  class StatCacheHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      StatCacheHandler( const XrdCl::URL       &url,
+                        const std::string      &path,
+                        XrdCl::ResponseHandler *userHandler ):
+        pUrl( url ),
+        pPath( path ),
+        pUserHandler( userHandler )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      // Handle the response
+      //------------------------------------------------------------------------
+      virtual void HandleResponseWithHosts( XrdCl::XRootDStatus *status,
+                                            XrdCl::AnyObject    *response,
+                                            XrdCl::HostList     *hostList )
+      {
+        using namespace XrdCl;
+        if( status->IsOK() && response )
+        {
+          StatInfo *info = 0;
+          response->Get( info );
+          if( info )
+            DefaultEnv::GetMetaCache()->PutStat( pUrl, pPath, *info );
+        }
+        pUserHandler->HandleResponseWithHosts( status, response, hostList );
+        delete this;
+      }
+
+    private:
+      XrdCl::URL              pUrl;
+      std::string             pPath;
+      XrdCl::ResponseHandler *pUserHandler;
+  };
+
+  //----------------------------------------------------------------------------
+  // Keep a window of requests for a list of paths in flight
+  //----------------------------------------------------------------------------
+  class BulkRequest
+  {
+    public:
+      enum Operation
+      {
+        Stat,
+        Locate,
+        DeepLocate
+      };
+
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      BulkRequest( XrdCl::FileSystem              *fs,
+                   Operation                       op,
+                   const std::vector<std::string> &paths,
+                   XrdCl::OpenFlags::Flags         flags,
+                   XrdCl::BulkResponseHandler     *handler,
+                   uint16_t                        window,
+                   uint16_t                        timeout ):
+        pFS( fs ),
+        pOperation( op ),
+        pPaths( paths ),
+        pFlags( flags ),
+        pHandler( handler ),
+        pWindow( window ),
+        pTimeout( timeout ),
+        pNext( 0 ),
+        pDone( 0 )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      // Send the first window of requests, the object deletes itself when
+      // all the responses have been handled
+      //------------------------------------------------------------------------
+      void Start()
+      {
+        uint32_t count = pPaths.size();
+
+        if( !count )
+        {
+          pHandler->HandleDone();
+          delete this;
+          return;
+        }
+
+        //----------------------------------------------------------------------
+        // The responses may start coming in before we're done here, so the
+        // window is claimed up front and this object is not touched after
+        // the last request has been sent
+        //----------------------------------------------------------------------
+        if( count > pWindow )
+          count = pWindow;
+        pNext = count;
+
+        for( uint32_t i = 0; i < count; ++i )
+        {
+          XrdCl::XRootDStatus st = Send( i );
+          if( !st.IsOK() )
+            Done( i, new XrdCl::XRootDStatus( st ), 0 );
+        }
+      }
+
+      //------------------------------------------------------------------------
+      // Hand the response over to the user and send the next request
+      //------------------------------------------------------------------------
+      void Done( uint32_t              index,
+                 XrdCl::XRootDStatus  *status,
+                 XrdCl::AnyObject     *response )
+      {
+        pHandler->HandleResponse( index, status, response );
+
+        while( 1 )
+        {
+          bool     last = false;
+          bool     send = false;
+          uint32_t next = 0;
+
+          pMutex.Lock();
+          if( ++pDone == pPaths.size() )
+            last = true;
+          else if( pNext < pPaths.size() )
+          {
+            next = pNext++;
+            send = true;
+          }
+          pMutex.UnLock();
+
+          if( last )
+          {
+            pHandler->HandleDone();
+            delete this;
+            return;
+          }
+
+          if( !send )
+            return;
+
+          XrdCl::XRootDStatus st = Send( next );
+          if( st.IsOK() )
+            return;
+          pHandler->HandleResponse( next, new XrdCl::XRootDStatus( st ), 0 );
+        }
+      }
+
+    private:
+      //------------------------------------------------------------------------
+      // Send the request for the path at index
+      //------------------------------------------------------------------------
+      XrdCl::XRootDStatus Send( uint32_t index );
+
+      XrdCl::FileSystem          *pFS;
+      Operation                   pOperation;
+      std::vector<std::string>    pPaths;
+      XrdCl::OpenFlags::Flags     pFlags;
+      XrdCl::BulkResponseHandler *pHandler;
+      uint32_t                    pWindow;
+      uint16_t                    pTimeout;
+      uint32_t                    pNext;
+      uint32_t                    pDone;
+      XrdSysMutex                 pMutex;
+  };
+
+  //----------------------------------------------------------------------------
+  // Pass the response for a single path back to the bulk request
+  //----------------------------------------------------------------------------
+  class BulkPathHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      BulkPathHandler( BulkRequest *request, uint32_t index ):
+        pRequest( request ),
+        pIndex( index )
+      {
+      }
+
+      virtual void HandleResponse( XrdCl::XRootDStatus *status,
+                                   XrdCl::AnyObject    *response )
+      {
+        pRequest->Done( pIndex, status, response );
+        delete this;
+      }
+
+    private:
+      BulkRequest *pRequest;
+      uint32_t     pIndex;
+  };
+
+  //----------------------------------------------------------------------------
+  // Send the request for the path at index
+  //----------------------------------------------------------------------------
+  XrdCl::XRootDStatus BulkRequest::Send( uint32_t index )
+  {
+    XrdCl::ResponseHandler *handler = new BulkPathHandler( this, index );
+    XrdCl::XRootDStatus     st;
+
+    switch( pOperation )
+    {
+      case Stat:
+        st = pFS->Stat( pPaths[index], handler, pTimeout );
+        break;
+      case Locate:
+        st = pFS->Locate( pPaths[index], pFlags, handler, pTimeout );
+        break;
+      case DeepLocate:
+        st = pFS->DeepLocate( pPaths[index], pFlags, handler, pTimeout );
+        break;
+    }
+
+    if( !st.IsOK() )
+      delete handler;
+    return st;
+  }
+
+  //----------------------------------------------------------------------------
+  // Start a bulk request
+  //----------------------------------------------------------------------------
+  XrdCl::XRootDStatus StartBulk( XrdCl::FileSystem              *fs,
+                                 BulkRequest::Operation          op,
+                                 const std::vector<std::string> &paths,
+                                 XrdCl::OpenFlags::Flags         flags,
+                                 XrdCl::BulkResponseHandler     *handler,
+                                 uint16_t                        window,
+                                 uint16_t                        timeout )
+  {
+    using namespace XrdCl;
+
+    if( !handler )
+      return XRootDStatus( stError, errInvalidArgs );
+
+    if( !window )
+    {
+      int defaultWindow = DefaultBulkWindow;
+      DefaultEnv::GetEnv()->GetInt( "BulkWindow", defaultWindow );
+      window = defaultWindow > 0 ? defaultWindow : 1;
+    }
+
+    BulkRequest *req = new BulkRequest( fs, op, paths, flags, handler,
+                                        window, timeout );
+    req->Start();
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Collect the responses of a bulk request
+  //----------------------------------------------------------------------------
+  template<class Type>
+  class SyncBulkHandler: public XrdCl::BulkResponseHandler
+  {
+    public:
+      //------------------------------------------------------------------------
+      // Constructor
+      //------------------------------------------------------------------------
+      SyncBulkHandler( std::vector<XrdCl::XRootDStatus> &status,
+                       std::vector<Type*>               &response ):
+        pStatus( status ),
+        pResponse( response ),
+        pErrors( 0 ),
+        pSem( 0 )
+      {
+      }
+
+      //------------------------------------------------------------------------
+      // Every path has its own slot in the vectors so no locking is needed
+      // to store the response
+      //------------------------------------------------------------------------
+      virtual void HandleResponse( uint32_t             index,
+                                   XrdCl::XRootDStatus *status,
+                                   XrdCl::AnyObject    *response )
+      {
+        using namespace XrdCl;
+        Type *obj = 0;
+
+        if( status->IsOK() )
+        {
+          if( response )
+          {
+            response->Get( obj );
+            response->Set( (int *)0 );
+          }
+          if( !obj )
+            *status = XRootDStatus( stError, errInternal );
+        }
+
+        pStatus[index]   = *status;
+        pResponse[index] = obj;
+
+        if( !status->IsOK() )
+        {
+          XrdSysMutexHelper scopedLock( pMutex );
+          ++pErrors;
+          pLastError = *status;
+        }
+        delete status;
+        delete response;
+      }
+
+      //------------------------------------------------------------------------
+      // All done
+      //------------------------------------------------------------------------
+      virtual void HandleDone()
+      {
+        pSem.Post();
+      }
+
+      //------------------------------------------------------------------------
+      // Wait for all the responses
+      //------------------------------------------------------------------------
+      XrdCl::XRootDStatus Wait()
+      {
+        using namespace XrdCl;
+        pSem.Wait();
+
+        if( !pErrors )
+          return XRootDStatus();
+        if( pErrors == pStatus.size() )
+          return pLastError;
+        return XRootDStatus( stOK, suPartial );
+      }
+
+    private:
+      std::vector<XrdCl::XRootDStatus> &pStatus;
+      std::vector<Type*>               &pResponse;
+      uint32_t                          pErrors;
+      XrdCl::XRootDStatus               pLastError;
+      XrdSysMutex                       pMutex;
+      XrdSysSemaphore                   pSem;
+  };
 }
 
 namespace XrdCl
@@ -295,9 +634,16 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   // Constructor
   //----------------------------------------------------------------------------
-  FileSystem::FileSystem( const URL &url ): pLoadBalancerLookupDone( false )
+  FileSystem::FileSystem( const URL &url ):
+    pLoadBalancerLookupDone( false )
   {
-    pUrl = new URL( url.GetURL() );
+    //--------------------------------------------------------------------------
+    // The URL we have been constructed with is kept next to the one we send
+    // the requests to, it keys the metadata cache
+    //--------------------------------------------------------------------------
+    pUrl    = new URL[2];
+    pUrl[0] = URL( url.GetURL() );
+    pUrl[1] = pUrl[0];
     DefaultEnv::GetForkHandler()->RegisterFileSystemObject( this );
   }
 
@@ -308,7 +654,7 @@ namespace XrdCl
   {
     if( DefaultEnv::GetForkHandler() )
       DefaultEnv::GetForkHandler()->UnRegisterFileSystemObject( this );
-    delete pUrl;
+    delete [] pUrl;
   }
 
   //----------------------------------------------------------------------------
@@ -389,6 +735,9 @@ namespace XrdCl
                                ResponseHandler   *handler,
                                uint16_t           timeout )
   {
+    InvalidateCache( source );
+    InvalidateCache( dest );
+
     Message         *msg;
     ClientMvRequest *req;
     MessageUtils::CreateRequest( msg, req, source.length()+dest.length()+1 );
@@ -468,6 +817,8 @@ namespace XrdCl
                                      ResponseHandler   *handler,
                                      uint16_t           timeout )
   {
+    InvalidateCache( path );
+
     Message               *msg;
     ClientTruncateRequest *req;
     MessageUtils::CreateRequest( msg, req, path.length() );
@@ -505,6 +856,8 @@ namespace XrdCl
                                ResponseHandler   *handler,
                                uint16_t           timeout )
   {
+    InvalidateCache( path );
+
     Message         *msg;
     ClientRmRequest *req;
     MessageUtils::CreateRequest( msg, req, path.length() );
@@ -581,6 +934,8 @@ namespace XrdCl
                                   ResponseHandler   *handler,
                                   uint16_t           timeout )
   {
+    InvalidateCache( path );
+
     Message            *msg;
     ClientRmdirRequest *req;
     MessageUtils::CreateRequest( msg, req, path.length() );
@@ -617,6 +972,8 @@ namespace XrdCl
                                   ResponseHandler   *handler,
                                   uint16_t           timeout )
   {
+    InvalidateCache( path );
+
     Message            *msg;
     ClientChmodRequest *req;
     MessageUtils::CreateRequest( msg, req, path.length() );
@@ -685,6 +1042,40 @@ namespace XrdCl
                                  ResponseHandler   *handler,
                                  uint16_t           timeout )
   {
+    //--------------------------------------------------------------------------
+    // Answer from the metadata cache if we can, otherwise remember the answer.
+    // The cache is keyed by the URL we were constructed with, not the load
+    // balancer we may have been bound to since.
+    //--------------------------------------------------------------------------
+    MetaCache        *cache        = DefaultEnv::GetMetaCache();
+    StatCacheHandler *cacheHandler = 0;
+    if( cache->IsEnabled() && path.find( '?' ) == std::string::npos )
+    {
+      StatInfo *info = cache->GetStat( pUrl[1], path );
+      if( info )
+      {
+        pMutex.Lock();
+        URL url( *pUrl );
+        pMutex.UnLock();
+
+        Log *log = DefaultEnv::GetLog();
+        log->Dump( FileSystemMsg, "[0x%x@%s] Stat of %s answered from the "
+                   "metadata cache", this, url.GetHostId().c_str(),
+                   path.c_str() );
+
+        AnyObject *obj = new AnyObject();
+        obj->Set( info );
+        HostList *hostList = new HostList();
+        hostList->push_back( HostInfo( url ) );
+        JobManager *jobMan = DefaultEnv::GetPostMaster()->GetJobManager();
+        jobMan->QueueJob( new ResponseJob( handler, new XRootDStatus(), obj,
+                                           hostList ) );
+        return XRootDStatus();
+      }
+      handler = cacheHandler = new StatCacheHandler( pUrl[1], path,
+                                                     handler );
+    }
+
     Message           *msg;
     ClientStatRequest *req;
     MessageUtils::CreateRequest( msg, req, path.length() );
@@ -697,7 +1088,10 @@ namespace XrdCl
     MessageUtils::ProcessSendParams( params );
     XRootDTransport::SetDescription( msg );
 
-    return Send( msg, handler, params );
+    Status st = Send( msg, handler, params );
+    if( !st.IsOK() )
+      delete cacheHandler;
+    return st;
   }
 
   //----------------------------------------------------------------------------
@@ -1020,6 +1414,107 @@ namespace XrdCl
     return MessageUtils::WaitForResponse( &handler, response );
   }
 
+  //----------------------------------------------------------------------------
+  // Obtain status information for a list of paths - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::BulkStat( const std::vector<std::string> &paths,
+                                     BulkResponseHandler            *handler,
+                                     uint16_t                        window,
+                                     uint16_t                        timeout )
+  {
+    return StartBulk( this, BulkRequest::Stat, paths, OpenFlags::None,
+                      handler, window, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Obtain status information for a list of paths - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::BulkStat( const std::vector<std::string> &paths,
+                                     std::vector<XRootDStatus>      &status,
+                                     std::vector<StatInfo*>         &response,
+                                     uint16_t                        window,
+                                     uint16_t                        timeout )
+  {
+    status.assign( paths.size(), XRootDStatus() );
+    response.assign( paths.size(), 0 );
+
+    SyncBulkHandler<StatInfo> handler( status, response );
+    XRootDStatus st = BulkStat( paths, &handler, window, timeout );
+    if( !st.IsOK() )
+      return st;
+
+    return handler.Wait();
+  }
+
+  //----------------------------------------------------------------------------
+  // Locate a list of files - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::BulkLocate( const std::vector<std::string> &paths,
+                                       OpenFlags::Flags                flags,
+                                       BulkResponseHandler            *handler,
+                                       uint16_t                        window,
+                                       uint16_t                        timeout )
+  {
+    return StartBulk( this, BulkRequest::Locate, paths, flags,
+                      handler, window, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Locate a list of files - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::BulkLocate( const std::vector<std::string> &paths,
+                                       OpenFlags::Flags                flags,
+                                       std::vector<XRootDStatus>      &status,
+                                       std::vector<LocationInfo*>     &response,
+                                       uint16_t                        window,
+                                       uint16_t                        timeout )
+  {
+    status.assign( paths.size(), XRootDStatus() );
+    response.assign( paths.size(), 0 );
+
+    SyncBulkHandler<LocationInfo> handler( status, response );
+    XRootDStatus st = BulkLocate( paths, flags, &handler, window, timeout );
+    if( !st.IsOK() )
+      return st;
+
+    return handler.Wait();
+  }
+
+  //----------------------------------------------------------------------------
+  // Locate a list of files, recursively locate all disk servers - async
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::BulkDeepLocate( const std::vector<std::string> &paths,
+                                           OpenFlags::Flags                flags,
+                                           BulkResponseHandler            *handler,
+                                           uint16_t                        window,
+                                           uint16_t                        timeout )
+  {
+    return StartBulk( this, BulkRequest::DeepLocate, paths, flags,
+                      handler, window, timeout );
+  }
+
+  //----------------------------------------------------------------------------
+  // Locate a list of files, recursively locate all disk servers - sync
+  //----------------------------------------------------------------------------
+  XRootDStatus FileSystem::BulkDeepLocate( const std::vector<std::string> &paths,
+                                           OpenFlags::Flags                flags,
+                                           std::vector<XRootDStatus>      &status,
+                                           std::vector<LocationInfo*>     &response,
+                                           uint16_t                        window,
+                                           uint16_t                        timeout )
+  {
+    status.assign( paths.size(), XRootDStatus() );
+    response.assign( paths.size(), 0 );
+
+    SyncBulkHandler<LocationInfo> handler( status, response );
+    XRootDStatus st = BulkDeepLocate( paths, flags, &handler, window,
+                                      timeout );
+    if( !st.IsOK() )
+      return st;
+
+    return handler.Wait();
+  }
+
   //----------------------------------------------------------------------------
   // Assign a load balancer if it has not already been assigned
   //----------------------------------------------------------------------------
@@ -1034,11 +1529,22 @@ namespace XrdCl
     log->Dump( FileSystemMsg, "[0x%x@%s] Assigning %s as load balancer", this,
                pUrl->GetHostId().c_str(), url.GetHostId().c_str() );
 
-    delete pUrl;
-    pUrl = new URL( url );
+    pUrl[0] = url;
     pLoadBalancerLookupDone = true;
   }
 
+  //----------------------------------------------------------------------------
+  // Drop the cached metadata of a path that is about to be modified
+  //----------------------------------------------------------------------------
+  void FileSystem::InvalidateCache( const std::string &path )
+  {
+    MetaCache *cache = DefaultEnv::GetMetaCache();
+    if( !cache->IsEnabled() )
+      return;
+
+    cache->Invalidate( pUrl[1], path );
+  }
+
   //----------------------------------------------------------------------------
   // Send a message in a locked environment
   //----------------------------------------------------------------------------
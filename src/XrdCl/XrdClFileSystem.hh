@@ -644,6 +644,132 @@ namespace XrdCl
                             Buffer                         *&response,
                             uint16_t                         timeout = 0 );
 
+      //------------------------------------------------------------------------
+      //! Obtain status information for a list of paths - async
+      //!
+      //! The requests are pipelined, at most window of them are in flight
+      //! at any given time. The FileSystem object must not be deleted
+      //! before the handler is notified that all the paths are done.
+      //!
+      //! @param paths   list of file/directory paths
+      //! @param handler handler to be notified when the response for
+      //!                each path arrives, the response parameter will hold
+      //!                a StatInfo object if the procedure is successful
+      //! @param window  maximum number of requests in flight, if 0 the
+      //!                environment default will be used
+      //! @param timeout timeout value for each request, if 0 the
+      //!                environment default will be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus BulkStat( const std::vector<std::string> &paths,
+                             BulkResponseHandler            *handler,
+                             uint16_t                        window  = 0,
+                             uint16_t                        timeout = 0 );
+
+      //------------------------------------------------------------------------
+      //! Obtain status information for a list of paths - sync
+      //!
+      //! @param paths    list of file/directory paths
+      //! @param status   status of the request for each path
+      //! @param response the response for each path (to be deleted by the
+      //!                 user), 0 if the request has failed
+      //! @param window   maximum number of requests in flight, if 0 the
+      //!                 environment default will be used
+      //! @param timeout  timeout value for each request, if 0 the
+      //!                 environment default will be used
+      //! @return         status of the operation, suPartial if some of the
+      //!                 requests have failed
+      //------------------------------------------------------------------------
+      XRootDStatus BulkStat( const std::vector<std::string> &paths,
+                             std::vector<XRootDStatus>      &status,
+                             std::vector<StatInfo*>         &response,
+                             uint16_t                        window  = 0,
+                             uint16_t                        timeout = 0 );
+
+      //------------------------------------------------------------------------
+      //! Locate a list of files - async
+      //!
+      //! @param paths   list of paths to be located
+      //! @param flags   some of the OpenFlags::Flags
+      //! @param handler handler to be notified when the response for
+      //!                each path arrives, the response parameter will hold
+      //!                a LocationInfo object if the procedure is successful
+      //! @param window  maximum number of requests in flight, if 0 the
+      //!                environment default will be used
+      //! @param timeout timeout value for each request, if 0 the
+      //!                environment default will be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus BulkLocate( const std::vector<std::string> &paths,
+                               OpenFlags::Flags                flags,
+                               BulkResponseHandler            *handler,
+                               uint16_t                        window  = 0,
+                               uint16_t                        timeout = 0 );
+
+      //------------------------------------------------------------------------
+      //! Locate a list of files - sync
+      //!
+      //! @param paths    list of paths to be located
+      //! @param flags    some of the OpenFlags::Flags
+      //! @param status   status of the request for each path
+      //! @param response the response for each path (to be deleted by the
+      //!                 user), 0 if the request has failed
+      //! @param window   maximum number of requests in flight, if 0 the
+      //!                 environment default will be used
+      //! @param timeout  timeout value for each request, if 0 the
+      //!                 environment default will be used
+      //! @return         status of the operation, suPartial if some of the
+      //!                 requests have failed
+      //------------------------------------------------------------------------
+      XRootDStatus BulkLocate( const std::vector<std::string> &paths,
+                               OpenFlags::Flags                flags,
+                               std::vector<XRootDStatus>      &status,
+                               std::vector<LocationInfo*>     &response,
+                               uint16_t                        window  = 0,
+                               uint16_t                        timeout = 0 );
+
+      //------------------------------------------------------------------------
+      //! Locate a list of files, recursively locate all disk servers - async
+      //!
+      //! @param paths   list of paths to be located
+      //! @param flags   some of the OpenFlags::Flags
+      //! @param handler handler to be notified when the response for
+      //!                each path arrives, the response parameter will hold
+      //!                a LocationInfo object if the procedure is successful
+      //! @param window  maximum number of requests in flight, if 0 the
+      //!                environment default will be used
+      //! @param timeout timeout value for each request, if 0 the
+      //!                environment default will be used
+      //! @return        status of the operation
+      //------------------------------------------------------------------------
+      XRootDStatus BulkDeepLocate( const std::vector<std::string> &paths,
+                                   OpenFlags::Flags                flags,
+                                   BulkResponseHandler            *handler,
+                                   uint16_t                        window  = 0,
+                                   uint16_t                        timeout = 0 );
+
+      //------------------------------------------------------------------------
+      //! Locate a list of files, recursively locate all disk servers - sync
+      //!
+      //! @param paths    list of paths to be located
+      //! @param flags    some of the OpenFlags::Flags
+      //! @param status   status of the request for each path
+      //! @param response the response for each path (to be deleted by the
+      //!                 user), 0 if the request has failed
+      //! @param window   maximum number of requests in flight, if 0 the
+      //!                 environment default will be used
+      //! @param timeout  timeout value for each request, if 0 the
+      //!                 environment default will be used
+      //! @return         status of the operation, suPartial if some of the
+      //!                 requests have failed
+      //------------------------------------------------------------------------
+      XRootDStatus BulkDeepLocate( const std::vector<std::string> &paths,
+                                   OpenFlags::Flags                flags,
+                                   std::vector<XRootDStatus>      &status,
+                                   std::vector<LocationInfo*>     &response,
+                                   uint16_t                        window  = 0,
+                                   uint16_t                        timeout = 0 );
+
     private:
 
       //------------------------------------------------------------------------
@@ -658,6 +784,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void AssignLoadBalancer( const URL &url );
 
+      //------------------------------------------------------------------------
+      // Drop the cached metadata of a path that is about to be modified
+      //------------------------------------------------------------------------
+      void InvalidateCache( const std::string &path );
+
       //------------------------------------------------------------------------
       // Lock the internal lock
       //------------------------------------------------------------------------
@@ -676,7 +807,7 @@ namespace XrdCl
 
       XrdSysMutex  pMutex;
       bool         pLoadBalancerLookupDone;
-      URL         *pUrl;
+      URL         *pUrl;  //!< [0] requests go to, [1] as constructed
   };
 }
 
@@ -23,6 +23,7 @@
 #include "XrdCl/XrdClPostMaster.hh"
 #include "XrdCl/XrdClFileTimer.hh"
 #include "XrdCl/XrdClFileStateHandler.hh"
+#include "XrdCl/XrdClMetaCache.hh"
 
 namespace XrdCl
 {
@@ -63,6 +64,8 @@ namespace XrdCl
     for( itFs = pFileSystemObjects.begin(); itFs != pFileSystemObjects.end();
          ++itFs )
       (*itFs)->Lock();
+
+    DefaultEnv::GetMetaCache()->Lock();
   }
 
   //----------------------------------------------------------------------------
@@ -88,6 +91,7 @@ namespace XrdCl
          ++itFs )
       (*itFs)->UnLock();
 
+    DefaultEnv::GetMetaCache()->UnLock();
     pFileTimer->UnLock();
     pPostMaster->Start();
 
@@ -120,6 +124,7 @@ namespace XrdCl
          ++itFs )
       (*itFs)->UnLock();
 
+    DefaultEnv::GetMetaCache()->UnLock();
     pFileTimer->UnLock();
     pPostMaster->Finalize();
     pPostMaster->Initialize();
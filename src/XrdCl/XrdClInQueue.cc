@@ -145,6 +145,15 @@ namespace XrdCl
         pHandlers.erase( it );
   }
 
+  //----------------------------------------------------------------------------
+  // Check whether any listeners are waiting for messages
+  //----------------------------------------------------------------------------
+  bool InQueue::HasHandlers()
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    return !pHandlers.empty();
+  }
+
   //----------------------------------------------------------------------------
   // Report an event to the handlers
   //----------------------------------------------------------------------------
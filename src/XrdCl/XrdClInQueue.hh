@@ -72,6 +72,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void RemoveMessageHandler( IncomingMsgHandler *handler );
 
+      //------------------------------------------------------------------------
+      //! Check whether any listeners are waiting for messages
+      //------------------------------------------------------------------------
+      bool HasHandlers();
+
       //------------------------------------------------------------------------
       //! Report an event to the handlers
       //------------------------------------------------------------------------
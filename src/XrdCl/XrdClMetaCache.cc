@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+// Author: Lukasz Janyst <ljanyst@cern.ch>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClMetaCache.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClURL.hh"
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  MetaCache::MetaCache()
+  {
+    Env *env        = DefaultEnv::GetEnv();
+    int  ttl        = DefaultMetaCacheTTL;
+    int  maxEntries = DefaultMetaCacheSize;
+    env->GetInt( "MetaCacheTTL",  ttl );
+    env->GetInt( "MetaCacheSize", maxEntries );
+    Init( ttl, maxEntries );
+  }
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  MetaCache::MetaCache( int ttl, int maxEntries )
+  {
+    Init( ttl, maxEntries );
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  MetaCache::~MetaCache()
+  {
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the cached stat information of a path
+  //----------------------------------------------------------------------------
+  StatInfo *MetaCache::GetStat( const URL &url, const std::string &path )
+  {
+    time_t                  now    = ::time(0);
+    StatInfo               *info   = 0;
+    bool                    report = false;
+    Monitor::MetaCacheInfo  counters;
+
+    pMutex.Lock();
+    EntryMap::iterator it = pEntries.find( GetKey( url, path ) );
+    if( it != pEntries.end() && it->second.statExpires > now )
+    {
+      info = new StatInfo( it->second.stat );
+      ++pInfo.statHits;
+    }
+    else
+      ++pInfo.statMisses;
+
+    if( (report = Purge( now )) )
+      counters = pInfo;
+    pMutex.UnLock();
+
+    if( report )
+      Report( counters );
+    return info;
+  }
+
+  //----------------------------------------------------------------------------
+  // Remember the stat information of a path
+  //----------------------------------------------------------------------------
+  void MetaCache::PutStat( const URL         &url,
+                           const std::string &path,
+                           const StatInfo    &info )
+  {
+    time_t now = ::time(0);
+    XrdSysMutexHelper scopedLock( pMutex );
+    Entry *entry = Insert( GetKey( url, path ), now );
+    entry->stat        = info;
+    entry->statExpires = now + pTTL;
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the data server the file has recently been opened at
+  //----------------------------------------------------------------------------
+  bool MetaCache::GetLocation( const URL   &url,
+                               std::string &dataServer,
+                               std::string &loadBalancer )
+  {
+    time_t                  now    = ::time(0);
+    bool                    found  = false;
+    bool                    report = false;
+    Monitor::MetaCacheInfo  counters;
+
+    pMutex.Lock();
+    EntryMap::iterator it = pEntries.find( GetKey( url, url.GetPath() ) );
+    if( it != pEntries.end() && it->second.locationExpires > now )
+    {
+      dataServer   = it->second.dataServer;
+      loadBalancer = it->second.loadBalancer;
+      found        = true;
+      ++pInfo.locationHits;
+    }
+    else
+      ++pInfo.locationMisses;
+
+    if( (report = Purge( now )) )
+      counters = pInfo;
+    pMutex.UnLock();
+
+    if( report )
+      Report( counters );
+    return found;
+  }
+
+  //----------------------------------------------------------------------------
+  // Remember where the file has been opened
+  //----------------------------------------------------------------------------
+  void MetaCache::PutLocation( const URL         &url,
+                               const std::string &dataServer,
+                               const std::string &loadBalancer )
+  {
+    time_t now = ::time(0);
+    XrdSysMutexHelper scopedLock( pMutex );
+    Entry *entry = Insert( GetKey( url, url.GetPath() ), now );
+    entry->dataServer      = dataServer;
+    entry->loadBalancer    = loadBalancer;
+    entry->locationExpires = now + pTTL;
+  }
+
+  //----------------------------------------------------------------------------
+  // Forget the location of a file because opening it there has failed
+  //----------------------------------------------------------------------------
+  void MetaCache::LocationFailed( const URL &url )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    ++pInfo.locationFailures;
+    EntryMap::iterator it = pEntries.find( GetKey( url, url.GetPath() ) );
+    if( it != pEntries.end() )
+      it->second.locationExpires = 0;
+  }
+
+  //----------------------------------------------------------------------------
+  // Forget everything about a path
+  //----------------------------------------------------------------------------
+  void MetaCache::Invalidate( const URL &url, const std::string &path )
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    pEntries.erase( GetKey( url, path ) );
+  }
+
+  //----------------------------------------------------------------------------
+  // Report the counters to the monitor
+  //----------------------------------------------------------------------------
+  void MetaCache::Report()
+  {
+    pMutex.Lock();
+    Monitor::MetaCacheInfo counters = pInfo;
+    counters.entries = pEntries.size();
+    pMutex.UnLock();
+    Report( counters );
+  }
+
+  //----------------------------------------------------------------------------
+  // Build the key of a path
+  //----------------------------------------------------------------------------
+  std::string MetaCache::GetKey( const URL &url, const std::string &path )
+  {
+    std::string::size_type start = path.find_first_not_of( '/' );
+    std::string key = url.GetHostId();
+    key += "/";
+    if( start != std::string::npos )
+      key.append( path, start, std::string::npos );
+    return key;
+  }
+
+  //----------------------------------------------------------------------------
+  // Find the data server a request has been redirected to
+  //----------------------------------------------------------------------------
+  bool MetaCache::GetRedirectTarget( const HostList *hosts,
+                                     std::string    &dataServer )
+  {
+    if( !hosts || hosts->size() < 2 )
+      return false;
+
+    //--------------------------------------------------------------------------
+    // The host that sent us somewhere with opaque information is followed by
+    // the same host without it when the request is retried, so we need to
+    // look at all of them
+    //--------------------------------------------------------------------------
+    for( size_t i = 1; i < hosts->size(); ++i )
+      if( !(*hosts)[i].url.GetParams().empty() )
+        return false;
+
+    const URL &ds = hosts->back().url;
+    dataServer = ds.GetProtocol() + "://" + ds.GetHostId();
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Apply the settings
+  //----------------------------------------------------------------------------
+  void MetaCache::Init( int ttl, int maxEntries )
+  {
+    pTTL        = ttl;
+    pMaxEntries = maxEntries > 0 ? maxEntries : 1;
+    pNextPurge  = ::time(0) + pTTL;
+
+    if( pTTL > 0 )
+    {
+      Log *log = DefaultEnv::GetLog();
+      log->Debug( UtilityMsg, "Metadata cache enabled, ttl: %d seconds, "
+                  "size: %d paths", pTTL, (int)pMaxEntries );
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Find or create an entry, make room for it if the cache is full
+  //----------------------------------------------------------------------------
+  MetaCache::Entry *MetaCache::Insert( const std::string &key, time_t now )
+  {
+    EntryMap::iterator it = pEntries.find( key );
+    if( it != pEntries.end() )
+      return &it->second;
+
+    if( pEntries.size() >= pMaxEntries )
+    {
+      pNextPurge = 0;
+      Purge( now );
+      if( pEntries.size() >= pMaxEntries )
+      {
+        Log *log = DefaultEnv::GetLog();
+        log->Debug( UtilityMsg, "Metadata cache full, dropping %d paths",
+                    (int)pEntries.size() );
+        pEntries.clear();
+      }
+    }
+    return &pEntries[key];
+  }
+
+  //----------------------------------------------------------------------------
+  // Drop the expired entries at most once per TTL, returns true if it did
+  // so the caller can report the counters
+  //----------------------------------------------------------------------------
+  bool MetaCache::Purge( time_t now )
+  {
+    if( now < pNextPurge )
+      return false;
+    pNextPurge = now + pTTL;
+
+    EntryMap::iterator it = pEntries.begin();
+    while( it != pEntries.end() )
+    {
+      if( it->second.statExpires <= now && it->second.locationExpires <= now )
+        pEntries.erase( it++ );
+      else
+        ++it;
+    }
+    pInfo.entries = pEntries.size();
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Pass the counters to the monitor
+  //----------------------------------------------------------------------------
+  void MetaCache::Report( const Monitor::MetaCacheInfo &info )
+  {
+    if( !info.statHits && !info.statMisses && !info.locationHits &&
+        !info.locationMisses )
+      return;
+
+    Monitor *mon = DefaultEnv::GetMonitor();
+    if( mon )
+    {
+      Monitor::MetaCacheInfo i = info;
+      mon->Event( Monitor::EvMetaCache, &i );
+    }
+  }
+}
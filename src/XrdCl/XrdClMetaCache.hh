@@ -0,0 +1,185 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+// Author: Lukasz Janyst <ljanyst@cern.ch>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_META_CACHE_HH__
+#define __XRD_CL_META_CACHE_HH__
+
+#include <map>
+#include <string>
+#include <ctime>
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdCl/XrdClMonitor.hh"
+
+namespace XrdCl
+{
+  class URL;
+
+  //----------------------------------------------------------------------------
+  //! Remember, for a limited time, the stat information of the paths and the
+  //! data servers that the files were opened at, so that the requests for
+  //! the paths that have just been used do not have to go through the
+  //! redirector again. The cache is keyed by the host the user addressed
+  //! and the path and is disabled when MetaCacheTTL is 0.
+  //----------------------------------------------------------------------------
+  class MetaCache
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Constructor, takes the settings from the default environment
+      //------------------------------------------------------------------------
+      MetaCache();
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param ttl        seconds the entries are valid for, 0 disables
+      //!                   the cache
+      //! @param maxEntries maximum number of paths remembered
+      //------------------------------------------------------------------------
+      MetaCache( int ttl, int maxEntries );
+
+      //------------------------------------------------------------------------
+      //! Destructor
+      //------------------------------------------------------------------------
+      ~MetaCache();
+
+      //------------------------------------------------------------------------
+      //! Check whether the cache is in use
+      //------------------------------------------------------------------------
+      bool IsEnabled() const
+      {
+        return pTTL > 0;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the cached stat information of a path
+      //!
+      //! @param url  the host the request is addressed to
+      //! @param path the path in question
+      //! @return     a copy of the stat info (to be deleted by the caller) or
+      //!             0 if nothing valid has been cached
+      //------------------------------------------------------------------------
+      StatInfo *GetStat( const URL &url, const std::string &path );
+
+      //------------------------------------------------------------------------
+      //! Remember the stat information of a path
+      //------------------------------------------------------------------------
+      void PutStat( const URL         &url,
+                    const std::string &path,
+                    const StatInfo    &info );
+
+      //------------------------------------------------------------------------
+      //! Get the data server the file has recently been opened at
+      //!
+      //! @param url          the URL of the file
+      //! @param dataServer   the data server
+      //! @param loadBalancer the load balancer that redirected to the data
+      //!                     server, empty if there was none
+      //! @return             true if a valid location has been found
+      //------------------------------------------------------------------------
+      bool GetLocation( const URL   &url,
+                        std::string &dataServer,
+                        std::string &loadBalancer );
+
+      //------------------------------------------------------------------------
+      //! Remember where the file has been opened
+      //------------------------------------------------------------------------
+      void PutLocation( const URL         &url,
+                        const std::string &dataServer,
+                        const std::string &loadBalancer );
+
+      //------------------------------------------------------------------------
+      //! Forget the location of a file because opening it there has failed
+      //------------------------------------------------------------------------
+      void LocationFailed( const URL &url );
+
+      //------------------------------------------------------------------------
+      //! Forget everything about a path, called when it has been modified
+      //------------------------------------------------------------------------
+      void Invalidate( const URL &url, const std::string &path );
+
+      //------------------------------------------------------------------------
+      //! Report the counters to the monitor, if anything has been counted
+      //------------------------------------------------------------------------
+      void Report();
+
+      //------------------------------------------------------------------------
+      //! Build the key of a path, the paths are compared without the leading
+      //! slashes and only the user, host and port are taken from the URL
+      //------------------------------------------------------------------------
+      static std::string GetKey( const URL &url, const std::string &path );
+
+      //------------------------------------------------------------------------
+      //! Find the data server a request has been redirected to
+      //!
+      //! @param hosts      the hosts the request has been sent to, the first
+      //!                   one being the one the user addressed
+      //! @param dataServer the protocol, user, host and port of the last host
+      //! @return           true if the location may be remembered, ie. the
+      //!                   request has been redirected and none of the
+      //!                   redirections carried opaque information that
+      //!                   would be lost when going to the data server
+      //!                   directly
+      //------------------------------------------------------------------------
+      static bool GetRedirectTarget( const HostList *hosts,
+                                     std::string    &dataServer );
+
+      //------------------------------------------------------------------------
+      //! Lock the cache
+      //------------------------------------------------------------------------
+      void Lock()
+      {
+        pMutex.Lock();
+      }
+
+      //------------------------------------------------------------------------
+      //! Un-lock the cache
+      //------------------------------------------------------------------------
+      void UnLock()
+      {
+        pMutex.UnLock();
+      }
+
+    private:
+      struct Entry
+      {
+        Entry(): statExpires(0), locationExpires(0) {}
+        StatInfo    stat;
+        time_t      statExpires;
+        std::string dataServer;
+        std::string loadBalancer;
+        time_t      locationExpires;
+      };
+      typedef std::map<std::string, Entry> EntryMap;
+
+      void   Init( int ttl, int maxEntries );
+      Entry *Insert( const std::string &key, time_t now );
+      bool   Purge( time_t now );
+      void   Report( const Monitor::MetaCacheInfo &info );
+
+      XrdSysMutex             pMutex;
+      EntryMap                pEntries;
+      int                     pTTL;
+      size_t                  pMaxEntries;
+      time_t                  pNextPurge;
+      Monitor::MetaCacheInfo  pInfo;
+  };
+}
+
+#endif // __XRD_CL_META_CACHE_HH__
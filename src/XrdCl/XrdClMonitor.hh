@@ -201,6 +201,24 @@ namespace XrdCl
         bool         isOK;      //!< True if checksum matched, false otherwise
       };
 
+      //------------------------------------------------------------------------
+      //! Describe the activity of the metadata cache, the counters are
+      //! cumulative since the start of the process
+      //------------------------------------------------------------------------
+      struct MetaCacheInfo
+      {
+        MetaCacheInfo():
+          statHits(0), statMisses(0), locationHits(0), locationMisses(0),
+          locationFailures(0), entries(0) {}
+        uint64_t statHits;         //!< Stat requests answered from the cache
+        uint64_t statMisses;       //!< Stat requests sent to the server
+        uint64_t locationHits;     //!< Opens sent to a cached data server
+        uint64_t locationMisses;   //!< Opens sent to the original host
+        uint64_t locationFailures; //!< Opens at a cached data server that
+                                   //!< failed and were retried
+        uint64_t entries;          //!< Number of paths in the cache
+      };
+
       //------------------------------------------------------------------------
       //! Event codes passed to the Event() method. Event code values not
       //! listed here, if encountered, should be ignored.
@@ -214,7 +232,8 @@ namespace XrdCl
         EvClose,          //!< CloseInfo: File closed
         EvErrIO,          //!< ErrorInfo: An I/O error occurred
         EvConnect,        //!< ConnectInfo: Login  into a server
-        EvDisconnect      //!< DisconnectInfo: Logout from a server
+        EvDisconnect,     //!< DisconnectInfo: Logout from a server
+        EvMetaCache       //!< MetaCacheInfo: Metadata cache counters
 
       };
 
@@ -227,6 +227,21 @@ namespace XrdCl
     return channel->Receive( handler, expires );
   }
 
+  //----------------------------------------------------------------------------
+  // Start connecting to a server ahead of the first request
+  //----------------------------------------------------------------------------
+  Status PostMaster::PreConnect( const URL &url )
+  {
+    if( !pInitialized )
+      return Status( stFatal, errUninitialized );
+    Channel *channel = GetChannel( url );
+
+    if( !channel )
+      return Status( stError, errNotSupported );
+
+    return channel->Connect();
+  }
+
   //----------------------------------------------------------------------------
   // Query the transport handler
   //----------------------------------------------------------------------------
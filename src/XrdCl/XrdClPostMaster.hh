@@ -150,6 +150,17 @@ namespace XrdCl
                       IncomingMsgHandler *handler,
                       time_t              expires );
 
+      //------------------------------------------------------------------------
+      //! Start connecting to a server that is likely to be contacted soon,
+      //! so that the handshake and the login are done by the time the first
+      //! request is sent. Idle connections are closed after their TTL
+      //! elapses.
+      //!
+      //! @param url the server to connect to
+      //! @return    success if the channel is connected or being connected
+      //------------------------------------------------------------------------
+      Status PreConnect( const URL &url );
+
       //------------------------------------------------------------------------
       //! Query the transport handler for a given URL
       //!
@@ -392,6 +392,20 @@ namespace XrdCl
       //! Check if the message invokes a stream action
       //------------------------------------------------------------------------
       virtual uint32_t StreamAction( Message *msg, AnyObject &channelData ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Notify the transport about a message that has been written to
+      //! the socket, does nothing by default
+      //------------------------------------------------------------------------
+      virtual void MessageSent( Message   *msg,
+                                AnyObject &channelData ) {}
+
+      //------------------------------------------------------------------------
+      //! Notify the transport about a message that has been read from
+      //! the socket, does nothing by default
+      //------------------------------------------------------------------------
+      virtual void MessageReceived( Message   *msg,
+                                    AnyObject &channelData ) {}
   };
 }
 
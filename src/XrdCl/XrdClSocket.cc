@@ -30,6 +30,7 @@
 #include <ctime>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <signal.h>
 #include <cstdlib>
 #include <cstring>
@@ -432,6 +433,22 @@ namespace XrdCl
 #endif
   }
 
+  //----------------------------------------------------------------------------
+  // Portable wrapper around SIGPIPE free gathering send
+  //----------------------------------------------------------------------------
+  ssize_t Socket::Send( const struct iovec *iov, int iovcnt )
+  {
+#ifdef __linux__
+    msghdr msg;
+    memset( &msg, 0, sizeof( msg ) );
+    msg.msg_iov    = const_cast<struct iovec*>( iov );
+    msg.msg_iovlen = iovcnt;
+    return ::sendmsg( pSocket, &msg, MSG_NOSIGNAL );
+#else
+    return ::writev( pSocket, iov, iovcnt );
+#endif
+  }
+
   //----------------------------------------------------------------------------
   // Poll the descriptor
   //----------------------------------------------------------------------------
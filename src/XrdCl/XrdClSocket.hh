@@ -22,6 +22,7 @@
 #include <stdint.h>
 #include <string>
 #include <sys/socket.h>
+#include <sys/uio.h>
 
 #include "XrdCl/XrdClStatus.hh"
 #include "XrdNet/XrdNetAddr.hh"
@@ -164,6 +165,15 @@ namespace XrdCl
       //------------------------------------------------------------------------
       ssize_t Send( void *buffer, uint32_t size );
 
+      //------------------------------------------------------------------------
+      //! Portable wrapper around SIGPIPE free gathering send
+      //!
+      //! @param iov    buffers to be written, in order
+      //! @param iovcnt number of buffers
+      //! @return       the amount of data actually written or -1 on error
+      //------------------------------------------------------------------------
+      ssize_t Send( const struct iovec *iov, int iovcnt );
+
       //------------------------------------------------------------------------
       //! Get the file descriptor
       //------------------------------------------------------------------------
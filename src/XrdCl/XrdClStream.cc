@@ -30,6 +30,7 @@
 
 #include <sys/types.h>
 #include <algorithm>
+#include <deque>
 #include <sys/socket.h>
 #include <sys/time.h>
 
@@ -90,9 +91,9 @@ namespace XrdCl
       delete outQueue;
     }
     AsyncSocketHandler   *socket;
-    OutQueue             *outQueue;
-    OutMessageHelper      outMsgHelper;
-    InMessageHelper       inMsgHelper;
+    OutQueue                     *outQueue;
+    std::deque<OutMessageHelper>  outMsgHelpers; // being written, in order
+    InMessageHelper               inMsgHelper;
     Socket::SocketStatus  status;
   };
 
@@ -112,6 +113,7 @@ namespace XrdCl
     pConnectionInitTime( 0 ),
     pAddressType( Utils::IPAll ),
     pSessionId( 0 ),
+    pLastActivity( 0 ),
     pQueueIncMsgJob(0),
     pBytesSent( 0 ),
     pBytesReceived( 0 )
@@ -333,6 +335,22 @@ namespace XrdCl
       OnConnectError( 0, st );
   }
 
+  //----------------------------------------------------------------------------
+  // Connect ahead of the first use
+  //----------------------------------------------------------------------------
+  Status Stream::Connect()
+  {
+    XrdSysMutexHelper scopedLock( pMutex );
+    if( pSubStreams[0]->status != Socket::Disconnected )
+      return Status();
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( PostMasterMsg, "[%s] Connecting ahead of the first request.",
+                pStreamName.c_str() );
+    PathID path( 0, 0 );
+    return EnableLink( path );
+  }
+
   //----------------------------------------------------------------------------
   // Disconnect the stream
   //----------------------------------------------------------------------------
@@ -402,6 +420,8 @@ namespace XrdCl
   {
     msg->SetSessionId( pSessionId );
     pBytesReceived += bytesReceived;
+    pLastActivity   = ::time(0);
+    pTransport->MessageReceived( msg, *pChannelData );
 
     //--------------------------------------------------------------------------
     // No handler, we cache and see what comes later
@@ -447,20 +467,24 @@ namespace XrdCl
   // Call when one of the sockets is ready to accept a new message
   //----------------------------------------------------------------------------
   std::pair<Message *, OutgoingMsgHandler *>
-    Stream::OnReadyToWrite( uint16_t subStream )
+    Stream::OnReadyToWrite( uint16_t subStream, bool batch )
   {
     XrdSysMutexHelper scopedLock( pMutex );
     Log *log = DefaultEnv::GetLog();
     if( pSubStreams[subStream]->outQueue->IsEmpty() )
     {
-      log->Dump( PostMasterMsg, "[%s] Nothing to write, disable uplink",
-                 pSubStreams[subStream]->socket->GetStreamName().c_str() );
+      if( !batch )
+      {
+        log->Dump( PostMasterMsg, "[%s] Nothing to write, disable uplink",
+                   pSubStreams[subStream]->socket->GetStreamName().c_str() );
 
-      pSubStreams[subStream]->socket->DisableUplink();
+        pSubStreams[subStream]->socket->DisableUplink();
+      }
       return std::make_pair( (Message *)0, (OutgoingMsgHandler *)0 );
     }
 
-    OutMessageHelper &h = pSubStreams[subStream]->outMsgHelper;
+    pSubStreams[subStream]->outMsgHelpers.push_back( OutMessageHelper() );
+    OutMessageHelper &h = pSubStreams[subStream]->outMsgHelpers.back();
     h.msg = pSubStreams[subStream]->outQueue->PopMessage( h.handler,
                                                           h.expires,
                                                           h.stateful );
@@ -477,11 +501,13 @@ namespace XrdCl
                               Message  *msg,
                               uint32_t  bytesSent )
   {
-    OutMessageHelper &h = pSubStreams[subStream]->outMsgHelper;
-    pBytesSent += bytesSent;
+    OutMessageHelper h = pSubStreams[subStream]->outMsgHelpers.front();
+    pSubStreams[subStream]->outMsgHelpers.pop_front();
+    pBytesSent    += bytesSent;
+    pLastActivity  = ::time(0);
+    pTransport->MessageSent( msg, *pChannelData );
     if( h.handler )
       h.handler->OnStatusReady( msg, Status() );
-    pSubStreams[subStream]->outMsgHelper.Reset();
   }
 
   //----------------------------------------------------------------------------
@@ -502,6 +528,7 @@ namespace XrdCl
       pConnectionCount = 0;
       uint16_t numSub = pTransport->SubStreamNumber( *pChannelData );
       ++pSessionId;
+      pLastActivity = ::time(0);
 
       //------------------------------------------------------------------------
       // Create the streams if they don't exist yet
@@ -678,14 +705,16 @@ namespace XrdCl
                 pStreamName.c_str(), subStream, status.ToString().c_str() );
 
     //--------------------------------------------------------------------------
-    // Reinsert the stuff that we have failed to sent
+    // Reinsert the stuff that we have failed to sent, last one first so that
+    // the original order is kept
     //--------------------------------------------------------------------------
-    if( pSubStreams[subStream]->outMsgHelper.msg )
+    std::deque<OutMessageHelper> &helpers = pSubStreams[subStream]->outMsgHelpers;
+    while( !helpers.empty() )
     {
-      OutMessageHelper &h = pSubStreams[subStream]->outMsgHelper;
+      OutMessageHelper &h = helpers.back();
       pSubStreams[subStream]->outQueue->PushFront( h.msg, h.handler, h.expires,
                                                    h.stateful );
-      pSubStreams[subStream]->outMsgHelper.Reset();
+      helpers.pop_back();
     }
 
     //--------------------------------------------------------------------------
@@ -820,8 +849,51 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   // Call back when a message has been reconstructed
   //----------------------------------------------------------------------------
-  void Stream::OnReadTimeout( uint16_t /*substream*/ )
+  void Stream::OnReadTimeout( uint16_t subStream )
   {
+    //--------------------------------------------------------------------------
+    // The main substream decides for all of them whether the stream has
+    // been idle for long enough to be closed
+    //--------------------------------------------------------------------------
+    if( subStream != 0 )
+      return;
+
+    XrdSysMutexHelper scopedLock( pMutex );
+    time_t inactiveTime = ::time(0) - pLastActivity;
+    if( !IsIdle() ||
+        !pTransport->IsStreamTTLElapsed( inactiveTime, *pChannelData ) )
+      return;
+
+    Log *log = DefaultEnv::GetLog();
+    log->Debug( PostMasterMsg, "[%s] Stream inactive for %d seconds, "
+                "disconnecting.", pStreamName.c_str(), (int)inactiveTime );
+
+    SubStreamList::iterator it;
+    for( it = pSubStreams.begin(); it != pSubStreams.end(); ++it )
+    {
+      if( (*it)->status == Socket::Disconnected )
+        continue;
+      (*it)->socket->Close();
+      (*it)->status = Socket::Disconnected;
+    }
+    MonitorDisconnection( Status() );
+  }
+
+  //----------------------------------------------------------------------------
+  // Check whether the stream is connected and has nothing to do
+  //----------------------------------------------------------------------------
+  bool Stream::IsIdle()
+  {
+    if( pSubStreams[0]->status != Socket::Connected )
+      return false;
+
+    SubStreamList::iterator it;
+    for( it = pSubStreams.begin(); it != pSubStreams.end(); ++it )
+      if( !(*it)->outQueue->IsEmpty() || !(*it)->outMsgHelpers.empty() ||
+          (*it)->inMsgHelper.handler )
+        return false;
+
+    return !pIncomingQueue->HasHandlers();
   }
 
   //----------------------------------------------------------------------------
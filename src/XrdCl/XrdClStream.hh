@@ -170,6 +170,12 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void ForceConnect();
 
+      //------------------------------------------------------------------------
+      //! Start connecting the stream ahead of its first use, does nothing
+      //! if the stream is already connected or connecting
+      //------------------------------------------------------------------------
+      Status Connect();
+
       //------------------------------------------------------------------------
       //! Return stream name
       //------------------------------------------------------------------------
@@ -186,10 +192,14 @@ namespace XrdCl
                        uint32_t  bytesReceived );
 
       //------------------------------------------------------------------------
-      // Call when one of the sockets is ready to accept a new message
+      // Call when one of the sockets is ready to accept a new message, batch
+      // indicates that the message will be written together with the ones
+      // obtained previously, in which case an empty queue leaves the uplink
+      // enabled. The messages need to be reported in the order they were
+      // obtained.
       //------------------------------------------------------------------------
       std::pair<Message *, OutgoingMsgHandler *>
-        OnReadyToWrite( uint16_t subStream );
+        OnReadyToWrite( uint16_t subStream, bool batch = false );
 
       //------------------------------------------------------------------------
       // Call when a message is written to the socket
@@ -295,6 +305,11 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void MonitorDisconnection( Status status );
 
+      //------------------------------------------------------------------------
+      //! Check whether the stream is connected and has nothing to do
+      //------------------------------------------------------------------------
+      bool IsIdle();
+
       typedef std::vector<SubStreamData*> SubStreamList;
 
       //------------------------------------------------------------------------
@@ -322,6 +337,7 @@ namespace XrdCl
       Utils::AddressType             pAddressType;
       ChannelHandlerList             pChannelEvHandlers;
       uint64_t                       pSessionId;
+      time_t                         pLastActivity;
 
       //------------------------------------------------------------------------
       // Jobs
@@ -412,6 +412,11 @@ namespace XrdCl
         //----------------------------------------------------------------------
         if( pRedirectAsAnswer )
         {
+          int preConnectLimit = DefaultPreConnectLimit;
+          DefaultEnv::GetEnv()->GetInt( "PreConnectLimit", preConnectLimit );
+          if( preConnectLimit > 0 )
+            pPostMaster->PreConnect( pUrl );
+
           pStatus   = Status( stOK, suXRDRedirect );
           pResponse = msgPtr.release();
           HandleResponse();
@@ -1125,6 +1130,7 @@ namespace XrdCl
           return Status( stError, errInvalidResponse );
         }
 
+        PreConnect( data );
         obj->Set( data );
         response = obj;
         return Status();
@@ -1737,4 +1743,24 @@ namespace XrdCl
     XRootDTransport::SetDescription( pRequest );
     XRootDTransport::MarshallRequest( pRequest );
   }
+
+  //----------------------------------------------------------------------------
+  // Connect ahead of time to the servers that hold the file
+  //----------------------------------------------------------------------------
+  void XRootDMsgHandler::PreConnect( LocationInfo *info )
+  {
+    int limit = DefaultPreConnectLimit;
+    DefaultEnv::GetEnv()->GetInt( "PreConnectLimit", limit );
+
+    LocationInfo::Iterator it;
+    for( it = info->Begin(); it != info->End() && limit > 0; ++it )
+    {
+      URL url( pUrl.GetProtocol() + "://" + it->GetAddress() );
+      if( !url.IsValid() || url.GetHostId() == pUrl.GetHostId() )
+        continue;
+
+      pPostMaster->PreConnect( url );
+      --limit;
+    }
+  }
 }
@@ -324,6 +324,12 @@ namespace XrdCl
       //------------------------------------------------------------------------
       void SwitchOnRefreshFlag();
 
+      //------------------------------------------------------------------------
+      //! Connect ahead of time to the servers that the caller is likely
+      //! to contact next
+      //------------------------------------------------------------------------
+      void PreConnect( LocationInfo *info );
+
       //------------------------------------------------------------------------
       // Helper struct for async reading of chunks
       //------------------------------------------------------------------------
@@ -879,6 +879,34 @@ namespace XrdCl
       virtual void HandleResponse( XRootDStatus *status,
                                    AnyObject    *response ) {}
   };
+
+  //----------------------------------------------------------------------------
+  //! Handle the responses of a request for a list of paths
+  //----------------------------------------------------------------------------
+  class BulkResponseHandler
+  {
+    public:
+      virtual ~BulkResponseHandler() {}
+
+      //------------------------------------------------------------------------
+      //! Called when a response for one of the paths arrives or an error
+      //! occurs. The responses do not come in the order of the paths and
+      //! the calls for different paths may be concurrent.
+      //!
+      //! @param index    index of the path in the list
+      //! @param status   status of the request for this path
+      //! @param response an object associated with the response
+      //!                 (request dependent)
+      //------------------------------------------------------------------------
+      virtual void HandleResponse( uint32_t      index,
+                                   XRootDStatus *status,
+                                   AnyObject    *response ) = 0;
+
+      //------------------------------------------------------------------------
+      //! Called once, after the responses for all the paths have been handled
+      //------------------------------------------------------------------------
+      virtual void HandleDone() {}
+  };
 }
 
 #endif // __XRD_CL_XROOTD_RESPONSES_HH__
@@ -25,6 +25,7 @@
 #include "XrdCl/XrdClSIDManager.hh"
 #include "XrdNet/XrdNetAddr.hh"
 #include "XrdSys/XrdSysPlatform.hh"
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdOuc/XrdOucErrInfo.hh"
 #include "XrdOuc/XrdOucUtils.hh"
 
@@ -34,6 +35,7 @@
 #include <dlfcn.h>
 #include <sstream>
 #include <iomanip>
+#include <set>
 
 namespace XrdCl
 {
@@ -83,7 +85,9 @@ namespace XrdCl
       authBuffer(0),
       authProtocol(0),
       authParams(0),
-      authEnv(0)
+      authEnv(0),
+      openFiles(0),
+      pendingRequests(0)
     {
       sidManager = new SIDManager();
       memset( sessionId, 0, 16 );
@@ -103,18 +107,22 @@ namespace XrdCl
     //--------------------------------------------------------------------------
     // Data
     //--------------------------------------------------------------------------
-    uint32_t          serverFlags;
-    uint32_t          protocolVersion;
-    uint8_t           sessionId[16];
-    SIDManager       *sidManager;
-    char             *authBuffer;
-    XrdSecProtocol   *authProtocol;
-    XrdSecParameters *authParams;
-    XrdOucEnv        *authEnv;
-    StreamInfoVector  stream;
-    std::string       streamName;
-    std::string       authProtocolName;
-    XrdSysMutex       mutex;
+    uint32_t           serverFlags;
+    uint32_t           protocolVersion;
+    uint8_t            sessionId[16];
+    SIDManager        *sidManager;
+    char              *authBuffer;
+    XrdSecProtocol    *authProtocol;
+    XrdSecParameters  *authParams;
+    XrdOucEnv         *authEnv;
+    StreamInfoVector   stream;
+    std::string        streamName;
+    std::string        authProtocolName;
+    uint32_t           openFiles;
+    std::set<uint16_t> sentOpens;
+    std::set<uint16_t> sentCloses;
+    int                pendingRequests; // size of the two sets, atomic
+    XrdSysMutex        mutex;
   };
 
   //----------------------------------------------------------------------------
@@ -410,10 +418,32 @@ namespace XrdCl
   //----------------------------------------------------------------------------
   // Check if the stream should be disconnected
   //----------------------------------------------------------------------------
-  bool XRootDTransport::IsStreamTTLElapsed( time_t     /*inactiveTime*/,
-                                            AnyObject &/*channelData*/ )
+  bool XRootDTransport::IsStreamTTLElapsed( time_t     inactiveTime,
+                                            AnyObject &channelData )
   {
-    return false;
+    XRootDChannelInfo *info = 0;
+    channelData.Get( info );
+    XrdSysMutexHelper scopedLock( info->mutex );
+
+    //--------------------------------------------------------------------------
+    // The open files would have to be recovered, so we keep the session
+    //--------------------------------------------------------------------------
+    if( info->openFiles || !info->sentOpens.empty() )
+      return false;
+
+    Env *env = DefaultEnv::GetEnv();
+    int ttl;
+    if( info->serverFlags & kXR_isServer )
+    {
+      ttl = DefaultDataServerTTL;
+      env->GetInt( "DataServerTTL", ttl );
+    }
+    else
+    {
+      ttl = DefaultLoadBalancerTTL;
+      env->GetInt( "LoadBalancerTTL", ttl );
+    }
+    return ttl > 0 && inactiveTime >= ttl;
   }
 
   //----------------------------------------------------------------------------
@@ -780,7 +810,13 @@ namespace XrdCl
     }
 
     if( subStreamId == 0 )
+    {
       info->sidManager->ReleaseAllTimedOut();
+      info->openFiles = 0;
+      info->sentOpens.clear();
+      info->sentCloses.clear();
+      AtomicZAP( info->pendingRequests );
+    }
   }
 
   //------------------------------------------------------------------------
@@ -830,6 +866,15 @@ namespace XrdCl
       case XRootDQuery::ProtocolVersion:
         result.Set( new int( info->protocolVersion ), false );
         return Status();
+
+      //------------------------------------------------------------------------
+      // Connection status of the main stream
+      //------------------------------------------------------------------------
+      case XRootDQuery::IsConnected:
+        result.Set( new bool( !info->stream.empty() &&
+                              info->stream[0].status ==
+                              XRootDStreamInfo::Connected ), false );
+        return Status();
     };
     return Status( stError, errQueryNotSupported );
   }
@@ -868,6 +913,86 @@ namespace XrdCl
     return NoAction;
   }
 
+  //----------------------------------------------------------------------------
+  // Keep track of the opens and closes that went through the stream
+  //----------------------------------------------------------------------------
+  void XRootDTransport::MessageSent( Message   *msg,
+                                     AnyObject &channelData )
+  {
+    //--------------------------------------------------------------------------
+    // The requests are always marshalled by the time they hit the socket
+    //--------------------------------------------------------------------------
+    ClientRequest *req   = (ClientRequest*)msg->GetBuffer();
+    uint16_t       reqId = ntohs( req->header.requestid );
+    if( reqId != kXR_open && reqId != kXR_close )
+      return;
+
+    XRootDChannelInfo *info = 0;
+    channelData.Get( info );
+    XrdSysMutexHelper scopedLock( info->mutex );
+    uint16_t sid;
+    memcpy( &sid, req->header.streamid, 2 );
+    std::set<uint16_t> &sent = reqId == kXR_open ? info->sentOpens :
+                                                   info->sentCloses;
+    if( sent.insert( sid ).second )
+      AtomicInc( info->pendingRequests );
+  }
+
+  //----------------------------------------------------------------------------
+  // Count the files opened through the stream
+  //----------------------------------------------------------------------------
+  void XRootDTransport::MessageReceived( Message   *msg,
+                                         AnyObject &channelData )
+  {
+    //--------------------------------------------------------------------------
+    // Most of the responses arrive when no open or close is outstanding, do
+    // not take the lock for those
+    //--------------------------------------------------------------------------
+    XRootDChannelInfo *info = 0;
+    channelData.Get( info );
+    if( !AtomicGet( info->pendingRequests ) )
+      return;
+    XrdSysMutexHelper scopedLock( info->mutex );
+
+    //--------------------------------------------------------------------------
+    // The header of an asynchronous response has not been unmarshalled yet
+    //--------------------------------------------------------------------------
+    ServerResponse *rsp    = (ServerResponse*)msg->GetBuffer();
+    uint16_t        status = rsp->hdr.status;
+    if( status == kXR_attn )
+    {
+      if( rsp->body.attn.actnum != (int32_t)htonl(kXR_asynresp) ||
+          msg->GetSize() < 24 )
+        return;
+      rsp    = (ServerResponse*)msg->GetBuffer(16);
+      status = ntohs( rsp->hdr.status );
+    }
+
+    if( status == kXR_oksofar || status == kXR_waitresp || status == kXR_wait )
+      return;
+
+    uint16_t sid;
+    memcpy( &sid, rsp->hdr.streamid, 2 );
+    std::set<uint16_t>::iterator it = info->sentOpens.find( sid );
+    if( it != info->sentOpens.end() )
+    {
+      info->sentOpens.erase( it );
+      AtomicDec( info->pendingRequests );
+      if( status == kXR_ok )
+        ++info->openFiles;
+      return;
+    }
+
+    it = info->sentCloses.find( sid );
+    if( it != info->sentCloses.end() )
+    {
+      info->sentCloses.erase( it );
+      AtomicDec( info->pendingRequests );
+      if( info->openFiles )
+        --info->openFiles;
+    }
+  }
+
   //----------------------------------------------------------------------------
   // Generate the message to be sent as an initial handshake
   // (handshake+kXR_protocol)
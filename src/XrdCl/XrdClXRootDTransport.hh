@@ -36,6 +36,8 @@ namespace XrdCl
     static const uint16_t SIDManager      = 1001; //!< returns the SIDManager object
     static const uint16_t ServerFlags     = 1002; //!< returns server flags
     static const uint16_t ProtocolVersion = 1003; //!< returns the protocol version
+    static const uint16_t IsConnected     = 1004; //!< returns whether the main
+                                                  //!< stream is connected
   };
 
   //----------------------------------------------------------------------------
@@ -193,6 +195,20 @@ namespace XrdCl
       //------------------------------------------------------------------------
       virtual uint32_t StreamAction( Message *msg, AnyObject &channelData );
 
+      //------------------------------------------------------------------------
+      //! Notify the transport about a message that has been written to
+      //! the socket
+      //------------------------------------------------------------------------
+      virtual void MessageSent( Message   *msg,
+                                AnyObject &channelData );
+
+      //------------------------------------------------------------------------
+      //! Notify the transport about a message that has been read from
+      //! the socket
+      //------------------------------------------------------------------------
+      virtual void MessageReceived( Message   *msg,
+                                    AnyObject &channelData );
+
     private:
 
       //------------------------------------------------------------------------
@@ -0,0 +1,640 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+// Author: Lukasz Janyst <ljanyst@cern.ch>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdCl/XrdClXtremeReader.hh"
+#include "XrdCl/XrdClConstants.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClLog.hh"
+#include "XrdCl/XrdClFile.hh"
+
+#include <sys/time.h>
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Current time in seconds
+  //----------------------------------------------------------------------------
+  double Now()
+  {
+    timeval tv;
+    gettimeofday( &tv, 0 );
+    return tv.tv_sec + tv.tv_usec/1000000.0;
+  }
+
+  //----------------------------------------------------------------------------
+  // A stolen block is only worth requesting if the thief is expected to
+  // deliver it noticeably sooner than the current owner
+  //----------------------------------------------------------------------------
+  const double StealMargin = 1.5;
+
+  //----------------------------------------------------------------------------
+  // Time assumed for a source that has not delivered anything yet
+  //----------------------------------------------------------------------------
+  const double Forever = 3600.0;
+
+  //----------------------------------------------------------------------------
+  // Never request more than this many copies of a block
+  //----------------------------------------------------------------------------
+  const uint8_t MaxCopies = 2;
+
+  //----------------------------------------------------------------------------
+  // Delete the file object when it has been closed
+  //----------------------------------------------------------------------------
+  class CloseHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      CloseHandler( XrdCl::File *file ): pFile( file ) {}
+
+      virtual void HandleResponse( XrdCl::XRootDStatus *status,
+                                   XrdCl::AnyObject    *response )
+      {
+        delete status;
+        delete response;
+        delete pFile;
+        delete this;
+      }
+
+    private:
+      XrdCl::File *pFile;
+  };
+}
+
+namespace XrdCl
+{
+  //----------------------------------------------------------------------------
+  // Handler of an asynchronous open
+  //----------------------------------------------------------------------------
+  class XtremeReader::OpenHandler: public ResponseHandler
+  {
+    public:
+      OpenHandler( XtremeReader *reader, uint16_t src ):
+        reader( reader ), source( src ) {}
+
+      virtual void HandleResponse( XRootDStatus *status,
+                                   AnyObject    *response )
+      {
+        delete response;
+        reader->Opened( source, status );
+        delete this;
+      }
+
+      XtremeReader *reader;
+      uint16_t      source;
+  };
+
+  //----------------------------------------------------------------------------
+  // Handler of a single asynchronous read
+  //----------------------------------------------------------------------------
+  class XtremeReader::ReadHandler: public ResponseHandler
+  {
+    public:
+      ReadHandler( XtremeReader *reader, uint16_t src, uint32_t blk,
+                   char *buffer ):
+        reader( reader ), source( src ), block( blk ), buffer( buffer ),
+        issued( Now() ) {}
+
+      virtual void HandleResponse( XRootDStatus *status,
+                                   AnyObject    *response )
+      {
+        reader->Done( this, status, response );
+      }
+
+      XtremeReader *reader;
+      uint16_t      source;
+      uint32_t      block;
+      char         *buffer;
+      double        issued;
+  };
+
+  //----------------------------------------------------------------------------
+  // Constructor
+  //----------------------------------------------------------------------------
+  XtremeReader::XtremeReader( const std::vector<URL> &sources,
+                              uint32_t                blockSize,
+                              uint8_t                 parallel ):
+    pCond( 0 ), pSize( -1 ), pBlockSize( blockSize ), pNextBlock( 0 ),
+    pDelivered( 0 ), pInFlight( 0 ), pOpening( 0 ), pBudget( 0 ),
+    pParallel( parallel ), pReleased( false )
+  {
+    if( !pParallel ) pParallel = 1;
+    pSources.resize( sources.size() );
+    for( uint32_t i = 0; i < sources.size(); ++i )
+    {
+      Source &s  = pSources[i];
+      s.url      = sources[i];
+      s.file     = new File();
+      s.start    = 0;
+      s.last     = 0;
+      s.received = 0;
+      s.pending  = 0;
+      s.bytes    = 0;
+      s.blocks   = 0;
+      s.stolen   = 0;
+      s.wasted   = 0;
+      s.inFlight = 0;
+      s.opening  = false;
+      s.failed   = false;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Destructor
+  //----------------------------------------------------------------------------
+  XtremeReader::~XtremeReader()
+  {
+    while( !pReady.empty() )
+    {
+      delete [] (char *)pReady.front().buffer;
+      pReady.pop_front();
+    }
+
+    for( uint32_t i = 0; i < pSources.size(); ++i )
+      delete pSources[i].file;
+  }
+
+  //----------------------------------------------------------------------------
+  // Open the sources
+  //----------------------------------------------------------------------------
+  XRootDStatus XtremeReader::Initialize()
+  {
+    Log *log = DefaultEnv::GetLog();
+    XrdSysCondVarHelper scopedLock( pCond );
+
+    for( uint16_t i = 0; i < pSources.size(); ++i )
+    {
+      Source &src = pSources[i];
+      log->Debug( UtilityMsg, "Opening %s for reading",
+                              src.url.GetURL().c_str() );
+
+      OpenHandler *h  = new OpenHandler( this, i );
+      XRootDStatus st = src.file->Open( src.url.GetURL(), OpenFlags::Read,
+                                        Access::None, h );
+      if( !st.IsOK() )
+      {
+        delete h;
+        Fail( src, st );
+        continue;
+      }
+      src.opening = true;
+      ++pOpening;
+    }
+
+    while( pSize == -1 && pOpening )
+      pCond.Wait();
+
+    if( pSize == -1 )
+      return pLastError.IsOK() ? XRootDStatus( stError, errInvalidArgs ) :
+                                 pLastError;
+    return XRootDStatus();
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the next data chunk
+  //----------------------------------------------------------------------------
+  XRootDStatus XtremeReader::GetChunk( ChunkInfo &ci )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+
+    while( 1 )
+    {
+      if( !pReady.empty() )
+      {
+        ci = pReady.front();
+        pReady.pop_front();
+        ++pDelivered;
+        FeedAll();
+        return XRootDStatus( stOK, suContinue );
+      }
+
+      if( pDelivered == pBlocks.size() )
+        return XRootDStatus( stOK, suDone );
+
+      if( !pError.IsOK() )
+        return pError;
+
+      pCond.Wait();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the data server of the first healthy source
+  //----------------------------------------------------------------------------
+  std::string XtremeReader::GetDataServer()
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    for( uint32_t i = 0; i < pSources.size(); ++i )
+      if( !pSources[i].failed && !pSources[i].opening && pSources[i].file )
+        return pSources[i].file->GetDataServer();
+    return "";
+  }
+
+  //----------------------------------------------------------------------------
+  // Get the statistics
+  //----------------------------------------------------------------------------
+  void XtremeReader::GetStats( std::vector<SourceStats> &stats )
+  {
+    XrdSysCondVarHelper scopedLock( pCond );
+    double now = Now();
+    stats.resize( pSources.size() );
+    for( uint32_t i = 0; i < pSources.size(); ++i )
+    {
+      stats[i].url    = pSources[i].url.GetURL();
+      stats[i].bytes  = pSources[i].bytes;
+      stats[i].blocks = pSources[i].blocks;
+      stats[i].stolen = pSources[i].stolen;
+      stats[i].wasted = pSources[i].wasted;
+      stats[i].rate   = Rate( pSources[i], now );
+      stats[i].failed = pSources[i].failed;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Release the reader
+  //----------------------------------------------------------------------------
+  void XtremeReader::Release()
+  {
+    pCond.Lock();
+    pReleased = true;
+    for( uint32_t i = 0; i < pSources.size(); ++i )
+      Shut( pSources[i] );
+    bool gone = Idle();
+    pCond.UnLock();
+
+    if( gone )
+      delete this;
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle an open response - called from the callback threads
+  //----------------------------------------------------------------------------
+  void XtremeReader::Opened( uint16_t idx, XRootDStatus *st )
+  {
+    Log *log = DefaultEnv::GetLog();
+    pCond.Lock();
+
+    Source &src = pSources[idx];
+    src.opening = false;
+    --pOpening;
+
+    //--------------------------------------------------------------------------
+    // The stat info comes with the open response so this does not block
+    //--------------------------------------------------------------------------
+    StatInfo *statInfo = 0;
+    if( st->IsOK() )
+      *st = src.file->Stat( false, statInfo );
+
+    if( st->IsOK() )
+    {
+      int64_t size = statInfo->GetSize();
+      delete statInfo;
+
+      if( pSize == -1 )
+      {
+        pSize = size;
+        uint32_t nBlocks = (pSize + pBlockSize - 1) / pBlockSize;
+        pBlocks.resize( nBlocks );
+        for( uint32_t i = 0; i < nBlocks; ++i )
+        {
+          Block &b = pBlocks[i];
+          b.offset = (uint64_t)i * pBlockSize;
+          b.length = pSize - b.offset < pBlockSize ? pSize - b.offset :
+                                                     pBlockSize;
+          b.issued = 0;
+          b.owner  = 0;
+          b.copies = 0;
+          b.done   = false;
+        }
+        log->Debug( UtilityMsg, "Reading %ld bytes in %d blocks",
+                    pSize, nBlocks );
+      }
+      else if( pSize != size )
+      {
+        log->Warning( UtilityMsg, "Source %s reports %ld bytes, expected "
+                      "%ld", src.url.GetURL().c_str(), size, pSize );
+        *st = XRootDStatus( stError, errDataError );
+      }
+    }
+
+    if( st->IsOK() )
+      log->Debug( UtilityMsg, "Source %s is ready", src.url.GetURL().c_str() );
+    else
+      Fail( src, *st );
+
+    if( pReleased )
+      Shut( src );
+    else
+      FeedAll();
+    pCond.Broadcast();
+
+    bool gone = pReleased && Idle();
+    pCond.UnLock();
+
+    delete st;
+    if( gone )
+      delete this;
+  }
+
+  //----------------------------------------------------------------------------
+  // Handle a read response - called from the callback threads
+  //----------------------------------------------------------------------------
+  void XtremeReader::Done( ReadHandler *req, XRootDStatus *st,
+                           AnyObject *resp )
+  {
+    Log *log = DefaultEnv::GetLog();
+    pCond.Lock();
+
+    Source &src = pSources[req->source];
+    Block  &blk = pBlocks[req->block];
+    --pInFlight;
+    --src.inFlight;
+    --blk.copies;
+    src.pending -= blk.length;
+
+    //--------------------------------------------------------------------------
+    // Check what we got
+    //--------------------------------------------------------------------------
+    ChunkInfo *chunk = 0;
+    if( st->IsOK() && resp )
+      resp->Get( chunk );
+
+    if( st->IsOK() && ( !chunk || chunk->length != blk.length ) )
+    {
+      log->Warning( UtilityMsg, "Source %s returned %d bytes at %ld, "
+                    "expected %d", src.url.GetURL().c_str(),
+                    chunk ? chunk->length : 0, blk.offset, blk.length );
+      *st = XRootDStatus( stError, errDataError );
+    }
+
+    if( st->IsOK() )
+    {
+      src.last      = Now();
+      src.received += blk.length;
+      if( blk.done )
+      {
+        ++src.wasted;
+        delete [] req->buffer;
+      }
+      else
+      {
+        blk.done = true;
+        src.bytes += blk.length;
+        ++src.blocks;
+        pReady.push_back( ChunkInfo( blk.offset, blk.length, req->buffer ) );
+      }
+    }
+    //--------------------------------------------------------------------------
+    // Give up on the source and put the block back into the pool unless
+    // somebody else is still reading it
+    //--------------------------------------------------------------------------
+    else
+    {
+      delete [] req->buffer;
+      Fail( src, *st );
+      if( !blk.done && !blk.copies )
+        pFree.push_back( req->block );
+    }
+
+    if( pReleased )
+      Shut( src );
+    else
+      FeedAll();
+    pCond.Broadcast();
+
+    bool gone = pReleased && Idle();
+    pCond.UnLock();
+
+    delete req;
+    delete st;
+    delete resp;
+    if( gone )
+      delete this;
+  }
+
+  //----------------------------------------------------------------------------
+  // Give up on a source, called with the lock held
+  //----------------------------------------------------------------------------
+  void XtremeReader::Fail( Source &src, const XRootDStatus &st )
+  {
+    pLastError = st;
+    if( src.failed )
+      return;
+
+    DefaultEnv::GetLog()->Warning( UtilityMsg, "Giving up on source %s: %s",
+                                   src.url.GetURL().c_str(),
+                                   st.ToStr().c_str() );
+    src.failed = true;
+  }
+
+  //----------------------------------------------------------------------------
+  // Keep all the sources busy, called with the lock held
+  //----------------------------------------------------------------------------
+  void XtremeReader::FeedAll()
+  {
+    bool usable = false;
+    pBudget = 0;
+    for( uint16_t i = 0; i < pSources.size(); ++i )
+    {
+      if( pSources[i].failed )
+        continue;
+      usable = true;
+      if( !pSources[i].opening )
+        pBudget += pParallel;
+    }
+
+    for( uint16_t i = 0; i < pSources.size(); ++i )
+      Feed( i );
+
+    if( !usable && pError.IsOK() &&
+        pDelivered + pReady.size() < pBlocks.size() )
+      pError = pLastError.IsOK() ? XRootDStatus( stError, errInternal ) :
+                                   pLastError;
+  }
+
+  //----------------------------------------------------------------------------
+  // Fill the read window of a source, called with the lock held
+  //----------------------------------------------------------------------------
+  void XtremeReader::Feed( uint16_t idx )
+  {
+    Source &src = pSources[idx];
+    if( src.failed || src.opening )
+      return;
+
+    uint32_t window = Window( src, Now() );
+    while( src.inFlight < window && pInFlight + pReady.size() < pBudget )
+    {
+      bool stolen = false;
+      int  b      = NextBlock( idx, stolen );
+      if( b < 0 )
+        return;
+
+      Block       &blk = pBlocks[b];
+      char        *buf = new char[blk.length];
+      ReadHandler *h   = new ReadHandler( this, idx, b, buf );
+      XRootDStatus st  = src.file->Read( blk.offset, blk.length, buf, h );
+      if( !st.IsOK() )
+      {
+        delete h;
+        delete [] buf;
+        Fail( src, st );
+        if( !blk.done && !blk.copies )
+          pFree.push_back( b );
+        return;
+      }
+
+      if( !src.start ) src.start = h->issued;
+      if( stolen ) ++src.stolen;
+      blk.issued = h->issued;
+      blk.owner  = idx;
+      ++blk.copies;
+      ++src.inFlight;
+      ++pInFlight;
+      src.pending += blk.length;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Nothing is in flight anymore
+  //----------------------------------------------------------------------------
+  bool XtremeReader::Idle() const
+  {
+    return !pInFlight && !pOpening;
+  }
+
+  //----------------------------------------------------------------------------
+  // Pick the block a source should read next, -1 if none
+  //----------------------------------------------------------------------------
+  int XtremeReader::NextBlock( uint16_t idx, bool &stolen )
+  {
+    //--------------------------------------------------------------------------
+    // Blocks that a failed source gave back and fresh ones come first
+    //--------------------------------------------------------------------------
+    while( !pFree.empty() )
+    {
+      uint32_t b = pFree.front();
+      pFree.pop_front();
+      if( !pBlocks[b].done && !pBlocks[b].copies )
+        return b;
+    }
+
+    if( pNextBlock < pBlocks.size() )
+      return pNextBlock++;
+
+    //--------------------------------------------------------------------------
+    // End-game: the sources drain their queues at their own pace, so find
+    // the outstanding block whose owner needs the most time to get through
+    // what it has been asked for and steal it if we can deliver it sooner.
+    // A source that has not delivered anything yet is assumed to be stuck.
+    //--------------------------------------------------------------------------
+    const Source &thief = pSources[idx];
+    double now  = Now();
+    double rate = Rate( thief, now );
+    if( !rate )
+      return -1;
+
+    double latest = 0;
+    double issued = 0;
+    int    victim = -1;
+
+    for( uint32_t i = 0; i < pBlocks.size(); ++i )
+    {
+      const Block &blk = pBlocks[i];
+      if( blk.done || !blk.copies || blk.copies >= MaxCopies ||
+          blk.owner == idx )
+        continue;
+
+      const Source &owner = pSources[blk.owner];
+      double ownerRate = Rate( owner, now );
+      double theirs    = ownerRate ? owner.pending / ownerRate : Forever;
+      double mine      = (thief.pending + blk.length) / rate;
+      if( theirs < mine * StealMargin )
+        continue;
+
+      //------------------------------------------------------------------------
+      // Of the blocks of the slowest owner, take the one it asked for last
+      //------------------------------------------------------------------------
+      if( theirs > latest || (theirs == latest && blk.issued > issued) )
+      {
+        latest = theirs;
+        issued = blk.issued;
+        victim = i;
+      }
+    }
+
+    if( victim >= 0 )
+      stolen = true;
+    return victim;
+  }
+
+  //----------------------------------------------------------------------------
+  // Average throughput of a source
+  //----------------------------------------------------------------------------
+  double XtremeReader::Rate( const Source &src, double now ) const
+  {
+    if( !src.inFlight )
+      now = src.last;
+    if( !src.received || now <= src.start )
+      return 0;
+    return src.received / (now - src.start);
+  }
+
+  //----------------------------------------------------------------------------
+  // Close a source that has nothing in flight, called with the lock held
+  //----------------------------------------------------------------------------
+  void XtremeReader::Shut( Source &src )
+  {
+    if( !src.file || src.opening || src.inFlight )
+      return;
+
+    File *file = src.file;
+    src.file   = 0;
+    if( !file->IsOpen() )
+    {
+      delete file;
+      return;
+    }
+
+    CloseHandler *h = new CloseHandler( file );
+    if( !file->Close( h ).IsOK() )
+    {
+      delete h;
+      delete file;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+  // Number of reads a source may have in flight - the sources that are slower
+  // than the best one get proportionally fewer so that they do not hoard the
+  // blocks that the faster ones would read sooner
+  //----------------------------------------------------------------------------
+  uint32_t XtremeReader::Window( const Source &src, double now ) const
+  {
+    double rate = Rate( src, now );
+    if( !rate )
+      return pParallel;
+
+    double best = 0;
+    for( uint32_t i = 0; i < pSources.size(); ++i )
+    {
+      double r = pSources[i].failed ? 0 : Rate( pSources[i], now );
+      if( r > best ) best = r;
+    }
+
+    uint32_t window = (uint32_t)(pParallel * rate / best + 0.999);
+    return window < 1 ? 1 : window;
+  }
+}
@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+// Author: Lukasz Janyst <ljanyst@cern.ch>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#ifndef __XRD_CL_XTREME_READER_HH__
+#define __XRD_CL_XTREME_READER_HH__
+
+#include "XrdCl/XrdClURL.hh"
+#include "XrdCl/XrdClXRootDResponses.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <stdint.h>
+
+namespace XrdCl
+{
+  class File;
+
+  //----------------------------------------------------------------------------
+  //! Read a file from several replicas at once (extreme copy)
+  //!
+  //! The file is split into blocks that are handed out on demand to the
+  //! sources, each of which keeps a window of asynchronous reads in flight.
+  //! The window of a source shrinks with its throughput relative to the
+  //! fastest one, so that faster replicas fetch more blocks. Once no
+  //! unassigned blocks remain (end-game), an idle source re-requests the
+  //! outstanding block that its owner would need the most time to deliver;
+  //! whichever copy comes back first is used and the other one is dropped.
+  //! Chunks are returned in completion order, not in offset order.
+  //!
+  //! The sources are opened asynchronously and join the transfer as soon as
+  //! they are ready, so a replica that cannot be reached does not hold it up.
+  //! For the same reason the object is not deleted but released, it goes
+  //! away by itself when the last outstanding request comes back.
+  //----------------------------------------------------------------------------
+  class XtremeReader
+  {
+    public:
+      //------------------------------------------------------------------------
+      //! Per-source transfer statistics
+      //------------------------------------------------------------------------
+      struct SourceStats
+      {
+        std::string url;        //!< the replica
+        uint64_t    bytes;      //!< bytes delivered to the caller
+        uint32_t    blocks;     //!< blocks delivered to the caller
+        uint32_t    stolen;     //!< blocks re-requested from slower sources
+        uint32_t    wasted;     //!< blocks that arrived after another copy
+        double      rate;       //!< average throughput in bytes per second
+        bool        failed;     //!< the source has been given up on
+      };
+
+      //------------------------------------------------------------------------
+      //! Constructor
+      //!
+      //! @param sources   the replicas of the file
+      //! @param blockSize size of the scheduling unit
+      //! @param parallel  maximum number of reads in flight per source
+      //------------------------------------------------------------------------
+      XtremeReader( const std::vector<URL> &sources,
+                    uint32_t                blockSize,
+                    uint8_t                 parallel );
+
+      //------------------------------------------------------------------------
+      //! Start opening all the sources and wait until the first one is ready,
+      //! the sources that fail or disagree about the size are dropped
+      //------------------------------------------------------------------------
+      XRootDStatus Initialize();
+
+      //------------------------------------------------------------------------
+      //! Get the size of the file
+      //------------------------------------------------------------------------
+      int64_t GetSize() const
+      {
+        return pSize;
+      }
+
+      //------------------------------------------------------------------------
+      //! Get the next data chunk, the buffer needs to be deleted by the user
+      //!
+      //! @return suContinue - there are some chunks left
+      //!         suDone     - no chunks left
+      //------------------------------------------------------------------------
+      XRootDStatus GetChunk( ChunkInfo &ci );
+
+      //------------------------------------------------------------------------
+      //! Get the data server of the first healthy source
+      //------------------------------------------------------------------------
+      std::string GetDataServer();
+
+      //------------------------------------------------------------------------
+      //! Get the statistics of all the sources
+      //------------------------------------------------------------------------
+      void GetStats( std::vector<SourceStats> &stats );
+
+      //------------------------------------------------------------------------
+      //! Release the reader, must be called instead of deleting it. The
+      //! sources are closed and the object is freed once the requests still
+      //! in flight come back.
+      //------------------------------------------------------------------------
+      void Release();
+
+    private:
+      ~XtremeReader();
+      XtremeReader(const XtremeReader &other);
+      XtremeReader &operator = (const XtremeReader &other);
+
+      struct Block
+      {
+        uint64_t offset;
+        double   issued;     // when the last copy was requested
+        uint32_t length;
+        uint16_t owner;      // source that got the last copy
+        uint8_t  copies;     // copies in flight
+        bool     done;
+      };
+
+      struct Source
+      {
+        URL       url;
+        File     *file;
+        double    start;     // first request
+        double    last;      // last completed request
+        uint64_t  received;  // including the copies that were dropped
+        uint64_t  pending;   // bytes in flight
+        uint64_t  bytes;
+        uint32_t  blocks;
+        uint32_t  stolen;
+        uint32_t  wasted;
+        uint32_t  inFlight;
+        bool      opening;
+        bool      failed;
+      };
+
+      class OpenHandler;
+      class ReadHandler;
+      friend class OpenHandler;
+      friend class ReadHandler;
+
+      void     Opened( uint16_t idx, XRootDStatus *st );
+      void     Done( ReadHandler *req, XRootDStatus *st, AnyObject *resp );
+      void     Fail( Source &src, const XRootDStatus &st );
+      void     Feed( uint16_t idx );
+      void     FeedAll();
+      bool     Idle() const;
+      int      NextBlock( uint16_t idx, bool &stolen );
+      double   Rate( const Source &src, double now ) const;
+      void     Shut( Source &src );
+      uint32_t Window( const Source &src, double now ) const;
+
+      std::vector<Source>    pSources;
+      std::vector<Block>     pBlocks;
+      std::deque<uint32_t>   pFree;        // blocks returned by failed sources
+      std::deque<ChunkInfo>  pReady;       // completed, not yet delivered
+      XrdSysCondVar          pCond;
+      XRootDStatus           pError;       // fatal, returned to the user
+      XRootDStatus           pLastError;   // last failure of any source
+      int64_t                pSize;
+      uint32_t               pBlockSize;
+      uint32_t               pNextBlock;   // first block never handed out
+      uint32_t               pDelivered;
+      uint32_t               pInFlight;
+      uint32_t               pOpening;
+      uint32_t               pBudget;      // max blocks in flight or ready
+      uint8_t                pParallel;
+      bool                   pReleased;
+  };
+}
+
+#endif // __XRD_CL_XTREME_READER_HH__
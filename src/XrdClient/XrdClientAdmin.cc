@@ -998,7 +998,8 @@ bool  XrdClientAdmin::DirList(const char *dir,
       fConnModule->ClearLastServerError();
 
       int precentries = entries.GetSize();
-      if (!DirList_low(dir, entries)) {
+      vecString dstat;
+      if (!DirList_low(dir, entries, &dstat)) {
          if ((fConnModule->LastServerError.errnum != kXR_NotFound) && (fConnModule->LastServerError.errnum != kXR_noErrorYet)) {
             ret = false;
             break;
@@ -1023,7 +1024,12 @@ bool  XrdClientAdmin::DirList(const char *dir,
          info.flags = 0;
          info.modtime = 0;
 
-         if (!Stat(info.fullpath.c_str(),
+         // Servers supporting kXR_dstat already sent us the stat info,
+         // otherwise we have to ask for it entry by entry
+         if (dstat.GetSize() == newentries-precentries)
+            sscanf(dstat[k-precentries].c_str(), "%ld %lld %ld %ld",
+                   &info.id, &info.size, &info.flags, &info.modtime);
+         else if (!Stat(info.fullpath.c_str(),
                    info.id,
                    info.size,
                    info.flags,
@@ -1050,9 +1056,44 @@ bool  XrdClientAdmin::DirList(const char *dir,
 
 
 //_____________________________________________________________________________
-bool  XrdClientAdmin::DirList_low(const char *dir, vecString &entries) {
+bool  XrdClientAdmin::DirListStat(const char *dir,
+                                  XrdClientVector<XrdClientAdmin::DirListInfo> &dirlistinfo,
+                                  bool &hasstat) {
+   // Get an ls-like output from the current server with the stat information
+   // for each entry, but only if the server can send it along with the list
+   vecString entries, dstat;
+   DirListInfo info;
+
+   hasstat = false;
+   if (!DirList_low(dir, entries, &dstat)) return false;
+   hasstat = (dstat.GetSize() == entries.GetSize());
+
+   info.host = GetCurrentUrl().HostWPort;
+   for (int k = 0; k < entries.GetSize(); k++) {
+      info.fullpath = dir;
+      if (info.fullpath[info.fullpath.length()-1] != '/') info.fullpath += "/";
+      info.fullpath += entries[k];
+      info.size = 0;
+      info.id = 0;
+      info.flags = 0;
+      info.modtime = 0;
+      if (hasstat)
+         sscanf(dstat[k].c_str(), "%ld %lld %ld %ld",
+                &info.id, &info.size, &info.flags, &info.modtime);
+      dirlistinfo.Push_back(info);
+   }
+
+   return true;
+}
+
+//_____________________________________________________________________________
+bool  XrdClientAdmin::DirList_low(const char *dir, vecString &entries,
+                                  vecString *dstat) {
    bool ret;
-   // asks the server for the content of a directory
+   // asks the server for the content of a directory. If dstat is given we
+   // also ask for the stat information of each entry. A server supporting
+   // that starts the response with a "." entry and follows each name with
+   // its stat line; older servers just send the names and dstat stays empty.
    ClientRequest DirListFileRequest;
    kXR_char *dl;
   
@@ -1064,6 +1105,7 @@ bool  XrdClientAdmin::DirList_low(const char *dir, vecString &entries) {
    DirListFileRequest.header.requestid = kXR_dirlist;
 
    DirListFileRequest.dirlist.dlen = strlen(dir);
+   if (dstat) DirListFileRequest.dirlist.options[0] = kXR_dstat;
   
    // Note that the connmodule has to dynamically alloc the space for the answer
    ret = fConnModule->SendGenCommand(&DirListFileRequest, dir,
@@ -1075,6 +1117,8 @@ bool  XrdClientAdmin::DirList_low(const char *dir, vecString &entries) {
       kXR_char *startp = dl, *endp = dl;
       char entry[1024];
       XrdOucString e;
+      bool isdstat = false;
+      int nlines = 0;
 
       while (startp) {
 
@@ -1087,9 +1131,25 @@ bool  XrdClientAdmin::DirList_low(const char *dir, vecString &entries) {
 	    strcpy(entry, (char *)startp);
       
 
-         if (strlen(entry) && strcmp((char *)entry, ".") && strcmp((char *)entry, "..")) {
-	    e = entry;
-	    entries.Push_back(e);
+         if (dstat && !nlines && !strcmp((char *)entry, ".")) isdstat = true;
+
+         if (isdstat) {
+            // Names and stat lines alternate, the first pair is the leadin
+            if (strlen(entry)) {
+               if (nlines > 1) {
+                  e = entry;
+                  if (nlines & 1) dstat->Push_back(e);
+                     else entries.Push_back(e);
+               }
+               nlines++;
+            }
+         }
+         else {
+            if (strlen(entry) && strcmp((char *)entry, ".") && strcmp((char *)entry, "..")) {
+	       e = entry;
+	       entries.Push_back(e);
+            }
+            nlines++;
          }
 
 
@@ -63,7 +63,8 @@ struct XrdClientLocate_Info {
 class XrdClientAdmin : public XrdClientAbs {
 
    XrdOucString                    fInitialUrl;
-   bool                            DirList_low(const char *dir, vecString &entries);
+   bool                            DirList_low(const char *dir, vecString &entries,
+                                               vecString *dstat = 0);
    int                             LocalLocate(kXR_char *path,
 					       XrdClientVector<XrdClientLocate_Info> &res,
 					       bool writable, int opts, bool all = false);
@@ -117,6 +118,14 @@ class XrdClientAdmin : public XrdClientAbs {
                                            XrdClientVector<DirListInfo> &dirlistinfo,
                                            bool askallservers=false);
 
+   // Lists a directory on the current server only and, when the server
+   // supports the kXR_dstat option, fills in the stat information of each
+   // entry from the same response. Otherwise hasstat is set to false and
+   // only fullpath and host are valid; no stat request is ever issued.
+   bool                            DirListStat(const char *dir,
+                                               XrdClientVector<DirListInfo> &dirlistinfo,
+                                               bool &hasstat);
+
    bool                            ExistFiles(vecString&,
                                               vecBool&);
 
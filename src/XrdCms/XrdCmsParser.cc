@@ -392,10 +392,29 @@ int XrdCmsParser::mapError(int ecode)
 int XrdCmsParser::Pack(int rnum, struct iovec *iovP, struct iovec *iovE,
                        char *Base, char *Work)
 {
+   XrdCmsRRData  *Data = (XrdCmsRRData *)Base;
    XrdOucPupArgs *PArgs;
    const char    *reason;
    char           buff[16];
-   int            iovcnt;
+   int            iovcnt, totLen;
+
+// Use a compiled codec if we have one. If it fails, the general packer below
+// will produce the appropriate diagnostic.
+//
+   switch(rnum)
+         {case kYR_locate: case kYR_select:
+               iovcnt = locCodec::Pack(iovP, iovE, Data, Work, totLen);
+               break;
+          case kYR_statfs: case kYR_gone: case kYR_try: case kYR_have:
+          case kYR_state:
+               iovcnt = pthCodec::Pack(iovP, iovE, Data, Work, totLen);
+               break;
+          default: iovcnt = 0;
+         }
+   if (iovcnt)
+      {Data->Request.datalen = htons(static_cast<unsigned short>(totLen));
+       return iovcnt;
+      }
 
 // Pack the request
 //
@@ -411,3 +430,27 @@ int XrdCmsParser::Pack(int rnum, struct iovec *iovP, struct iovec *iovE,
    Say.Emsg("Pack", "Unable to pack request;", reason, buff);
    return 0;
 }
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                U n p a c k                                 */
+/******************************************************************************/
+
+// Unpack requests for which we have a compiled codec. A zero return means the
+// caller must use the general unpacker, which also diagnoses bad requests.
+  
+int XrdCmsParser::Unpack(int rnum, const char *Aps, const char *Apt,
+                         XrdCmsRRData *Data)
+{
+   switch(rnum)
+         {case kYR_locate: case kYR_select:
+               return locCodec::Unpack(Aps, Apt, Data);
+          case kYR_statfs: case kYR_gone: case kYR_try: case kYR_have:
+          case kYR_state:
+               return pthCodec::Unpack(Aps, Apt, Data);
+          default: break;
+         }
+   return 0;
+}
@@ -34,6 +34,7 @@
 
 #include "XrdCms/XrdCmsRRData.hh"
 #include "XrdOuc/XrdOucPup.hh"
+#include "XrdOuc/XrdOucPupCodec.hh"
 
 /******************************************************************************/
 /*                    C l a s s   X r d C m s P a r s e r                     */
@@ -65,7 +66,9 @@ inline int            Parse(XrdCms::CmsLoginData *Data,
 
 inline int            Parse(int rnum, const char *Aps, const char *Apt, 
                             XrdCmsRRData *Data)
-                           {Data->Opaque = Data->Opaque2 = Data->Path = 0;
+                           {int n;
+                            Data->Opaque = Data->Opaque2 = Data->Path = 0;
+                            if ((n = Unpack(rnum, Aps, Apt, Data))) return n;
                             return rnum < XrdCms::kYR_MaxReq 
                                    && vecArgs[rnum] != 0
                                    && Pup.Unpack(Aps, Apt,
@@ -82,6 +85,26 @@ static XrdOucPupArgs *PupArgs(int rnum)
 
 private:
 
+// Compiled codecs for requests on the redirector hot path. They must mirror
+// the corresponding XrdOucPupArgs tables below as those are used to diagnose
+// and handle anything the codecs do not accept.
+//
+typedef XrdOucPupCodec<XrdCmsRRData,
+                       PUPstr(XrdCmsRRData, Ident),
+                       PUPint(XrdCmsRRData, Opts),
+                       PUPstr(XrdCmsRRData, Path),
+                       PUPdlen(XrdCmsRRData, PathLen),
+                       PUPfence(XrdCmsRRData),
+                       PUPcstr(XrdCmsRRData, Opaque),
+                       PUPstr(XrdCmsRRData, Avoid)> locCodec; // locArgs
+
+typedef XrdOucPupCodec<XrdCmsRRData,
+                       PUPstr(XrdCmsRRData, Path),
+                       PUPdlen(XrdCmsRRData, PathLen)> pthCodec; // pthArgs
+
+static int            Unpack(int rnum, const char *Aps, const char *Apt,
+                             XrdCmsRRData *Data);
+
 static const char   **PupNVec;
 static XrdOucPupNames PupName;
 
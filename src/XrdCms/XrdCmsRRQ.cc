@@ -54,10 +54,6 @@ using namespace XrdCms;
   
 XrdCmsRRQ             XrdCms::RRQ;
 
-XrdSysMutex           XrdCmsRRQSlot::myMutex;
-XrdCmsRRQSlot        *XrdCmsRRQSlot::freeSlot = 0;
-short                 XrdCmsRRQSlot::initSlot = 0;
-
 /******************************************************************************/
 /*                    E x t e r n a l   F u n c t i o n s                     */
 /******************************************************************************/
@@ -69,6 +65,27 @@ void *XrdCmsRRQ_StartRespond(void *parg) {return RRQ.Respond();}
 /******************************************************************************/
 /*               X r d C m s R R Q   C l a s s   M e t h o d s                */
 /******************************************************************************/
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdCmsRRQ::XrdCmsRRQ() : isWaiting(0), isReady(0), send_node(0), send_num(0),
+                         send_vnum(0), send_tot(0),
+                         luFast(0), luSlow(0), rdFast(0), rdSlow(0),
+                         Tslice(178), Tdelay(5), tmoIdle(1), myClock(0)
+{
+   int i;
+
+// Number the slots and distribute them among the shards. Slot zero is never
+// used as a zero slot number means no slot.
+//
+   for (i = numSlots-1; i > 0; i--)
+       {Slot[i].slotNum = i;
+        Slot[i].Cont = Shards[i % numShards].freeSlot;
+        Shards[i % numShards].freeSlot = &Slot[i];
+       }
+}
+
 /******************************************************************************/
 /*                                   A d d                                    */
 /******************************************************************************/
@@ -76,37 +93,67 @@ void *XrdCmsRRQ_StartRespond(void *parg) {return RRQ.Respond();}
 short XrdCmsRRQ::Add(short Snum, XrdCmsRRQInfo *Info)
 {
 // EPNAME("RRQ Add");
-   XrdCmsRRQSlot *sp;
-
-// Obtain a slot and fill it in
-//
-   if (!(sp = XrdCmsRRQSlot::Alloc(Info))) return 0;
-// DEBUG("adding slot " <<sp->slotNum);
+   XrdCmsRRQSlot *sp, *pp;
+   Shard *shP;
+   int i, n, wasIdle;
 
 // If a slot number given, check if it's the right slot and it is still queued.
 // If so, piggy-back this request to existing one and make a fast exit
 //
-   myMutex.Lock(); Stats.Add2Q++;
-   if (Snum && Slot[Snum].Info.Key == Info->Key && Slot[Snum].Expire)
-      {if (Info->isLU)
-          {sp->LkUp = Slot[Snum].LkUp;
-           Slot[Snum].LkUp = sp;
-          } else {
-           sp->Cont = Slot[Snum].Cont;
-           Slot[Snum].Cont = sp;
+   if (Snum > 0 && Snum < numSlots)
+      {shP = &Shards[Snum % numShards];
+       shP->Mutex.Lock();
+       pp = &Slot[Snum];
+       if (pp->Info.Key == Info->Key && pp->Expire
+       &&  (sp = getWait(shP, Info)))
+          {if (Info->isLU)
+              {sp->LkUp = pp->LkUp;
+               pp->LkUp = sp;
+              } else {
+               sp->Cont = pp->Cont;
+               pp->Cont = sp;
+              }
+           shP->Stats.Add2Q++; shP->Stats.PBack++;
+           shP->Mutex.UnLock();
+           return Snum;
           }
-       Stats.PBack++;
-       myMutex.UnLock();
-       return Snum;
+       shP->Mutex.UnLock();
       }
 
-// Queue this slot to the pending response queue and tell the timeout scheduler
+// Obtain a slot, preferably from the shard the key hashes to. We peek at the
+// other shards' free lists without the lock to avoid locking them all when
+// we are out of slots; the list is checked again once the lock is held.
 //
+   n = static_cast<int>((reinterpret_cast<unsigned long>(Info->Key) >> 6)
+                        % numShards);
+   sp = 0;
+   for (i = 0; i < numShards; i++)
+       {shP = &Shards[(n+i) % numShards];
+        if (i && !shP->freeSlot) continue;
+        shP->Mutex.Lock();
+        if ((sp = shP->freeSlot)) break;
+        shP->Mutex.UnLock();
+       }
+   if (!sp) return 0;
+// DEBUG("adding slot " <<sp->slotNum);
+
+// Fill it in and queue it to the pending response queue
+//
+   shP->freeSlot = sp->Cont;
+   sp->Info = *Info;
+   sp->Cont = sp->LkUp = 0;
+   sp->Arg1 = sp->Arg2 = 0;
    sp->Expire = myClock+1;
-   if (waitQ.Singleton()) isWaiting.Post();
-   waitQ.Prev()->Insert(&sp->Link);
-   myMutex.UnLock();
-   return sp->slotNum;
+   shP->Stats.Add2Q++;
+   wasIdle = shP->waitQ.Singleton();
+   shP->waitQ.Prev()->Insert(&sp->Link);
+   n = sp->slotNum;
+   shP->Mutex.UnLock();
+
+// Tell the timeout scheduler if this is the first pending request
+//
+   if (wasIdle) Wakeup();
+   return static_cast<short>(n);
 }
 
 /******************************************************************************/
@@ -124,14 +171,14 @@ void XrdCmsRRQ::Del(short Snum, const void *Key)
   
 int XrdCmsRRQ::Init(int Tint, int Tdly)
 {
-   int rc;
+   int rc, i;
    pthread_t tid;
 
 // Set values
 //
    if (Tint) Tslice = Tint;
    if (Tdly) Tdelay = Tdly;
-   memset(&Stats, 0, sizeof(Stats));
+   for (i = 0; i < numShards; i++) Shards[i].Stats = Info();
 
 // Fill out the response structure
 //
@@ -198,13 +245,16 @@ int XrdCmsRRQ::Ready(int Snum, const void *Key, SMask_t mask1, SMask_t mask2)
 {
 // EPNAME("RRQ Ready");
    XrdCmsRRQSlot *sp;
+   Shard *shP;
 
 // Check if it's the right slot and it is still queued.
 //
-   myMutex.Lock();
+   if (Snum <= 0 || Snum >= numSlots) return 1;
+   shP = &Shards[Snum % numShards];
+   shP->Mutex.Lock();
    sp = &Slot[Snum];
    if (sp->Info.Key != Key || !sp->Expire)
-      {myMutex.UnLock();
+      {shP->Mutex.UnLock();
 //     DEBUG("slot " <<Snum <<" no longer valid");
        return 1;
       }
@@ -213,23 +263,26 @@ int XrdCmsRRQ::Ready(int Snum, const void *Key, SMask_t mask1, SMask_t mask2)
 // a fixed differentiation mask. Accumulate the 1st but replace the 2nd.
 //
    sp->Arg1 |= mask1; sp->Arg2 = mask2;
-   Stats.Resp++;
+   shP->Stats.Resp++;
 
 // Check if we should still hold on to this slot because the number of actual
 // responders is less than the number needed.
 //
    if (sp->Info.actR < sp->Info.minR)
-      {sp->Info.actR++; Stats.Multi++;
-       myMutex.UnLock();
+      {sp->Info.actR++; shP->Stats.Multi++;
+       shP->Mutex.UnLock();
        return 0;
       }
 
-// Move the element from the waiting queue to the ready queue
+// Move the element from the waiting queue to the ready queue. It may already
+// be in the ready queue if another response arrived in the interim.
 //
+   readyMutex.Lock();
    sp->Link.Remove();
    if (readyQ.Singleton()) isReady.Post();
    readyQ.Prev()->Insert(&sp->Link);
-   myMutex.UnLock();
+   readyMutex.UnLock();
+   shP->Mutex.UnLock();
 // DEBUG("readied slot " <<Snum <<" mask " <<mask);
    return 1;
 }
@@ -242,16 +295,26 @@ void *XrdCmsRRQ::Respond()
 {
 // EPNAME("RRQ Respond");
    XrdCmsRRQSlot *sp;
+   Shard *shP;
 
 // In an endless loop, process all ready elements
 //
    do {isReady.Wait();     // DEBUG("responder awoken");
-   do {myMutex.Lock();
-       Stats.rdFast += rdFast; Stats.rdSlow += rdSlow;
-       Stats.luFast += luFast; Stats.luSlow += luSlow;
-       if (readyQ.Singleton()) {myMutex.UnLock(); break;}
-       sp = readyQ.Next()->Item(); sp->Link.Remove(); sp->Expire = 0;
-       myMutex.UnLock();
+   do {readyMutex.Lock();
+       if (readyQ.Singleton()) {readyMutex.UnLock(); break;}
+       sp = readyQ.Next()->Item(); sp->Link.Remove();
+       readyMutex.UnLock();
+
+    // Freeze the slot so that nothing more can be piggy-backed on it. As we
+    // did not hold the shard lock, a late response may have requeued it.
+    //
+       shP = &Shards[sp->slotNum % numShards];
+       shP->Mutex.Lock();
+       readyMutex.Lock();
+       if (!sp->Link.Singleton()) sp->Link.Remove();
+       readyMutex.UnLock();
+       sp->Expire = 0;
+       shP->Mutex.UnLock();
 
     // A locate request can be pggy-backed on a select request and vice-versa
     // We separate the two queues here as each has a different response.
@@ -269,7 +332,7 @@ void *XrdCmsRRQ::Respond()
               }
            sendRedResp(sp);
           }
-       sp->Recycle();
+       Recycle(sp);
       } while(1);
       } while(1);
 
@@ -278,6 +341,212 @@ void *XrdCmsRRQ::Respond()
    return (void *)0;
 }
 
+/******************************************************************************/
+/*                            S t a t i s t i c s                             */
+/******************************************************************************/
+  
+void XrdCmsRRQ::Statistics(Info &Data)
+{
+   int i;
+
+// Sum up the shard statistics
+//
+   Data = Info();
+   for (i = 0; i < numShards; i++)
+       {Shards[i].Mutex.Lock();
+        Data.Add2Q += Shards[i].Stats.Add2Q;
+        Data.PBack += Shards[i].Stats.PBack;
+        Data.Resp  += Shards[i].Stats.Resp;
+        Data.Multi += Shards[i].Stats.Multi;
+        Shards[i].Mutex.UnLock();
+       }
+
+// The response counters are only updated by the responder thread
+//
+   Data.luFast = luFast; Data.luSlow = luSlow;
+   Data.rdFast = rdFast; Data.rdSlow = rdSlow;
+}
+
+/******************************************************************************/
+/*                               T i m e O u t                                */
+/******************************************************************************/
+  
+void *XrdCmsRRQ::TimeOut()
+{
+// EPNAME("RRQ TimeOut");
+   XrdCmsRRQSlot *sp;
+   Shard *shP;
+   int i, numPend;
+
+// We measure millisecond intervals to timeout waiting requests. We used to zero
+// out arg1/2 to force expiration, but they would be zero anyway if no responses
+// occurred. Now with qdn we need to leave them alone as we may have defered
+// a fast dispatch because we were waiting for more than one responder.
+//
+   while(1)
+        {isWaiting.Wait();
+         while(1)
+              {myClock++;
+               XrdSysTimer::Wait(Tslice);
+               numPend = 0;
+               for (i = 0; i < numShards; i++)
+                   {shP = &Shards[i];
+                    shP->Mutex.Lock();
+                    if (!shP->waitQ.Singleton())
+                       {readyMutex.Lock();
+                        while((sp=shP->waitQ.Next()->Item())
+                           && sp->Expire < myClock)
+                             {sp->Link.Remove();
+                              if (readyQ.Singleton()) isReady.Post();
+//                            sp->Arg1 = 0; sp->Arg2 = 0;
+//                            DEBUG("expired slot " <<sp->slotNum);
+                              readyQ.Prev()->Insert(&sp->Link);
+                             }
+                        readyMutex.UnLock();
+                        if (!shP->waitQ.Singleton()) numPend++;
+                       }
+                    shP->Mutex.UnLock();
+                   }
+               if (numPend) continue;
+
+            // Nothing is pending, go idle. A request added after we looked at
+            // its shard will see that we are idle and wake us up; one added
+            // before that must be found by a final look at all the shards.
+            //
+               tmoMutex.Lock(); tmoIdle = 1; tmoMutex.UnLock();
+               for (i = 0; i < numShards && !numPend; i++)
+                   {Shards[i].Mutex.Lock();
+                    if (!Shards[i].waitQ.Singleton()) numPend = 1;
+                    Shards[i].Mutex.UnLock();
+                   }
+               if (!numPend) break;
+               tmoMutex.Lock();
+               if (tmoIdle) {tmoIdle = 0; tmoMutex.UnLock();}
+                  else {tmoMutex.UnLock(); isWaiting.Wait();}
+              }
+        }
+
+// Keep the compiler happy
+//
+   return (void *)0;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 F l u s h                                  */
+/******************************************************************************/
+
+// Send all of the responses queued for a node in one go. Caller must hold the
+// RTable lock so that the node object remains valid.
+  
+void XrdCmsRRQ::Flush()
+{
+   if (send_num)
+      {send_node->Send(send_iov, send_vnum, send_tot);
+       send_num = send_vnum = send_tot = 0;
+      }
+   send_node = 0;
+}
+
+/******************************************************************************/
+/*                               g e t W a i t                                */
+/******************************************************************************/
+
+// Caller must hold the shard mutex
+  
+XrdCmsRRQSlot *XrdCmsRRQ::getWait(Shard *shP, XrdCmsRRQInfo *Info)
+{
+   static const int wAlloc = 64;
+   XrdCmsRRQSlot *sp;
+   int i;
+
+// Allocate more waiter slots if we have none and we can still do so. These
+// are never freed but are, of course, reused.
+//
+   if (!shP->freeWait)
+      {if (shP->numWait >= maxWait) return 0;
+       sp = new XrdCmsRRQSlot[wAlloc];
+       for (i = 0; i < wAlloc; i++)
+           {sp[i].Cont = shP->freeWait; shP->freeWait = &sp[i];}
+       shP->numWait += wAlloc;
+      }
+
+// Fill out the waiter slot
+//
+   sp = shP->freeWait;
+   shP->freeWait = sp->Cont;
+   sp->Info = *Info;
+   sp->Cont = sp->LkUp = 0;
+   sp->Arg1 = sp->Arg2 = 0;
+   return sp;
+}
+
+/******************************************************************************/
+/*                                 Q u e u e                                  */
+/******************************************************************************/
+
+// Queue a response for a node, sending what we have queued so far if this is
+// a different node or we have as many as we can send at once. Most responses
+// for a popular file go to the same redirector so this avoids a write per
+// response. Caller must hold the RTable lock and call Flush() when done.
+  
+void XrdCmsRRQ::Queue(XrdCmsNode *nP, XrdCms::CmsResponse &rsp, kXR_unt32 sid,
+                      struct iovec *dP, int bytes)
+{
+   if (nP != send_node || send_num >= maxBatch) {Flush(); send_node = nP;}
+
+   send_hdr[send_num] = rsp;
+   send_hdr[send_num].Hdr.streamid = sid;
+   send_iov[send_vnum].iov_base = (char *)&send_hdr[send_num];
+   send_iov[send_vnum].iov_len  = sizeof(rsp);
+   send_vnum++;
+   if (dP) send_iov[send_vnum++] = *dP;
+   send_tot += bytes;
+   send_num++;
+}
+
+/******************************************************************************/
+/*                               R e c y c l e                                */
+/******************************************************************************/
+  
+void XrdCmsRRQ::Recycle(XrdCmsRRQSlot *rP)
+{
+   Shard *shP = &Shards[rP->slotNum % numShards];
+   XrdCmsRRQSlot *sp, *np;
+
+   shP->Mutex.Lock();
+   if (!rP->Link.Singleton()) rP->Link.Remove();
+
+// Remove items in the lookup chain first
+//
+   np = rP->LkUp;
+   while((sp = np))
+        {np            = sp->LkUp;
+         sp->Cont      = shP->freeWait;
+         shP->freeWait = sp;
+         sp->Info.Key  = 0;
+        }
+
+// Now remove items in the select chain
+//
+   np = rP->Cont;
+   while((sp = np))
+        {np            = sp->Cont;
+         sp->Cont      = shP->freeWait;
+         shP->freeWait = sp;
+         sp->Info.Key  = 0;
+        }
+
+// Now put this item in the free chain
+//
+   rP->Info.Key  = 0;
+   rP->Cont      = shP->freeSlot;
+   shP->freeSlot = rP;
+   shP->Mutex.UnLock();
+}
+
 /******************************************************************************/
 /*                           s e n d L o c R e s p                            */
 /******************************************************************************/
@@ -320,11 +589,10 @@ void XrdCmsRRQ::sendLocResp(XrdCmsRRQSlot *lP)
 //
    RTable.Lock();
    do {if ((nP = RTable.Find(lP->Info.Rnum, lP->Info.Rinst)))
-          {dataResp.Hdr.streamid = lP->Info.ID;
-           nP->Send(data_iov, iov_cnt, bytes);
-          }
+          Queue(nP, dataResp, lP->Info.ID, &data_iov[1], bytes);
        luFast++;
       } while((lP = lP->LkUp));
+   Flush();
    RTable.UnLock();
 }
 
@@ -341,12 +609,13 @@ void XrdCmsRRQ::sendLwtResp(XrdCmsRRQSlot *rP)
 //
    RTable.Lock();
 do{if ((nP = RTable.Find(rP->Info.Rnum, rP->Info.Rinst)))
-      {waitResp.Hdr.streamid = rP->Info.ID; luSlow++;
-       nP->Send((char *)&waitResp, sizeof(waitResp));
+      {luSlow++;
+       Queue(nP, waitResp, rP->Info.ID, 0, sizeof(waitResp));
 //     DEBUG("Redirect delay " <<nP->Name() <<' ' <<Tdelay);
       }
 //    else {DEBUG("redirector " <<Info->Rnum <<'.' <<Info->Rinst <<"not found");}
   } while((rP = rP->LkUp));
+   Flush();
    RTable.UnLock();
 }
   
@@ -375,57 +644,32 @@ void XrdCmsRRQ::sendRedResp(XrdCmsRRQSlot *rP)
 //
    RTable.Lock();
 do{if ((nP = RTable.Find(rP->Info.Rnum, rP->Info.Rinst)))
-      {if (doredir){redrResp.Hdr.streamid = rP->Info.ID; rdFast++;
-                    nP->Send(redr_iov, iov_cnt, hlen);
+      {if (doredir){rdFast++;
+                    Queue(nP, redrResp, rP->Info.ID, &redr_iov[1], hlen);
 //                  DEBUG("Fast redirect " <<nP->Name() <<" -> " <<hostbuff);
                    }
-              else {waitResp.Hdr.streamid = rP->Info.ID; rdSlow++;
-                    nP->Send((char *)&waitResp, sizeof(waitResp));
+              else {rdSlow++;
+                    Queue(nP, waitResp, rP->Info.ID, 0, sizeof(waitResp));
 //                  DEBUG("Redirect delay " <<nP->Name() <<' ' <<Tdelay);
                    }
       } 
 //    else {DEBUG("redirector " <<Info->Rnum <<'.' <<Info->Rinst <<"not found");}
   } while((rP = rP->Cont));
+   Flush();
    RTable.UnLock();
 }
 
 /******************************************************************************/
-/*                               T i m e O u t                                */
+/*                                W a k e u p                                 */
 /******************************************************************************/
+
+// Wake up the timeout thread if it is idle
   
-void *XrdCmsRRQ::TimeOut()
+void XrdCmsRRQ::Wakeup()
 {
-// EPNAME("RRQ TimeOut");
-   XrdCmsRRQSlot *sp;
-
-// We measure millisecond intervals to timeout waiting requests. We used to zero
-// out arg1/2 to force expiration, but they would be zero anyway if no responses
-// occurred. Now with qdn we need to leave them alone as we may have defered
-// a fast dispatch because we were waiting for more than one responder.
-//
-   while(1)
-        {isWaiting.Wait();
-         myMutex.Lock();
-         while(1)
-              {myClock++;
-               myMutex.UnLock();
-               XrdSysTimer::Wait(Tslice);
-               myMutex.Lock();
-               while((sp=waitQ.Next()->Item()) && sp->Expire < myClock)
-                    {sp->Link.Remove();
-                     if (readyQ.Singleton()) isReady.Post();
-//                   sp->Arg1 = 0; sp->Arg2 = 0;
-//                   DEBUG("expired slot " <<sp->slotNum);
-                     readyQ.Prev()->Insert(&sp->Link);
-                    }
-               if (waitQ.Singleton()) break;
-              }
-         myMutex.UnLock();
-        }
-
-// Keep the compiler happy
-//
-   return (void *)0;
+   tmoMutex.Lock();
+   if (tmoIdle) {tmoIdle = 0; isWaiting.Post();}
+   tmoMutex.UnLock();
 }
 
 /******************************************************************************/
@@ -437,72 +681,9 @@ void *XrdCmsRRQ::TimeOut()
 
 XrdCmsRRQSlot::XrdCmsRRQSlot() : Link(this)
 {
-
-   slotNum  = initSlot++;
-   if (slotNum)
-      {Cont     = freeSlot;
-       freeSlot = this;
-      } else Cont = 0;
+   Cont = LkUp = 0;
    Arg1 = Arg2 = 0;
+   Expire  = 0;
+   slotNum = 0;
    Info.Key = 0;
 }
-
-/******************************************************************************/
-/*                                 A l l o c                                  */
-/******************************************************************************/
-  
-XrdCmsRRQSlot *XrdCmsRRQSlot::Alloc(XrdCmsRRQInfo *theInfo)
-{
-   XrdCmsRRQSlot *sp;
-
-   myMutex.Lock();
-   if ((sp = freeSlot))
-      {sp->Info = *theInfo;
-       freeSlot = sp->Cont;
-       sp->Cont = 0;
-       sp->LkUp = 0;
-       sp->Arg1 = 0;
-       sp->Arg2 = 0;
-      }
-   myMutex.UnLock();
-   return sp;
-}
-
-/******************************************************************************/
-/*                               R e c y c l e                                */
-/******************************************************************************/
-  
-void XrdCmsRRQSlot::Recycle()
-{
-   XrdCmsRRQSlot *sp, *np;
-
-   myMutex.Lock();
-   if (!Link.Singleton()) Link.Remove();
-
-// Remove items in the lookup chain first
-//
-   np = LkUp;
-   while((sp = np))
-        {np           = sp->LkUp;
-         sp->Cont     = freeSlot;
-         freeSlot     = sp;
-         sp->Info.Key = 0;
-        }
-
-// Now remove items in the select chain
-//
-   np = Cont;
-   while((sp = np))
-        {np           = sp->Cont;
-         sp->Cont     = freeSlot;
-         freeSlot     = sp;
-         sp->Info.Key = 0;
-        }
-
-// Now put this item in the free chain
-//
-   Info.Key = 0;
-   Cont     = freeSlot;
-   freeSlot = this;
-   myMutex.UnLock();
-}
@@ -38,6 +38,8 @@
 #include "XrdCms/XrdCmsTypes.hh"
 #include "XrdOuc/XrdOucDLlist.hh"
 #include "XrdSys/XrdSysPthread.hh"
+
+class XrdCmsNode;
   
 /******************************************************************************/
 /*                         X r d C m s R R Q I n f o                          */
@@ -74,19 +76,11 @@ class XrdCmsRRQSlot
 {
 friend class XrdCmsRRQ;
 
-static XrdCmsRRQSlot *Alloc(XrdCmsRRQInfo *Info);
-
-       void           Recycle();
-
        XrdCmsRRQSlot();
       ~XrdCmsRRQSlot() {}
 
 private:
 
-static   XrdSysMutex                 myMutex;
-static   XrdCmsRRQSlot              *freeSlot;
-static   short                       initSlot;
-
          XrdOucDLlist<XrdCmsRRQSlot> Link;
          XrdCmsRRQSlot              *Cont;
          XrdCmsRRQSlot              *LkUp;
@@ -94,7 +88,7 @@ static   short                       initSlot;
          SMask_t                     Arg1;
          SMask_t                     Arg2;
 unsigned int                         Expire;
-         int                         slotNum;
+         int                         slotNum;  // Zero for piggy-backed waiters
 };
 
 /******************************************************************************/
@@ -129,31 +123,64 @@ struct Info
        long long rdSlow;   // Slow redirects
       };
 
-void  Statistics(Info &Data) {myMutex.Lock(); Data = Stats; myMutex.UnLock();}
+void  Statistics(Info &Data);
 
 void *TimeOut();
 
-      XrdCmsRRQ() : isWaiting(0), isReady(0),
-                    luFast(0),    luSlow(0),  rdFast(0), rdSlow(0),
-                    Tslice(178),  Tdelay(5),  myClock(0) {}
+      XrdCmsRRQ();
      ~XrdCmsRRQ() {}
 
 private:
 
-void sendLocResp(XrdCmsRRQSlot *lP);
-void sendLwtResp(XrdCmsRRQSlot *rP);
-void sendRedResp(XrdCmsRRQSlot *rP);
-static const int numSlots = 1024;
+// Slots are partitioned into shards, each with its own lock, free lists, and
+// wait queue so that requests for different files do not contend. A slot
+// number always maps to the same shard. Requests piggy-backed on a pending
+// one (e.g. many clients opening the same new file) use waiter slots from an
+// expandable per-shard pool as they are never referenced by slot number.
+//
+struct Shard
+      {XrdSysMutex                 Mutex;
+       XrdCmsRRQSlot              *freeSlot;  // Free numbered slots
+       XrdCmsRRQSlot              *freeWait;  // Free waiter slots
+       XrdOucDLlist<XrdCmsRRQSlot> waitQ;
+       Info                        Stats;
+       int                         numWait;   // Waiter slots allocated
+
+       Shard() : freeSlot(0), freeWait(0), numWait(0) {}
+      ~Shard() {}
+      };
 
-         XrdSysMutex                   myMutex;
+void           Flush();
+XrdCmsRRQSlot *getWait(Shard *shP, XrdCmsRRQInfo *Info);
+void           Queue(XrdCmsNode *nP, XrdCms::CmsResponse &rsp, kXR_unt32 sid,
+                     struct iovec *dP, int bytes);
+void           Recycle(XrdCmsRRQSlot *sp);
+void           sendLocResp(XrdCmsRRQSlot *lP);
+void           sendLwtResp(XrdCmsRRQSlot *rP);
+void           sendRedResp(XrdCmsRRQSlot *rP);
+void           Wakeup();
+
+static const int numSlots  = 1024;
+static const int numShards = 16;
+static const int maxWait   = 8192;      // Per shard waiter slot limit
+static const int maxBatch  = 64;        // Responses per writev to a node
+
+         XrdSysMutex                   readyMutex;
+         XrdSysMutex                   tmoMutex;
          XrdSysSemaphore               isWaiting;
          XrdSysSemaphore               isReady;
          XrdCmsRRQSlot                 Slot[numSlots];
-         XrdOucDLlist<XrdCmsRRQSlot>   waitQ;
+         Shard                         Shards[numShards];
          XrdOucDLlist<XrdCmsRRQSlot>   readyQ;  // Redirect/Locate ready queue
 static   const int                     iov_cnt = 2;
          struct iovec                  data_iov[iov_cnt];
          struct iovec                  redr_iov[iov_cnt];
+         struct iovec                  send_iov[maxBatch*2];
+         XrdCms::CmsResponse           send_hdr[maxBatch];
+         XrdCmsNode                   *send_node;
+         int                           send_num;
+         int                           send_vnum;
+         int                           send_tot;
          XrdCms::CmsResponse           dataResp;
          XrdCms::CmsResponse           redrResp;
          XrdCms::CmsResponse           waitResp;
@@ -161,14 +188,14 @@ union   {char                          hostbuff[288];
          char                          databuff[XrdCms::CmsLocateRequest::RHLen
                                                *STMax];
         };
-         Info                          Stats;
-         int                           luFast;
-         int                           luSlow;
-         int                           rdFast;
-         int                           rdSlow;
+         long long                     luFast;
+         long long                     luSlow;
+         long long                     rdFast;
+         long long                     rdSlow;
          int                           Tslice;
          int                           Tdelay;
-unsigned int                           myClock;
+         int                           tmoIdle;
+volatile unsigned int                  myClock;
 };
 
 namespace XrdCms
@@ -265,6 +265,169 @@ void XrdFfsDent_cache_destroy()
         XrdFfsDent_dentcache_free(&XrdFfsDentCaches[i]);
 }
 
+/* managing caches for file attributes */
+
+struct XrdFfsDentattr {
+    char *path;
+    time_t t0;
+    struct stat st;
+    struct XrdFfsDentattr *next;
+};
+
+#define XrdFfsDent_NATTRHASH 4096
+#define XrdFfsDent_MAXATTRS 65536
+struct XrdFfsDentattr *XrdFfsDentAttrs[XrdFfsDent_NATTRHASH];
+int XrdFfsDentAttrs_count = 0;
+int XrdFfsDentAttrs_life = 0;
+long long XrdFfsDentAttrs_hits = 0;
+long long XrdFfsDentAttrs_misses = 0;
+pthread_mutex_t XrdFfsDentAttrs_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+unsigned int XrdFfsDent_attr_hash(const char *path)
+{
+    unsigned int h = 5381;
+    while (*path != '\0')
+        h = h * 33 + (unsigned char)*path++;
+    return h % XrdFfsDent_NATTRHASH;
+}
+
+/*
+   _unlink() removes *p from its hash chain and frees it, *p will point
+   to the next node. Caller must hold XrdFfsDentAttrs_mutex.
+ */
+void XrdFfsDent_attr_unlink(struct XrdFfsDentattr **p)
+{
+    struct XrdFfsDentattr *a = *p;
+
+    *p = a->next;
+    free(a->path);
+    free(a);
+    XrdFfsDentAttrs_count--;
+}
+
+void XrdFfsDent_attr_init(int life)
+{
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+    XrdFfsDentAttrs_life = (life > 0 ? life : 0);
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+}
+
+int XrdFfsDent_attr_life()
+{
+    return XrdFfsDentAttrs_life;
+}
+
+int XrdFfsDent_attr_get(const char *path, struct stat *stbuf)
+{
+    struct XrdFfsDentattr *a;
+    int rval = 0;
+
+    if (XrdFfsDentAttrs_life == 0) return 0;
+
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+    for (a = XrdFfsDentAttrs[XrdFfsDent_attr_hash(path)]; a != NULL; a = a->next)
+        if (! strcmp(a->path, path))
+        {
+            if (time(NULL) - a->t0 < XrdFfsDentAttrs_life)
+            {
+                memcpy(stbuf, &a->st, sizeof(struct stat));
+                rval = 1;
+            }
+            break;
+        }
+    if (rval) XrdFfsDentAttrs_hits++;
+        else  XrdFfsDentAttrs_misses++;
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+    return rval;
+}
+
+/*
+   _put() also reaps expired entries on the hash chain it walks. When the
+   cache is full new paths are simply not cached until entries expire.
+ */
+void XrdFfsDent_attr_put(const char *path, struct stat *stbuf)
+{
+    struct XrdFfsDentattr **p, *a;
+    unsigned int h;
+    time_t t1;
+
+    if (XrdFfsDentAttrs_life == 0) return;
+
+    h = XrdFfsDent_attr_hash(path);
+    t1 = time(NULL);
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+    p = &XrdFfsDentAttrs[h];
+    while (*p != NULL)
+    {
+        if (! strcmp((*p)->path, path))
+        {
+            memcpy(&(*p)->st, stbuf, sizeof(struct stat));
+            (*p)->t0 = t1;
+            pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+            return;
+        }
+        if (t1 - (*p)->t0 >= XrdFfsDentAttrs_life)
+            XrdFfsDent_attr_unlink(p);
+        else
+            p = &(*p)->next;
+    }
+    if (XrdFfsDentAttrs_count < XrdFfsDent_MAXATTRS)
+    {
+        a = (struct XrdFfsDentattr*) malloc(sizeof(struct XrdFfsDentattr));
+        a->path = strdup(path);
+        a->t0 = t1;
+        memcpy(&a->st, stbuf, sizeof(struct stat));
+        a->next = XrdFfsDentAttrs[h];
+        XrdFfsDentAttrs[h] = a;
+        XrdFfsDentAttrs_count++;
+    }
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+}
+
+/*
+   _drop() is used when a path is modified locally. The parent directory
+   is dropped too because its entries (and mtime) have changed.
+ */
+void XrdFfsDent_attr_drop(const char *path)
+{
+    struct XrdFfsDentattr **p;
+    char *parent, *slash;
+    int i;
+
+    if (XrdFfsDentAttrs_life == 0) return;
+
+    parent = strdup(path);
+    slash = strrchr(parent, '/');
+    if (slash == parent) slash[1] = '\0';
+    else if (slash != NULL) slash[0] = '\0';
+
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+    for (i = 0; i < 2; i++)
+    {
+        const char *dpath = (i == 0 ? path : parent);
+        p = &XrdFfsDentAttrs[XrdFfsDent_attr_hash(dpath)];
+        while (*p != NULL)
+        {
+            if (! strcmp((*p)->path, dpath))
+            {
+                XrdFfsDent_attr_unlink(p);
+                break;
+            }
+            p = &(*p)->next;
+        }
+    }
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+    free(parent);
+}
+
+void XrdFfsDent_attr_stats(long long *hits, long long *misses)
+{
+    pthread_mutex_lock(&XrdFfsDentAttrs_mutex);
+    *hits = XrdFfsDentAttrs_hits;
+    *misses = XrdFfsDentAttrs_misses;
+    pthread_mutex_unlock(&XrdFfsDentAttrs_mutex);
+}
+
 /*
 #include <stdio.h>
 
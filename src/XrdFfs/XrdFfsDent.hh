@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <time.h>
 #include <pthread.h>
+#include <sys/stat.h>
 
 #ifdef __cplusplus
   extern "C" {
@@ -51,6 +52,17 @@ void XrdFfsDent_cache_destroy();
 int  XrdFfsDent_cache_fill(char *dname, char ***dnarray, int nents);
 int  XrdFfsDent_cache_search(char *dname, char *dentname);
 
+/*
+   attribute cache: stat() results of paths, valid for 'life' seconds.
+   A life of 0 (the default) disables the cache.
+ */
+void XrdFfsDent_attr_init(int life);
+int  XrdFfsDent_attr_life();
+int  XrdFfsDent_attr_get(const char *path, struct stat *stbuf);
+void XrdFfsDent_attr_put(const char *path, struct stat *stbuf);
+void XrdFfsDent_attr_drop(const char *path);
+void XrdFfsDent_attr_stats(long long *hits, long long *misses);
+
 #ifdef __cplusplus
   }
 #endif
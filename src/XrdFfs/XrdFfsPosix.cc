@@ -48,6 +48,9 @@
 #include <syslog.h>
 #include "XrdFfs/XrdFfsPosix.hh"
 #include "XrdPosix/XrdPosixXrootd.hh"
+#include "XProtocol/XProtocol.hh"
+#include "XrdClient/XrdClientAdmin.hh"
+#include "XrdClient/XrdClientUrlInfo.hh"
 #include "XrdFfs/XrdFfsMisc.hh"
 #include "XrdFfs/XrdFfsDent.hh"
 #include "XrdFfs/XrdFfsQueue.hh"
@@ -407,10 +410,79 @@ int XrdFfsPosix_truncateall(const char *rdrurl, const char *path, off_t size, ui
 
 struct XrdFfsPosixX_readdirall_args {
     char *url;
+    const char *path;
     int *res;
     int *err;
     struct XrdFfsDentnames **dents;
 };
+
+/*
+   Fill a stat buffer from the stat info of a dirlist entry the way 
+   XrdFfsPosix_stat() would have done it.
+ */
+void XrdFfsPosix_x_dirstat(XrdClientAdmin::DirListInfo *info, struct stat *stbuf)
+{
+    memset(stbuf, 0, sizeof(struct stat));
+    stbuf->st_size = info->size;
+    stbuf->st_blocks = stbuf->st_size/512+1;
+    stbuf->st_atime = stbuf->st_mtime = stbuf->st_ctime = info->modtime;
+    stbuf->st_ino = info->id;
+    stbuf->st_nlink = 1;
+    stbuf->st_blksize = 64*1024;
+    stbuf->st_uid = getuid();
+    stbuf->st_gid = getgid();
+
+    if (info->flags & kXR_xset)     stbuf->st_mode |= S_IXUSR;
+    if (info->flags & kXR_readable) stbuf->st_mode |= S_IRUSR;
+    if (info->flags & kXR_writable) stbuf->st_mode |= S_IWUSR;
+    if (info->flags & kXR_isDir)    stbuf->st_mode |= S_IFDIR;
+    else if (info->flags & kXR_other)  /* HPSS, see XrdFfsPosix_stat() */
+        stbuf->st_mode |= ((stbuf->st_mode & S_IXUSR)? S_IFDIR : S_IFREG);
+    else
+        stbuf->st_mode |= S_IFREG;
+    if (info->flags & kXR_offline)  stbuf->st_mode |= S_ISVTX;
+    if (info->flags & kXR_poscpend) stbuf->st_mode |= S_ISUID;
+}
+
+/*
+   With the attribute cache enabled, list the directory with kXR_dstat so that
+   the stat info of all entries comes back in the same response and the
+   following getattr() calls (e.g. from "ls -l") are served from the cache.
+ */
+void XrdFfsPosix_x_readdirstat(struct XrdFfsPosixX_readdirall_args *args)
+{
+    XrdOucString str(args->url);
+    XrdClientUrlInfo url(str);
+    XrdClientAdmin adm(args->url);
+    XrdClientVector<XrdClientAdmin::DirListInfo> dinfo;
+    struct stat stbuf;
+    char entpath[1024];
+    const char *name;
+    bool hasstat;
+    int i, plen;
+
+    if (!adm.Connect() || !adm.DirListStat(url.File.c_str(), dinfo, hasstat))
+    {
+        *(args->err) = XrdPosixXrootd::mapError(adm.LastServerError()->errnum);
+        *(args->res) = -1;
+        return;
+    }
+
+    *(args->res) = 0;
+    plen = strlen(args->path);
+    if (plen > 0 && args->path[plen-1] == '/') plen--;
+    for (i = 0; i < dinfo.GetSize(); i++)
+    {
+        name = strrchr(dinfo[i].fullpath.c_str(), '/') + 1;
+        XrdFfsDent_names_add(args->dents, (char *)name);
+        if (hasstat && plen + strlen(name) + 2 <= sizeof(entpath))
+        {
+            sprintf(entpath, "%.*s/%s", plen, args->path, name);
+            XrdFfsPosix_x_dirstat(&dinfo[i], &stbuf);
+            XrdFfsDent_attr_put(entpath, &stbuf);
+        }
+    }
+}
  
 /*
    It seems xrootd posix return dp[i] != NULL even if the dir
@@ -427,6 +499,12 @@ void* XrdFfsPosix_x_readdirall(void* x)
     DIR *dp;
     struct dirent *de;
 
+    if (XrdFfsDent_attr_life() > 0)
+    {
+        XrdFfsPosix_x_readdirstat(args);
+        return NULL;
+    }
+
 /*
    Xrootd's Opendir will not return NULL even under some error. For instance,
    when it is supposed to return ENOENT or ENOTDIR, it actually returns 
@@ -489,6 +567,7 @@ int XrdFfsPosix_readdirall(const char *rdrurl, const char *path, char*** direnta
         strcat(newurls[i], path);
         XrdFfsMisc_xrd_secsss_editurl(newurls[i], user_uid);
         args[i].url = newurls[i];
+        args[i].path = path;
         args[i].err = &errno_i[i];
         args[i].res = &res_i[i];
         args[i].dents = &dir_i[i];
@@ -748,6 +827,8 @@ int XrdFfsPosix_statall(const char *rdrurl, const char *path, struct stat *stbuf
 
     char *p1, *p2, *dir, *file, rootpath[1024];
 
+    if (XrdFfsDent_attr_get(path, stbuf)) return 0;
+
     rootpath[0] = '\0';
     strcat(rootpath,rdrurl);
     strcat(rootpath,path);
@@ -768,6 +849,7 @@ int XrdFfsPosix_statall(const char *rdrurl, const char *path, struct stat *stbuf
          {
              free(p1);
              free(p2);
+             XrdFfsDent_attr_put(path, stbuf);
              return 0;
          }
     }
@@ -816,6 +898,7 @@ int XrdFfsPosix_statall(const char *rdrurl, const char *path, struct stat *stbuf
     for (i = 0; i < nurls; i++)
         free(newurls[i]);
 
+    if (res == 0) XrdFfsDent_attr_put(path, stbuf);
     return res;
 }
 
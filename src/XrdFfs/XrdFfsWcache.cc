@@ -1,5 +1,5 @@
 /******************************************************************************/
-/* XrdFfsWcache.cc simple write cache that captures consecutive small writes  */
+/* XrdFfsWcache.cc write-back cache that coalesces small writes               */
 /*                                                                            */
 /* (c) 2010 by the Board of Trustees of the Leland Stanford, Jr., University  */
 /*                            All Rights Reserved                             */
@@ -35,8 +35,19 @@
    Note that fuse 2.8.0 pre2 or above and kernel 2.6.27 or above provide
    a big_writes option to allow > 4KByte writing. It will make this 
    smiple write caching obsolete. 
+
+   Each open file keeps a list of dirty extents sorted by offset. Writes
+   that overlap or touch an extent are merged into it, so out of order and
+   rewritten small writes still reach the data server as a few large ones.
+   Once a file holds XrdFfsWcacheFlushsize dirty bytes, the extents are
+   handed to a XrdFfsQueue worker and written in the background (one such
+   write per file at a time to keep writes ordered). The dirty bytes of all
+   files in a mount are bounded by XROOTDFS_WCACHESZ (in MBytes); a writer
+   going over it flushes its own file and waits. Everything is written out
+   on read, ftruncate, fsync and close.
 */
 #define XrdFfsWcacheBufsize 131072
+#define XrdFfsWcacheFlushsize (XrdFfsWcacheBufsize * 8)
 
 #if defined(__linux__)
 /* For pread()/pwrite() */
@@ -45,6 +56,7 @@
 #endif
 #endif
 
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <sys/types.h>
@@ -55,6 +67,7 @@
 #include <pthread.h>
 
 #include "XrdFfs/XrdFfsWcache.hh"
+#include "XrdFfs/XrdFfsQueue.hh"
 #ifndef NOXRD
     #include "XrdFfs/XrdFfsPosix.hh"
 #endif
@@ -63,10 +76,21 @@
   extern "C" {
 #endif
 
-struct XrdFfsWcacheFilebuf {
+struct XrdFfsWcacheExtent {
     off_t offset;
     size_t len;
+    size_t size;
     char *buf;
+    struct XrdFfsWcacheExtent *next;
+};
+
+struct XrdFfsWcacheFilebuf {
+    int fd;
+    struct XrdFfsWcacheExtent *dirty;     /* sorted, never overlapping or adjacent */
+    size_t ndirty;
+    struct XrdFfsWcacheExtent *inflight;  /* being written by a queue worker */
+    struct XrdFfsQueueTasks *task;
+    int werrno;                           /* errno of a failed background write */
     pthread_mutex_t *mlock;
 };
 
@@ -75,11 +99,18 @@ struct XrdFfsWcacheFilebuf *XrdFfsWcacheFbufs;
 /* #include "xrdposix.h" */
 
 int XrdFfsWcacheNFILES;
+size_t XrdFfsWcacheMaxdirty = 64 * 1024 * 1024;
+size_t XrdFfsWcacheNdirty = 0;
+pthread_mutex_t XrdFfsWcacheNdirty_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 void XrdFfsWcache_init()
 {
-    int fd;
+    int fd, mb;
     struct rlimit rlp;
 
+    if (getenv("XROOTDFS_WCACHESZ") != NULL && sscanf(getenv("XROOTDFS_WCACHESZ"), "%d", &mb) == 1 && mb > 0)
+        XrdFfsWcacheMaxdirty = (size_t)mb * 1024 * 1024;
+
     getrlimit(RLIMIT_NOFILE, &rlp);
     XrdFfsWcacheNFILES = rlp.rlim_cur;
     XrdFfsWcacheNFILES = (XrdFfsWcacheNFILES == (int)RLIM_INFINITY? 4096 : XrdFfsWcacheNFILES);
@@ -88,22 +119,223 @@ void XrdFfsWcache_init()
     XrdFfsWcacheFbufs = (struct XrdFfsWcacheFilebuf*)malloc(sizeof(struct XrdFfsWcacheFilebuf) * XrdFfsWcacheNFILES);
     for (fd = 0; fd < XrdFfsWcacheNFILES; fd++)
     {
-        XrdFfsWcacheFbufs[fd].offset = 0;
-        XrdFfsWcacheFbufs[fd].len = 0;
-        XrdFfsWcacheFbufs[fd].buf = NULL;
+        XrdFfsWcacheFbufs[fd].fd = fd;
+        XrdFfsWcacheFbufs[fd].dirty = NULL;
+        XrdFfsWcacheFbufs[fd].ndirty = 0;
+        XrdFfsWcacheFbufs[fd].inflight = NULL;
+        XrdFfsWcacheFbufs[fd].task = NULL;
+        XrdFfsWcacheFbufs[fd].werrno = 0;
         XrdFfsWcacheFbufs[fd].mlock = NULL;
     }
 }
 
+/* keep track of the dirty bytes in the whole mount */
+static void XrdFfsWcache_account(ssize_t n)
+{
+    pthread_mutex_lock(&XrdFfsWcacheNdirty_mutex);
+    XrdFfsWcacheNdirty += n;
+    pthread_mutex_unlock(&XrdFfsWcacheNdirty_mutex);
+}
+
+static int XrdFfsWcache_overlimit()
+{
+    int over;
+    pthread_mutex_lock(&XrdFfsWcacheNdirty_mutex);
+    over = (XrdFfsWcacheNdirty > XrdFfsWcacheMaxdirty);
+    pthread_mutex_unlock(&XrdFfsWcacheNdirty_mutex);
+    return over;
+}
+
+static ssize_t XrdFfsWcache_pwrite_direct(int fd, char *buf, size_t len, off_t offset)
+{
+#ifndef NOXRD
+    return XrdFfsPosix_pwrite(fd, buf, len, offset);
+#else
+    return pwrite(fd, buf, len, offset);
+#endif
+}
+
+/* write out and free a list of extents. return 0 or the errno of the first failure */
+static int XrdFfsWcache_write_extents(int fd, struct XrdFfsWcacheExtent *ext)
+{
+    struct XrdFfsWcacheExtent *next;
+    size_t done, n = 0;
+    ssize_t rc;
+    int err = 0;
+
+    while (ext != NULL)
+    {
+        done = 0;
+        while (err == 0 && done < ext->len)
+        {
+            rc = XrdFfsWcache_pwrite_direct(fd, ext->buf + done, ext->len - done, ext->offset + done);
+            if (rc > 0)
+                done += rc;
+            else
+                err = (rc < 0 && errno != 0)? errno : EIO;
+        }
+        n += ext->len;
+        next = ext->next;
+        free(ext->buf);
+        free(ext);
+        ext = next;
+    }
+    XrdFfsWcache_account(-(ssize_t)n);
+    return err;
+}
+
+void *XrdFfsWcache_bgflush(void *arg)
+{
+    struct XrdFfsWcacheFilebuf *fbuf = (struct XrdFfsWcacheFilebuf*) arg;
+    int err;
+
+    err = XrdFfsWcache_write_extents(fbuf->fd, fbuf->inflight);
+    fbuf->inflight = NULL;
+    if (err != 0) 
+        fbuf->werrno = err;
+    return NULL;
+}
+
+/* the following routines are called with the file's mlock held */
+
+static void XrdFfsWcache_bgwait(struct XrdFfsWcacheFilebuf *fbuf)
+{
+    if (fbuf->task == NULL) 
+        return;
+    XrdFfsQueue_wait_task(fbuf->task);
+    XrdFfsQueue_free_task(fbuf->task);
+    fbuf->task = NULL;
+}
+
+static void XrdFfsWcache_bgstart(struct XrdFfsWcacheFilebuf *fbuf)
+{
+    int err;
+
+    XrdFfsWcache_bgwait(fbuf);
+    if (fbuf->dirty == NULL)
+        return;
+    if (XrdFfsQueue_count_workers() == 0)
+    {
+        err = XrdFfsWcache_write_extents(fbuf->fd, fbuf->dirty);
+        if (err != 0) 
+            fbuf->werrno = err;
+    }
+    else
+    {
+        fbuf->inflight = fbuf->dirty;
+        fbuf->task = XrdFfsQueue_create_task(XrdFfsWcache_bgflush, (void**)fbuf, 0);
+    }
+    fbuf->dirty = NULL;
+    fbuf->ndirty = 0;
+}
+
+static int XrdFfsWcache_syncflush(struct XrdFfsWcacheFilebuf *fbuf)
+{
+    int err = 0;
+
+    XrdFfsWcache_bgwait(fbuf);
+    if (fbuf->dirty != NULL)
+        err = XrdFfsWcache_write_extents(fbuf->fd, fbuf->dirty);
+    fbuf->dirty = NULL;
+    fbuf->ndirty = 0;
+    if (err == 0)
+        err = fbuf->werrno;
+    fbuf->werrno = 0;
+    return err;
+}
+
+static int XrdFfsWcache_insert(struct XrdFfsWcacheFilebuf *fbuf, const char *buf, size_t len, off_t offset)
+{
+    struct XrdFfsWcacheExtent *prev = NULL, *first, *ext, *next;
+    off_t lo = offset, hi = offset + len;
+    size_t need, size, merged = 0;
+    char *nbuf;
+
+/* find the first extent that overlaps or touches the new data */
+    first = fbuf->dirty;
+    while (first != NULL && (off_t)(first->offset + first->len) < offset)
+    {
+        prev = first;
+        first = first->next;
+    }
+
+/* nothing to merge with, add a new extent */
+    if (first == NULL || first->offset > hi)
+    {
+        size = (len > XrdFfsWcacheBufsize)? len : XrdFfsWcacheBufsize;
+        if ((ext = (struct XrdFfsWcacheExtent*)malloc(sizeof(struct XrdFfsWcacheExtent))) == NULL)
+            return -1;
+        if ((ext->buf = (char*)malloc(size)) == NULL)
+        {
+            free(ext);
+            return -1;
+        }
+        memcpy(ext->buf, buf, len);
+        ext->offset = offset;
+        ext->len = len;
+        ext->size = size;
+        ext->next = first;
+        if (prev != NULL) 
+            prev->next = ext;
+        else
+            fbuf->dirty = ext;
+        fbuf->ndirty += len;
+        XrdFfsWcache_account(len);
+        return 0;
+    }
+
+/* the union of the new data and all extents it overlaps or touches */
+    if (first->offset < lo)
+        lo = first->offset;
+    for (ext = first; ext != NULL && ext->offset <= hi; ext = ext->next)
+    {
+        if ((off_t)(ext->offset + ext->len) > hi)
+            hi = ext->offset + ext->len;
+        merged += ext->len;
+    }
+    need = hi - lo;
+
+/* grow the first extent so it can hold the union */
+    if (need > first->size)
+    {
+        size = first->size * 2;
+        if (size < need)
+            size = need;
+        if ((nbuf = (char*)realloc(first->buf, size)) == NULL)
+            return -1;
+        first->buf = nbuf;
+        first->size = size;
+    }
+    if (first->offset > lo)
+        memmove(first->buf + (first->offset - lo), first->buf, first->len);
+
+/* absorb the following extents and lay the new data on top of them */
+    ext = first->next;
+    while (ext != NULL && ext->offset <= hi)
+    {
+        memcpy(first->buf + (ext->offset - lo), ext->buf, ext->len);
+        next = ext->next;
+        free(ext->buf);
+        free(ext);
+        ext = next;
+    }
+    first->next = ext;
+    memcpy(first->buf + (offset - lo), buf, len);
+    first->offset = lo;
+    first->len = need;
+
+    fbuf->ndirty += need - merged;
+    XrdFfsWcache_account(need - merged);
+    return 0;
+}
+
 int XrdFfsWcache_create(int fd) 
 {
     XrdFfsWcache_destroy(fd);
 
-    XrdFfsWcacheFbufs[fd].offset = 0;
-    XrdFfsWcacheFbufs[fd].len = 0;
-    XrdFfsWcacheFbufs[fd].buf = (char*)malloc(XrdFfsWcacheBufsize);
-    if (XrdFfsWcacheFbufs[fd].buf == NULL)
-        return 0;
+    XrdFfsWcacheFbufs[fd].dirty = NULL;
+    XrdFfsWcacheFbufs[fd].ndirty = 0;
+    XrdFfsWcacheFbufs[fd].werrno = 0;
     XrdFfsWcacheFbufs[fd].mlock = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
     if (XrdFfsWcacheFbufs[fd].mlock == NULL)
         return 0;
@@ -114,13 +346,23 @@ int XrdFfsWcache_create(int fd)
 
 void XrdFfsWcache_destroy(int fd)
 {
+    struct XrdFfsWcacheExtent *ext, *next;
+    size_t n = 0;
+
 /*  XrdFfsWcache_flush(fd); */
     
-    XrdFfsWcacheFbufs[fd].offset = 0;
-    XrdFfsWcacheFbufs[fd].len = 0;
-    if (XrdFfsWcacheFbufs[fd].buf != NULL) 
-        free(XrdFfsWcacheFbufs[fd].buf);
-    XrdFfsWcacheFbufs[fd].buf = NULL;
+    XrdFfsWcache_bgwait(&XrdFfsWcacheFbufs[fd]);
+    for (ext = XrdFfsWcacheFbufs[fd].dirty; ext != NULL; ext = next)
+    {
+        next = ext->next;
+        n += ext->len;
+        free(ext->buf);
+        free(ext);
+    }
+    if (n != 0)
+        XrdFfsWcache_account(-(ssize_t)n);
+    XrdFfsWcacheFbufs[fd].dirty = NULL;
+    XrdFfsWcacheFbufs[fd].ndirty = 0;
     if (XrdFfsWcacheFbufs[fd].mlock != NULL)
     {
         pthread_mutex_destroy(XrdFfsWcacheFbufs[fd].mlock);
@@ -131,66 +373,79 @@ void XrdFfsWcache_destroy(int fd)
 
 ssize_t XrdFfsWcache_flush(int fd)
 {
-    ssize_t rc;
+    int err;
 
-    if (XrdFfsWcacheFbufs[fd].len == 0 || XrdFfsWcacheFbufs[fd].buf == NULL )
+    if (fd < 0 || fd >= XrdFfsWcacheNFILES || XrdFfsWcacheFbufs[fd].mlock == NULL)
         return 0;
 
-#ifndef NOXRD
-    rc = XrdFfsPosix_pwrite(fd, XrdFfsWcacheFbufs[fd].buf, XrdFfsWcacheFbufs[fd].len, XrdFfsWcacheFbufs[fd].offset);
-#else
-    rc =     pwrite(fd, XrdFfsWcacheFbufs[fd].buf, XrdFfsWcacheFbufs[fd].len, XrdFfsWcacheFbufs[fd].offset);
-#endif
-    if (rc > 0)
+    pthread_mutex_lock(XrdFfsWcacheFbufs[fd].mlock);
+    err = XrdFfsWcache_syncflush(&XrdFfsWcacheFbufs[fd]);
+    pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+    if (err != 0)
     {
-        XrdFfsWcacheFbufs[fd].offset = 0;
-        XrdFfsWcacheFbufs[fd].len = 0;
+        errno = err;
+        return -1;
     }
-    return rc;
+    return 0;
 }
 
 ssize_t XrdFfsWcache_pwrite(int fd, char *buf, size_t len, off_t offset)
 {
+    struct XrdFfsWcacheFilebuf *fbuf;
     ssize_t rc;
-    char *bufptr;
+    int err;
 
 /* do not use caching under these cases */
-    if (len > XrdFfsWcacheBufsize/2 || fd >= XrdFfsWcacheNFILES)
+    if (fd < 0 || fd >= XrdFfsWcacheNFILES || XrdFfsWcacheFbufs[fd].mlock == NULL)
+        return XrdFfsWcache_pwrite_direct(fd, buf, len, offset);
+
+    fbuf = &XrdFfsWcacheFbufs[fd];
+    pthread_mutex_lock(fbuf->mlock);
+
+/* a failed background write is reported by the next write */
+    if (fbuf->werrno != 0)
     {
-#ifndef NOXRD
-        rc = XrdFfsPosix_pwrite(fd, buf, len, offset);
-#else 
-        rc = pwrite(fd, buf, len, offset);
-#endif
-        return rc;
+        errno = fbuf->werrno;
+        fbuf->werrno = 0;
+        pthread_mutex_unlock(fbuf->mlock);
+        return -1;
     }
 
-    pthread_mutex_lock(XrdFfsWcacheFbufs[fd].mlock);
-    rc = XrdFfsWcacheFbufs[fd].len;
-/* 
-   in the following two cases, a XrdFfsWcache_flush is required:
-   1. current offset isnn't pointing to the tail of data in buffer
-   2. adding new data will exceed the current buffer 
-*/ 
-    if (offset != (off_t)(XrdFfsWcacheFbufs[fd].offset + XrdFfsWcacheFbufs[fd].len) ||
-        (off_t)(offset + len) > (XrdFfsWcacheFbufs[fd].offset + XrdFfsWcacheBufsize))
-        rc = XrdFfsWcache_flush(fd);
+/* large writes go directly to the server once all data before them is out */
+    if (len >= XrdFfsWcacheFlushsize)
+    {
+        if ((err = XrdFfsWcache_syncflush(fbuf)) == 0)
+            rc = XrdFfsWcache_pwrite_direct(fd, buf, len, offset);
+        else
+        {
+            errno = err;
+            rc = -1;
+        }
+        pthread_mutex_unlock(fbuf->mlock);
+        return rc;
+    }
 
     errno = 0;
-    if (rc < 0) 
+    if (XrdFfsWcache_insert(fbuf, buf, len, offset) != 0)
     {
-        errno = ENOSPC;
-        pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+        errno = ENOMEM;
+        pthread_mutex_unlock(fbuf->mlock);
         return -1;
     }
 
-    bufptr = &XrdFfsWcacheFbufs[fd].buf[XrdFfsWcacheFbufs[fd].len];
-    memcpy(bufptr, buf, len);
-    if (XrdFfsWcacheFbufs[fd].len == 0)
-        XrdFfsWcacheFbufs[fd].offset = offset;
-    XrdFfsWcacheFbufs[fd].len += len;
+/* 
+   write in the background once enough is collected. if the whole mount is
+   over its limit, push this file out and wait so that memory stays bounded
+*/
+    if (fbuf->ndirty >= XrdFfsWcacheFlushsize)
+        XrdFfsWcache_bgstart(fbuf);
+    else if (XrdFfsWcache_overlimit())
+    {
+        XrdFfsWcache_bgstart(fbuf);
+        XrdFfsWcache_bgwait(fbuf);
+    }
 
-    pthread_mutex_unlock(XrdFfsWcacheFbufs[fd].mlock);
+    pthread_mutex_unlock(fbuf->mlock);
     return (ssize_t)len;
 }
 
@@ -1,5 +1,5 @@
 /******************************************************************************/
-/* XrdFfsWcache.hh simple write cache that captures consecutive small writes  */
+/* XrdFfsWcache.hh write-back cache that coalesces small writes               */
 /*                                                                            */
 /* (c) 2010 by the Board of Trustees of the Leland Stanford, Jr., University  */
 /*                            All Rights Reserved                             */
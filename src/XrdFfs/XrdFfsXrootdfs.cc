@@ -64,7 +64,7 @@
 #include "XrdFfs/XrdFfsMisc.hh"
 #include "XrdFfs/XrdFfsWcache.hh"
 #include "XrdFfs/XrdFfsQueue.hh"
-//#include "XrdFfs/XrdFfsDent.hh"
+#include "XrdFfs/XrdFfsDent.hh"
 #include "XrdFfs/XrdFfsFsinfo.hh"
 #include "XrdPosix/XrdPosixXrootd.hh"
 
@@ -77,12 +77,13 @@ struct XROOTDFS {
     char *urlcachelife;
     bool ofsfwd;
     int  nworkers;
+    int  statcachelife;
 };
 
 int cwdfd; // File descript of the initial working dir
 
 struct XROOTDFS xrootdfs;
-static struct fuse_opt xrootdfs_opts[13];
+static struct fuse_opt xrootdfs_opts[14];
 
 enum { OPT_KEY_HELP, OPT_KEY_SECSSS, };
 
@@ -384,6 +385,7 @@ static int xrootdfs_mknod(const char *path, mode_t mode, dev_t rdev)
         if (res == -1)
             return -errno;
         XrdFfsPosix_close(res);
+        XrdFfsDent_attr_drop(path);
 /* We have to make sure CNS file is created as well, otherwise, xrootdfs_getattr()
    may or may not find this file (due to multi-threads) */
         if (xrootdfs.cns == NULL)
@@ -424,6 +426,7 @@ static int xrootdfs_mkdir(const char *path, mode_t mode)
     XrdFfsMisc_xrd_secsss_register(fuse_get_context()->uid, fuse_get_context()->gid);
     XrdFfsMisc_xrd_secsss_editurl(rootpath, fuse_get_context()->uid);
 
+    XrdFfsDent_attr_drop(path);
     res = XrdFfsPosix_mkdir(rootpath, mode);
     if (res == 0) return 0;
 /* 
@@ -457,6 +460,7 @@ static int xrootdfs_unlink(const char *path)
     else
         res = XrdFfsPosix_unlinkall(xrootdfs.rdr, path, fuse_get_context()->uid);
 
+    XrdFfsDent_attr_drop(path);
     if (res == -1)
         return -errno;
 
@@ -493,6 +497,7 @@ static int xrootdfs_rmdir(const char *path)
     else
         res = XrdFfsPosix_rmdirall(xrootdfs.rdr, path, fuse_get_context()->uid);
 
+    XrdFfsDent_attr_drop(path);
     if (res == -1)
         return -errno;
 
@@ -566,6 +571,8 @@ static int xrootdfs_rename(const char *from, const char *to)
     else
         res = XrdFfsPosix_renameall(xrootdfs.rdr, from, to, fuse_get_context()->uid);
 
+    XrdFfsDent_attr_drop(from);
+    XrdFfsDent_attr_drop(to);
     if (res == -1)
         return -errno;
     
@@ -637,6 +644,7 @@ static int xrootdfs_ftruncate(const char *path, off_t size,
     fd = (int) fi->fh;
     XrdFfsWcache_flush(fd);
     res = XrdFfsPosix_ftruncate(fd, size);
+    XrdFfsDent_attr_drop(path);
     if (res == -1)
         return -errno;
                                                                                                                               
@@ -676,6 +684,7 @@ static int xrootdfs_truncate(const char *path, off_t size)
     else
         res = XrdFfsPosix_truncateall(xrootdfs.rdr, path, size, fuse_get_context()->uid);
 
+    XrdFfsDent_attr_drop(path);
     if (res == -1)
         return -errno;
 
@@ -755,6 +764,7 @@ static int xrootdfs_write(const char *path, const char *buf, size_t size,
    truncate a file before calling xrootdfs_write() 
 */
     fd = (int) fi->fh;
+    XrdFfsDent_attr_drop(path);
 //    res = XrdFfsPosix_pwrite(fd, buf, size, offset);
     res = XrdFfsWcache_pwrite(fd, (char *)buf, size, offset);
     if (res == -1)
@@ -844,6 +854,8 @@ static int xrootdfs_release(const char *path, struct fuse_file_info *fi)
     XrdFfsWcache_destroy(fd);
     XrdFfsPosix_close(fd);
     fi->fh = 0;
+    if ((fi->flags & O_ACCMODE) != O_RDONLY)
+        XrdFfsDent_attr_drop(path);
 /* 
    Return at here because the current version of Cluster Name Space daemon 
    doesn't implement the 'truncate' functon we originally planned.
@@ -928,12 +940,23 @@ static int xrootdfs_release(const char *path, struct fuse_file_info *fi)
 static int xrootdfs_fsync(const char *path, int isdatasync,
                      struct fuse_file_info *fi)
 {
-    /* Just a stub.  This method is optional and can safely be left
-       unimplemented */
+    /* Write out everything held in the write cache for this file. */
 
     (void) path;
     (void) isdatasync;
-    (void) fi;
+    if (XrdFfsWcache_flush((int) fi->fh) == -1)
+        return -errno;
+    return 0;
+}
+
+static int xrootdfs_flush(const char *path, struct fuse_file_info *fi)
+{
+    /* Called on each close(); write out the cache so that errors of
+       background writes are reported to the application */
+
+    (void) path;
+    if (XrdFfsWcache_flush((int) fi->fh) == -1)
+        return -errno;
     return 0;
 }
 
@@ -1061,6 +1084,31 @@ static int xrootdfs_getxattr(const char *path, const char *name, char *value,
             return -1;
         }
     }
+    else if (!strcmp(name, "xrootdfs.fs.statcache"))
+    {
+        char statcache[64];
+        long long hits, misses;
+        XrdFfsDent_attr_stats(&hits, &misses);
+        sprintf(statcache, "life=%d hits=%lld misses=%lld", XrdFfsDent_attr_life(), hits, misses);
+
+        if (size == 0)
+            return strlen(statcache);
+        else if (size >= strlen(statcache))
+        {
+            size = strlen(statcache);
+            if (size != 0)
+            {
+                 value[0] = '\0';
+                 strcat(value, statcache);
+            }
+            return size;
+        }
+        else
+        {
+            errno = ERANGE;
+            return -1;
+        }
+    }
     else if (!strcmp(name, "xrootdfs.file.permission"))
     {
         char xattr[256];
@@ -1160,6 +1208,7 @@ static void xrootdfs_usage(const char *progname)
 "    -o refreshdslist=NNNs/m/h/d  refresh internal list of data servers in NNN sec/min/hour/day, default unit is second\n"
 "                                 Absents of this option will disable automatically refreshing\n"
 "    -o nworkers=N            number of workers to handle parallel requests to data servers, default 4\n"
+"    -o statcachelife=N       keep file attributes (from stat and readdir) for N seconds, default 10, 0 disables\n"
 "    -o fastls=RDR            set to RDR when CNS is presented will cause stat() to go to redirector\n"
 "\n", progname);
 }
@@ -1215,6 +1264,7 @@ int main(int argc, char *argv[])
     xrootdfs_oper.write		= xrootdfs_write;
     xrootdfs_oper.statfs	= xrootdfs_statfs;
     xrootdfs_oper.release	= xrootdfs_release;
+    xrootdfs_oper.flush		= xrootdfs_flush;
     xrootdfs_oper.fsync		= xrootdfs_fsync;
     xrootdfs_oper.setxattr	= xrootdfs_setxattr;
     xrootdfs_oper.getxattr	= xrootdfs_getxattr;
@@ -1288,7 +1338,12 @@ int main(int argc, char *argv[])
     xrootdfs_opts[11].offset = offsetof(struct XROOTDFS, nworkers);
     xrootdfs_opts[11].value = 0;
 
-    xrootdfs_opts[12].templ = NULL;
+/* life time of cached file attributes */
+    xrootdfs_opts[12].templ = "statcachelife=%d";
+    xrootdfs_opts[12].offset = offsetof(struct XROOTDFS, statcachelife);
+    xrootdfs_opts[12].value = 0;
+
+    xrootdfs_opts[13].templ = NULL;
 
 /* initialize struct xrootdfs */
 //    memset(&xrootdfs, 0, sizeof(xrootdfs));
@@ -1300,6 +1355,7 @@ int main(int argc, char *argv[])
     xrootdfs.ssskeytab = NULL;
     xrootdfs.urlcachelife = strdup("3650d"); /* 10 years */
     xrootdfs.nworkers = 4;
+    xrootdfs.statcachelife = 10;
 
 /* Get options from environment variables first */
     xrootdfs.rdr = getenv("XROOTDFS_RDRURL");
@@ -1309,6 +1365,7 @@ int main(int argc, char *argv[])
     xrootdfs.daemon_user = getenv("XROOTDFS_USER");
     if (getenv("XROOTDFS_OFSFWD") != NULL && ! strcmp(getenv("XROOTDFS_OFSFWD"),"1")) xrootdfs.ofsfwd = true;
     if (getenv("XROOTDFS_NWORKERS") != NULL) sscanf(getenv("XROOTDFS_NWORKERS"), "%d", &xrootdfs.nworkers);
+    if (getenv("XROOTDFS_STATCACHELIFE") != NULL) sscanf(getenv("XROOTDFS_STATCACHELIFE"), "%d", &xrootdfs.statcachelife);
 
 /* Parse XrootdFS options, will overwrite those defined in environment variables */
     fuse_opt_parse(&args, &xrootdfs, xrootdfs_opts, xrootdfs_opt_proc);
@@ -1343,6 +1400,7 @@ int main(int argc, char *argv[])
 
     XrdFfsMisc_xrd_init(xrootdfs.rdr,xrootdfs.urlcachelife,0);
     XrdFfsWcache_init();
+    XrdFfsDent_attr_init(xrootdfs.statcachelife);
     signal(SIGUSR1,xrootdfs_sigusr1_handler);
 
     cwdfd = open(".",O_RDONLY);
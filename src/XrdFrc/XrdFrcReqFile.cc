@@ -43,6 +43,7 @@
 #include "XrdFrc/XrdFrcTrace.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPlatform.hh"
+#include "XrdSys/XrdSysTimer.hh"
 
 using namespace XrdFrc;
 
@@ -52,11 +53,27 @@ using namespace XrdFrc;
   
 XrdSysMutex XrdFrcReqFile::rqMonitor::rqMutex;
 
+/******************************************************************************/
+/*                     E x t e r n a l   L i n k a g e s                      */
+/******************************************************************************/
+  
+void *XrdFrcReqFileCompact(void *pp)
+{
+   static const int compIntvl = 60;
+   XrdFrcReqFile *rqFile = (XrdFrcReqFile *)pp;
+
+   while(1)
+        {XrdSysTimer::Snooze(compIntvl);
+         rqFile->Compact();
+        }
+   return (void *)0;
+}
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
 
-XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal)
+XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal) : bCV(0)
 {
    char buff[1200];
 
@@ -66,6 +83,8 @@ XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal)
    lokFN = strdup(buff);
    lokFD = reqFD = -1;
    isAgent = aVal;
+   bFirst = bLast = 0;
+   bBusy = 0;
 }
   
 /******************************************************************************/
@@ -74,24 +93,33 @@ XrdFrcReqFile::XrdFrcReqFile(const char *fn, int aVal)
   
 void XrdFrcReqFile::Add(XrdFrcRequest *rP)
 {
-   rqMonitor rqMon(isAgent);
-   XrdFrcRequest tmpReq;
-   int fP;
 
-// Lock the file
+// Additions are committed together with whatever else is pending
 //
-   if (!FileLock()) {FailAdd(rP->LFN, 0); return;}
+   Batch(rP, 0);
+}
+  
+/******************************************************************************/
+/* Private:                       A d d O n e                                 */
+/******************************************************************************/
+  
+int XrdFrcReqFile::AddOne(XrdFrcRequest *rP, int &eofP)
+{
+   XrdFrcRequest tmpReq;
+   int fP;
 
-// Obtain a free slot
+// Obtain a free slot. The end of file is only obtained once per batch.
 //
    if ((fP = HdrData.Free))
-      {if (!reqRead((void *)&tmpReq, fP)) {FailAdd(rP->LFN, 1); return;}
+      {if (!reqRead((void *)&tmpReq, fP)) return 0;
        HdrData.Free = tmpReq.Next;
       } else {
-       struct stat buf;
-       if (fstat(reqFD, &buf))
-          {Say.Emsg("Add",errno,"stat",reqFN); FailAdd(rP->LFN, 1); return;}
-       fP = buf.st_size;
+       if (eofP < 0)
+          {struct stat buf;
+           if (fstat(reqFD, &buf)) {Say.Emsg("Add",errno,"stat",reqFN); return 0;}
+           eofP = buf.st_size;
+          }
+       fP = eofP; eofP += ReqSize;
       }
 
 // Chain in the request (registration requests go fifo)
@@ -101,20 +129,52 @@ void XrdFrcReqFile::Add(XrdFrcRequest *rP)
        HdrData.First = fP;
       } else {
        if (HdrData.First && HdrData.Last)
-          {if (!reqRead((void *)&tmpReq, HdrData.Last))
-              {FailAdd(rP->LFN, 1); return;}
+          {if (!reqRead((void *)&tmpReq, HdrData.Last)) return 0;
            tmpReq.Next = fP;
-           if (!reqWrite((void *)&tmpReq, HdrData.Last, 0))
-              {FailAdd(rP->LFN, 1); return;}
+           if (!reqWrite((void *)&tmpReq, HdrData.Last, 0)) return 0;
           } else HdrData.First = fP;
        HdrData.Last = fP; rP->Next = 0;
       }
 
-// Write out the file
+// Write out the request, the header is written when the batch is committed
 //
    rP->This = fP;
-   if (!reqWrite(rP, fP)) FailAdd(rP->LFN, 0);
-   FileLock(lkNone);
+   return reqWrite(rP, fP, 0);
+}
+
+/******************************************************************************/
+/* Private:                        B a t c h                                  */
+/******************************************************************************/
+
+// Requests are queued and whoever finds no commit in progress becomes the
+// leader: it applies everything queued so far under a single file lock and
+// writes the header and syncs the file once for the whole batch. Each caller
+// returns only after its own request has been committed.
+//
+void XrdFrcReqFile::Batch(XrdFrcRequest *rP, int isDel)
+{
+   reqBatch myReq(rP, isDel), *bP;
+
+// Add our request to the pending batch
+//
+   bCV.Lock();
+   if (bLast) bLast->Next = &myReq;
+      else    bFirst      = &myReq;
+   bLast = &myReq;
+
+// Wait until our request has been committed, leading a batch if need be
+//
+   while(!myReq.Done)
+        {if (bBusy) {bCV.Wait(); continue;}
+         bP = bFirst; bFirst = bLast = 0; bBusy = 1;
+         bCV.UnLock();
+         Commit(bP);
+         bCV.Lock();
+         while(bP) {bP->Done = 1; bP = bP->Next;}
+         bBusy = 0;
+         bCV.Broadcast();
+        }
+   bCV.UnLock();
 }
   
 /******************************************************************************/
@@ -159,25 +219,130 @@ void XrdFrcReqFile::Can(XrdFrcRequest *rP)
 }
   
 /******************************************************************************/
-/*                                   D e l                                    */
+/*                                C o m m i t                                 */
 /******************************************************************************/
 
-void XrdFrcReqFile::Del(XrdFrcRequest *rP)
+void XrdFrcReqFile::Commit(reqBatch *bP)
 {
    rqMonitor rqMon(isAgent);
-   XrdFrcRequest tmpReq;
+   reqBatch *xP;
+   int eofP = -1, aOK;
 
 // Lock the file
 //
-   if (!FileLock()) {FailDel(rP->LFN, 0); return;}
+   if (!FileLock())
+      {for (xP = bP; xP; xP = xP->Next)
+           if (xP->isDel) FailDel(xP->rP->LFN, 0);
+              else        FailAdd(xP->rP->LFN, 0);
+       return;
+      }
+
+// Apply each request. Should one fail we abandon the rest of the batch
+// without updating the header, just as a single failed request would.
+//
+   for (xP = bP; xP; xP = xP->Next)
+       {aOK = (xP->isDel ? DelOne(xP->rP) : AddOne(xP->rP, eofP));
+        if (!aOK) break;
+       }
+
+// Write out the header and sync the file for the whole batch
+//
+   if (!xP && reqWrite(0, 0, 1)) {FileLock(lkNone); return;}
 
-// Put entry on the free chain
+// Report what failed
+//
+   for (xP = bP; xP; xP = xP->Next)
+       if (xP->isDel) FailDel(xP->rP->LFN, 0);
+          else        FailAdd(xP->rP->LFN, 0);
+   FileLock(lkNone);
+}
+
+/******************************************************************************/
+/*                               C o m p a c t                                */
+/******************************************************************************/
+
+// Free slots at the end of the file are unlinked from the free chain and
+// the file is truncated. Nothing is moved, so the offsets of requests that
+// are being processed stay valid. The header is synced before truncating so
+// that a crash can at worst leave unreferenced free slots behind.
+//
+void XrdFrcReqFile::Compact()
+{
+   EPNAME("Compact");
+   static const int compMin = 64;
+   XrdFrcRequest tmpReq, prvReq;
+   struct stat buf;
+   int Offs, newEnd, fP, prvOff = 0, prvChg = 0, numFree = 0;
+
+// Lock the file and get its size
+//
+   if (!FileLock()) return;
+   if (fstat(reqFD, &buf))
+      {Say.Emsg("Compact",errno,"stat",reqFN); FileLock(lkNone); return;}
+
+// Count the free slots at the end of the file
+//
+   for (Offs = buf.st_size - ReqSize; Offs >= ReqSize; Offs -= ReqSize)
+       {if (!reqRead((void *)&tmpReq, Offs)) {FileLock(lkNone); return;}
+        if (*tmpReq.LFN || tmpReq.addTOD) break;
+        numFree++;
+       }
+   newEnd = Offs + ReqSize;
+   if (numFree < compMin) {FileLock(lkNone); return;}
+
+// Unlink the slots beyond the new end from the free chain
+//
+   fP = HdrData.Free;
+   while(fP)
+        {if (!reqRead((void *)&tmpReq, fP)) {FileLock(lkNone); return;}
+         if (fP >= newEnd)
+            {if (prvOff) {prvReq.Next = tmpReq.Next; prvChg = 1;}
+                else HdrData.Free = tmpReq.Next;
+            } else {
+             if (prvChg && !reqWrite((void *)&prvReq, prvOff, 0))
+                {FileLock(lkNone); return;}
+             prvReq = tmpReq; prvOff = fP; prvChg = 0;
+            }
+         fP = tmpReq.Next;
+        }
+   if (prvChg && !reqWrite((void *)&prvReq, prvOff, 0))
+      {FileLock(lkNone); return;}
+
+// Commit the chain and then shorten the file
+//
+   if (!reqWrite(0, 0, 1)) {FileLock(lkNone); return;}
+   if (ftruncate(reqFD, newEnd)) Say.Emsg("Compact",errno,"trunc",reqFN);
+      else DEBUG(numFree <<" free slots removed from " <<reqFN);
+   FileLock(lkNone);
+}
+  
+/******************************************************************************/
+/*                                   D e l                                    */
+/******************************************************************************/
+
+void XrdFrcReqFile::Del(XrdFrcRequest *rP)
+{
+
+// Deletions are committed together with whatever else is pending
+//
+   Batch(rP, 1);
+}
+
+/******************************************************************************/
+/* Private:                       D e l O n e                                 */
+/******************************************************************************/
+
+int XrdFrcReqFile::DelOne(XrdFrcRequest *rP)
+{
+   XrdFrcRequest tmpReq;
+
+// Put entry on the free chain, the header is written when the batch is
+// committed.
 //
    memset(&tmpReq, 0, sizeof(tmpReq));
    tmpReq.Next  = HdrData.Free;
    HdrData.Free = rP->This;
-   if (!reqWrite((void *)&tmpReq, rP->This)) FailDel(rP->LFN, 0);
-   FileLock(lkNone);
+   return reqWrite((void *)&tmpReq, rP->This, 0);
 }
 
 /******************************************************************************/
@@ -248,6 +413,7 @@ int XrdFrcReqFile::Init()
        HdrData.Free = ReqSize;
        if (!reqWrite((void *)&tmpReq, ReqSize)) return FailIni("init file");
        FileLock(lkNone);
+       if (!isAgent) RunCompact();
        return 1;
       }
 
@@ -296,9 +462,10 @@ int XrdFrcReqFile::Init()
          delete tP;
         }
 
-// All done
+// All done, start compacting the file in the background
 //
    FileLock(lkNone);
+   if (rc) RunCompact();
    return rc;
 }
   
@@ -539,6 +706,20 @@ int XrdFrcReqFile::reqRead(void *Buff, int Offs)
    return 1;
 }
 
+/******************************************************************************/
+/*                            R u n C o m p a c t                             */
+/******************************************************************************/
+  
+void XrdFrcReqFile::RunCompact()
+{
+   pthread_t tid;
+   int retc;
+
+   if ((retc = XrdSysThread::Run(&tid, XrdFrcReqFileCompact, (void *)this,
+                                 XRDSYSTHREAD_BIND, "Request compaction")))
+      Say.Emsg("Init", retc, "create compaction thread for", reqFN);
+}
+
 /******************************************************************************/
 /*                              r e q W r i t e                               */
 /******************************************************************************/
@@ -41,6 +41,8 @@ public:
 
        void   Can(XrdFrcRequest *rP);
 
+       void   Compact();
+
        void   Del(XrdFrcRequest *rP);
 
        int    Get(XrdFrcRequest *rP);
@@ -61,6 +63,19 @@ enum LockType {lkNone, lkShare, lkExcl, lkInit};
 
 static const int ReqSize  = sizeof(XrdFrcRequest);
 
+struct reqBatch
+      {reqBatch      *Next;
+       XrdFrcRequest *rP;
+       int            isDel;
+       int            Done;
+                      reqBatch(XrdFrcRequest *reqP, int dval)
+                              : Next(0), rP(reqP), isDel(dval), Done(0) {}
+      };
+
+int    AddOne(XrdFrcRequest *rP, int &eofP);
+void   Batch(XrdFrcRequest *rP, int isDel);
+void   Commit(reqBatch *bP);
+int    DelOne(XrdFrcRequest *rP);
 void   FailAdd(char *lfn, int unlk=1);
 void   FailCan(char *rid, int unlk=1);
 void   FailDel(char *lfn, int unlk=1);
@@ -68,9 +83,15 @@ int    FailIni(const char *lfn);
 int    FileLock(LockType ltype=lkExcl);
 int    reqRead(void *Buff, int Offs);
 int    reqWrite(void *Buff, int Offs, int updthdr=1);
+void   RunCompact();
 
 XrdSysMutex flMutex;
 
+XrdSysCondVar bCV;
+reqBatch     *bFirst;
+reqBatch     *bLast;
+int           bBusy;
+
 struct FileHdr
 {
 int    First;
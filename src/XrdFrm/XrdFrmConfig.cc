@@ -151,6 +151,7 @@ XrdFrmConfig::XrdFrmConfig(SubSys ss, const char *vopts, const char *uinfo)
    QPath    = 0;
    AdminMode= 0740;
    xfrMax   = 2;
+   memset(xfrQMax, 0, sizeof(xfrQMax));
    FailHold = 3*60*60;
    IdleHold = 10*60;
    WaitMigr = 60*60;
@@ -1413,8 +1414,15 @@ int XrdFrmConfig::xcnsd()
 
    Purpose:  To parse the directive: copycmd [Options] cmd [args]
 
-   Options:  [in] [noalloc] [out] [rmerr] [stats] [timeout <sec>] [url] [xpd]
+   Options:  [agent] [in] [noalloc] [out] [rmerr] [stats] [timeout <sec>]
+             [url] [xpd]
 
+             agent     the command is a long-lived copy agent. It is started
+                       once per transfer thread and each transfer is sent to
+                       it as a line holding the substituted arguments. The
+                       agent must reply, in order, with a line holding the
+                       ending status of the copy optionally followed by
+                       program data (see xpd).
              in        use command for incomming copies.
              noalloc   do not pre-allocate space for incomming copies.
              out       use command for outgoing copies.
@@ -1429,10 +1437,11 @@ int XrdFrmConfig::xcnsd()
 */
 int XrdFrmConfig::xcopy()
 {  int cmdIO[2] = {0,0}, TLim=0, Stats=0, hasMDP=0, cmdUrl=0, noAlo=0, rmErr=0;
-   int monPD = 0;
+   int monPD = 0, isAgent = 0;
    char *val, *theCmd = 0;
    struct copyopts {const char *opname; int *oploc;} cpopts[] =
          {
+          {"agent",  &isAgent},
           {"in",     &cmdIO[0]},
           {"out",    &cmdIO[1]},
           {"noalloc",&noAlo},
@@ -1481,6 +1490,7 @@ int XrdFrmConfig::xcopy()
            if (monPD)  xfrCmd[n].Opts  |= cmdXPD;
            if (hasMDP) xfrCmd[n].Opts  |= cmdMDP;
            if (rmErr)  xfrCmd[n].Opts  |= cmdRME;
+           if (isAgent)xfrCmd[n].Opts  |= cmdAgent;
            if (noAlo)  xfrCmd[n].Opts  &=~cmdAlloc;
               else     xfrCmd[n].Opts  |= cmdAlloc;
            xfrCmd[n].TLimit = TLim;
@@ -1512,20 +1522,38 @@ int XrdFrmConfig::xcopy(int &TLim)
 
 /* Function: copymax
 
-   Purpose:  To parse the directive: copymax  <num>
+   Purpose:  To parse the directive: copymax  <num> [<queue> <qnum>] [...]
 
              <num>     maximum number of simultaneous transfers
+             <queue>   one of stage, migr, copyin, or copyout.
+             <qnum>    maximum number of simultaneous transfers for <queue>.
+                       It is capped by <num>; the default is <num>.
 
    Output: 0 upon success or !0 upon failure.
 */
 int XrdFrmConfig::xcmax()
-{   int xmax = 1;
+{   static const char *qName[] = {"stage", "migr", "copyin", "copyout"};
+    int i, xmax = 1, qmax[4] = {0, 0, 0, 0};
     char *val;
 
     if (!(val = cFile->GetWord()))
        {Say.Emsg("Config", "maxio value not specified"); return 1;}
     if (XrdOuca2x::a2i(Say, "maxio", val, &xmax, 1)) return 1;
+
+    while((val = cFile->GetWord()))
+         {for (i = 0; i < 4; i++) if (!strcmp(val, qName[i])) break;
+          if (i >= 4)
+             {Say.Emsg("Config", "invalid copymax queue -", val); return 1;}
+          if (!(val = cFile->GetWord()))
+             {Say.Emsg("Config", qName[i], "copymax value not specified");
+              return 1;
+             }
+          if (XrdOuca2x::a2i(Say, "copymax queue value", val, &qmax[i], 1))
+             return 1;
+         }
+
     xfrMax = xmax;
+    for (i = 0; i < 4; i++) xfrQMax[i] = (qmax[i] < xmax ? qmax[i] : 0);
     return 0;
 }
 
@@ -81,6 +81,7 @@ static const int    cmdMDP   = 0x0002;
 static const int    cmdStats = 0x0004;
 static const int    cmdXPD   = 0x0008;
 static const int    cmdRME   = 0x0010;
+static const int    cmdAgent = 0x0020;
 
 int                 xfrIN;
 int                 xfrOUT;
@@ -98,6 +99,7 @@ int                 cmdHold;
 int                 AdminMode;
 int                 isAgent;
 int                 xfrMax;
+int                 xfrQMax[4]; // Per-queue limit indexed by queue number
 int                 FailHold;
 int                 IdleHold;
 int                 WaitQChk;
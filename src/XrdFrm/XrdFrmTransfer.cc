@@ -28,6 +28,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <stdlib.h>
 #include <string.h>
 #include <strings.h>
 #include <stdio.h>
@@ -53,6 +54,7 @@
 #include "XrdOuc/XrdOucEnv.hh"
 #include "XrdOuc/XrdOucMsubs.hh"
 #include "XrdOuc/XrdOucProg.hh"
+#include "XrdOuc/XrdOucStream.hh"
 #include "XrdOuc/XrdOucSxeq.hh"
 #include "XrdOuc/XrdOucUtils.hh"
 #include "XrdOuc/XrdOucXAttr.hh"
@@ -74,11 +76,12 @@ XrdOucMsubs *theVec;
 char        *theSrc;
 char        *theDst;
 char        *theINS;
+int          isAgent;
 char         theMDP[8];
 
             XrdFrmTranArg(XrdOucEnv *Env)
                          : theEnv(Env), theCmd(0), theVec(0), theSrc(0),
-                           theDst(0), theINS(0) 
+                           theDst(0), theINS(0), isAgent(0)
                             {theMDP[0] = '0'; theMDP[1] = 0;}
            ~XrdFrmTranArg() {}
 };
@@ -107,10 +110,14 @@ XrdFrmTransfer::XrdFrmTransfer()
 {
    int i;
 
-// Construct program objects
+// Construct program objects. Copy agents are started right away and linger
+// for the life of this transfer thread.
 //
    for (i = 0; i < 4; i++)
-       xfrCmd[i] = (Config.xfrCmd[i].theVec ? new XrdOucProg(&Say) : 0);
+       {xfrCmd[i] = (Config.xfrCmd[i].theVec ? new XrdOucProg(&Say) : 0);
+        if (xfrCmd[i] && Config.xfrCmd[i].Opts & Config.cmdAgent
+        &&  !StartAgent(i)) {delete xfrCmd[i]; xfrCmd[i] = 0;}
+       }
 }
 
 /******************************************************************************/
@@ -206,6 +213,7 @@ const char *XrdFrmTransfer::Fetch()
    cmdArg.theSrc = theSrc;
    cmdArg.theDst = xfrP->PFN;
    cmdArg.theINS = xfrP->reqData.iName;
+   cmdArg.isAgent= Config.xfrCmd[iXfr].Opts & Config.cmdAgent;
    if (!SetupCmd(&cmdArg)) return "incoming transfer setup failed";
 
 // If the copycmd needs a placeholder in the filesystem for this transfer, we
@@ -232,7 +240,7 @@ const char *XrdFrmTransfer::Fetch()
 // the file we just fetched; then rename it to be the correct name.
 //
    xfrET = time(0);
-   if (!(rc = cmdArg.theCmd->Run(pdBuff, pdSZ)))
+   if (!(rc = RunCmd(&cmdArg, pdBuff, pdSZ)))
       {if ((rc = Config.Stat(lfnpath, xfrP->PFN, &pfnStat)))
           {Say.Emsg("Fetch", lfnpath, "fetched but not resident!"); fSize = 0;}
           else {fSize  = pfnStat.st_size;
@@ -473,11 +481,66 @@ int XrdFrmTransfer::SetupCmd(XrdFrmTranArg *argP)
         strcpy(cP, pdata[i]); cP += pdlen[i];
        }
 
-// Now setup the command
+// Now setup the command. Agents are already running and will be sent the
+// command line by RunCmd().
 //
+   if (argP->isAgent) return 1;
    return (argP->theCmd->Setup(cmdBuff, &Say) == 0);
 }
 
+/******************************************************************************/
+/* Private:                       R u n C m d                                 */
+/******************************************************************************/
+  
+int XrdFrmTransfer::RunCmd(XrdFrmTranArg *argP, char *pdBuff, int pdSZ)
+{
+   XrdOucStream *aStream;
+   char *lP, *eP, *cP, buff[16];
+   int rc;
+
+// Ordinary copy commands are run as a new process for each transfer
+//
+   if (!argP->isAgent) return argP->theCmd->Run(pdBuff, pdSZ);
+
+// A copy agent is sent the command line less the program name as a single
+// line. SetupCmd() reserved enough room to add the newline.
+//
+   if ((cP = index(cmdBuff, ' '))) cP++;
+      else cP = cmdBuff + strlen(cmdBuff);
+   strcat(cP, "\n");
+   if (argP->theCmd->Feed(cP)) return -EPIPE;
+
+// The agent replies with the ending status of the copy followed by optional
+// program data. Should the agent go away, Feed() restarts it next time.
+//
+   aStream = argP->theCmd->getStream();
+   if (!(lP = aStream->GetLine()))
+      {Say.Emsg("Transfer", "Copy agent for", xfrP->reqData.LFN,
+                            "ended unexpectedly");
+       return -EPIPE;
+      }
+   rc = strtol(lP, &eP, 10);
+   if (eP == lP || (*eP && *eP != ' '))
+      {Say.Emsg("Transfer", "Invalid copy agent response -", lP);
+       return -EINVAL;
+      }
+
+// Return program data, if wanted
+//
+   if (pdSZ)
+      {while(*eP == ' ') eP++;
+       strlcpy(pdBuff, eP, pdSZ);
+      }
+
+// Return the status as Run() would have
+//
+   if (rc)
+      {sprintf(buff, "%d", rc);
+       Say.Emsg("Run", xfrP->reqData.LFN, "copy agent ended with status", buff);
+      }
+   return (rc > 0 ? -rc : rc);
+}
+
 /******************************************************************************/
 /* Public:                         S t a r t                                  */
 /******************************************************************************/
@@ -519,6 +582,38 @@ void XrdFrmTransfer::Start()
         }
 }
 
+/******************************************************************************/
+/* Private:                   S t a r t A g e n t                             */
+/******************************************************************************/
+  
+int XrdFrmTransfer::StartAgent(int iXfr)
+{
+   char *cP, Prog[MAXPATHLEN+1];
+   int n, rc;
+
+// The agent is the program in the copy command; its arguments are sent to it
+// on a per-transfer basis.
+//
+   if ((cP = index(Config.xfrCmd[iXfr].theCmd, ' ')))
+      n = cP - Config.xfrCmd[iXfr].theCmd;
+      else n = strlen(Config.xfrCmd[iXfr].theCmd);
+   if (n >= (int)sizeof(Prog))
+      {Say.Emsg("Transfer", ENAMETOOLONG, "start copy agent for",
+                            Config.xfrCmd[iXfr].Desc);
+       return 0;
+      }
+   strncpy(Prog, Config.xfrCmd[iXfr].theCmd, n); Prog[n] = 0;
+
+// Start the agent and let it linger
+//
+   if (xfrCmd[iXfr]->Setup(Prog, &Say)) return 0;
+   if ((rc = xfrCmd[iXfr]->Start()))
+      {Say.Emsg("Transfer", (rc < 0 ? -rc : rc), "start copy agent", Prog);
+       return 0;
+      }
+   return 1;
+}
+
 /******************************************************************************/
 /* Private:                      T r a c k D C                                */
 /******************************************************************************/
@@ -646,6 +741,7 @@ const char *XrdFrmTransfer::Throw()
    cmdArg.theDst = theDest;
    cmdArg.theSrc = xfrP->PFN;
    cmdArg.theINS = xfrP->reqData.iName;
+   cmdArg.isAgent= Config.xfrCmd[iXfr].Opts & Config.cmdAgent;
    if (Config.xfrCmd[iXfr].Opts & Config.cmdMDP)
       mDP = TrackDC(lfnpath+xfrP->reqData.LFO, cmdArg.theMDP, Rfn);
    if (!SetupCmd(&cmdArg)) return "outgoing transfer setup failed";
@@ -658,7 +754,7 @@ const char *XrdFrmTransfer::Throw()
 // migration request, cretae a fail file if one does not exist.
 //
    xfrET = time(0);
-   if ((rc = cmdArg.theCmd->Run(pdBuff, pdSZ)))
+   if ((rc = RunCmd(&cmdArg, pdBuff, pdSZ)))
       {if (isMigr) ffMake(rc == -2);
        retMsg = "copy failed";
       }
@@ -57,7 +57,9 @@ const char *Fetch();
 const char *FetchDone(char *lfnpath, struct stat &Stat, int &rc);
 const char *ffCheck();
       void  ffMake(int nofile=0);
+      int   RunCmd(XrdFrmTranArg *aP, char *pdBuff, int pdSZ);
       int   SetupCmd(XrdFrmTranArg *aP);
+      int   StartAgent(int iXfr);
       int   TrackDC(char *Lfn, char *Mdp, char *Rfn);
       int   TrackDC(char *Rfn);
 const char *Throw();
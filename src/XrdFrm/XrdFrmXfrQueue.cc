@@ -203,9 +203,12 @@ void XrdFrmXfrQueue::Done(XrdFrmXfrJob *xP, const char *Msg)
 //
    hMutex.Lock(); hTab.Del(xP->reqFile); hMutex.UnLock();
   
-// Place job element on the free queue
+// Place job element on the free queue. If the queue was at its concurrency
+// limit and still has pending work, tell a transfer agent to look again.
 //
    qMutex.Lock();
+   if (xfrQ[xP->qNum].Active-- == xfrQ[xP->qNum].Limit
+   &&  xfrQ[xP->qNum].First) qReady.Post();
    xP->Next = xfrQ[xP->qNum].Free;
    xfrQ[xP->qNum].Free = xP;
    xfrQ[xP->qNum].Avail.Post();
@@ -261,6 +264,7 @@ int XrdFrmXfrQueue::Init()
         xfrQ[qNum].File = strdup(StopFile);
         xfrQ[qNum].Name = StopQN[qNum];
         xfrQ[qNum].qNum = qNum;
+        xfrQ[qNum].Limit= Config.xfrQMax[qNum];
 
    // Start the stop file monitor thread for this queue
    //
@@ -303,10 +307,11 @@ do{ioX = (ioX + 1) & 1;
    if (ioX) {Q1 = XrdFrcRequest::migQ; Q2 = XrdFrcRequest::putQ; pikQ = 1;}
       else  {Q1 = XrdFrcRequest::stgQ; Q2 = XrdFrcRequest::getQ; pikQ = 0;}
 
-// Check if we should avoid either queue because it is stopped
+// Check if we should avoid either queue because it is stopped or because it
+// already has as many active transfers as it is allowed to have
 //
-   if (xfrQ[Q1].Stop || Stopped(Q1)) Q1 = XrdFrcRequest::nilQ;
-   if (xfrQ[Q2].Stop || Stopped(Q2)) Q2 = XrdFrcRequest::nilQ;
+   if (xfrQ[Q1].Stop || Stopped(Q1) || Limited(Q1)) Q1 = XrdFrcRequest::nilQ;
+   if (xfrQ[Q2].Stop || Stopped(Q2) || Limited(Q2)) Q2 = XrdFrcRequest::nilQ;
 
 // Pick the oldest possible request
 //
@@ -320,8 +325,10 @@ do{ioX = (ioX + 1) & 1;
 
 // Dequeue the request (we may have an empty selectoin here)
 //
-   if ((xfrP = xfrQ[theQ].First)
-   &&  !(xfrQ[theQ].First = xfrP->Next)) xfrQ[theQ].Last = 0;
+   if ((xfrP = xfrQ[theQ].First))
+      {if (!(xfrQ[theQ].First = xfrP->Next)) xfrQ[theQ].Last = 0;
+       xfrQ[theQ].Active++;
+      }
   } while(!xfrP && nSel--);
 
 // Return the job, if any
@@ -331,6 +338,15 @@ do{ioX = (ioX + 1) & 1;
    return xfrP;
 }
 
+/******************************************************************************/
+/* Private:                      L i m i t e d                                */
+/******************************************************************************/
+  
+int XrdFrmXfrQueue::Limited(int qNum) // Called with qMutex locked!
+{
+   return xfrQ[qNum].Limit && xfrQ[qNum].Active >= xfrQ[qNum].Limit;
+}
+
 /******************************************************************************/
 /* Private:                       N o t i f y                                 */
 /******************************************************************************/
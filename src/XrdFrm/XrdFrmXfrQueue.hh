@@ -57,6 +57,7 @@ static void          StopMon(void *parg);
 
 private:
 
+static int           Limited(int qNum);
 static XrdFrmXfrJob *Pull();
 static int           Notify(XrdFrcRequest *rP,int qN,int rc,const char *msg=0);
 static void          Send2File(char *Dest, char *Msg, int Mln);
@@ -80,7 +81,10 @@ struct theQueue
               const char        *Name;
               int                Stop;
               int                qNum;
-              theQueue() : Avail(0),Free(0),First(0),Last(0),Alert(0),Stop(0) {}
+              int                Active;
+              int                Limit;
+              theQueue() : Avail(0),Free(0),First(0),Last(0),Alert(0),Stop(0),
+                           Active(0),Limit(0) {}
              ~theQueue() {}
       };
 static theQueue                  xfrQ[XrdFrcRequest::numQ];
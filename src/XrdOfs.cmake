@@ -25,13 +25,26 @@ add_library(
   XrdOfs/XrdOfsStats.cc         XrdOfs/XrdOfsStats.hh
   XrdOfs/XrdOfsTPC.cc           XrdOfs/XrdOfsTPC.hh
   XrdOfs/XrdOfsTPCAuth.cc       XrdOfs/XrdOfsTPCAuth.hh
+  XrdOfs/XrdOfsTPCCopy.cc       XrdOfs/XrdOfsTPCCopy.hh
   XrdOfs/XrdOfsTPCJob.cc        XrdOfs/XrdOfsTPCJob.hh
   XrdOfs/XrdOfsTPCInfo.cc       XrdOfs/XrdOfsTPCInfo.hh
   XrdOfs/XrdOfsTPCProg.cc       XrdOfs/XrdOfsTPCProg.hh )
 
+#-------------------------------------------------------------------------------
+# The builtin third party copy engine needs the new client
+#-------------------------------------------------------------------------------
+if( ENABLE_XRDCL )
+  set_source_files_properties(
+    XrdOfs/XrdOfsTPCCopy.cc
+    PROPERTIES
+    COMPILE_DEFINITIONS HAVE_XRDCL )
+  set( XRD_OFS_XRDCL_LIB XrdCl )
+endif()
+
 target_link_libraries(
   XrdOfs
   XrdServer
+  ${XRD_OFS_XRDCL_LIB}
   XrdUtils
   pthread )
 
@@ -155,6 +155,7 @@ XrdOfs::XrdOfs()
    poscLog = 0;
    poscHold= 10*60;
    poscAuto= 0;
+   poscSync= 1;
 
 // Establish our hostname and IPV6 address
 //
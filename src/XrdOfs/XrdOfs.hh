@@ -373,6 +373,7 @@ XrdOfsPoscq      *poscQ;          //    -> poscQ if  persist on close enabled
 char             *poscLog;        //    -> Directory for posc recovery log
 int               poscHold;       //       Seconds to hold a forced close
 int               poscAuto;       //  1 -> Automatic persist on close
+int               poscSync;       //  1 -> Group commit the posc recovery log
 
 XrdCksConfig     *CksConfig;      // Checksum configurator
 XrdCks           *Cks;            // Checksum manager
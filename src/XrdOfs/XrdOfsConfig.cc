@@ -319,7 +319,7 @@ void XrdOfs::Config_Display(XrdSysError &Eroute)
                                   "       ofs.maxdelay   %d\n"
                                   "%s%s%s%s%s"
                                   "%s%s%s"
-                                  "       ofs.persist    %s hold %d%s%s%s"
+                                  "       ofs.persist    %s hold %d sync %s%s%s%s"
                                   "       ofs.trace      %x",
               cloc, myRole,
               (Options & Authorize ? "       ofs.authorize\n" : ""),
@@ -331,7 +331,8 @@ void XrdOfs::Config_Display(XrdSysError &Eroute)
               (CmsParms? CmsParms : ""), (CmsLib ? "\n" : ""),
               (OssLib                    ? "       ofs.osslib " : ""),
               (OssLib ? OssLib : ""), (OssLib ? "\n" : ""),
-               pval, poscHold, (poscLog ? " logdir " : ""),
+               pval, poscHold, (poscSync ? "group" : "each"),
+               (poscLog ? " logdir " : ""),
                (poscLog ? poscLog    : ""), (poscLog ? "\n" : ""),
               OfsTrace.What);
 
@@ -455,7 +456,7 @@ int XrdOfs::ConfigPosc(XrdSysError &Eroute)
 
 // Create object then initialize it
 //
-   poscQ = new XrdOfsPoscq(&Eroute, XrdOfsOss, poscLog);
+   poscQ = new XrdOfsPoscq(&Eroute, XrdOfsOss, poscLog, poscSync);
    rP = poscQ->Init(rc);
    if (!rc) return 1;
 
@@ -1097,12 +1098,15 @@ int XrdOfs::xolib(XrdOucStream &Config, XrdSysError &Eroute)
 
    Purpose:  To parse the directive: persist [auto | manual | off]
                                              [hold <sec>] [logdir <dirp>]
+                                             [sync {each | group}]
 
              auto      POSC processing always on for creation requests
              manual    POSC processing must be requested (default)
              off       POSC processing is disabled
              <sec>     Seconds inclomplete files held (default 10m)
              <dirp>    Directory to hold POSC recovery log (default adminpath)
+             each      Write and sync each POSC recovery log update by itself
+             group     Write and sync concurrent updates together (default)
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1110,7 +1114,7 @@ int XrdOfs::xolib(XrdOucStream &Config, XrdSysError &Eroute)
 int XrdOfs::xpers(XrdOucStream &Config, XrdSysError &Eroute)
 {
    char *val;
-   int htime = -1, popt = -2;
+   int htime = -1, popt = -2, psync = -1;
 
    if (!(val = Config.GetWord()))
       {Eroute.Emsg("Config","persist option not specified");return 1;}
@@ -1136,6 +1140,17 @@ int XrdOfs::xpers(XrdOucStream &Config, XrdSysError &Eroute)
                   if (XrdOuca2x::a2tm(Eroute,"persist hold",val,&htime,0))
                       return 1;
                  }
+         else if (!strcmp(val, "sync"))
+                 {if (!(val = Config.GetWord()))
+                     {Eroute.Emsg("Config","persist sync value not specified");
+                      return 1;
+                     }
+                       if (!strcmp(val, "each"))  psync = 0;
+                  else if (!strcmp(val, "group")) psync = 1;
+                  else {Eroute.Emsg("Config","invalid persist sync value -",val);
+                        return 1;
+                       }
+                 }
          else if (!strcmp(val, "logdir"))
                  {if (!(val = Config.GetWord()))
                      {Eroute.Emsg("Config","persist logdir path not specified");
@@ -1152,6 +1167,7 @@ int XrdOfs::xpers(XrdOucStream &Config, XrdSysError &Eroute)
 //
    if (htime >= 0) poscHold = htime;
    if (popt  > -2) poscAuto = popt;
+   if (psync >= 0) poscSync = psync;
    return 0;
 }
 
@@ -1286,6 +1302,7 @@ int XrdOfs::xrole(XrdOucStream &Config, XrdSysError &Eroute)
                                          [logok] [xfr <n>] [allow <parms>]
                                          [require {all|client|dest} <auth>[+]]
                                          [restrict <path>] [streams <num>]
+                                         [chunk <sz>] [pipeline <cnt>]
                                          [pgm <path> [parms]]
 
              parms: [dn <name>] [group <grp>] [host <hn>] [vo <vo>]
@@ -1298,6 +1315,9 @@ int XrdOfs::xrole(XrdOucStream &Config, XrdSysError &Eroute)
                      authentication specification.
              <n>     maximum number of simultaneous transfers.
              <num>   the number of TCP streams to use for the copy.
+             <sz>    the size of each read issued by the builtin copy engine.
+             <cnt>   the number of reads the builtin copy engine keeps in
+                     flight for each copy.
              <auth>  require that the client, destination, or both (i.e. all)
                      use the specified authentication protocol. Additional
                      require statements may be specified to add additional
@@ -1305,7 +1325,8 @@ int XrdOfs::xrole(XrdOucStream &Config, XrdSysError &Eroute)
                      by a plus, then the request must also be encrypted using
                      the authentication's session key.
              pgm     specifies the transfer command with optional paramaters.
-                     It must be the last parameter on the line.
+                     It must be the last parameter on the line. When omitted,
+                     copies are done by the builtin copy engine.
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1314,6 +1335,7 @@ int XrdOfs::xtpc(XrdOucStream &Config, XrdSysError &Eroute)
 {
    XrdOfsTPC::iParm Parms;
    char *val, pgm[1024];
+   long long llval;
    int  reqType;
    *pgm = 0;
 
@@ -1322,6 +1344,14 @@ int XrdOfs::xtpc(XrdOucStream &Config, XrdSysError &Eroute)
             {if (!xtpcal(Config, Eroute)) return 1;
              continue;
             }
+         if (!strcmp(val, "chunk"))
+            {if (!(val = Config.GetWord()))
+                {Eroute.Emsg("Config","tpc chunk value not specified"); return 1;}
+             if (XrdOuca2x::a2sz(Eroute,"tpc chunk",val,&llval,4096,1<<26))
+                return 1;
+             Parms.Csize = static_cast<int>(llval);
+             continue;
+            }
          if (!strcmp(val, "cksum"))
             {if (!(val = Config.GetWord()))
                 {Eroute.Emsg("Config","cksum type not specified"); return 1;}
@@ -1338,6 +1368,13 @@ int XrdOfs::xtpc(XrdOucStream &Config, XrdSysError &Eroute)
              Parms.Pgm = pgm;
              break;
             }
+         if (!strcmp(val, "pipeline"))
+            {if (!(val = Config.GetWord()))
+                {Eroute.Emsg("Config","tpc pipeline value not specified"); return 1;}
+             if (XrdOuca2x::a2i(Eroute,"tpc pipeline",val,&Parms.Cnum,1,64))
+                return 1;
+             continue;
+            }
          if (!strcmp(val, "require"))
             {if (!(val = Config.GetWord()))
                 {Eroute.Emsg("Config","tpc require parameter not specified"); return 1;}
@@ -48,7 +48,8 @@
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
 
-XrdOfsPoscq::XrdOfsPoscq(XrdSysError *erp, XrdOss *oss, const char *fn)
+XrdOfsPoscq::XrdOfsPoscq(XrdSysError *erp, XrdOss *oss, const char *fn,
+                         int grpsync) : grpCV(0)
 {
    eDest = erp;
    ossFS = oss;
@@ -57,6 +58,9 @@ XrdOfsPoscq::XrdOfsPoscq(XrdSysError *erp, XrdOss *oss, const char *fn)
    pocSZ = 0;
    pocIQ = 0;
    SlotList = SlotLust = 0;
+   grpFirst = grpLast = 0;
+   grpBusy  = 0;
+   grpSync  = grpsync;
 }
   
 /******************************************************************************/
@@ -164,6 +168,61 @@ int XrdOfsPoscq::Del(const char *Lfn, int Offset, int Unlink)
    return 0;
 }
   
+/******************************************************************************/
+/* Private:                     g r p W r i t e                               */
+/******************************************************************************/
+
+// Records are queued and whoever finds no write in progress becomes the
+// leader: it writes everything queued so far and issues a single fsync on
+// behalf of the whole batch. Every caller still returns only after its own
+// record is on disk, so recovery sees exactly what it would have otherwise.
+//
+int XrdOfsPoscq::grpWrite(void *Buff, int Bsz, int Offs)
+{
+   SyncReq myReq(Buff, Bsz, Offs), *rP, *bP;
+   int rc, doSync;
+
+// Add our request to the pending batch
+//
+   grpCV.Lock();
+   if (grpLast) grpLast->Next = &myReq;
+      else      grpFirst       = &myReq;
+   grpLast = &myReq;
+
+// Wait until our request has been written, leading a batch if need be
+//
+   while(!myReq.Done)
+        {if (grpBusy) {grpCV.Wait(); continue;}
+         bP = grpFirst; grpFirst = grpLast = 0; grpBusy = 1;
+         grpCV.UnLock();
+
+         doSync = 0;
+         for (rP = bP; rP; rP = rP->Next)
+             {do {rc = pwrite(pocFD, rP->Buff, rP->Bsz, rP->Offs);}
+                 while(rc < 0 && errno == EINTR);
+              if (rc < 0) rP->eNum = errno;
+                 else if (rP->Bsz > 8) doSync = 1;
+             }
+
+         if (doSync && fsync(pocFD))
+            {rc = errno;
+             for (rP = bP; rP; rP = rP->Next) if (!rP->eNum) rP->eNum = rc;
+            }
+
+         grpCV.Lock();
+         for (rP = bP; rP; rP = rP->Next) rP->Done = 1;
+         grpBusy = 0;
+         grpCV.Broadcast();
+        }
+   grpCV.UnLock();
+
+// Report the outcome for our request
+//
+   if (myReq.eNum)
+      {eDest->Emsg("reqWrite", myReq.eNum, "write", pocFN); return 0;}
+   return 1;
+}
+
 /******************************************************************************/
 /*                                  I n i t                                   */
 /******************************************************************************/
@@ -284,6 +343,8 @@ int XrdOfsPoscq::reqWrite(void *Buff, int Bsz, int Offs)
 {
    int rc = 0;
 
+   if (grpSync) return grpWrite(Buff, Bsz, Offs);
+
    do {rc = pwrite(pocFD, Buff, Bsz, Offs);} while(rc < 0 && errno == EINTR);
 
    if (rc >= 0 && Bsz > 8) rc = fsync(pocFD);
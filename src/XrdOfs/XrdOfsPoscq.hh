@@ -72,13 +72,15 @@ static recEnt *List(XrdSysError *Say, const char *theFN);
 
 inline int     Num() {return pocIQ;}
 
-               XrdOfsPoscq(XrdSysError *erp, XrdOss *oss, const char *fn);
+               XrdOfsPoscq(XrdSysError *erp, XrdOss *oss, const char *fn,
+                           int grpsync=1);
               ~XrdOfsPoscq() {}
 
 private:
 void   FailIni(const char *lfn);
 int    reqRead(void *Buff, int Offs);
 int    reqWrite(void *Buff, int Bsz, int Offs);
+int    grpWrite(void *Buff, int Bsz, int Offs);
 int    ReWrite(recEnt *rP);
 int    VerOffset(const char *Lfn, int Offset);
 
@@ -87,7 +89,24 @@ struct FileSlot
        int       Offset;
       };
 
+struct SyncReq
+      {SyncReq  *Next;
+       void     *Buff;
+       int       Bsz;
+       int       Offs;
+       int       Done;
+       int       eNum;
+                 SyncReq(void *bP, int bsz, int offs)
+                        : Next(0), Buff(bP), Bsz(bsz), Offs(offs),
+                          Done(0), eNum(0) {}
+      };
+
 XrdSysMutex  myMutex;
+XrdSysCondVar grpCV;
+SyncReq     *grpFirst;
+SyncReq     *grpLast;
+int          grpBusy;
+int          grpSync;
 XrdSysError *eDest;
 XrdOss      *ossFS;
 FileSlot    *SlotList;
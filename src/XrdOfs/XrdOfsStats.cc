@@ -30,6 +30,7 @@
 #include <stdio.h>
 
 #include "XrdOfs/XrdOfsStats.hh"
+#include "XrdOss/XrdOssMio.hh"
 
 /******************************************************************************/
 /*                                R e p o r t                                 */
@@ -41,11 +42,15 @@ int XrdOfsStats::Report(char *buff, int blen)
            "<opr>%d</opr><opw>%d</opw><opp>%d</opp><ups>%d</ups><han>%d</han>"
            "<rdr>%d</rdr><bxq>%d</bxq><rep>%d</rep><err>%d</err><dly>%d</dly>"
            "<sok>%d</sok><ser>%d</ser>"
-           "<tpc><grnt>%d</grnt><deny>%d</deny><err>%d</err><exp>%d</exp></tpc>"
+           "<tpc><grnt>%d</grnt><deny>%d</deny><err>%d</err><exp>%d</exp>"
+           "<xfr>%d</xfr><bytes>%lld</bytes></tpc>"
+           "<mio><hit>%lld</hit><miss>%lld</miss><evict>%lld</evict>"
+           "<mem>%lld</mem></mio>"
            "</stats>";
-    static const int  statsz = sizeof(stats1) + (12*10) + 64;
+    static const int  statsz = sizeof(stats1) + (14*10) + (5*20) + 64;
 
     StatsData myData;
+    XrdOssMioStats mioData;
 
 // If only the size is wanted, return the size
 //
@@ -60,6 +65,7 @@ int XrdOfsStats::Report(char *buff, int blen)
    sdMutex.Lock();
    myData = Data;
    sdMutex.UnLock();
+   XrdOssMio::Stats(mioData);
 
 // Format the buffer
 //
@@ -69,5 +75,8 @@ int XrdOfsStats::Report(char *buff, int blen)
                     myData.numErrors,   myData.numDelays,
                     myData.numSeventOK, myData.numSeventER,
                     myData.numTPCgrant, myData.numTPCdeny,
-                    myData.numTPCerrs,  myData.numTPCexpr);
+                    myData.numTPCerrs,  myData.numTPCexpr,
+                    myData.numTPCxfr,   myData.numTPCbytes,
+                    mioData.Hits,       mioData.Misses,
+                    mioData.Evicts,     mioData.Mapped);
 }
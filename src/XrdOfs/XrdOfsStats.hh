@@ -55,12 +55,17 @@ int         numTPCgrant;
 int         numTPCdeny;
 int         numTPCerrs;
 int         numTPCexpr;
+int         numTPCxfr;  // Copies in progress
+long long   numTPCbytes;
 }           Data;
 
 XrdSysMutex sdMutex;
 
 inline void Add(int &Cntr) {sdMutex.Lock(); Cntr++; sdMutex.UnLock();}
 
+inline void Add(long long &Cntr, int Val)
+               {sdMutex.Lock(); Cntr += Val; sdMutex.UnLock();}
+
 inline void Dec(int &Cntr) {sdMutex.Lock(); Cntr--; sdMutex.UnLock();}
 
        int  Report(char *Buff, int Blen);
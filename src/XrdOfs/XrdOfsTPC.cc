@@ -40,6 +40,7 @@
 #include "XrdOfs/XrdOfsTPC.hh"
 #include "XrdOfs/XrdOfsTPCAuth.hh"
 #include "XrdOfs/XrdOfsTPCJob.hh"
+#include "XrdOfs/XrdOfsTPCCopy.hh"
 #include "XrdOfs/XrdOfsTPCProg.hh"
 #include "XrdOfs/XrdOfsTrace.hh"
 #include "XrdOss/XrdOss.hh"
@@ -351,6 +352,10 @@ void XrdOfsTPC::Init(XrdOfsTPC::iParm &Parms)
    if (Parms.Logok  >= 0) LogOK  = Parms.Logok;
    if (Parms.Strm   >  0) nStrms = Parms.Strm;
    if (Parms.Xmax   >  0) xfrMax = Parms.Xmax;
+
+// Set the pipeline used by the builtin copy engine
+//
+   XrdOfsTPCCopy::Init(Parms.Csize, Parms.Cnum);
 }
 
 /******************************************************************************/
@@ -439,9 +444,10 @@ int XrdOfsTPC::Start()
 //
    if (RPList) RPList->Default(1);
 
-// If there is no copy program then we use the default one
+// If there is no copy program then we use the builtin copy engine. Should
+// that not be available we fall back to the default copy program.
 //
-   if (!XfrProg)
+   if (!XfrProg && !XrdOfsTPCCopy::Available())
       {char pgmBuff[256], sBuff[32];
        if (nStrms) sprintf(sBuff, " -S %d", nStrms);
           else *sBuff = 0;
@@ -80,8 +80,11 @@ struct  iParm {char *Pgm;
                int   Logok;
                int   Strm;
                int   Xmax;
+               int   Csize;
+               int   Cnum;
                      iParm() : Pgm(0), Ckst(0), Dflttl(-1), Maxttl(-1),
-                               Logok(-1), Strm(-1), Xmax(-1) {}
+                               Logok(-1), Strm(-1), Xmax(-1),
+                               Csize(-1), Cnum(-1) {}
               };
 
 static  void  Init(iParm &Parms);
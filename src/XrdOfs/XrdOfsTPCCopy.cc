@@ -0,0 +1,363 @@
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d O f s T P C C o p y . c c                       */
+/*                                                                            */
+/* (c) 2013 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "XrdOfs/XrdOfsStats.hh"
+#include "XrdOfs/XrdOfsTPC.hh"
+#include "XrdOfs/XrdOfsTPCCopy.hh"
+#include "XrdOfs/XrdOfsTPCJob.hh"
+#include "XrdOfs/XrdOfsTrace.hh"
+#include "XrdOuc/XrdOucTrace.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+#ifdef HAVE_XRDCL
+#include "XrdCks/XrdCksCalc.hh"
+#include "XrdCks/XrdCksData.hh"
+#include "XrdCl/XrdClCheckSumManager.hh"
+#include "XrdCl/XrdClDefaultEnv.hh"
+#include "XrdCl/XrdClFile.hh"
+#include "XrdCl/XrdClURL.hh"
+#include "XrdCl/XrdClUtils.hh"
+#endif
+
+/******************************************************************************/
+/*                        G l o b a l   O b j e c t s                         */
+/******************************************************************************/
+  
+extern XrdSysError  OfsEroute;
+extern XrdOucTrace  OfsTrace;
+extern XrdOfsStats  OfsStats;
+
+/******************************************************************************/
+/*                      S t a t i c   V a r i a b l e s                       */
+/******************************************************************************/
+  
+int                XrdOfsTPCCopy::chunkSize = 1024*1024;
+int                XrdOfsTPCCopy::chunkNum  = 8;
+
+#ifdef HAVE_XRDCL
+/******************************************************************************/
+/*                     C l a s s   X r d O f s T P C C h u n k                */
+/******************************************************************************/
+
+// Each chunk describes one read that is in flight against the source. Reads
+// are issued in offset order and consumed in the same order so that the data
+// can be written and checksummed sequentially while later reads proceed.
+//
+class XrdOfsTPCChunk : public XrdCl::ResponseHandler
+{
+public:
+
+void  HandleResponse(XrdCl::XRootDStatus *sP, XrdCl::AnyObject *rP)
+                    {XrdCl::ChunkInfo *ciP = 0;
+                     xStat = *sP; delete sP;
+                     if (rP) {rP->Get(ciP);
+                              if (ciP) dLen = ciP->length;
+                              delete rP;
+                             }
+                     rdDone.Post();
+                    }
+
+void  Read(XrdCl::File &srcFile, long long offs, int blen)
+          {dOff = offs; dLen = 0;
+           xStat = srcFile.Read(offs, blen, Buff, this);
+           if (!xStat.IsOK()) rdDone.Post();
+          }
+
+      XrdOfsTPCChunk() : rdDone(0), Buff(0), dOff(0), dLen(0) {}
+     ~XrdOfsTPCChunk() {}
+
+XrdCl::XRootDStatus xStat;
+XrdSysSemaphore     rdDone;
+char               *Buff;
+long long           dOff;
+int                 dLen;
+};
+
+/******************************************************************************/
+/*                         L o c a l   M e t h o d s                          */
+/******************************************************************************/
+
+namespace
+{
+int Fail(char *eBuff, int eBlen, const char *What, XrdCl::XRootDStatus &xStat)
+{
+   std::string eText = xStat.ToStr();
+
+   if (!eText.empty() && eText[eText.size()-1] == '\n')
+      eText.erase(eText.size()-1);
+   snprintf(eBuff, eBlen, "Copy failed; unable to %s; %s", What, eText.c_str());
+   return EIO;
+}
+
+int Fail(char *eBuff, int eBlen, const char *What, int rc)
+{
+   snprintf(eBuff, eBlen, "Copy failed; unable to %s; %s", What, strerror(rc));
+   return rc;
+}
+}
+#endif
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+  
+XrdOfsTPCCopy::~XrdOfsTPCCopy()
+{
+#ifdef HAVE_XRDCL
+   if (Chunk) delete [] Chunk;
+#endif
+   if (Buff) free(Buff);
+}
+
+/******************************************************************************/
+/*                             A v a i l a b l e                              */
+/******************************************************************************/
+  
+int XrdOfsTPCCopy::Available()
+{
+#ifdef HAVE_XRDCL
+   return 1;
+#else
+   return 0;
+#endif
+}
+
+/******************************************************************************/
+/*                                  I n i t                                   */
+/******************************************************************************/
+  
+void XrdOfsTPCCopy::Init(int csz, int cnum)
+{
+   if (csz  > 0) chunkSize = csz;
+   if (cnum > 0) chunkNum  = cnum;
+}
+
+/******************************************************************************/
+/* Private:                        S e t u p                                  */
+/******************************************************************************/
+  
+int XrdOfsTPCCopy::Setup(char *eBuff, int eBlen)
+{
+#ifdef HAVE_XRDCL
+   int i, rc;
+
+// Allocate the buffers for the pipeline. They stay with this program slot so
+// that subsequent copies run without allocating anything.
+//
+   if ((rc = posix_memalign((void **)&Buff, getpagesize(),
+                            (size_t)chunkSize * chunkNum)))
+      {Buff = 0; return Fail(eBuff, eBlen, "allocate buffers", rc);}
+
+   Chunk = new XrdOfsTPCChunk[chunkNum];
+   for (i = 0; i < chunkNum; i++) Chunk[i].Buff = Buff + (i * chunkSize);
+   return 0;
+#else
+   return ENOTSUP;
+#endif
+}
+  
+/******************************************************************************/
+/*                                   X e q                                    */
+/******************************************************************************/
+  
+int XrdOfsTPCCopy::Xeq(XrdOfsTPCJob *jP, char *eBuff, int eBlen)
+{
+#ifdef HAVE_XRDCL
+   EPNAME("Copy");
+   XrdCl::File          srcFile;
+   XrdCl::XRootDStatus  xStat;
+   XrdCl::StatInfo     *sInfo = 0;
+   XrdOfsTPCChunk      *cP;
+   XrdCksCalc          *cksCalc = 0;
+   std::string          cksType, cksRmt, srcHost;
+   const char *cksVal, *tident = jP->Info.Org;
+   struct timeval tBeg, tEnd;
+   long long fSize, rdOff = 0, wrOff = 0;
+   double xfrTime;
+   int fd, i, n, rc = 0, inFlight = 0;
+
+   DEBUG("Job " <<Pnum <<" copying " <<jP->Info.Key <<' ' <<jP->Info.Dst);
+   gettimeofday(&tBeg, 0);
+   *eBuff = 0;
+
+// Allocate the pipeline if we have not done so yet
+//
+   if (!Chunk && (rc = Setup(eBuff, eBlen)))
+      {OfsEroute.Emsg("TPC", jP->Info.Org, jP->Info.Lfn, eBuff);
+       return rc;
+      }
+
+// Open the source and get its size
+//
+   xStat = srcFile.Open(std::string(jP->Info.Key), XrdCl::OpenFlags::Read);
+   if (!xStat.IsOK()) rc = Fail(eBuff, eBlen, "open source", xStat);
+      else {xStat = srcFile.Stat(false, sInfo);
+            if (!xStat.IsOK())
+               {rc = Fail(eBuff, eBlen, "stat source", xStat);
+                srcFile.Close();
+               }
+           }
+   if (rc)
+      {OfsEroute.Emsg("TPC", jP->Info.Org, jP->Info.Lfn, eBuff);
+       return rc;
+      }
+   fSize = (long long)sInfo->GetSize();
+   srcHost = srcFile.GetDataServer();
+   delete sInfo;
+
+// Open the target. The file has already been created by whoever opened it
+// for writing so we simply replace its contents.
+//
+   if ((fd = open(jP->Info.Dst, O_WRONLY|O_CREAT|O_TRUNC, 0644)) < 0)
+      {rc = Fail(eBuff, eBlen, "open target", errno);
+       OfsEroute.Emsg("TPC", jP->Info.Org, jP->Info.Lfn, eBuff);
+       srcFile.Close();
+       return rc;
+      }
+
+// Get a checksum calculator if the copy needs to be verified. The checksum
+// may be specified as <type> or as <type>:<value>.
+//
+   if ((cksVal = (jP->Info.Cks ? jP->Info.Cks : XrdOfsTPC::cksType)))
+      {const char *colon = index(cksVal, ':');
+       cksType.assign(cksVal, (colon ? colon - cksVal : strlen(cksVal)));
+       if (colon) {cksRmt = cksType; cksRmt += colon;}
+       if (!(cksCalc = XrdCl::DefaultEnv::GetCheckSumManager()
+                       ->GetCalculator(cksType)))
+          {snprintf(eBuff, eBlen, "Copy failed; %s checksum not supported",
+                                  cksType.c_str());
+           rc = ENOTSUP;
+          } else cksCalc->Init();
+      }
+
+// Fill the pipeline
+//
+   OfsStats.Add(OfsStats.Data.numTPCxfr);
+   for (i = 0; !rc && i < chunkNum && rdOff < fSize; i++)
+       {Chunk[i].Read(srcFile, rdOff, chunkSize);
+        rdOff += chunkSize; inFlight++;
+       }
+
+// Consume the chunks in order, writing them out and refilling the pipeline.
+// Once an error is encountered we simply drain whatever is still in flight.
+//
+   i = 0;
+   while(inFlight)
+        {cP = &Chunk[i]; i = (i+1) % chunkNum;
+         cP->rdDone.Wait(); inFlight--;
+         if (rc) continue;
+         if (isCancelled)
+            {strcpy(eBuff, "Copy failed; transfer cancelled.");
+             rc = ECANCELED; continue;
+            }
+         if (!cP->xStat.IsOK())
+            {rc = Fail(eBuff, eBlen, "read source", cP->xStat); continue;}
+         if (cP->dLen != chunkSize && cP->dOff + cP->dLen < fSize)
+            {snprintf(eBuff, eBlen, "Copy failed; short read at offset %lld",
+                                    cP->dOff);
+             rc = EIO; continue;
+            }
+         if ((n = pwrite(fd, cP->Buff, cP->dLen, cP->dOff)) != cP->dLen)
+            {rc = Fail(eBuff, eBlen, "write target", (n < 0 ? errno : EIO));
+             continue;
+            }
+         if (cksCalc) cksCalc->Update(cP->Buff, cP->dLen);
+         OfsStats.Add(OfsStats.Data.numTPCbytes, cP->dLen);
+         wrOff += cP->dLen;
+         if (rdOff < fSize)
+            {cP->Read(srcFile, rdOff, chunkSize);
+             rdOff += chunkSize; inFlight++;
+            }
+        }
+   OfsStats.Dec(OfsStats.Data.numTPCxfr);
+
+// Close the target and make sure we got everything
+//
+   if (close(fd) && !rc) rc = Fail(eBuff, eBlen, "close target", errno);
+   if (!rc && wrOff != fSize)
+      {snprintf(eBuff, eBlen, "Copy failed; only %lld of %lld bytes copied",
+                              wrOff, fSize);
+       rc = EIO;
+      }
+
+// Verify the checksum against the one the source has
+//
+   if (!rc && cksCalc)
+      {XrdCksData cksData;
+       char cksBuff[256];
+       int  cksLen;
+       if (cksRmt.empty())
+          {xStat = XrdCl::Utils::GetRemoteCheckSum(cksRmt, cksType, srcHost,
+                               XrdCl::URL(std::string(jP->Info.Key)).GetPath());
+           if (!xStat.IsOK()) rc = Fail(eBuff,eBlen,"get source checksum",xStat);
+          }
+       if (!rc)
+          {cksCalc->Type(cksLen);
+           cksData.Set(cksType.c_str());
+           cksData.Set((void *)cksCalc->Final(), cksLen);
+           cksData.Get(cksBuff, sizeof(cksBuff));
+           if (strcasecmp(cksRmt.c_str() + cksType.size() + 1, cksBuff))
+              {snprintf(eBuff, eBlen, "Copy failed; %s checksum mismatch "
+                        "(source %s target %s)", cksType.c_str(),
+                        cksRmt.c_str() + cksType.size() + 1, cksBuff);
+               rc = EILSEQ;
+              }
+          }
+      }
+   if (cksCalc) delete cksCalc;
+   srcFile.Close();
+
+// Report how it went
+//
+   gettimeofday(&tEnd, 0);
+   xfrTime = (tEnd.tv_sec  - tBeg.tv_sec)
+           + (tEnd.tv_usec - tBeg.tv_usec) / 1000000.0;
+   DEBUG("Job " <<Pnum <<" copied " <<wrOff <<" bytes in " <<xfrTime
+         <<" sec (" <<(xfrTime > 0 ? wrOff/xfrTime/1048576.0 : 0)
+         <<" MB/s); rc=" <<rc);
+
+   if (rc) OfsEroute.Emsg("TPC", jP->Info.Org, jP->Info.Lfn, eBuff);
+   return rc;
+#else
+   strcpy(eBuff, "Copy failed; builtin copy engine not available.");
+   return ENOTSUP;
+#endif
+}
@@ -0,0 +1,66 @@
+#ifndef __XRDOFSTPCCOPY_HH__
+#define __XRDOFSTPCCOPY_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                      X r d O f s T P C C o p y . h h                       */
+/*                                                                            */
+/* (c) 2013 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+class XrdOfsTPCChunk;
+class XrdOfsTPCJob;
+
+class XrdOfsTPCCopy
+{
+public:
+
+static int       Available();
+
+       void      Cancel() {isCancelled = 1;}
+
+static void      Init(int csz, int cnum);
+
+       void      Reset()  {isCancelled = 0;}
+
+       int       Xeq(XrdOfsTPCJob *jP, char *eBuff, int eBlen);
+
+                 XrdOfsTPCCopy(int num) : Chunk(0), Buff(0), Pnum(num),
+                                          isCancelled(0) {}
+
+                ~XrdOfsTPCCopy();
+private:
+
+int              Setup(char *eBuff, int eBlen);
+
+static int             chunkSize;
+static int             chunkNum;
+
+       XrdOfsTPCChunk *Chunk;
+       char           *Buff;
+       int             Pnum;
+volatile int           isCancelled;
+};
+#endif
@@ -116,6 +116,7 @@ XrdOfsTPCJob *XrdOfsTPCJob::Done(XrdOfsTPCProg *pgmP, const char *eTxt, int rc)
       {if (jP == jobLast) jobQ = jobLast = 0;
           else            jobQ = jP->Next;
        jP->myProg = pgmP; jP->Refs++; jP->inQ = 0; jP->Status = isRunning;
+       pgmP->Reset();
        if (jP->Info.cbP) jP->Info.Reply(SFS_OK, 0, "");
       }
 
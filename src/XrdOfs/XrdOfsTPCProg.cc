@@ -73,7 +73,7 @@ void *XrdOfsTPCProgRun(void *pp)
   
 XrdOfsTPCProg::XrdOfsTPCProg(XrdOfsTPCProg *Prev, int num)
              : Prog(&OfsEroute),
-               JobStream(&OfsEroute),
+               JobStream(&OfsEroute), Copy(num),
                Next(Prev), Job(0), Pnum(num)
              {}
 
@@ -85,12 +85,13 @@ int XrdOfsTPCProg::Init(char *xProg, int Num)
 {
    int n;
 
-// Allocate copy program objects
+// Allocate copy program objects. When there is no copy program, the builtin
+// copy engine is used and the objects merely bound the number of copies.
 //
    XfrProg = xProg;
    for (n = 0; n < Num; n++)
        {pgmIdle = new XrdOfsTPCProg(pgmIdle, n);
-        if (pgmIdle->Prog.Setup(XfrProg, &OfsEroute)) return 0;
+        if (XfrProg && pgmIdle->Prog.Setup(XfrProg, &OfsEroute)) return 0;
        }
 
 // All done
@@ -109,7 +110,7 @@ void XrdOfsTPCProg::Run()
 // Run the current job and indicate it's ending status and possibly getting a
 // another job to run. Note "Job" will always be valid.
 //
-do{rc = Xeq();
+do{rc = (XfrProg ? Xeq() : Copy.Xeq(Job, eRec, sizeof(eRec)));
    Job = Job->Done(this, eRec, rc);
   } while(Job);
 
@@ -136,6 +137,7 @@ XrdOfsTPCProg *XrdOfsTPCProg::Start(XrdOfsTPCJob *jP, int &rc)
 //
    if (!(pgmP = pgmIdle)) {rc = 0; return 0;}
    pgmP->Job = jP;
+   pgmP->Reset();
 
 // Start a thread to run the job
 //
@@ -30,6 +30,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include "XrdOfs/XrdOfsTPCCopy.hh"
 #include "XrdOuc/XrdOucProg.hh"
 #include "XrdOuc/XrdOucStream.hh"
 #include "XrdSys/XrdSysPthread.hh"
@@ -41,10 +42,14 @@ class XrdOfsTPCProg
 {
 public:
 
-       void      Cancel() {JobStream.Drain();}
+       void      Cancel() {if (XfrProg) JobStream.Drain();
+                              else Copy.Cancel();
+                          }
 
 static int       Init(char *XfrProg, int Num);
 
+       void      Reset() {Copy.Reset();}
+
        void      Run();
 
 static
@@ -63,6 +68,7 @@ static const char    *XfrProg;
 
        XrdOucProg     Prog;
        XrdOucStream   JobStream;
+       XrdOfsTPCCopy  Copy;
        XrdOfsTPCProg *Next;
        XrdOfsTPCJob  *Job;
        char           eRec[1024];
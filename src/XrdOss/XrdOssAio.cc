@@ -154,7 +154,7 @@ int XrdOssFile::Read(XrdSfsAio *aiop)
 
 // Complete the aio request block and do the operation
 //
-   if (XrdOssSys::AioAllOk)
+   if (XrdOssSys::AioAllOk && !mmWind)
       {aiop->sfsAio.aio_fildes = fd;
        aiop->sfsAio.aio_sigevent.sigev_signo  = OSS_AIO_READ_DONE;
        aiop->TIdent = tident;
@@ -37,10 +37,13 @@
 #include <signal.h>
 #include <strings.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/param.h>
+#include <sys/uio.h>
 #ifdef __solaris__
 #include <sys/vnode.h>
 #endif
@@ -743,7 +746,8 @@ int XrdOssFile::Open(const char *path, int Oflag, mode_t Mode, XrdOucEnv &Env)
        if (popts & XRDEXP_MMAP  || Info.Attr.Flags & XrdFrcXAttrMem::memMap)
           mopts |= OSSMIO_MMAP;
        if (mopts) mmFile = XrdOssMio::Map(local_path, fd, mopts);
-      } else mmFile = 0;
+       mmWind = (mmFile && mmFile->isWindowed());
+      } else {mmFile = 0; mmWind = 0;}
 
 // Return the result of this open
 //
@@ -773,7 +777,7 @@ int XrdOssFile::Close(long long *retsz)
         if (retsz) *retsz = buf.st_size;
        }
     if (close(fd)) return -errno;
-    if (mmFile) {XrdOssMio::Recycle(mmFile); mmFile = 0;}
+    if (mmFile) {XrdOssMio::Recycle(mmFile); mmFile = 0; mmWind = 0;}
 #ifdef XRDOSSCX
     if (cxobj) {delete cxobj; cxobj = 0;}
 #endif
@@ -825,10 +829,19 @@ ssize_t XrdOssFile::Read(off_t offset, size_t blen)
 
 ssize_t XrdOssFile::Read(void *buff, off_t offset, size_t blen)
 {
-     ssize_t retval;
+     ssize_t retval, mmbytes = 0;
 
      if (fd < 0) return (ssize_t)-XRDOSS_E8004;
 
+// Files mapped by window are read from memory. Whatever could not be copied
+// (e.g. no memory to map another window) is read from the file.
+//
+     if (mmWind)
+        {mmbytes = XrdOssMio::Read(mmFile, fd, (char *)buff, offset, blen);
+         if (mmbytes == (ssize_t)blen) return mmbytes;
+         buff = (char *)buff + mmbytes; offset += mmbytes; blen -= mmbytes;
+        }
+
 #ifdef XRDOSSCX
      if (cxobj)  
         if (XrdOssSS->DirFlags & XrdOssNOSSDEC) return (ssize_t)-XRDOSS_E8021;
@@ -838,7 +851,7 @@ ssize_t XrdOssFile::Read(void *buff, off_t offset, size_t blen)
              do { retval = pread(fd, buff, blen, offset); }
                 while(retval < 0 && errno == EINTR);
 
-     return (retval >= 0 ? retval : (ssize_t)-errno);
+     return (retval >= 0 ? retval + mmbytes : (ssize_t)-errno);
 }
 
 /******************************************************************************/
@@ -863,6 +876,24 @@ ssize_t XrdOssFile::ReadV(XrdOucIOVec *readV, int n)
    ssize_t rdsz, totBytes = 0;
    int i;
 
+// Unless disabled, uncompressed files are read in offset order with nearby
+// elements merged into a single request (see ReadV_Merge()).
+//
+   if (n > 1 && !cxobj && !mmWind && XrdOssSS->rvSpan)
+      return ReadV_Merge(readV, n);
+
+// Files mapped by window are read element by element from memory
+//
+   if (mmWind)
+      {for (i = 0; i < n; i++)
+           {rdsz = Read(readV[i].data, readV[i].offset, readV[i].size);
+            if (rdsz < 0 || rdsz != readV[i].size)
+               return (rdsz < 0 ? rdsz : -ESPIPE);
+            totBytes += rdsz;
+           }
+       return totBytes;
+      }
+
 // For platforms that support fadvise, pre-advise what we will be reading
 //
 #if defined(__linux__) && defined(HAVE_ATOMICS)
@@ -923,6 +954,173 @@ ssize_t XrdOssFile::ReadV(XrdOucIOVec *readV, int n)
    return totBytes;
 }
 
+/******************************************************************************/
+/*                           R e a d V _ M e r g e                            */
+/******************************************************************************/
+
+struct XrdOssRVGroup
+      {long long offset;  // File offset of the first byte
+       int       size;    // Bytes spanned by the group, gaps included
+       int       beg;     // First element (index into the sorted vector)
+       int       end;     // One past the last element
+       int       copy;    // Elements overlap, read into a buffer and copy
+      };
+
+static int XrdOssRVOrder(const void *a, const void *b)
+{
+    long long aOff = (*(XrdOucIOVec * const *)a)->offset;
+    long long bOff = (*(XrdOucIOVec * const *)b)->offset;
+
+    return (aOff < bOff ? -1 : (aOff > bOff ? 1 : 0));
+}
+
+/*
+  Function: Perform all the reads specified in the readV vector in offset
+            order, merging elements that are no more than rvGap bytes apart
+            into one request of at most rvSpan bytes. The data of each
+            element is placed in its own buffer; elements that abut are read
+            with a single preadv() straight into those buffers and the bytes
+            skipped between elements go into a discard buffer. Groups with
+            overlapping elements (or all groups when there is no preadv()) are
+            read into one buffer and copied out.
+
+  Input:    Same as ReadV().
+
+  Output:   Same as ReadV().
+*/
+
+ssize_t XrdOssFile::ReadV_Merge(XrdOucIOVec *readV, int n)
+{
+   static const int rvIOVMax = 256;
+   XrdOucIOVec  *vecLocal[64], **vP;
+   XrdOssRVGroup grpLocal[64], *gP;
+   struct iovec  iov[rvIOVMax];
+   char *gapBuff = 0, *cpyBuff = 0;
+   long long gEnd, sEnd;
+   ssize_t rdsz = 0, totBytes = 0;
+   int i, j, k, nG = 0, nV, cpySize = 0;
+   int gapMax = XrdOssSS->rvGap, spanMax = XrdOssSS->rvSpan;
+
+// Get a vector of element pointers sorted by offset, small vectors (the
+// common case) avoid going to the heap.
+//
+   if (n <= 64) {vP = vecLocal; gP = grpLocal;}
+      else {vP = new XrdOucIOVec  *[n];
+            gP = new XrdOssRVGroup [n];
+           }
+   for (i = 0; i < n; i++) vP[i] = &readV[i];
+   qsort(vP, n, sizeof(XrdOucIOVec *), XrdOssRVOrder);
+
+// Cut the sorted vector into groups, each one is read with a single request
+//
+   i = 0;
+   while(i < n)
+        {gP[nG].offset = vP[i]->offset;
+         gP[nG].beg    = i;
+#ifdef HAVE_PREADV
+         gP[nG].copy   = 0;
+#else
+         gP[nG].copy   = 1;
+#endif
+         gEnd = vP[i]->offset + vP[i]->size;
+         nV   = 1;
+         for (j = i+1; j < n; j++)
+             {sEnd = vP[j]->offset + vP[j]->size;
+              if (vP[j]->offset > gEnd + gapMax
+              ||  (sEnd > gEnd ? sEnd : gEnd) - gP[nG].offset > spanMax) break;
+              k = (vP[j]->offset > gEnd ? 2 : 1);
+              if (nV + k > rvIOVMax) break;
+              nV += k;
+              if (vP[j]->offset < gEnd) gP[nG].copy = 1;
+              if (sEnd > gEnd) gEnd = sEnd;
+             }
+         gP[nG].end  = j;
+         gP[nG].size = static_cast<int>(gEnd - gP[nG].offset);
+         nG++; i = j;
+        }
+
+// For platforms that support fadvise, pre-advise what we will be reading.
+// This works as in ReadV() except that the unit is a group, not an element.
+//
+#if defined(__linux__) && defined(HAVE_ATOMICS)
+   EPNAME("ReadV");
+   int nPR = nG;
+
+   if (XrdOssSS->prDepth
+   && AtomicInc((XrdOssSS->prActive)) < XrdOssSS->prQSize && nG > 2)
+      {int faBytes = 0;
+       for (nPR=0; nPR < XrdOssSS->prDepth && nPR < nG
+                && faBytes < XrdOssSS->prBytes; nPR++)
+           if (gP[nPR].size <= XrdOssSS->prBytes)
+              {posix_fadvise(fd,gP[nPR].offset,gP[nPR].size,POSIX_FADV_WILLNEED);
+               TRACE(Debug,"fadvise(" <<fd <<',' <<gP[nPR].offset <<','
+                                      <<gP[nPR].size <<')');
+               faBytes += gP[nPR].size;
+              }
+      }
+#endif
+
+// Read in each group
+//
+   for (k = 0; k < nG; k++)
+       {if (gP[k].copy)
+           {if (gP[k].size > cpySize)
+               {if (cpyBuff) free(cpyBuff);
+                if (!(cpyBuff = (char *)malloc(gP[k].size)))
+                   {totBytes = -ENOMEM; break;}
+                cpySize = gP[k].size;
+               }
+            do {rdsz = pread(fd, cpyBuff, gP[k].size, gP[k].offset);}
+               while(rdsz < 0 && errno == EINTR);
+           } else {
+#ifdef HAVE_PREADV
+            nV = 0; gEnd = gP[k].offset;
+            for (i = gP[k].beg; i < gP[k].end; i++)
+                {if (vP[i]->offset > gEnd)
+                    {if (!gapBuff && !(gapBuff = (char *)malloc(gapMax))) break;
+                     iov[nV].iov_base = gapBuff;
+                     iov[nV].iov_len  = vP[i]->offset - gEnd;
+                     nV++;
+                    }
+                 iov[nV].iov_base = vP[i]->data;
+                 iov[nV].iov_len  = vP[i]->size;
+                 nV++;
+                 gEnd = vP[i]->offset + vP[i]->size;
+                }
+            if (i < gP[k].end) {totBytes = -ENOMEM; break;}
+            do {rdsz = preadv(fd, iov, nV, gP[k].offset);}
+               while(rdsz < 0 && errno == EINTR);
+#endif
+           }
+        if (rdsz < 0 || rdsz != gP[k].size)
+           {totBytes =  (rdsz < 0 ? -errno : -ESPIPE); break;}
+        for (i = gP[k].beg; i < gP[k].end; i++)
+            {if (gP[k].copy) memcpy(vP[i]->data,
+                                    cpyBuff + (vP[i]->offset - gP[k].offset),
+                                    vP[i]->size);
+             totBytes += vP[i]->size;
+            }
+#if defined(__linux__) && defined(HAVE_ATOMICS)
+        if (nPR < nG && gP[nPR].size <= XrdOssSS->prBytes)
+           {posix_fadvise(fd,gP[nPR].offset,gP[nPR].size,POSIX_FADV_WILLNEED);
+            TRACE(Debug,"fadvise(" <<fd <<',' <<gP[nPR].offset <<','
+                                   <<gP[nPR].size <<')');
+           }
+        nPR++;
+#endif
+       }
+
+// All done, release what we allocated and return bytes read.
+//
+#if defined(__linux__) && defined(HAVE_ATOMICS)
+   if (XrdOssSS->prDepth) AtomicDec((XrdOssSS->prActive));
+#endif
+   if (gapBuff) free(gapBuff);
+   if (cpyBuff) free(cpyBuff);
+   if (vP != vecLocal) {delete [] vP; delete [] gP;}
+   return totBytes;
+}
+
 /******************************************************************************/
 /*                               R e a d R a w                                */
 /******************************************************************************/
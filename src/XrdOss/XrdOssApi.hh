@@ -96,7 +96,7 @@ int     Fstat(struct stat *);
 int     Fsync();
 int     Fsync(XrdSfsAio *aiop);
 int     Ftruncate(unsigned long long);
-int     getFD() {return fd;}
+int     getFD() {return (mmWind ? -1 : fd);}
 off_t   getMmap(void **addr);
 int     isCompressed(char *cxidp=0);
 ssize_t Read(               off_t, size_t);
@@ -110,13 +110,14 @@ int     Write(XrdSfsAio *aiop);
         // Constructor and destructor
         XrdOssFile(const char *tid)
                   {cxobj = 0; rawio = 0; cxpgsz = 0; cxid[0] = '\0';
-                   mmFile = 0; tident = tid;
+                   mmFile = 0; mmWind = 0; tident = tid;
                   }
 
 virtual ~XrdOssFile() {if (fd >= 0) Close();}
 
 private:
 int     Open_ufs(const char *, int, int, unsigned long long);
+ssize_t ReadV_Merge(XrdOucIOVec *readV, int);
 
 static int      AioFailure;
 oocx_CXFile    *cxobj;
@@ -127,6 +128,7 @@ long long       FSize;
 int             rawio;
 int             cxpgsz;
 char            cxid[4];
+char            mmWind;   // mmFile is read through mapped windows
 };
 
 /******************************************************************************/
@@ -266,6 +268,9 @@ int               prActive;  //    preread activity count
 short             prDepth;   //    preread depth
 short             prQSize;   //    preread maximum allowed
 
+int               rvGap;     //    readv largest hole merged over
+int               rvSpan;    //    readv largest merged request (0 -> off)
+
 XrdVersionInfo   *myVersion; //    Compilation version set by constructor
    
          XrdOssSys();
@@ -340,6 +345,7 @@ int    xmemf(XrdOucStream &Config, XrdSysError &Eroute);
 int    xnml(XrdOucStream &Config, XrdSysError &Eroute);
 int    xpath(XrdOucStream &Config, XrdSysError &Eroute);
 int    xprerd(XrdOucStream &Config, XrdSysError &Eroute);
+int    xreadv(XrdOucStream &Config, XrdSysError &Eroute);
 int    xspace(XrdOucStream &Config, XrdSysError &Eroute, int *isCD=0);
 int    xspaceBuild(char *grp, char *fn, int isxa, XrdSysError &Eroute);
 int    xstg(XrdOucStream &Config, XrdSysError &Eroute);
@@ -218,6 +218,8 @@ XrdOssSys::XrdOssSys()
    prActive      = 0;
    prDepth       = 0;
    prQSize       = 0;
+   rvGap         = 65536;
+   rvSpan        = 2097152;
    STT_Lib       = 0;
    STT_Parms     = 0;
    STT_Func      = 0;
@@ -396,6 +398,12 @@ void XrdOssSys::Config_Display(XrdSysError &Eroute)
 
      Eroute.Say(buff);
 
+     if (!rvSpan) Eroute.Say("       oss.readv        off");
+        else {snprintf(buff, sizeof(buff),
+                       "       oss.readv        gap %d span %d", rvGap, rvSpan);
+              Eroute.Say(buff);
+             }
+
      XrdOssMio::Display(Eroute);
 
      XrdOssCache::List("       oss.", Eroute);
@@ -936,6 +944,7 @@ int XrdOssSys::ConfigXeq(char *var, XrdOucStream &Config, XrdSysError &Eroute)
    TS_Xeq("namelib",       xnml);
    TS_Xeq("path",          xpath);
    TS_Xeq("preread",       xprerd);
+   TS_Xeq("readv",         xreadv);
    TS_Xeq("space",         xspace);
    TS_Xeq("stagecmd",      xstg);
    TS_Xeq("statlib",       xstl);
@@ -1188,6 +1197,7 @@ int XrdOssSys::xmaxsz(XrdOucStream &Config, XrdSysError &Eroute)
 
    Purpose:  Parse the directive: memfile [off] [max <msz>]
                                           [check xattr] [preload]
+                                          [window <wsz>]
 
              check      Applies memory mapping options based on file's xattrs.
                         For backward compatibility, we also accept:
@@ -1197,6 +1207,10 @@ int XrdOssSys::xmaxsz(XrdOucStream &Config, XrdSysError &Eroute)
              on         Enables memory mapping
              preload    Preloads the file after every opn reference.
              <msz>      Maximum amount of memory to use (can be n% or real mem).
+             <wsz>      Files larger than this are mapped in windows of this
+                        size as they are read. Unused windows of all files
+                        are unmapped least recently used first when memory is
+                        needed. The default is to map files as a whole.
 
    Output: 0 upon success or !0 upon failure.
 */
@@ -1205,7 +1219,7 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
 {
     char *val;
     int i, j, V_check=-1, V_preld = -1, V_on=-1;
-    long long V_max = 0;
+    long long V_max = 0, V_window = 0;
 
     static struct mmapopts {const char *opname; int otyp;
                             const char *opmsg;} mmopts[] =
@@ -1213,7 +1227,8 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
         {"off",        0, ""},
         {"preload",    1, "memfile preload"},
         {"check",      2, "memfile check"},
-        {"max",        3, "memfile max"}};
+        {"max",        3, "memfile max"},
+        {"window",     4, "memfile window"}};
     int numopts = sizeof(mmopts)/sizeof(struct mmapopts);
 
     if (!(val = Config.GetWord()))
@@ -1251,6 +1266,10 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
                                                 mmopts[i].opmsg, val, &V_max,
                                                 10*1024*1024)) return 1;
                                   break;
+                          case 4: if (XrdOuca2x::a2sz(Eroute, mmopts[i].opmsg,
+                                      val, &V_window, 64*1024,
+                                      1024*1024*1024)) return 1;
+                                  break;
                           default: V_on = 0; break;
                          }
                   val = Config.GetWord();
@@ -1261,6 +1280,7 @@ int XrdOssSys::xmemf(XrdOucStream &Config, XrdSysError &Eroute)
 //
    XrdOssMio::Set(V_on, V_preld, V_check);
    XrdOssMio::Set(V_max);
+   XrdOssMio::SetWindow(V_window);
    return 0;
 }
 
@@ -1397,6 +1417,70 @@ int XrdOssSys::xprerd(XrdOucStream &Config, XrdSysError &Eroute)
       return 0;
 }
   
+/******************************************************************************/
+/*                                x r e a d v                                 */
+/******************************************************************************/
+
+/* Function: xreadv
+
+   Purpose:  To parse the directive: readv {off | [gap <gap>] [span <span>]}
+
+             off      Read each element of a readv request on its own and in
+                      the order given by the client.
+             <gap>    Elements of a readv request are read in offset order and
+                      an element that starts no more than <gap> bytes past the
+                      end of the previous one is read in the same request;
+                      the bytes in between are read and discarded. A value of
+                      0 only merges elements that abut. The default is 64k,
+                      the max is 1M.
+             <span>   The maximum number of bytes a merged request may cover.
+                      The default is 2M, the max is 16M.
+
+   Output: 0 upon success or !0 upon failure.
+*/
+
+int XrdOssSys::xreadv(XrdOucStream &Config, XrdSysError &Eroute)
+{
+    static const long long m1  =  1048576LL;
+    static const long long m16 = 16777216LL;
+    char *val;
+    long long gap = rvGap, span = rvSpan;
+
+      if (!(val = Config.GetWord()))
+         {Eroute.Emsg("Config", "readv parameters not specified"); return 1;}
+
+      if (!strcmp(val, "off")) {rvSpan = 0; return 0;}
+      if (!rvSpan) span = 2097152;
+
+      do {     if (!strcmp(val, "gap"))
+                  {if (!(val = Config.GetWord()))
+                      {Eroute.Emsg("Config","readv gap not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2sz(Eroute,"readv gap",val,&gap,0,m1))
+                      return 1;
+                  }
+          else if (!strcmp(val, "span"))
+                  {if (!(val = Config.GetWord()))
+                      {Eroute.Emsg("Config","readv span not specified");
+                       return 1;
+                      }
+                   if (XrdOuca2x::a2sz(Eroute,"readv span",val,&span,4096,m16))
+                      return 1;
+                  }
+          else {Eroute.Emsg("Config","invalid readv option -",val); return 1;}
+         } while((val = Config.GetWord()));
+
+      if (gap >= span)
+         {Eroute.Emsg("Config","readv gap must be less than the span");
+          return 1;
+         }
+
+      rvGap  = static_cast<int>(gap);
+      rvSpan = static_cast<int>(span);
+      return 0;
+}
+  
 /******************************************************************************/
 /*                                x s p a c e                                 */
 /******************************************************************************/
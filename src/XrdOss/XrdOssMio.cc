@@ -30,6 +30,8 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/param.h>
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -55,6 +57,9 @@ XrdOssMioFile *XrdOssMio::MM_Perm     = 0;
 XrdOssMioFile *XrdOssMio::MM_Idle     = 0;
 XrdOssMioFile *XrdOssMio::MM_IdleLast = 0;
 
+XrdOssMioRegion *XrdOssMio::MM_lruFirst = 0;
+XrdOssMioRegion *XrdOssMio::MM_lruLast  = 0;
+
 char           XrdOssMio::MM_on       = 1;
 char           XrdOssMio::MM_chk      = 0;
 char           XrdOssMio::MM_okmlock  = 1;
@@ -67,6 +72,10 @@ long long      XrdOssMio::MM_pages    = (long long)sysconf(_SC_PHYS_PAGES);
 #endif
 long long      XrdOssMio::MM_max      = MM_pagsz*MM_pages/2;
 long long      XrdOssMio::MM_inuse    = 0;
+long long      XrdOssMio::MM_window   = 0;
+long long      XrdOssMio::MM_hits     = 0;
+long long      XrdOssMio::MM_misses   = 0;
+long long      XrdOssMio::MM_evicts   = 0;
 
 extern XrdSysError OssEroute;
 
@@ -78,11 +87,13 @@ extern XrdOucTrace OssTrace;
 
 void XrdOssMio::Display(XrdSysError &Eroute)
 {
-     char buff[1080];
-     snprintf(buff, sizeof(buff), "       oss.memfile %s%s%s max %lld",
+     char buff[1080], wbuff[64];
+     if (MM_window) snprintf(wbuff, sizeof(wbuff), " window %lld", MM_window);
+        else *wbuff = 0;
+     snprintf(buff, sizeof(buff), "       oss.memfile %s%s%s max %lld%s",
              (MM_on      ? ""            : "off "),
              (MM_preld   ? "preload"     : ""),
-             (MM_chk     ? "check xattr" : ""), MM_max);
+             (MM_chk     ? "check xattr" : ""), MM_max, wbuff);
      Eroute.Say(buff);
 }
 
@@ -127,6 +138,33 @@ XrdOssMioFile *XrdOssMio::Map(char *path, int fd, int opts)
        return mp;
       }
 
+// A file larger than the window size is mapped window by window as it is
+// read (see Read()). Here we only create the window table.
+//
+   if (MM_window && statb.st_size > MM_window)
+      {int nReg = (statb.st_size + MM_window - 1) / MM_window;
+       XrdOssMioRegion **rTab;
+       if (!(rTab = (XrdOssMioRegion **)calloc(nReg, sizeof(XrdOssMioRegion *))))
+          {OssEroute.Emsg("Mio", ENOMEM, "allocate mmap window table for",path);
+           return 0;
+          }
+       mp = new XrdOssMioFile(hashname);
+       mp->Regions    = rTab;
+       mp->numRegions = nReg;
+       mp->Size       = statb.st_size;
+       mp->Dev        = statb.st_dev;
+       mp->Ino        = statb.st_ino;
+       mp->Status     = opts;
+       if (MM_Hash.Add(hashname, mp))
+          {OssEroute.Emsg("Mio", "Hash add failed for", path);
+           delete mp;
+           return 0;
+          }
+       if (opts & OSSMIO_MPRM) {mp->Next = MM_Perm; MM_Perm = mp;}
+       DEBUG("mmap " <<nReg <<" windows of " <<MM_window <<" bytes for " <<path);
+       return mp;
+      }
+
 // Check if memory will be over committed
 //
    if (MM_inuse + statb.st_size > MM_max)
@@ -235,6 +273,132 @@ void *XrdOssMio::preLoad(void *arg)
    return (void *)0;
 }
 
+/******************************************************************************/
+/*                                  R e a d                                   */
+/******************************************************************************/
+
+// Read() copies data from the windows of a file, mapping them as needed. It
+// returns the number of bytes copied, which is less than requested at the end
+// of the file or when a window could not be mapped. In the latter case the
+// caller should read the rest of the data from the file.
+//
+ssize_t XrdOssMio::Read(XrdOssMioFile *mp, int fd, char *buff,
+                        off_t offset, size_t blen)
+{
+   XrdOssMioRegion *rp;
+   ssize_t totBytes = 0;
+   size_t  rLen;
+   off_t   rOff;
+   int     rNum;
+
+// Reads past the end of the file return nothing
+//
+   if (offset >= mp->Size) return 0;
+   if ((off_t)blen > mp->Size - offset) blen = mp->Size - offset;
+
+// Copy the data window by window. The window is pinned while we copy so that
+// it cannot be unmapped underneath us.
+//
+   while(blen)
+        {rNum = offset / MM_window;
+         if (!(rp = Pin(mp, fd, rNum))) break;
+         rOff = offset - (off_t)rNum * MM_window;
+         rLen = rp->Size - rOff;
+         if (rLen > blen) rLen = blen;
+         memcpy(buff, rp->Base + rOff, rLen);
+         Unpin(rp);
+         buff += rLen; offset += rLen; blen -= rLen; totBytes += rLen;
+        }
+   return totBytes;
+}
+
+/******************************************************************************/
+/*                                   P i n                                    */
+/******************************************************************************/
+
+XrdOssMioRegion *XrdOssMio::Pin(XrdOssMioFile *mp, int fd, int rNum)
+{
+#if defined(_POSIX_MAPPED_FILES)
+   EPNAME("MioPin");
+   XrdSysMutexHelper mmMutex(&MM_Mutex);
+   XrdOssMioRegion *rp;
+   off_t  rOff;
+   size_t rSize;
+   void  *addr;
+
+// Track the order in which the windows are referenced
+//
+   if (rNum != mp->lastRegion)
+      {if (rNum == mp->lastRegion+1) mp->seqRegions++;
+          else mp->seqRegions = 0;
+       mp->lastRegion = rNum;
+      }
+
+// If the window is mapped, take it off the unused list
+//
+   if ((rp = mp->Regions[rNum]))
+      {MM_hits++;
+       if (!rp->inUse++)
+          {if (rp->lruPrev) rp->lruPrev->lruNext = rp->lruNext;
+              else MM_lruFirst = rp->lruNext;
+           if (rp->lruNext) rp->lruNext->lruPrev = rp->lruPrev;
+              else MM_lruLast  = rp->lruPrev;
+          }
+       return rp;
+      }
+
+// Make room for the window
+//
+   MM_misses++;
+   rOff  = (off_t)rNum * MM_window;
+   rSize = (mp->Size - rOff < MM_window ? mp->Size - rOff : MM_window);
+   if (MM_inuse + (long long)rSize > MM_max
+   && !Reclaim(MM_inuse + rSize - MM_max)) return 0;
+
+// Map the window
+//
+   if ((addr = mmap(0, rSize, PROT_READ, MAP_PRIVATE, fd, rOff)) == MAP_FAILED)
+      {OssEroute.Emsg("Mio", errno, "mmap file window");
+       return 0;
+      }
+
+// Give the kernel a hint. Windows read in order are brought in as a whole
+// and may be dropped behind the reader; otherwise we let the kernel decide
+// unless preloading was asked for.
+//
+   if (mp->seqRegions)
+      {madvise(addr, rSize, MADV_SEQUENTIAL);
+       madvise(addr, rSize, MADV_WILLNEED);
+      } else if (MM_preld) madvise(addr, rSize, MADV_WILLNEED);
+
+// Lock the window, if need be
+//
+   if (MM_okmlock && (mp->Status & OSSMIO_MLOK) && mlock(addr, rSize))
+      {if (errno == ENOSYS || errno == EPERM)
+          {OssEroute.Emsg("Mio", errno, "mlock file window; feature disabled");
+           MM_okmlock = 0;
+          }
+      }
+
+// Record the window
+//
+   rp = new XrdOssMioRegion;
+   rp->lruNext = rp->lruPrev = 0;
+   rp->File    = mp;
+   rp->Base    = (char *)addr;
+   rp->Size    = rSize;
+   rp->Index   = rNum;
+   rp->inUse   = 1;
+   mp->Regions[rNum] = rp;
+   mp->Mapped += rSize;
+   MM_inuse   += rSize;
+   DEBUG("mmap window " <<rNum <<" (" <<rSize <<" bytes) of " <<mp->HashName);
+   return rp;
+#else
+   return 0;
+#endif
+}
+
 /******************************************************************************/
 /*                               R e c l a i m                                */
 /******************************************************************************/
@@ -247,12 +411,26 @@ int XrdOssMio::Reclaim(off_t amount)
    XrdOssMioFile *mp;
    DEBUG("Trying to reclaim " <<amount <<" bytes.");
 
-// Try to reclaim memory
+// Unmap unused windows first, least recently used first
+//
+   while(MM_lruLast && amount > 0)
+        {amount -= MM_lruLast->Size;
+         MM_evicts++;
+         Unmap(MM_lruLast);
+        }
+
+// Now try to reclaim memory from files no one is using
 //
    while((mp = MM_Idle) && amount > 0)
         {MM_Idle = mp->Next;
-         MM_inuse -= mp->Size;
-         amount   -= mp->Size;
+         if (mp == MM_IdleLast) MM_IdleLast = 0;
+         if (mp->Regions)
+            {amount -= mp->Mapped;
+             Unmap(mp);
+            } else {
+             MM_inuse -= mp->Size;
+             amount   -= mp->Size;
+            }
          MM_Hash.Del(mp->HashName);  // This will delete the object
         }
 
@@ -326,6 +504,83 @@ void XrdOssMio::Set(long long V_max)
    if (V_max > 0) MM_max = V_max;
       else if (V_max < 0) MM_max = MM_pagsz*MM_pages*(-V_max)/100;
 }
+
+// The window size must be a multiple of the page size as windows are mapped
+// at offsets that are multiples of it.
+//
+void XrdOssMio::SetWindow(long long V_window)
+{
+   if (V_window > 0) MM_window = (V_window + MM_pagsz - 1) / MM_pagsz * MM_pagsz;
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+  
+void XrdOssMio::Stats(XrdOssMioStats &Data)
+{
+   XrdSysMutexHelper mmMutex(&MM_Mutex);
+
+   Data.Hits   = MM_hits;
+   Data.Misses = MM_misses;
+   Data.Evicts = MM_evicts;
+   Data.Mapped = MM_inuse;
+}
+
+/******************************************************************************/
+/*                                 U n m a p                                  */
+/******************************************************************************/
+
+// Unmap() can only be called if the caller has the MM_Mutex lock and the
+// window is not in use (i.e. it is on the unused list)!
+//
+void XrdOssMio::Unmap(XrdOssMioRegion *rp)
+{
+   XrdOssMioFile *mp = rp->File;
+
+   if (rp->lruPrev) rp->lruPrev->lruNext = rp->lruNext;
+      else MM_lruFirst = rp->lruNext;
+   if (rp->lruNext) rp->lruNext->lruPrev = rp->lruPrev;
+      else MM_lruLast  = rp->lruPrev;
+
+#if defined(_POSIX_MAPPED_FILES)
+   munmap(rp->Base, rp->Size);
+#endif
+   mp->Regions[rp->Index] = 0;
+   mp->Mapped -= rp->Size;
+   MM_inuse   -= rp->Size;
+   delete rp;
+}
+
+/******************************************************************************/
+
+// Unmap all of the windows of a file no one is using
+//
+void XrdOssMio::Unmap(XrdOssMioFile *mp)
+{
+   int i;
+
+   for (i = 0; i < mp->numRegions; i++)
+       if (mp->Regions[i]) Unmap(mp->Regions[i]);
+}
+
+/******************************************************************************/
+/*                                 U n p i n                                  */
+/******************************************************************************/
+
+// The most recently used window goes to the front of the unused list
+//
+void XrdOssMio::Unpin(XrdOssMioRegion *rp)
+{
+   XrdSysMutexHelper mmMutex(&MM_Mutex);
+
+   if (--rp->inUse > 0) return;
+   rp->lruPrev = 0;
+   rp->lruNext = MM_lruFirst;
+   if (MM_lruFirst) MM_lruFirst->lruPrev = rp;
+      else MM_lruLast = rp;
+   MM_lruFirst = rp;
+}
  
 /******************************************************************************/
 /*             X r d O s s d M i o F i l e   D e s t r u c t o r              */
@@ -333,6 +588,7 @@ void XrdOssMio::Set(long long V_max)
   
 XrdOssMioFile::~XrdOssMioFile()
 {
+    if (Regions) {free(Regions); return;}
 #if defined(_POSIX_MAPPED_FILES)
     munmap((char *)Base, Size);
 #endif
@@ -40,6 +40,16 @@
 #define OSSMIO_MLOK 0x0001
 #define OSSMIO_MMAP 0x0002
 #define OSSMIO_MPRM 0x0004
+
+// Counters of the window cache, see Stats()
+//
+struct XrdOssMioStats
+{
+long long Hits;       // Reads from a window that was mapped
+long long Misses;     // Windows that had to be mapped
+long long Evicts;     // Windows unmapped to make room
+long long Mapped;     // Bytes currently mapped (files and windows)
+};
   
 class XrdOssMio
 {
@@ -54,15 +64,26 @@ static XrdOssMioFile *Map(char *path, int fd, int opts);
 
 static void          *preLoad(void *arg);
 
+static ssize_t        Read(XrdOssMioFile *mp, int fd, char *buff,
+                           off_t offset, size_t blen);
+
 static void           Recycle(XrdOssMioFile *mp);
 
 static void           Set(int V_off, int V_preld, int V_check);
 
 static void           Set(long long V_max);
 
+static void           SetWindow(long long V_window);
+
+static void           Stats(XrdOssMioStats &Data);
+
 private:
+static XrdOssMioRegion *Pin(XrdOssMioFile *mp, int fd, int rNum);
 static int  Reclaim(off_t amount);
 static int  Reclaim(XrdOssMioFile *mp);
+static void Unmap(XrdOssMioRegion *rp);
+static void Unmap(XrdOssMioFile *mp);
+static void Unpin(XrdOssMioRegion *rp);
 
 static XrdOucHash<XrdOssMioFile> MM_Hash;
 
@@ -70,6 +91,8 @@ static XrdSysMutex    MM_Mutex;
 static XrdOssMioFile *MM_Perm;
 static XrdOssMioFile *MM_Idle;
 static XrdOssMioFile *MM_IdleLast;
+static XrdOssMioRegion *MM_lruFirst;
+static XrdOssMioRegion *MM_lruLast;
 
 static char       MM_on;
 static char       MM_chk;
@@ -79,5 +102,9 @@ static long long  MM_max;
 static long long  MM_pagsz;
 static long long  MM_pages;
 static long long  MM_inuse;
+static long long  MM_window;
+static long long  MM_hits;
+static long long  MM_misses;
+static long long  MM_evicts;
 };
 #endif
@@ -32,29 +32,57 @@
 
 #include <time.h>
 #include <sys/types.h>
+
+// A file that is too large to be mapped as a whole is mapped in aligned
+// windows of a fixed size. Unused windows of all files are kept on a least
+// recently used list and are unmapped when memory is needed.
+//
+class XrdOssMioFile;
+
+struct XrdOssMioRegion
+{
+XrdOssMioRegion *lruNext;   // Next (older) unused region
+XrdOssMioRegion *lruPrev;   // Previous (newer) unused region
+XrdOssMioFile   *File;
+char            *Base;
+size_t           Size;
+int              Index;     // Window number within the file
+int              inUse;     // Number of reads copying from the region
+};
   
 class XrdOssMioFile
 {
 public:
 friend class XrdOssMio;
 
-off_t Export(void **Addr) {*Addr = Base; return Size;}
+off_t Export(void **Addr) {if (Regions) {*Addr = 0; return 0;}
+                           *Addr = Base; return Size;
+                          }
+
+int   isWindowed() {return Regions != 0;}
 
        XrdOssMioFile(char *hname)
                     {strcpy(HashName, hname); 
-                     inUse = 1; Next = 0; Size = 0;
+                     inUse = 1; Next = 0; Size = 0; Base = 0;
+                     Regions = 0; numRegions = 0; Mapped = 0;
+                     lastRegion = -1; seqRegions = 0;
                     }
       ~XrdOssMioFile();
 
 private:
 
-XrdOssMioFile *Next;
-dev_t          Dev;
-ino_t          Ino;
-int            Status;
-int            inUse;
-void          *Base;
-off_t          Size;
-char           HashName[64];
+XrdOssMioFile    *Next;
+dev_t             Dev;
+ino_t             Ino;
+int               Status;
+int               inUse;
+void             *Base;
+off_t             Size;
+XrdOssMioRegion **Regions;     // Window table, if mapped by window
+long long         Mapped;      // Bytes mapped in windows
+int               numRegions;
+int               lastRegion;  // Window referenced last
+int               seqRegions;  // Windows referenced in ascending order
+char              HashName[64];
 };
 #endif
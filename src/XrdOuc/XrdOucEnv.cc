@@ -34,51 +34,58 @@
 
 #include "XrdOuc/XrdOucEnv.hh"
   
+/******************************************************************************/
+/*                               G l o b a l s                                */
+/******************************************************************************/
+
+extern unsigned long XrdOucHashVal2(const char *KeyVal, int KeyLen);
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
   
 XrdOucEnv::XrdOucEnv(const char *vardata, int varlen, 
                      const XrdSecEntity *secent)
-                    : env_Hash(8,13), secEntity(secent)
+                    : secEntity(secent), global_env(0), global_len(0),
+                      env_Arena(0), env_Vars(env_Fixed), env_Num(0),
+                      env_Max(envFixed)
 {
-   char *vdp, varsave, *varname, *varvalu;
-
-   if (!vardata) {global_env = 0; global_len = 0; return;}
+   if (!vardata) return;
 
 // Get the length of the global information (don't rely on its being correct)
 //
    if (!varlen) varlen = strlen(vardata);
 
-// We want our env copy to start with a single ampersand
+// We want our env copy to start with a single ampersand. We allocate room for
+// a second copy that is chopped up into names and values right away.
 //
    while(*vardata == '&' && varlen) {vardata++; varlen--;}
-   if (!varlen) {global_env = 0; global_len = 0; return;}
-   global_env = (char *)malloc(varlen+2);
-   *global_env = '&'; vdp = global_env+1;
-   memcpy((void *)vdp, (const void *)vardata, (size_t)varlen);
-   *(vdp+varlen) = '\0'; global_len = varlen+1;
-
-// scan through the string looking for '&'
-//
-   while(*vdp)
-        {while(*vdp == '&') vdp++;
-         varname = vdp;
-
-         while(*vdp && *vdp != '=') vdp++;  // &....=
-         if (!*vdp) break;
-         *vdp = '\0';
-         varvalu = ++vdp;
+   if (!varlen) return;
+   if ((varlen+2)*2 <= envBuffSz) global_env = env_Buff;
+      else global_env = (char *)malloc((varlen+2)*2);
+   *global_env = '&';
+   memcpy((void *)(global_env+1), (const void *)vardata, (size_t)varlen);
+   *(global_env+1+varlen) = '\0'; global_len = varlen+1;
+   env_Arena  = global_env + varlen + 2;
+   Parse();
+}
 
-         while(*vdp && *vdp != '&') vdp++;  // &....=....&
-         varsave = *vdp; *vdp = '\0';
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
 
-         if (*varname && *varvalu)
-            env_Hash.Rep(varname, strdup(varvalu), 0, Hash_dofree);
+XrdOucEnv::~XrdOucEnv()
+{
+   int i;
 
-         *vdp = varsave; *(varvalu-1) = '=';
-        }
-   return;
+// Free whatever was set by the caller
+//
+   for (i = 0; i < env_Num; i++)
+       {if (env_Vars[i].Owned & 1) free((void *)env_Vars[i].Name);
+        if (env_Vars[i].Owned & 2) free((void *)env_Vars[i].Value);
+       }
+   if (env_Vars != env_Fixed) free(env_Vars);
+   if (global_env && global_env != env_Buff) free(global_env);
 }
 
 /******************************************************************************/
@@ -157,6 +164,19 @@ bool XrdOucEnv::Import( const char *var, long  &val )
   return true;
 }
 
+/******************************************************************************/
+/*                                   G e t                                    */
+/******************************************************************************/
+
+char *XrdOucEnv::Get(const char *varname)
+{
+   EnvVar *vP;
+
+   if (!(vP = Find(varname, XrdOucHashVal2(varname, strlen(varname)))))
+      return (char *)0;
+   return vP->Value;
+}
+
 /******************************************************************************/
 /*                                G e t I n t                                 */
 /******************************************************************************/
@@ -168,7 +188,7 @@ long XrdOucEnv::GetInt(const char *varname)
 // Retrieve a char* value from the Hash table and convert it into a long.
 // Return -999999999 if the varname does not exist
 //
-  if ((cP = env_Hash.Find(varname)) == NULL) return -999999999;
+  if ((cP = Get(varname)) == NULL) return -999999999;
   return atol(cP);
 }
 
@@ -182,7 +202,7 @@ void XrdOucEnv::PutInt(const char *varname, long value)
 //
   char stringValue[24];
   sprintf(stringValue, "%ld", value);
-  env_Hash.Rep(varname, strdup(stringValue), 0, Hash_dofree);
+  Set(varname, strdup(stringValue));
 }
 
 /******************************************************************************/
@@ -197,7 +217,7 @@ void *XrdOucEnv::GetPtr(const char *varname)
 
 // Retrieve the variable from the hash
 //
-   if ((cP = env_Hash.Find(varname)) == NULL) return (void *)0;
+   if ((cP = Get(varname)) == NULL) return (void *)0;
 
 // Verify that the string is not too long or too short
 //
@@ -238,7 +258,121 @@ void XrdOucEnv::PutPtr(const char *varname, void *value)
                   }
    Buff[j] = '\0';
 
-// Replace the value in he hash
+// Replace the value in the table
+//
+   Set(varname, strdup(Buff));
+}
+
+/******************************************************************************/
+/*                                   P u t                                    */
+/******************************************************************************/
+
+void XrdOucEnv::Put(const char *varname, const char *value)
+{
+   Set(varname, strdup(value));
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                  F i n d                                   */
+/******************************************************************************/
+  
+XrdOucEnv::EnvVar *XrdOucEnv::Find(const char *varname, unsigned long hval)
+{
+   int i;
+
+// Variables are replaced in place, so there is only one of each
+//
+   for (i = 0; i < env_Num; i++)
+       if (env_Vars[i].Hash == hval && !strcmp(env_Vars[i].Name, varname))
+          return &env_Vars[i];
+   return (EnvVar *)0;
+}
+
+/******************************************************************************/
+/*                                 P a r s e                                  */
+/******************************************************************************/
+
+void XrdOucEnv::Parse()
+{
+   char *vdp, *varname, *varvalu;
+   int   nlen;
+
+// Chop up the second copy of the environment; the first one stays intact
+//
+   memcpy(env_Arena, global_env, global_len+1);
+   vdp = env_Arena;
+
+// scan through the string looking for '&'
+//
+   while(*vdp)
+        {while(*vdp == '&') vdp++;
+         varname = vdp;
+
+         if (!(vdp = index(vdp, '='))) break;  // &....=
+         *vdp = '\0';
+         nlen = vdp - varname;
+         varvalu = ++vdp;
+
+         if ((vdp = index(vdp, '&'))) *vdp++ = '\0';  // &....=....&
+            else vdp = varvalu + strlen(varvalu);
+
+         if (*varname && *varvalu)
+            {EnvVar *vP, theVar;
+             theVar.Name  = varname;
+             theVar.Value = varvalu;
+             theVar.Hash  = XrdOucHashVal2(varname, nlen);
+             theVar.Owned = 0;
+             if ((vP = Find(varname, theVar.Hash))) vP->Value = varvalu;
+                else if (env_Num < env_Max || Grow())
+                        env_Vars[env_Num++] = theVar;
+            }
+        }
+}
+
+/******************************************************************************/
+/*                                   S e t                                    */
+/******************************************************************************/
+
+void XrdOucEnv::Set(const char *varname, char *value)
+{
+   unsigned long hval = XrdOucHashVal2(varname, strlen(varname));
+   EnvVar *vP;
+
+// Replace the value of an existing variable
 //
-   env_Hash.Rep(varname, strdup(Buff), 0, Hash_dofree);
+   if ((vP = Find(varname, hval)))
+      {if (vP->Owned & 2) free(vP->Value);
+       vP->Value  = value;
+       vP->Owned |= 2;
+       return;
+      }
+
+// Add a new variable
+//
+   if (env_Num >= env_Max && !Grow()) {free(value); return;}
+   vP = &env_Vars[env_Num++];
+   vP->Name  = strdup(varname);
+   vP->Value = value;
+   vP->Hash  = hval;
+   vP->Owned = 3;
+}
+
+/******************************************************************************/
+/*                                  G r o w                                   */
+/******************************************************************************/
+
+bool XrdOucEnv::Grow()
+{
+   EnvVar *newVars;
+   int     newMax = env_Max*2;
+
+   if (!(newVars = (EnvVar *)malloc(newMax*sizeof(EnvVar)))) return false;
+   memcpy(newVars, env_Vars, env_Num*sizeof(EnvVar));
+   if (env_Vars != env_Fixed) free(env_Vars);
+   env_Vars = newVars;
+   env_Max  = newMax;
+   return true;
 }
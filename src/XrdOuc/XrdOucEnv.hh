@@ -38,6 +38,11 @@
 
 class XrdSecEntity;
 
+// The variables are parsed when the object is constructed and are kept in a
+// flat table that points into a single copy of the environment string; only
+// variables that are set with Put() are allocated. Get() does not modify the
+// object so that it may be used by several threads as long as none sets it.
+
 class XrdOucEnv
 {
 public:
@@ -61,7 +66,7 @@ static bool  Import( const char *var, long  &val );
 // Get() returns the address of the string associated with the variable
 //       name. If no association exists, zero is returned.
 //
-       char *Get(const char *varname) {return env_Hash.Find(varname);}
+       char *Get(const char *varname);
 
 // GetInt() returns a long integer value. If the variable varname is not found
 //           in the hash table, return -999999999.       
@@ -75,10 +80,9 @@ static bool  Import( const char *var, long  &val );
 
 // Put() associates a string value with the a variable name. If one already
 //       exists, it is replaced. The passed value and variable strings are
-//       duplicated (value here, variable by env_Hash).
+//       duplicated.
 //
-       void  Put(const char *varname, const char *value)
-                {env_Hash.Rep((char *)varname, strdup(value), 0, Hash_dofree);}
+       void  Put(const char *varname, const char *value);
 
 // PutInt() puts a long integer value into the hash. Internally, the value gets
 //          converted into a char*
@@ -107,13 +111,32 @@ inline const XrdSecEntity *secEnv() {return secEntity;}
        XrdOucEnv(const char *vardata=0, int vardlen=0, 
                  const XrdSecEntity *secent=0);
 
-      ~XrdOucEnv() {if (global_env) free((void *)global_env);}
+      ~XrdOucEnv();
 
 private:
 
-XrdOucHash<char> env_Hash;
+struct EnvVar {const char   *Name;
+               char         *Value;
+               unsigned long Hash;
+               char          Owned;  // Name(1) and/or Value(2) allocated
+              };
+
+static const int envFixed = 16;
+static const int envBuffSz= 256;
+
+EnvVar *Find(const char *varname, unsigned long hval);
+bool    Grow();
+void    Parse();
+void    Set(const char *varname, char *value);
+
 const XrdSecEntity *secEntity;
-char *global_env;
-int   global_len;
+char   *global_env;
+int     global_len;
+char   *env_Arena;          // Parse copy of global_env (names & values)
+EnvVar *env_Vars;           // -> env_Fixed or an allocated table
+int     env_Num;            // Number of variables in env_Vars
+int     env_Max;            // Size of env_Vars
+EnvVar  env_Fixed[envFixed];
+char    env_Buff[envBuffSz];// Holds both copies of short environments
 };
 #endif
@@ -0,0 +1,265 @@
+#ifndef __XRDOUCPUPCODEC_HH__
+#define __XRDOUCPUPCODEC_HH__
+/******************************************************************************/
+/*                                                                            */
+/*                     X r d O u c P u p C o d e c . h h                      */
+/*                                                                            */
+/* (c) 2007 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <string.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+#include "XrdOuc/XrdOucPup.hh"
+
+// The classes here are a compile-time counterpart to the XrdOucPupArgs tables
+// interpreted by XrdOucPup. A codec is a list of field types, each naming the
+// member of the target structure it handles, so the compiler generates
+// straight line code for the layout. Strings are decoded in place as pointers
+// into the buffer and all lengths are checked as each item is consumed. The
+// wire format is identical to that of XrdOucPup. A codec only reports success
+// or failure; callers should use XrdOucPup to diagnose a failure.
+
+/******************************************************************************/
+/*                    X r d O u c P u p C o d e c S t a t e                   */
+/******************************************************************************/
+  
+struct XrdOucPupCodecState
+{const char   *bp;      // Unpack: Next byte to unpack
+ const char   *bend;    // Unpack: End of buffer
+ struct iovec *vP;      // Pack:   Next iovec element to fill
+ struct iovec *vE;      // Pack:   Last iovec element+1
+ char         *wP;      // Pack:   Next free byte in work buffer
+ int           dlen;    // Both:   Length of the previous item
+ int           TotLen;  // Pack:   Total packed length
+ int           Aok;     // Unpack: Remaining items are optional
+};
+
+/******************************************************************************/
+/*                     X r d O u c P u p C o d e c S t r                      */
+/******************************************************************************/
+
+// A null terminated string or null pointer (i.e. PT_char with Dlen < 0). The
+// member may be a char * or a const char *.
+//
+template<class T, class MT, MT T::*M>
+struct XrdOucPupCodecStr
+{
+enum {Items = 1};
+
+static inline bool Pack(XrdOucPupCodecState &cs, T *base)
+                  {static char Nil[] = {PT_char, '\0'};
+                   const char *data = base->*M;
+                   unsigned short n16;
+                   if (!data)
+                      {cs.vP->iov_base = Nil; cs.vP->iov_len = 2;
+                       cs.vP++; cs.TotLen += 2;
+                       return cs.vP < cs.vE;
+                      }
+                   cs.dlen = strlen(data)+1;
+                   if (cs.dlen > XrdOucPup::MaxLen || cs.vP+1 >= cs.vE)
+                      return false;
+                   n16 = htons(static_cast<unsigned short>(cs.dlen));
+                   memcpy(cs.wP, &n16, sizeof(n16));
+                   cs.vP->iov_base = cs.wP;  cs.vP->iov_len = sizeof(n16);
+                   cs.vP++; cs.wP += sizeof(n16);
+                   cs.vP->iov_base = (char *)data; cs.vP->iov_len = cs.dlen;
+                   cs.vP++;
+                   cs.TotLen += cs.dlen + sizeof(n16);
+                   return cs.vP < cs.vE;
+                  }
+
+static inline bool Unpack(XrdOucPupCodecState &cs, T *base)
+                  {unsigned short n16;
+                   if (cs.bp+2 > cs.bend || (*cs.bp & PT_short)) return false;
+                   memcpy(&n16, cs.bp, sizeof(n16));
+                   cs.dlen = static_cast<int>(ntohs(n16));
+                   cs.bp += sizeof(n16);
+                   if (cs.dlen)
+                      {if (cs.bp+cs.dlen > cs.bend) return false;
+                       base->*M = (char *)cs.bp;
+                       cs.bp += cs.dlen;
+                      } else {
+                       if (!cs.Aok) return false;
+                       base->*M = 0;
+                      }
+                   return true;
+                  }
+};
+
+/******************************************************************************/
+/*                     X r d O u c P u p C o d e c I n t                      */
+/******************************************************************************/
+
+// An unsigned int (i.e. PT_int)
+//
+template<class T, unsigned int T::*M>
+struct XrdOucPupCodecInt
+{
+enum {Items = 1};
+
+static inline bool Pack(XrdOucPupCodecState &cs, T *base)
+                  {unsigned int n32 = htonl(base->*M);
+                   *cs.wP = static_cast<char>(PT_int);
+                   memcpy(cs.wP+1, &n32, sizeof(n32));
+                   cs.vP->iov_base = cs.wP; cs.vP->iov_len = sizeof(n32)+1;
+                   cs.vP++; cs.wP += sizeof(n32)+1;
+                   cs.TotLen += sizeof(n32)+1; cs.dlen = sizeof(n32);
+                   return cs.vP < cs.vE;
+                  }
+
+static inline bool Unpack(XrdOucPupCodecState &cs, T *base)
+                  {const char *dp;
+                   unsigned int n32;
+                   if (cs.bp+2 > cs.bend
+                   || (*cs.bp & PT_MaskT) != (PT_int & PT_MaskT)) return false;
+                   dp = (*cs.bp & PT_Inline ? cs.bp : cs.bp+1);
+                   if (dp+sizeof(n32) > cs.bend) return false;
+                   memcpy(&n32, dp, sizeof(n32));
+                   if (dp == cs.bp) *(unsigned char *)&n32 &= PT_MaskD;
+                   base->*M = ntohl(n32);
+                   cs.dlen = sizeof(n32);
+                   cs.bp   = dp + sizeof(n32);
+                   return true;
+                  }
+};
+
+/******************************************************************************/
+/*                    X r d O u c P u p C o d e c D l e n                     */
+/******************************************************************************/
+
+// Sets the member to the length of the previous item (i.e. PT_Datlen)
+//
+template<class T, class MT, MT T::*M>
+struct XrdOucPupCodecDlen
+{
+enum {Items = 1};
+
+static inline bool Pack(XrdOucPupCodecState &cs, T *base)
+                  {base->*M = cs.dlen; return true;}
+
+static inline bool Unpack(XrdOucPupCodecState &cs, T *base)
+                  {base->*M = cs.dlen; return true;}
+};
+
+/******************************************************************************/
+/*                   X r d O u c P u p C o d e c F e n c e                    */
+/******************************************************************************/
+
+// Remaining strings may be empty when unpacking (i.e. PT_Fence)
+//
+template<class T>
+struct XrdOucPupCodecFence
+{
+enum {Items = 1};
+
+static inline bool Pack(XrdOucPupCodecState &cs, T *base) {return true;}
+
+static inline bool Unpack(XrdOucPupCodecState &cs, T *base)
+                  {cs.Aok = 1; return true;}
+};
+
+/******************************************************************************/
+/*                    X r d O u c P u p C o d e c N o n e                     */
+/******************************************************************************/
+
+// Filler for unused codec slots
+//
+template<class T>
+struct XrdOucPupCodecNone
+{
+enum {Items = 0};
+
+static inline bool Pack(XrdOucPupCodecState &cs, T *base) {return true;}
+
+static inline bool Unpack(XrdOucPupCodecState &cs, T *base) {return true;}
+};
+
+/******************************************************************************/
+/*                        X r d O u c P u p C o d e c                         */
+/******************************************************************************/
+
+// The codec itself. The list of items corresponds to an XrdOucPupArgs table
+// less the terminating PT_End or PT_EndFill entry.
+//
+template<class T,
+         class F0,                         class F1 = XrdOucPupCodecNone<T>,
+         class F2 = XrdOucPupCodecNone<T>, class F3 = XrdOucPupCodecNone<T>,
+         class F4 = XrdOucPupCodecNone<T>, class F5 = XrdOucPupCodecNone<T>,
+         class F6 = XrdOucPupCodecNone<T>, class F7 = XrdOucPupCodecNone<T>,
+         class F8 = XrdOucPupCodecNone<T>, class F9 = XrdOucPupCodecNone<T> >
+class XrdOucPupCodec
+{
+public:
+
+enum {Items = F0::Items + F1::Items + F2::Items + F3::Items + F4::Items
+            + F5::Items + F6::Items + F7::Items + F8::Items + F9::Items};
+
+// Pack: Packs base into the iovec elements starting at iovP and ending before
+//       iovE. The Work buffer is used for interleaved meta-data and should be
+//       sized 9 times the number of items. Returns the number of iovec
+//       elements used and the total packed length in TotLen or zero if the
+//       data does not fit.
+//
+static int Pack(struct iovec *iovP, struct iovec *iovE, T *base, char *Work,
+                int &TotLen)
+               {XrdOucPupCodecState cs = {0, 0, iovP, iovE, Work, 0, 0, 0};
+                if (F0::Pack(cs, base) && F1::Pack(cs, base)
+                &&  F2::Pack(cs, base) && F3::Pack(cs, base)
+                &&  F4::Pack(cs, base) && F5::Pack(cs, base)
+                &&  F6::Pack(cs, base) && F7::Pack(cs, base)
+                &&  F8::Pack(cs, base) && F9::Pack(cs, base))
+                   {TotLen = cs.TotLen;
+                    return static_cast<int>(cs.vP - iovP);
+                   }
+                return 0;
+               }
+
+// Unpack: Unpacks the buffer starting at buff and ending before bend into
+//         base. String members point into the buffer. Returns the number of
+//         items (as does XrdOucPup::Unpack()) or zero upon failure.
+//
+static int Unpack(const char *buff, const char *bend, T *base)
+                 {XrdOucPupCodecState cs = {buff, bend, 0, 0, 0, 0, 0, 0};
+                  if (F0::Unpack(cs, base) && F1::Unpack(cs, base)
+                  &&  F2::Unpack(cs, base) && F3::Unpack(cs, base)
+                  &&  F4::Unpack(cs, base) && F5::Unpack(cs, base)
+                  &&  F6::Unpack(cs, base) && F7::Unpack(cs, base)
+                  &&  F8::Unpack(cs, base) && F9::Unpack(cs, base))
+                     return Items;
+                  return 0;
+                 }
+};
+
+// Convenience macros paralleling setPUP1()
+//
+#define PUPstr(Base,Var)  XrdOucPupCodecStr<Base, char *, &Base::Var>
+#define PUPcstr(Base,Var) XrdOucPupCodecStr<Base, const char *, &Base::Var>
+#define PUPint(Base,Var)  XrdOucPupCodecInt<Base, &Base::Var>
+#define PUPdlen(Base,Var) XrdOucPupCodecDlen<Base, int, &Base::Var>
+#define PUPfence(Base)    XrdOucPupCodecFence<Base>
+#endif
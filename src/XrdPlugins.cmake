@@ -44,6 +44,7 @@ add_library(
   XrdBwm/XrdBwmHandle.cc       XrdBwm/XrdBwmHandle.hh
   XrdBwm/XrdBwmLogger.cc       XrdBwm/XrdBwmLogger.hh
   XrdBwm/XrdBwmPolicy1.cc      XrdBwm/XrdBwmPolicy1.hh
+  XrdBwm/XrdBwmPolicy2.cc      XrdBwm/XrdBwmPolicy2.hh
                                XrdBwm/XrdBwmPolicy.hh
                                XrdBwm/XrdBwmTrace.hh )
 
@@ -60,6 +61,20 @@ set_target_properties(
   SOVERSION ${XRD_BWM_SOVERSION}
   LINK_INTERFACE_LIBRARIES "" )
 
+#-------------------------------------------------------------------------------
+# xrdbwmsim: replays transfer traces against the bwm policies (not installed)
+#-------------------------------------------------------------------------------
+add_executable(
+  xrdbwmsim
+  XrdBwm/XrdBwmSim.cc
+  XrdBwm/XrdBwmPolicy1.cc
+  XrdBwm/XrdBwmPolicy2.cc )
+
+target_link_libraries(
+  xrdbwmsim
+  XrdUtils
+  pthread )
+
 #-------------------------------------------------------------------------------
 # Install
 #-------------------------------------------------------------------------------
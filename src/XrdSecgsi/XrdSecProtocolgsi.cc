@@ -160,6 +160,7 @@ XrdSecgsiAuthzKey_t XrdSecProtocolgsi::AuthzKey = 0;
 int    XrdSecProtocolgsi::AuthzCertFmt = -1;
 int    XrdSecProtocolgsi::GMAPCacheTimeOut = -1;
 int    XrdSecProtocolgsi::AuthzCacheTimeOut = 43200;  // 12h, default
+int    XrdSecProtocolgsi::VerCacheTimeOut = 0;  // disabled, default
 String XrdSecProtocolgsi::SrvAllowedNames;
 int    XrdSecProtocolgsi::VOMSAttrOpt = 1;
 XrdSecgsiAuthz_t XrdSecProtocolgsi::VOMSFun = 0;
@@ -182,6 +183,7 @@ XrdSutCache XrdSecProtocolgsi::cachePxy;  // Client proxies
 XrdSutCache XrdSecProtocolgsi::cacheGMAP; // Grid map entries
 XrdSutCache XrdSecProtocolgsi::cacheGMAPFun; // Entries mapped by GMAPFun
 XrdSutCache XrdSecProtocolgsi::cacheAuthzFun; // Entities filled by AuthzFun
+XrdSutCache XrdSecProtocolgsi::cacheVerified; // Verified client chains
 //
 // CRL stack
 GSICrlStack  XrdSecProtocolgsi::stackCRL; // Stack of CRL in use
@@ -816,6 +818,27 @@ char *XrdSecProtocolgsi::Init(gsiOptions opt, XrdOucErrInfo *erp)
          DEBUG("grid-map cache entries expire after "<<GMAPCacheTimeOut<<" secs");
       }
 
+      //
+      // Cache of verified client chains: repeated logins with the same proxy
+      // skip the full chain verification while the entry is valid
+      if (opt.vercacheto > 0) {
+         if (cacheVerified.Empty()) {
+            if (cacheVerified.Init(100) != 0) {
+               ErrF(erp, kGSErrError, "Internal cache for verified chains failed to initialize"); 
+               PRINT(erp->getErrText());
+               return Parms;
+            }
+         } else {
+            if (cacheVerified.Reset() != 0) {
+               ErrF(erp, kGSErrError, "Internal cache for verified chains failed to reset"); 
+               PRINT(erp->getErrText());
+               return Parms;
+            }
+         }
+         VerCacheTimeOut = opt.vercacheto;
+         DEBUG("verified chain cache entries expire after "<<VerCacheTimeOut<<" secs");
+      }
+
       //
       // Request for delegated proxies
       if (opt.dlgpxy == 1 || opt.dlgpxy == 3)
@@ -2256,6 +2279,8 @@ void gsiOptions::Print(XrdOucTrace *t)
          if (authzfunparms) POPTS(t, " Authorization function parms: ignored (no authz function defined)");
       }
       POPTS(t, " Client proxy availability in XrdSecEntity.endorsement: "<< authzpxy);
+      if (vercacheto > 0)
+         POPTS(t, " Verified chain cache entries expiration (secs): "<< vercacheto);
       POPTS(t, " VOMS option: "<< vomsat);
       if (vomsfun) {
          POPTS(t, " VOMS extraction function: " << vomsfun);
@@ -2502,6 +2527,7 @@ char *XrdSecProtocolgsiInit(const char mode,
       //              [-authzfunparms:<authz_function_init_parameters>]
       //              [-authzto:<authz_cache_entry_validity_in_secs>]
       //              [-gmapto:<grid_map_cache_entry_validity_in_secs>]
+      //              [-vercacheto:<verified_chain_cache_entry_validity_in_secs>]
       //              [-gmapopt:<grid_map_check_option>]
       //              [-dlgpxy:<proxy_req_option>]
       //              [-exppxy:<filetemplate>]
@@ -2534,6 +2560,7 @@ char *XrdSecProtocolgsiInit(const char mode,
       int ogmap = 1;
       int gmapto = -1;
       int authzto = -1;
+      int vercacheto = 0;
       int dlgpxy = 0;
       int authzpxy = 0;
       int vomsat = 1;
@@ -2582,6 +2609,8 @@ char *XrdSecProtocolgsiInit(const char mode,
                authzto = atoi(op+9);
             } else if (!strncmp(op, "-gmapto:",8)) {
                gmapto = atoi(op+8);
+            } else if (!strncmp(op, "-vercacheto:",12)) {
+               vercacheto = atoi(op+12);
             } else if (!strncmp(op, "-dlgpxy:",8)) {
                dlgpxy = atoi(op+8);
             } else if (!strncmp(op, "-exppxy:",8)) {
@@ -2618,6 +2647,7 @@ char *XrdSecProtocolgsiInit(const char mode,
       opts.ogmap = ogmap;
       opts.gmapto = gmapto;
       opts.authzto = authzto;
+      opts.vercacheto = vercacheto;
       opts.dlgpxy = dlgpxy;
       opts.authzpxy = authzpxy;
       opts.vomsat = vomsat;
@@ -3523,13 +3553,26 @@ int XrdSecProtocolgsi::ServerDoCert(XrdSutBuffer *br,  XrdSutBuffer **bm,
       return -1;
    }
    //
-   // Verify the chain
-   x509ChainVerifyOpt_t vopt = {0,static_cast<int>(hs->TimeStamp),-1,hs->Crl};
-   XrdCryptoX509Chain::EX509ChainErr ecode = XrdCryptoX509Chain::kNone;
-   if (!(hs->Chain->Verify(ecode, &vopt))) {
-      cmsg = "certificate chain verification failed: ";
-      cmsg += hs->Chain->LastError();
-      return -1;
+   // Verify the chain, unless the very same chain has already been verified
+   // against the CRL currently in use
+   String fp;
+   bool useVerCache = (VerCacheTimeOut > 0 && ChainFingerprint(bck, sessionCF, fp));
+   if (useVerCache && ChainVerified(fp.c_str(), hs->Crl, hs->TimeStamp)) {
+      // Verification also puts the chain in order; do it here
+      if (hs->Chain->Reorder() != 0) {
+         cmsg = "certificate chain verification failed: inconsistent chain";
+         return -1;
+      }
+      DEBUG("chain found in the verified chain cache");
+   } else {
+      x509ChainVerifyOpt_t vopt = {0,static_cast<int>(hs->TimeStamp),-1,hs->Crl};
+      XrdCryptoX509Chain::EX509ChainErr ecode = XrdCryptoX509Chain::kNone;
+      if (!(hs->Chain->Verify(ecode, &vopt))) {
+         cmsg = "certificate chain verification failed: ";
+         cmsg += hs->Chain->LastError();
+         return -1;
+      }
+      if (useVerCache) SaveVerified(fp.c_str(), hs->Chain, hs->Crl, hs->TimeStamp);
    }
 
    //
@@ -3609,6 +3652,103 @@ int XrdSecProtocolgsi::ServerDoCert(XrdSutBuffer *br,  XrdSutBuffer **bm,
    return 0;
 }
 
+//_________________________________________________________________________
+bool XrdSecProtocolgsi::ChainFingerprint(XrdSutBucket *bck,
+                                         XrdCryptoFactory *cf, String &fp)
+{
+   // Compute the fingerprint of the certificate chain in bucket 'bck', i.e.
+   // the hex form of its SHA-1 digest. Return 1 on success, 0 otherwise.
+   EPNAME("ChainFingerprint");
+
+   if (!bck || !cf || bck->size <= 0) return 0;
+
+   XrdCryptoMsgDigest *md = cf->MsgDigest("sha1");
+   if (!md || md->Update(bck->buffer, bck->size) != 0 || md->Final() != 0) {
+      NOTIFY("WARNING: could not compute chain fingerprint");
+      SafeDelete(md);
+      return 0;
+   }
+
+   // AsHexString() uses a static buffer: convert locally to be thread safe
+   char hex[128];
+   int len = (md->Length() < 63) ? md->Length() : 63;
+   bool ok = (XrdSutToHex(md->Buffer(), len, hex) == 0);
+   if (ok) fp = hex;
+   SafeDelete(md);
+   return ok;
+}
+
+//_________________________________________________________________________
+bool XrdSecProtocolgsi::ChainVerified(const char *fp, XrdCryptoX509Crl *crl,
+                                      int now)
+{
+   // Check whether the chain with fingerprint 'fp' has been successfully
+   // verified less than VerCacheTimeOut secs ago, is still within its
+   // validity period and was checked against the same version of the CRL
+   // now in use. Stale entries are removed.
+   EPNAME("ChainVerified");
+
+   XrdSutCacheRef pfeRef;
+   XrdSutPFEntry *cent = cacheVerified.Get(pfeRef, fp);
+   if (!cent) return 0;
+   if (cent->status != kPFE_ok || cent->buf1.len != 2*sizeof(kXR_int32)) {
+      pfeRef.UnLock();
+      return 0;
+   }
+
+   kXR_int32 info[2];   // {notafter, CRL last update}
+   memcpy(info, cent->buf1.buf, sizeof(info));
+   kXR_int32 crlupd = (crl) ? crl->LastUpdate() : -1;
+
+   bool expired = 0;
+   if ((now - cent->mtime) > VerCacheTimeOut) expired = 1;
+   if (now > info[0]) expired = 1;
+   if (crlupd != info[1]) expired = 1;
+   if (expired) {
+      cent->status = kPFE_disabled; // Prevent use after unlock!
+      pfeRef.UnLock();              // Discarding cent!
+      cacheVerified.Remove(fp);
+      DEBUG("verified chain entry expired or CRL changed: "<<fp);
+      return 0;
+   }
+   cent->cnt++;
+   return 1;
+}
+
+//_________________________________________________________________________
+void XrdSecProtocolgsi::SaveVerified(const char *fp, X509Chain *chain,
+                                     XrdCryptoX509Crl *crl, int now)
+{
+   // Record that the chain with fingerprint 'fp' was successfully verified
+   // at time 'now' against 'crl'. The entry is never valid beyond the
+   // earliest expiration time of the certificates in the chain.
+   EPNAME("SaveVerified");
+
+   kXR_int32 info[2];   // {notafter, CRL last update}
+   info[0] = now + VerCacheTimeOut;
+   XrdCryptoX509 *xc = chain->Begin();
+   while (xc) {
+      if (xc->NotAfter() < info[0]) info[0] = xc->NotAfter();
+      xc = chain->Next();
+   }
+   info[1] = (crl) ? crl->LastUpdate() : -1;
+
+   XrdSutCacheRef pfeRef;
+   XrdSutPFEntry *cent = cacheVerified.Add(pfeRef, fp);
+   if (!cent) {
+      NOTIFY("WARNING: could not add entry to the verified chain cache");
+      return;
+   }
+   cent->status = kPFE_ok;
+   cent->cnt = 0;
+   cent->mtime = now; // verification time
+   cent->buf1.SetBuf((const char *)info, sizeof(info));
+   // Rehash cache
+   pfeRef.UnLock();   // cent can no longer be used
+   cacheVerified.Rehash(1);
+   DEBUG("saved chain to the verified chain cache: "<<fp);
+}
+
 //_________________________________________________________________________
 int XrdSecProtocolgsi::ServerDoSigpxy(XrdSutBuffer *br,  XrdSutBuffer **bm,
                                       String &cmsg)
@@ -181,6 +181,7 @@ public:
    char  *authzfun;// [s] file with the function to fill entities [0]
    char  *authzfunparms;// [s] parameters for the function to fill entities [0]
    int    authzto; // [s] validity in secs of authz cache entries [-1 => unlimited]
+   int    vercacheto; // [s] validity in secs of verified chain cache entries [0 => no cache]
    int    ogmap;  // [s] gridmap file checking option 
    int    dlgpxy; // [c] explicitely ask the creation of a delegated proxy 
                   // [s] ask client for proxies
@@ -201,6 +202,7 @@ public:
                   proxy = 0; valid = 0; deplen = 0; bits = 512;
                   gridmap = 0; gmapto = -1;
                   gmapfun = 0; gmapfunparms = 0; authzfun = 0; authzfunparms = 0; authzto = -1;
+                  vercacheto = 0;
                   ogmap = 1; dlgpxy = 0; sigpxy = 1; srvnames = 0;
                   exppxy = 0; authzpxy = 0;
                   vomsat = 1; vomsfun = 0; vomsfunparms = 0; moninfo = 0; hashcomp = 1; }
@@ -330,6 +332,7 @@ private:
    static XrdSecgsiAuthzKey_t AuthzKey; 
    static int              AuthzCertFmt; 
    static int              AuthzCacheTimeOut;
+   static int              VerCacheTimeOut;
    static int              PxyReqOpts;
    static int              AuthzPxyWhat;
    static int              AuthzPxyWhere;
@@ -355,6 +358,7 @@ private:
    static XrdSutCache      cacheGMAP; // Cache for gridmap entries
    static XrdSutCache      cacheGMAPFun; // Cache for entries mapped by GMAPFun
    static XrdSutCache      cacheAuthzFun; // Cache for entities filled by AuthzFun
+   static XrdSutCache      cacheVerified; // Cache for verified client chains
    //
    // CRL stack
    static GSICrlStack      stackCRL; // Stack of CRL in use
@@ -421,6 +425,13 @@ private:
                                        XrdCryptoFactory *cf,
                                        time_t timestamp, String &cal);
 
+   // Verified chain cache handling
+   static bool    ChainFingerprint(XrdSutBucket *bck, XrdCryptoFactory *cf,
+                                   String &fp);
+   static bool    ChainVerified(const char *fp, XrdCryptoX509Crl *crl, int now);
+   static void    SaveVerified(const char *fp, X509Chain *chain,
+                               XrdCryptoX509Crl *crl, int now);
+
    // Load CRLs
    static XrdCryptoX509Crl *LoadCRL(XrdCryptoX509 *xca, const char *sjhash,
                                     XrdCryptoFactory *CF, int dwld);
@@ -122,11 +122,14 @@ add_library(
   XrdXrootd/XrdXrootdBridge.cc          XrdXrootd/XrdXrootdBridge.hh
   XrdXrootd/XrdXrootdCallBack.cc        XrdXrootd/XrdXrootdCallBack.hh
   XrdXrootd/XrdXrootdConfig.cc
+  XrdXrootd/XrdXrootdDirList.cc         XrdXrootd/XrdXrootdDirList.hh
   XrdXrootd/XrdXrootdFile.cc            XrdXrootd/XrdXrootdFile.hh
                                         XrdXrootd/XrdXrootdFileLock.hh
   XrdXrootd/XrdXrootdFileLock1.cc       XrdXrootd/XrdXrootdFileLock1.hh
                                         XrdXrootd/XrdXrootdFileStats.hh
+                                        XrdXrootd/XrdXrootdFreeList.hh
   XrdXrootd/XrdXrootdJob.cc             XrdXrootd/XrdXrootdJob.hh
+  XrdXrootd/XrdXrootdLatency.cc         XrdXrootd/XrdXrootdLatency.hh
   XrdXrootd/XrdXrootdLoadLib.cc
                                         XrdXrootd/XrdXrootdMonData.hh
   XrdXrootd/XrdXrootdMonFile.cc         XrdXrootd/XrdXrootdMonFile.hh
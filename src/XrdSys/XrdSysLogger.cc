@@ -44,7 +44,9 @@
 #include <sys/termios.h>
 #include <sys/uio.h>
 #endif // WIN32
+#include <streambuf>
 
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysLogger.hh"
 #include "XrdSys/XrdSysHeaders.hh"
 #include "XrdSys/XrdSysPlatform.hh"
@@ -58,6 +60,118 @@
 
 #define BLAB(x) cerr <<"Logger " <<x <<"!!!" <<endl
 
+#ifdef HAVE_ATOMICS
+#define MemBarrier() __sync_synchronize()
+#else
+#define MemBarrier()
+#endif
+
+/******************************************************************************/
+/*                   L o c a l   T h r e a d   B u f f e r                    */
+/******************************************************************************/
+
+// Each thread that logs gets one of these. The timestamp cache is used in all
+// modes. In asynchronous mode the ring buffer is a single producer (the owning
+// thread) single consumer (the writer thread) queue of whole messages so that
+// queueing needs no lock and per-thread message order is preserved. The stage
+// buffer accumulates stream (i.e. cerr) output until a full line is present.
+//
+struct XrdSysLoggerTB
+      {XrdSysLoggerTB        *next;
+       XrdSysLogger          *logger;
+       char                  *rBuff;      // Ring buffer (async mode only)
+       char                  *sBuff;      // Stage buffer (async mode only)
+       unsigned int           rMask;      // Ring buffer size - 1
+       volatile unsigned int  rHead;      // Only advanced by the writer
+       volatile unsigned int  rTail;      // Only advanced by the owner
+       volatile unsigned int  rDrop;      // Messages dropped by the owner
+       unsigned int           rSeen;      // Drops already reported
+       volatile int           isDead;     // Owning thread has exited
+       int                    sLen;       // Bytes in sBuff
+       int                    tLen;       // Length of tStamp
+       time_t                 tSec;       // Second tStamp corresponds to
+       unsigned long          tNum;       // Thread number
+       XrdSysMutex           *tMutex;     // Mutex held by traceBeg()
+       char                   tStamp[24]; // yymmdd hh:mm:ss
+       char                   tBuff[32];  // Trace header buffer
+
+static const int              sBsz = 4096;
+
+       XrdSysLoggerTB(XrdSysLogger *lP)
+                     : next(0), logger(lP), rBuff(0), sBuff(0), rMask(0),
+                       rHead(0), rTail(0), rDrop(0), rSeen(0), isDead(0),
+                       sLen(0), tLen(0), tSec(0), tNum(XrdSysThread::Num()),
+                       tMutex(0) {}
+      ~XrdSysLoggerTB() {if (rBuff) free(rBuff);
+                         if (sBuff) free(sBuff);
+                        }
+      };
+
+/******************************************************************************/
+/*                   L o c a l   S t r e a m   B u f f e r                    */
+/******************************************************************************/
+
+// In asynchronous mode this stream buffer replaces the one used by cerr so
+// that trace and other stream output is staged in the writing thread's buffer
+// and queued a line at a time instead of being written piecemeal to stderr.
+//
+class XrdSysLoggerSB : public std::streambuf
+{
+public:
+
+XrdSysLogger   *logger;
+std::streambuf *oldBuf;
+
+       XrdSysLoggerSB() : logger(0), oldBuf(0) {}
+      ~XrdSysLoggerSB() {}
+
+protected:
+
+virtual int overflow(int c)
+               {if (c != EOF) {char ch = (char)c; Stage(&ch, 1);}
+                return (c == EOF ? 0 : c);
+               }
+
+virtual std::streamsize xsputn(const char *s, std::streamsize n)
+               {Stage(s, (int)n); return n;}
+
+private:
+
+void Stage(const char *s, int n)
+          {XrdSysLoggerTB *tbP = logger->getTB(true);
+           struct iovec iov;
+           const char *nl;
+           int i, k;
+           if (!tbP->sBuff || tbP->logger != logger)
+              {iov.iov_base = (char *)s; iov.iov_len = n;
+               logger->Put(1, &iov);
+               return;
+              }
+           while(n > 0)
+                {k = XrdSysLoggerTB::sBsz - tbP->sLen;
+                 if (k > n) k = n;
+                 memcpy(tbP->sBuff + tbP->sLen, s, k);
+                 for (i = k-1; i >= 0 && s[i] != '\n'; i--) {}
+                 nl = (i >= 0 ? s+i : 0);
+                 tbP->sLen += k; s += k; n -= k;
+                 if (nl || tbP->sLen >= XrdSysLoggerTB::sBsz)
+                    {int slen = (nl ? tbP->sLen - (s - nl) + 1 : tbP->sLen);
+                     iov.iov_base = tbP->sBuff; iov.iov_len = slen;
+                     logger->Enqueue(tbP, 1, &iov);
+                     if ((tbP->sLen -= slen))
+                        memmove(tbP->sBuff, tbP->sBuff+slen, tbP->sLen);
+                    }
+                }
+          }
+};
+
+namespace
+{
+XrdSysLoggerSB     errBuff;
+pthread_key_t      tbKey;
+pthread_once_t     tbOnce = PTHREAD_ONCE_INIT;
+}
+
 /******************************************************************************/
 /*            E x t e r n a l   T h r e a d   I n t e r f a c e s             */
 /******************************************************************************/
@@ -79,11 +193,39 @@ void  *XrdSysLoggerRT(void *carg)
        return (void *)0;
       }
 
+/******************************************************************************/
+
+void   XrdSysLoggerTBD(void *carg)
+      {XrdSysLoggerTB *tbP = (XrdSysLoggerTB *)carg;
+       struct iovec iov;
+
+// Synchronous buffers can simply be deleted. Asynchronous ones may still hold
+// queued messages; queue any staged output and let the writer delete it.
+//
+       if (!tbP->rBuff) {delete tbP; return;}
+       if (tbP->sLen)
+          {iov.iov_base = tbP->sBuff; iov.iov_len = tbP->sLen;
+           tbP->logger->Enqueue(tbP, 1, &iov);
+           tbP->sLen = 0;
+          }
+       MemBarrier();
+       tbP->isDead = 1;
+      }
+
+void   XrdSysLoggerTBK()
+      {pthread_key_create(&tbKey, XrdSysLoggerTBD);}
+
+void  *XrdSysLoggerWT(void *carg)
+      {XrdSysLogger *lp = (XrdSysLogger *)carg;
+       lp->wrHandler();
+       return (void *)0;
+      }
+
 /******************************************************************************/
 /*                           C o n s t r u c t o r                            */
 /******************************************************************************/
 
-XrdSysLogger::XrdSysLogger(int ErrFD, int dorotate)
+XrdSysLogger::XrdSysLogger(int ErrFD, int dorotate) : wrCV(0)
 {
    char * logFN;
 
@@ -97,6 +239,13 @@ XrdSysLogger::XrdSysLogger(int ErrFD, int dorotate)
    hiRes   = false;
    fifoFN  = 0;
    reserved1 = 0;
+   tbList  = 0;
+   nDrops  = 0;
+   asyncSz = 0;
+   wrIdle  = 0;
+   wrStop  = 0;
+   wrTID   = 0;
+   pthread_once(&tbOnce, XrdSysLoggerTBK);
 
 // Establish default log file name
 //
@@ -111,6 +260,49 @@ XrdSysLogger::XrdSysLogger(int ErrFD, int dorotate)
            }
 }
   
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdSysLogger::~XrdSysLogger()
+{
+   XrdSysLoggerTB *tbP;
+
+// Stop routing stream output to us
+//
+   if (errBuff.logger == this)
+      {Logger_Mutex.Lock();
+       cerr.rdbuf(errBuff.oldBuf);
+       errBuff.logger = 0;
+       Logger_Mutex.UnLock();
+      }
+
+// Stop the writer thread; it writes out whatever is still queued before it
+// exits.
+//
+   if (wrTID)
+      {wrCV.Lock(); wrStop = 1; wrCV.Signal(); wrCV.UnLock();
+       XrdSysThread::Join(wrTID, 0);
+      }
+
+// Release the thread buffers. Those of exited threads are deleted. The others
+// are still referenced by their thread so we only free the ring and stage
+// buffers and let the thread delete the rest when it exits.
+//
+   tbMutex.Lock();
+   while((tbP = tbList))
+        {tbList = tbP->next;
+         if (tbP->isDead) delete tbP;
+            else {free(tbP->rBuff); tbP->rBuff = 0;
+                  free(tbP->sBuff); tbP->sBuff = 0;
+                  tbP->sLen = 0; tbP->rMask = 0;
+                  tbP->rHead = tbP->rTail = 0;
+                 }
+        }
+   tbMutex.UnLock();
+   if (ePath) free(ePath);
+}
+
 /******************************************************************************/
 /*                                A d d M s g                                 */
 /******************************************************************************/
@@ -192,6 +384,96 @@ int XrdSysLogger::Bind(const char *path, int lfh)
    return (rc > 0 ? -rc : rc);
 }
 
+/******************************************************************************/
+/*                               E n q u e u e                                */
+/******************************************************************************/
+
+void XrdSysLogger::Enqueue(XrdSysLoggerTB *tbP, int iovcnt,
+                           const struct iovec *iov)
+{
+   unsigned int rSize = tbP->rMask + 1, rTail = tbP->rTail, rPos, k, n;
+   unsigned int mlen = 0;
+   int i;
+
+// Compute the message length and drop it if it does not fit. We never wait
+// for the writer as that is exactly what asynchronous logging is to avoid.
+//
+   for (i = 0; i < iovcnt; i++) mlen += iov[i].iov_len;
+   if (mlen > rSize - (rTail - tbP->rHead))
+      {tbP->rDrop++;
+       AtomicBeg(tbMutex);
+       AtomicInc(nDrops);
+       AtomicEnd(tbMutex);
+       return;
+      }
+   MemBarrier();
+
+// Copy the message into the ring, wrapping as needed
+//
+   for (i = 0; i < iovcnt; i++)
+       {const char *src = (const char *)iov[i].iov_base;
+        n = iov[i].iov_len;
+        rPos = rTail & tbP->rMask;
+        k = (n > rSize - rPos ? rSize - rPos : n);
+        memcpy(tbP->rBuff + rPos, src, k);
+        if (n > k) memcpy(tbP->rBuff, src + k, n - k);
+        rTail += n;
+       }
+
+// Publish the message and wake up the writer if it is waiting for work. The
+// writer sets wrIdle before its final scan so no wakeup can be lost.
+//
+   MemBarrier();
+   tbP->rTail = rTail;
+   MemBarrier();
+   if (wrIdle) {wrCV.Lock(); wrCV.Signal(); wrCV.UnLock();}
+}
+
+/******************************************************************************/
+/*                                 F l u s h                                  */
+/******************************************************************************/
+  
+void XrdSysLogger::Flush()
+{
+   if (asyncSz) Drain();
+   fsync(eFD);
+}
+
+/******************************************************************************/
+/*                                 g e t T B                                  */
+/******************************************************************************/
+  
+XrdSysLoggerTB *XrdSysLogger::getTB(bool attach)
+{
+   XrdSysLoggerTB *tbP;
+   unsigned int rSize;
+
+// Allocate a buffer for this thread if it does not have one
+//
+   if (!(tbP = (XrdSysLoggerTB *)pthread_getspecific(tbKey)))
+      {tbP = new XrdSysLoggerTB(this);
+       pthread_setspecific(tbKey, tbP);
+      }
+
+// Attach the asynchronous buffers if so wanted and not yet done. We never do
+// this when called from Time() as the caller may hold the logger mutex.
+//
+   if (attach && asyncSz && !tbP->rBuff)
+      {rSize = static_cast<unsigned int>(asyncSz);
+       if ((tbP->rBuff = (char *)malloc(rSize))
+       &&  (tbP->sBuff = (char *)malloc(XrdSysLoggerTB::sBsz)))
+          {tbP->rMask = rSize - 1;
+           tbP->logger = this;
+           tbMutex.Lock();
+           tbP->next = tbList; tbList = tbP;
+           tbMutex.UnLock();
+          } else {
+           if (tbP->rBuff) {free(tbP->rBuff); tbP->rBuff = 0;}
+          }
+      }
+   return tbP;
+}
+
 /******************************************************************************/
 /*                             P a r s e K e e p                              */
 /******************************************************************************/
@@ -233,6 +515,7 @@ int XrdSysLogger::ParseKeep(const char *arg)
   
 void XrdSysLogger::Put(int iovcnt, struct iovec *iov)
 {
+    XrdSysLoggerTB *tbP;
     int retc;
     char tbuff[32];
 
@@ -243,6 +526,13 @@ void XrdSysLogger::Put(int iovcnt, struct iovec *iov)
        iov[0].iov_len  = (int)Time(tbuff);
       }
 
+// In asynchronous mode simply queue the message in this thread's buffer
+//
+   if (asyncSz && (tbP = getTB(true))->rBuff && tbP->logger == this)
+      {Enqueue(tbP, iovcnt, iov);
+       return;
+      }
+
 // Obtain the serailization mutex if need be
 //
    Logger_Mutex.Lock();
@@ -258,12 +548,55 @@ void XrdSysLogger::Put(int iovcnt, struct iovec *iov)
    Logger_Mutex.UnLock();
 }
   
+/******************************************************************************/
+/*                              s e t A s y n c                               */
+/******************************************************************************/
+  
+int XrdSysLogger::setAsync(int bsz)
+{
+#ifdef HAVE_ATOMICS
+   int rc, rsz = 4096;
+
+// Ignore this call if we are already asynchronous
+//
+   if (asyncSz) return 0;
+
+// Compute the buffer size, it must be a power of two
+//
+   while(rsz < bsz && rsz < 0x40000000) rsz <<= 1;
+
+// Start the writer thread
+//
+   asyncSz = rsz;
+   if ((rc = XrdSysThread::Run(&wrTID, XrdSysLoggerWT, (void *)this,
+                               XRDSYSTHREAD_HOLD, "Log writer")))
+      {asyncSz = 0; wrTID = 0;
+       return (rc > 0 ? -rc : rc);
+      }
+
+// Route stream output through thread buffers as well. This is only done once
+// and only when this logger actually receives what is written to stderr. We
+// wait for any trace in progress to complete before switching.
+//
+   if (eFD == STDERR_FILENO && !errBuff.logger)
+      {Logger_Mutex.Lock();
+       errBuff.logger = this;
+       errBuff.oldBuf = cerr.rdbuf(&errBuff);
+       Logger_Mutex.UnLock();
+      }
+   return 0;
+#else
+   return -ENOTSUP;
+#endif
+}
+
 /******************************************************************************/
 /*                                  T i m e                                   */
 /******************************************************************************/
   
 int XrdSysLogger::Time(char *tbuff)
 {
+    XrdSysLoggerTB *tbP = getTB();
     struct timeval tVal;
     const int minblen = 32;
     struct tm tNow;
@@ -273,30 +606,164 @@ int XrdSysLogger::Time(char *tbuff)
 //
    gettimeofday(&tVal, 0);
 
-// Format the time in human terms
+// Format the date and time in human terms only when the second changes as
+// localtime_r() is comparatively expensive. The thread number is cached too.
 //
+   if (tbP->tSec != tVal.tv_sec)
+      {localtime_r((const time_t *) &tVal.tv_sec, &tNow);
+       tbP->tLen = snprintf(tbP->tStamp, sizeof(tbP->tStamp),
+                            "%02d%02d%02d %02d:%02d:%02d",
+                            tNow.tm_year-100, tNow.tm_mon+1, tNow.tm_mday,
+                            tNow.tm_hour,     tNow.tm_min,   tNow.tm_sec);
+       tbP->tSec = tVal.tv_sec;
+      }
    tbuff[minblen-1] = '\0'; // tbuff must be at least 32 bytes long
-   localtime_r((const time_t *) &tVal.tv_sec, &tNow);
+   memcpy(tbuff, tbP->tStamp, tbP->tLen);
 
 // Choose appropriate output
 //
    if (hiRes)
-      {i = snprintf(tbuff, minblen, "%02d%02d%02d %02d:%02d:%02d.%06d %03ld ",
-                    tNow.tm_year-100, tNow.tm_mon+1, tNow.tm_mday,
-                    tNow.tm_hour,     tNow.tm_min,   tNow.tm_sec,
-                    static_cast<int>(tVal.tv_usec), XrdSysThread::Num());
+      {i = snprintf(tbuff+tbP->tLen, minblen-tbP->tLen, ".%06d %03ld ",
+                    static_cast<int>(tVal.tv_usec), tbP->tNum);
       } else {
-       i = snprintf(tbuff, minblen, "%02d%02d%02d %02d:%02d:%02d %03ld ",
-                    tNow.tm_year-100, tNow.tm_mon+1, tNow.tm_mday,
-                    tNow.tm_hour,     tNow.tm_min,   tNow.tm_sec,
-                    XrdSysThread::Num());
+       i = snprintf(tbuff+tbP->tLen, minblen-tbP->tLen, " %03ld ", tbP->tNum);
       }
+   i += tbP->tLen;
    return (i >= minblen ? minblen-1 : i);
 }
 
+/******************************************************************************/
+/*                              t r a c e B e g                               */
+/******************************************************************************/
+
+char *XrdSysLogger::traceBeg()
+{
+   XrdSysLoggerTB *tbP = getTB();
+
+// In synchronous mode trace output goes straight to stderr so we must hold the
+// logger mutex. In asynchronous mode it is staged in the thread's buffer so we
+// only need to keep other threads from changing the stream's format flags.
+// The choice is recorded so that traceEnd() releases the same mutex.
+//
+   tbP->tMutex = (asyncSz ? &Trace_Mutex : &Logger_Mutex);
+   tbP->tMutex->Lock();
+   Time(tbP->tBuff);
+   return tbP->tBuff;
+}
+
+/******************************************************************************/
+/*                              t r a c e E n d                               */
+/******************************************************************************/
+
+char XrdSysLogger::traceEnd()
+{
+   XrdSysLoggerTB *tbP = getTB();
+
+   tbP->tMutex->UnLock();
+   return '\n';
+}
+
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
+/******************************************************************************/
+/*                                 D r a i n                                  */
+/******************************************************************************/
+
+// Write out everything queued in all of the thread buffers and delete buffers
+// whose thread has exited once they are empty. Return the number of bytes
+// written. We only need tbMutex to look at the list head and to unlink as new
+// buffers are only ever added at the front and only Drain() removes them.
+  
+int XrdSysLogger::Drain()
+{
+   static const int iovMax = 64;
+   struct {XrdSysLoggerTB *tbP; unsigned int rTail;} seg[iovMax/2];
+   struct iovec iov[iovMax];
+   XrdSysLoggerTB *tbP, *tbPrev, *tbNext;
+   unsigned int rHead, rTail, rPos, rSize, n, newDrops = 0;
+   int i, iNum = 0, sNum = 0, retc, wTot = 0;
+
+   drMutex.Lock();
+   tbMutex.Lock(); tbP = tbList; tbMutex.UnLock();
+   while(tbP || sNum)
+        {
+
+// Write out the segments we have gathered when we are full or at the end
+//
+         if (sNum && (!tbP || sNum >= iovMax/2))
+            {Logger_Mutex.Lock();
+             do {retc = writev(eFD, (const struct iovec *)iov, iNum);}
+                while (retc < 0 && errno == EINTR);
+             Logger_Mutex.UnLock();
+             for (i = 0; i < sNum; i++)
+                 {MemBarrier();
+                  seg[i].tbP->rHead = seg[i].rTail;
+                 }
+             iNum = sNum = 0;
+             if (!tbP) break;
+            }
+
+// Capture what this buffer has
+//
+         MemBarrier();
+         rTail  = tbP->rTail;
+         rHead  = tbP->rHead;
+         if (tbP->rDrop != tbP->rSeen)
+            {newDrops += tbP->rDrop - tbP->rSeen; tbP->rSeen = tbP->rDrop;}
+         if (rTail == rHead) {tbP = tbP->next; continue;}
+
+// Add one or two iovec elements depending on whether the data wraps
+//
+         rSize = tbP->rMask + 1;
+         rPos  = rHead & tbP->rMask;
+         n     = rTail - rHead;
+         wTot += n;
+         if (n > rSize - rPos)
+            {iov[iNum].iov_base = tbP->rBuff + rPos;
+             iov[iNum].iov_len  = rSize - rPos;
+             iNum++;
+             iov[iNum].iov_base = tbP->rBuff;
+             iov[iNum].iov_len  = n - (rSize - rPos);
+             iNum++;
+            } else {
+             iov[iNum].iov_base = tbP->rBuff + rPos;
+             iov[iNum].iov_len  = n;
+             iNum++;
+            }
+         seg[sNum].tbP = tbP; seg[sNum].rTail = rTail; sNum++;
+         tbP = tbP->next;
+        }
+
+// Delete empty buffers whose thread has exited as nothing more can be added
+//
+   tbMutex.Lock();
+   tbPrev = 0; tbP = tbList;
+   while(tbP)
+        {tbNext = tbP->next;
+         if (tbP->isDead && tbP->rTail == tbP->rHead)
+            {if (tbPrev) tbPrev->next = tbNext;
+                else     tbList       = tbNext;
+             delete tbP;
+            } else tbPrev = tbP;
+         tbP = tbNext;
+        }
+   tbMutex.UnLock();
+   drMutex.UnLock();
+
+// Report any dropped messages
+//
+   if (newDrops)
+      {char eBuff[80];
+       int msz = snprintf(eBuff, sizeof(eBuff), "Logger dropped %u message(s);"
+                          " thread log buffer full!\n", newDrops);
+       Logger_Mutex.Lock();
+       putEmsg(eBuff, msz);
+       Logger_Mutex.UnLock();
+      }
+   return wTot;
+}
+
 /******************************************************************************/
 /*                              F i f o M a k e                               */
 /******************************************************************************/
@@ -634,3 +1101,42 @@ void XrdSysLogger::zHandler()
          Logger_Mutex.UnLock();
         }
 }
+
+/******************************************************************************/
+/*                             w r H a n d l e r                              */
+/******************************************************************************/
+
+void XrdSysLogger::wrHandler()
+{
+   XrdSysLoggerTB *tbP;
+   int haveData;
+
+// This loop writes out queued messages until the logger is destroyed. When
+// there is nothing to do we set wrIdle and rescan before waiting so that a
+// message queued in the interim is either seen here or causes the producer to
+// signal us. We wake up periodically regardless to clean up after threads
+// that exited.
+//
+   while(!wrStop)
+        {if (Drain()) continue;
+         wrCV.Lock();
+         if (wrStop) {wrCV.UnLock(); break;}
+         wrIdle = 1;
+         MemBarrier();
+         haveData = 0;
+         tbMutex.Lock();
+         tbP = tbList;
+         while(tbP && !haveData)
+              {if (tbP->rTail != tbP->rHead) haveData = 1;
+               tbP = tbP->next;
+              }
+         tbMutex.UnLock();
+         if (!haveData) wrCV.WaitMS(1000);
+         wrIdle = 0;
+         wrCV.UnLock();
+        }
+
+// Write out whatever was queued before we were told to stop
+//
+   Drain();
+}
@@ -42,6 +42,8 @@
 
 #include "XrdSys/XrdSysPthread.hh"
 
+struct XrdSysLoggerTB;
+
 //-----------------------------------------------------------------------------
 //! XrdSysLogger is the object that is used to route messages to wherever they
 //! need to go and also handles log file rotation and trimming.
@@ -63,10 +65,11 @@ public:
          XrdSysLogger(int ErrFD=STDERR_FILENO, int xrotate=1);
 
 //-----------------------------------------------------------------------------
-//! Destructor
+//! Destructor. In asynchronous mode all queued messages are written out and
+//! the writer thread is stopped. The logger must no longer be in use.
 //-----------------------------------------------------------------------------
 
-        ~XrdSysLogger() {if (ePath) free(ePath);}
+        ~XrdSysLogger();
 
 //-----------------------------------------------------------------------------
 //! Add a message to be printed at midnight.
@@ -105,10 +108,19 @@ static const int onFifo = (int)0x80000000;
 int Bind(const char *path, int lfh=0);
 
 //-----------------------------------------------------------------------------
-//! Flush any pending output
+//! Flush any pending output. In asynchronous mode this first writes out all
+//! messages queued by any thread.
+//-----------------------------------------------------------------------------
+
+void Flush();
+
+//-----------------------------------------------------------------------------
+//! Get the number of messages dropped because a thread's log buffer was full.
+//!
+//! @return the number of dropped messages (always zero in synchronous mode).
 //-----------------------------------------------------------------------------
 
-void Flush() {fsync(eFD);}
+long long Dropped() {return nDrops;}
 
 //-----------------------------------------------------------------------------
 //! Get the file descriptor passed at construction time.
@@ -141,6 +153,22 @@ int  ParseKeep(const char *arg);
 
 void Put(int iovcnt, struct iovec *iov);
 
+//-----------------------------------------------------------------------------
+//! Switch to asynchronous logging. Each thread formats its messages into its
+//! own fixed size buffer without taking any lock and a background thread
+//! writes them out. Per-thread message order is preserved; messages that do
+//! not fit into the thread's buffer are dropped and counted (see Dropped()).
+//! Once enabled, asynchronous logging cannot be turned off.
+//!
+//! @param  bsz       The size of each thread's buffer (rounded up to a power
+//!                   of two and at least 4K).
+//!
+//! @return  0        Asynchronous logging is enabled.
+//! @return <0        Unable to enable it, returned value is -errno of reason.
+//-----------------------------------------------------------------------------
+
+int  setAsync(int bsz=65536);
+
 //-----------------------------------------------------------------------------
 //! Set log file timstamp to high resolution (hh:mm:ss.uuuu).
 //-----------------------------------------------------------------------------
@@ -172,7 +200,7 @@ void setRotate(int onoff) {doLFR = onoff;}
 //! @return pointer to the time buffer to be used as the msg timestamp.
 //-----------------------------------------------------------------------------
 
-char *traceBeg() {Logger_Mutex.Lock(); Time(TBuff); return TBuff;}
+char *traceBeg();
 
 //-----------------------------------------------------------------------------
 //! Stop trace message serialization. This method must be preceeded by a call
@@ -181,7 +209,7 @@ char *traceBeg() {Logger_Mutex.Lock(); Time(TBuff); return TBuff;}
 //! @return pointer to a new line character to terminate the message.
 //-----------------------------------------------------------------------------
 
-char  traceEnd() {Logger_Mutex.UnLock(); return '\n';}
+char  traceEnd();
 
 //-----------------------------------------------------------------------------
 //! Get the log file routing.
@@ -198,7 +226,29 @@ const char *xlogFN() {return (ePath ? ePath : "stderr");}
 
 void        zHandler();
 
+//-----------------------------------------------------------------------------
+//! Internal method to write out asynchronous messages. This is public because
+//! it needs to be called by an external thread.
+//-----------------------------------------------------------------------------
+
+void        wrHandler();
+
+//-----------------------------------------------------------------------------
+//! Internal method to queue a message in asynchronous mode. This is public
+//! because it needs to be called by external functions.
+//-----------------------------------------------------------------------------
+
+void        Enqueue(XrdSysLoggerTB *tbP, int iovcnt, const struct iovec *iov);
+
+//-----------------------------------------------------------------------------
+//! Internal method to get the calling thread's buffer. This is public because
+//! it needs to be called by external functions.
+//-----------------------------------------------------------------------------
+
+XrdSysLoggerTB *getTB(bool attach=false);
+
 private:
+int         Drain();
 int         FifoMake();
 void        FifoWait();
 int         Time(char *tbuff);
@@ -210,8 +260,17 @@ struct mmMsg
       };
 mmMsg     *msgList;
 XrdSysMutex Logger_Mutex;
+XrdSysMutex Trace_Mutex;     // Serializes trace formatting in async mode
+XrdSysMutex tbMutex;         // Protects tbList
+XrdSysMutex drMutex;         // Serializes Drain()
+XrdSysCondVar wrCV;          // Writer thread wakeup
+XrdSysLoggerTB *tbList;      // Thread buffers being drained (async mode)
 long long  eKeep;
-char       TBuff[32];        // Trace header buffer
+long long  nDrops;
+int        asyncSz;          // Thread buffer size when async, 0 otherwise
+volatile int wrIdle;
+volatile int wrStop;         // Writer thread is to exit
+pthread_t  wrTID;
 int        eFD;
 int        baseFD;
 char      *ePath;
@@ -69,6 +69,25 @@ time_t XrdSysTimer::Midnight(time_t tnow)
    return mktime(&midtime) + add_time;
 }
   
+/******************************************************************************/
+/*                                 N a n o s                                  */
+/******************************************************************************/
+
+long long XrdSysTimer::Nanos()
+{
+#if defined(CLOCK_MONOTONIC) && !defined(__APPLE__)
+   struct timespec tp;
+
+   clock_gettime(CLOCK_MONOTONIC, &tp);
+   return static_cast<long long>(tp.tv_sec)*1000000000LL + tp.tv_nsec;
+#else
+   struct timeval tv;
+
+   gettimeofday(&tv, 0);
+   return static_cast<long long>(tv.tv_sec)*1000000000LL + tv.tv_usec*1000LL;
+#endif
+}
+  
 /******************************************************************************/
 /*                                R e p o r t                                 */
 /******************************************************************************/
@@ -48,6 +48,11 @@ public:
 
 static time_t Midnight(time_t tnow=0);
 
+       // Nanos() returns a monotonic clock in nanoseconds. It is only useful
+       // to measure intervals as it bears no relation to the time of day.
+       //
+static long long Nanos();
+
 inline int    TimeLE(time_t tsec) {return StopWatch.tv_sec <= tsec;}
 
        // The following routines return the current interval added to the
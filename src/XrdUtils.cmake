@@ -72,6 +72,7 @@ add_library(
   XrdOuc/XrdOucNSWalk.cc        XrdOuc/XrdOucNSWalk.hh
   XrdOuc/XrdOucProg.cc          XrdOuc/XrdOucProg.hh
   XrdOuc/XrdOucPup.cc           XrdOuc/XrdOucPup.hh
+                                XrdOuc/XrdOucPupCodec.hh
   XrdOuc/XrdOucReqID.cc         XrdOuc/XrdOucReqID.hh
   XrdOuc/XrdOucSid.cc           XrdOuc/XrdOucSid.hh
   XrdOuc/XrdOucSiteName.cc      XrdOuc/XrdOucSiteName.hh
@@ -88,7 +88,7 @@
         XrdVERSIONPLUGIN_Rule(Optional,  0,  0, XrdBwmPolicyObject            )\
         XrdVERSIONPLUGIN_Rule(Required,  0,  0, XrdCksCalcInit                )\
         XrdVERSIONPLUGIN_Rule(Required,  0,  0, XrdCksInit                    )\
-        XrdVERSIONPLUGIN_Rule(Required,  0,  0, XrdCmsGetClient               )\
+        XrdVERSIONPLUGIN_Rule(Required,  4,  0, XrdCmsGetClient               )\
         XrdVERSIONPLUGIN_Rule(Optional,  0,  0, XrdCmsgetXmi                  )\
         XrdVERSIONPLUGIN_Rule(Required,  4,  0, XrdgetProtocol                )\
         XrdVERSIONPLUGIN_Rule(Required,  4,  0, XrdgetProtocolPort            )\
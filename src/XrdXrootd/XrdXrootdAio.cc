@@ -33,6 +33,7 @@
 #include "Xrd/XrdBuffer.hh"
 #include "Xrd/XrdLink.hh"
 #include "XProtocol/XProtocol.hh"
+#include "XrdSys/XrdSysAtomics.hh"
 #include "XrdSys/XrdSysError.hh"
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdSfs/XrdSfsInterface.hh"
@@ -51,14 +52,14 @@ XrdScheduler             *XrdXrootdAio::Sched;
 XrdXrootdStats           *XrdXrootdAio::SI;
 
 XrdSysMutex               XrdXrootdAio::fqMutex;
-XrdXrootdAio             *XrdXrootdAio::fqFirst = 0;
+XrdXrootdFreeList<XrdXrootdAio>    XrdXrootdAio::fqList;
 const char               *XrdXrootdAio::TraceID = "Aio";
 
 int                       XrdXrootdAio::maxAio;
+int                       XrdXrootdAio::numAio = 0;
 
 XrdSysError              *XrdXrootdAioReq::eDest;
-XrdSysMutex               XrdXrootdAioReq::rqMutex;
-XrdXrootdAioReq          *XrdXrootdAioReq::rqFirst = 0;
+XrdXrootdFreeList<XrdXrootdAioReq> XrdXrootdAioReq::rqList;
 const char               *XrdXrootdAioReq::TraceID = "AioReq";
 
 int                       XrdXrootdAioReq::QuantumMin;
@@ -76,14 +77,33 @@ extern XrdOucTrace       *XrdXrootdTrace;
 XrdXrootdAio *XrdXrootdAio::Alloc(XrdXrootdAioReq *arp, int bsize)
 {
    XrdXrootdAio *aiop;
+   long long     anow;
+
+// Reserve one of the aio objects we may have in use. The reservation is
+// backed out when we are at the limit so that the count is always exact.
+//
+   AtomicBeg(fqMutex);
+   if (AtomicInc(numAio) >= maxAio)
+      {AtomicDec(numAio);
+       AtomicEnd(fqMutex);
+       return 0;
+      }
+   anow = AtomicInc(SI->AsyncNow) + 1;
+   AtomicEnd(fqMutex);
+
+// Update the high water mark (not locked as it is only statistical)
+//
+   if (anow > SI->AsyncMax) SI->AsyncMax = anow;
 
 // Obtain an aio object
 //
-   fqMutex.Lock();
-   if ((aiop = fqFirst)) fqFirst = aiop->Next;
-      else if (maxAio) aiop = addBlock();
-   if (aiop && (++(SI->AsyncNow) > SI->AsyncMax)) SI->AsyncMax = SI->AsyncNow;
-   fqMutex.UnLock();
+   if (!(aiop = fqList.Pop()))
+      {AtomicBeg(fqMutex);
+       AtomicDec(numAio);
+       AtomicDec(SI->AsyncNow);
+       AtomicEnd(fqMutex);
+       return 0;
+      }
 
 // Allocate a buffer for this object
 //
@@ -191,36 +211,13 @@ void XrdXrootdAio::Recycle()
 //
    if (buffp) {BPool->Release(buffp); buffp = 0;}
 
-// Add this object to the free queue
+// Add this object to the free list and release its reservation
 //
-   fqMutex.Lock();
-   Next = fqFirst;
-   fqFirst = this;
-   if (--(SI->AsyncNow) < 0) SI->AsyncNow=0;
-   fqMutex.UnLock();
-}
-  
-/******************************************************************************/
-/*                       P r i v a t e   M e t h o d s                        */
-/******************************************************************************/
-/******************************************************************************/
-/*                X r d X r o o t d A i o : : a d d B l o c k                 */
-/******************************************************************************/
-  
-XrdXrootdAio *XrdXrootdAio::addBlock()
-{
-   const int numalloc = 4096/sizeof(XrdXrootdAio);
-   int i = (numalloc <= maxAio ? numalloc : maxAio);
-   XrdXrootdAio *aiop;
-
-   TRACE(DEBUG, "Adding " <<i <<" aio objects; " <<maxAio <<" pending.");
-
-   if ((aiop = new XrdXrootdAio[i]()))
-      {maxAio -= i;
-       while(--i) {aiop->Next = fqFirst; fqFirst = aiop; aiop++;}
-      }
-
-   return aiop;
+   fqList.Push(this);
+   AtomicBeg(fqMutex);
+   AtomicDec(SI->AsyncNow);
+   AtomicDec(numAio);
+   AtomicEnd(fqMutex);
 }
   
 /******************************************************************************/
@@ -245,10 +242,7 @@ XrdXrootdAioReq *XrdXrootdAioReq::Alloc(XrdXrootdProtocol *prot,
 
 // Obtain an aioreq object
 //
-   rqMutex.Lock();
-   if ((arp = rqFirst)) rqFirst = arp->Next;
-      else arp = addBlock();
-   rqMutex.UnLock();
+   arp = rqList.Pop();
 
 // Make sure we have one, fully reset it if we do
 //
@@ -345,7 +339,7 @@ void XrdXrootdAioReq::Init(int iosize, int maxaiopr, int maxaio)
    if (QuantumMax > XrdXrootdProtocol::maxBuffsz)
        QuantumMax = XrdXrootdProtocol::maxBuffsz;
 
-// Set the maximum number of aio objects we can have (used by Aio object only)
+// Set the maximum number of aio objects we can have in use (used by Aio only)
 // Note that sysconf(_SC_AIO_MAX) usually provides an unreliable number if it
 // provides a number at all.
 //
@@ -359,10 +353,10 @@ void XrdXrootdAioReq::Init(int iosize, int maxaiopr, int maxaio)
                 <<"; aio/srv=" <<XrdXrootdAio::maxAio
                 <<"; Quantum=" <<Quantum);
 
-// Preallocate a block of AIO request objects AIO I/O objects
+// Preallocate a slab of AIO request objects and AIO I/O objects
 //
-   if ((arp  =               addBlock())) {arp->Clear(0); arp->Recycle(0);}
-   if ((aiop = XrdXrootdAio::addBlock())) aiop->Recycle();
+   if ((arp  = rqList.Pop()))               {arp->Clear(0); arp->Recycle(0);}
+   if ((aiop = XrdXrootdAio::fqList.Pop())) XrdXrootdAio::fqList.Push(aiop);
 }
 
 /******************************************************************************/
@@ -444,12 +438,9 @@ void XrdXrootdAioReq::Recycle(int dref, XrdXrootdAio *oldp)
 //
    if (isLocked) UnLock();
 
-// Put ourselves on the free queue
+// Put ourselves on the free list
 //
-   rqMutex.Lock();
-   Next = rqFirst;
-   rqFirst = this;
-   rqMutex.UnLock();
+   rqList.Push(this);
 }
 
 /******************************************************************************/
@@ -482,32 +473,12 @@ int XrdXrootdAioReq::Write(XrdXrootdAio *aiop)
 /******************************************************************************/
 /*                       P r i v a t e   M e t h o d s                        */
 /******************************************************************************/
-/******************************************************************************/
-/*             X r d X r o o t d A i o R e q : : a d d B l o c k              */
-/******************************************************************************/
-  
-XrdXrootdAioReq *XrdXrootdAioReq::addBlock()
-{
-   const int numalloc = 4096/sizeof(XrdXrootdAioReq);
-   int i = numalloc;
-   XrdXrootdAioReq *arp;
-
-   if (!numalloc) return new XrdXrootdAioReq();
-   TRACE(DEBUG, "Adding " <<numalloc <<" aioreq objects.");
-
-   if ((arp = new XrdXrootdAioReq[numalloc]()))
-      while(--i) {arp->Next = rqFirst; rqFirst = arp; arp++;}
-
-   return arp;
-}
-  
 /******************************************************************************/
 /*                                 C l e a r                                  */
 /******************************************************************************/
 
 void XrdXrootdAioReq::Clear(XrdLink *lnkp)
 {
-Next      = 0;
 myOffset  = 0;
 myIOLen   = 0;
 Instance  = 0;
@@ -34,6 +34,7 @@
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdSfs/XrdSfsAio.hh"
 #include "Xrd/XrdScheduler.hh"
+#include "XrdXrootd/XrdXrootdFreeList.hh"
 #include "XrdXrootd/XrdXrootdResponse.hh"
 
 /******************************************************************************/
@@ -69,15 +70,15 @@ virtual void          Recycle();
 private:
 
 static  XrdXrootdAio    *Alloc(XrdXrootdAioReq *arp, int bsize=0);
-static  XrdXrootdAio    *addBlock();
 
 static  const char      *TraceID;
 static  XrdBuffManager  *BPool;   // -> Buffer Manager
 static  XrdScheduler    *Sched;   // -> System Scheduler
 static  XrdXrootdStats  *SI;      // -> System Statistics
-static  XrdSysMutex      fqMutex; // Locks static data
-static  XrdXrootdAio    *fqFirst; // -> Object in free queue
-static  int              maxAio;  // Maximum Aio objects we can yet have
+static  XrdSysMutex      fqMutex; // Locks counters (no atomics only)
+static  XrdXrootdFreeList<XrdXrootdAio> fqList; // Free objects
+static  int              maxAio;  // Maximum Aio objects we can have in use
+static  int              numAio;  // Number of Aio objects now in use
 
         XrdXrootdAio    *Next;    // Chain pointer
         XrdXrootdAioReq *aioReq;  // -> Associated request object
@@ -130,7 +131,6 @@ private:
 
         void               Clear(XrdLink *lnkp);
 
-static  XrdXrootdAioReq   *addBlock();
         void               endRead();
         void               endWrite();
 inline  void               Lock() {aioMutex.Lock(); isLocked = 1;}
@@ -140,8 +140,7 @@ inline  void               UnLock() {isLocked = 0; aioMutex.UnLock();}
 
 static  const char        *TraceID;
 static  XrdSysError       *eDest;      // -> Error Object
-static  XrdSysMutex        rqMutex;    // Locks static data
-static  XrdXrootdAioReq   *rqFirst;    // -> Object in free queue
+static  XrdXrootdFreeList<XrdXrootdAioReq> rqList; // Free objects
 static  int                QuantumMin; // aio segment size (Quantum/2)
 static  int                Quantum;    // aio segment size
 static  int                QuantumMax; // aio segment size (Quantum*2)
@@ -149,7 +148,6 @@ static  int                maxAioPR;   // aio objects per request (max)
 static  int                maxAioPR2;  // aio objects per request (max*2)
 
         XrdSysMutex        aioMutex;  // Locks private data
-        XrdXrootdAioReq   *Next;      // -> Chain pointer
 
         off_t              myOffset;  // Next offset    (used for read's only)
         int                myIOLen;   // Size remaining (read and write end)
@@ -63,6 +63,7 @@
 #include "XrdXrootd/XrdXrootdAdmin.hh"
 #include "XrdXrootd/XrdXrootdAio.hh"
 #include "XrdXrootd/XrdXrootdCallBack.hh"
+#include "XrdXrootd/XrdXrootdDirList.hh"
 #include "XrdXrootd/XrdXrootdFile.hh"
 #include "XrdXrootd/XrdXrootdFileLock.hh"
 #include "XrdXrootd/XrdXrootdFileLock1.hh"
@@ -289,6 +290,10 @@ int XrdXrootdProtocol::Configure(char *parms, XrdProtocol_Config *pi)
    else if (!as_noaio) XrdXrootdAioReq::Init(as_segsize, as_maxperreq, as_maxpersrv);
    else eDest.Say("Config warning: asynchronous I/O has been disabled!");
 
+// Directory listings longer than a response are sent in the background
+//
+   XrdXrootdDirList::Init(Sched, SI, Port);
+
 // Create the file lock manager
 //
    Locker = (XrdXrootdFileLock *)new XrdXrootdFileLock1();
@@ -822,7 +827,7 @@ int XrdXrootdProtocol::xlog(XrdOucStream &Config)
 /* Function: xmon
 
    Purpose:  Parse directive: monitor [all] [auth]  [flush [io] <sec>]
-                                      [fstat <sec> [lfn] [ops] [ssq] [xfr <n>]
+                                      [fstat <sec> [lfn] [ops] [pat] [ssq] [xfr <n>]
                                       [ident <sec>] [mbuff <sz>] [rbuff <sz>]
                                       [rnums <cnt>] [window <sec>]
                                       dest [Events] <host:port>
@@ -837,6 +842,7 @@ int XrdXrootdProtocol::xlog(XrdOucStream &Config)
                             <sec> specifies the flush interval (also see xfr)
                             lfn    - adds lfn to the open event
                             ops    - adds the ops record when the file is closed
+                            pat    - adds access pattern stats to the ops rec
                             ssq    - computes the sum of squares for the ops rec
                             xfr <n>- inserts i/o stats for open files every
                                      <sec>*<n>. Minimum is 1.
@@ -896,6 +902,7 @@ int XrdXrootdProtocol::xmon(XrdOucStream &Config)
                    while((val = Config.GetWord()))
                         if (!strcmp("lfn", val)) monFSopt |=  XROOTD_MON_FSLFN;
                    else if (!strcmp("ops", val)) monFSopt |=  XROOTD_MON_FSOPS;
+                   else if (!strcmp("pat", val)) monFSopt |=  XROOTD_MON_FSPAT;
                    else if (!strcmp("ssq", val)) monFSopt |=  XROOTD_MON_FSSSQ;
                    else if (!strcmp("xfr", val))
                            {if (!(val = Config.GetWord()))
@@ -0,0 +1,411 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d D i r L i s t . c c                    */
+/*                                                                            */
+/* (c) 2013 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+  
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Xrd/XrdLink.hh"
+#include "Xrd/XrdScheduler.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdSfs/XrdSfsInterface.hh"
+#include "XrdXrootd/XrdXrootdDirList.hh"
+#include "XrdXrootd/XrdXrootdMonitor.hh"
+#include "XrdXrootd/XrdXrootdProtocol.hh"
+#include "XrdXrootd/XrdXrootdStats.hh"
+#include "XrdXrootd/XrdXrootdTrace.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   O b j e c t s                         */
+/******************************************************************************/
+
+extern XrdOucTrace       *XrdXrootdTrace;
+
+const char               *XrdXrootdDirList::TraceID = "DirList";
+XrdScheduler             *XrdXrootdDirList::Sched   = 0;
+XrdXrootdStats           *XrdXrootdDirList::SI      = 0;
+int                       XrdXrootdDirList::Port    = 0;
+
+#undef  TRACELINK
+#define TRACELINK Link
+
+/******************************************************************************/
+/*                         L o c a l   D e f i n e s                          */
+/******************************************************************************/
+
+// The maximum length of the stat information of an entry, the maximum number
+// of helpers stat'ing the entries of a batch, the minimum number of entries
+// that makes a helper worthwhile, and the seconds a client waits before
+// retrying a listing whose stat the file system wanted to defer.
+//
+namespace
+{
+const int statSz   = 80;
+const int maxHelp  = 7;
+const int minEnts  = 8;
+const int waitTime = 10;
+}
+
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+
+XrdXrootdDirList::XrdXrootdDirList(XrdXrootdResponse &resp,
+                                   XrdSfsDirectory   *dP,
+                                   const char        *path, bool dStat)
+                 : XrdJob("dirlist"), sCond(0)
+{
+   Response = resp;
+   Link    = resp.theLink();
+   dirP    = dP;
+   dirPath = strdup(path);
+   dName   = 0;
+   numEnt  = 0;
+   doStat  = dStat;
+   leadIn  = dStat;
+   memset(&Stat, 0, sizeof(Stat));
+
+   sfsP    = 0;
+   Client  = 0;
+   Opaque  = 0;
+   sTab    = 0;
+   nBuff   = 0;
+   monID   = 0;
+   clntPV  = 0;
+   sEmsg   = 0;
+   sEcode  = 0;
+   sRC     = SFS_OK;
+   sNum    = sNext = sLeft = 0;
+   numRef  = 1;
+}
+
+/******************************************************************************/
+/*                            D e s t r u c t o r                             */
+/******************************************************************************/
+
+XrdXrootdDirList::~XrdXrootdDirList()
+{
+   if (dirP) {dirP->close(); delete dirP;}
+   if (dirPath) free(dirPath);
+   if (Opaque)  free(Opaque);
+   if (sEmsg)   free(sEmsg);
+   if (nBuff)   free(nBuff);
+   if (sTab)    delete [] sTab;
+}
+
+/******************************************************************************/
+/*                                 A l l o c                                  */
+/******************************************************************************/
+
+XrdXrootdDirList *XrdXrootdDirList::Alloc(XrdXrootdResponse  &resp,
+                                          XrdSfsDirectory    *dP,
+                                          const char         *path,
+                                          bool                dStat,
+                                          XrdSfsFileSystem   *fsP,
+                                          const XrdSecEntity *client,
+                                          const char         *opaque,
+                                          int                 monID,
+                                          int                 clientPV)
+{
+   XrdXrootdDirList *dlP = new XrdXrootdDirList(resp, dP, path, dStat);
+
+// The stat information is best supplied by the directory along with each
+// entry. The stat buffer is in the object so it stays put for as long as the
+// directory is being read. Otherwise, we stat the entries in batches.
+//
+   if (dStat && dP->autoStat(&(dlP->Stat)) != SFS_OK)
+      {memset(&(dlP->Stat), 0, sizeof(struct stat));
+       dlP->sfsP   = fsP;
+       dlP->Client = client;
+       dlP->Opaque = (opaque ? strdup(opaque) : 0);
+       dlP->monID  = monID;
+       dlP->clntPV = clientPV;
+       dlP->sTab   = new StatEnt[sizeof(dlP->eBuff)/(statSz+2)+1];
+       dlP->nBuff  = (char *)malloc(sizeof(dlP->eBuff));
+      }
+   return dlP;
+}
+
+/******************************************************************************/
+/*                                  D o I t                                   */
+/******************************************************************************/
+
+void XrdXrootdDirList::DoIt()
+{
+
+// Send the next chunk and reschedule ourselves if more remain. This gives
+// other work a chance to run in between chunks.
+//
+   if (Chunk() > 0) {Sched->Schedule(this); return;}
+
+// The listing has ended (or the client went away). Let go of the link.
+//
+   Link->setRef(-1);
+   Recycle();
+}
+
+/******************************************************************************/
+/*                                 S t a r t                                  */
+/******************************************************************************/
+
+int XrdXrootdDirList::Start(bool bgOK)
+{
+   int rc;
+
+// Send the first chunk and, if allowed, hand off the rest to a worker. The
+// link is held until we are done with it.
+//
+   while((rc = Chunk()) > 0)
+        {if (bgOK)
+            {Link->setRef(1);
+             Sched->Schedule(this);
+             return 0;
+            }
+        }
+
+// Return the final result
+//
+   Recycle();
+   return rc;
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                                 C h u n k                                  */
+/******************************************************************************/
+
+// Place as many entries in the buffer as will fit, each with a trailing new
+// line character (the last entry will have a null byte). If we cannot fit a
+// full entry in the buffer, send what we have with an OKSOFAR and return 1 so
+// that the entry is sent with the next chunk. Otherwise, send the final chunk
+// and return 0. A directory entry is never longer than the buffer. No errors
+// are allowed to be reflected at this point except for a failing stat which
+// ends the listing; -1 is returned if the send fails.
+//
+int XrdXrootdDirList::Chunk()
+{
+   char *buff = eBuff, *nP = nBuff;
+   int bleft = sizeof(eBuff), dlen, rc, i, sCnt = 0;
+
+// The initial leadin is a "dot" entry to indicate to the client that we
+// support the dstat option (older servers will not do that).
+//
+   if (leadIn)
+      {strcpy(eBuff, ".\n");
+       buff += 2; bleft -= 2;
+       dlen = XrdXrootdProtocol::StatGen(Stat, buff);
+       bleft -= (dlen+1); buff += dlen; *buff = '\n'; buff++;
+       leadIn = false;
+      }
+
+// Fill the buffer. When we must stat each entry ourselves, the names are only
+// gathered here (with room reserved for the stat information) and the entries
+// are added once the whole batch has been stat'ed.
+//
+   while(dName || (dName = dirP->nextEntry()))
+        {dlen = strlen(dName);
+         if (dlen > 2 || dName[0] != '.' || (dlen == 2 && dName[1] != '.'))
+            {if ((bleft -= (dlen+1)) < 0 || (doStat && bleft < statSz)) break;
+             numEnt++;
+             if (sfsP)
+                {strcpy(nP, dName); sTab[sCnt++].Name = nP; nP += dlen+1;
+                 bleft -= statSz;
+                } else {
+                 strcpy(buff, dName); buff += dlen; *buff = '\n'; buff++;
+                 if (doStat)
+                    {dlen = XrdXrootdProtocol::StatGen(Stat, buff);
+                     bleft -= (dlen+1); buff += dlen; *buff = '\n'; buff++;
+                    }
+                }
+            }
+         dName = 0;
+        }
+
+// Stat the batch, if any, and add the entries. A failed stat ends the listing.
+//
+   if (sCnt)
+      {if (StatAll(sCnt) != SFS_OK) return (StatError() ? -1 : 0);
+       for (i = 0; i < sCnt; i++)
+           {dlen = strlen(sTab[i].Name);
+            strcpy(buff, sTab[i].Name); buff += dlen; *buff = '\n'; buff++;
+            dlen = XrdXrootdProtocol::StatGen(sTab[i].Stat, buff);
+            buff += dlen; *buff = '\n'; buff++;
+           }
+      }
+
+// Send a partial response if the entry did not fit
+//
+   if (dName) return (Response.Send(kXR_oksofar, eBuff, buff-eBuff) ? -1 : 1);
+
+// Send the ending packet
+//
+   if (eBuff == buff) rc = Response.Send();
+      else {*(buff-1) = '\0';
+            rc = Response.Send((void *)eBuff, buff-eBuff);
+           }
+   if (!rc) {TRACEP(FS, (doStat ? "dirstat" : "dirlist") <<" entries="
+                        <<numEnt <<" path=" <<dirPath);
+            }
+   return (rc ? -1 : 0);
+}
+
+/******************************************************************************/
+/*                               R e c y c l e                                */
+/******************************************************************************/
+
+// The object is deleted once the owner and every helper scheduled for it are
+// done with it. A helper may well run after the listing has ended.
+//
+void XrdXrootdDirList::Recycle()
+{
+   int n;
+
+   sCond.Lock(); n = --numRef; sCond.UnLock();
+   if (!n) delete this;
+}
+
+/******************************************************************************/
+/*                               S t a t A l l                                */
+/******************************************************************************/
+
+// Stat the gathered entries. Helpers are scheduled for a large enough batch
+// but we never wait for a helper that has not started; whatever it did not
+// claim we stat ourselves. This keeps a busy scheduler from stalling us.
+// The return code of the first failing stat is returned, SFS_OK otherwise.
+//
+int XrdXrootdDirList::StatAll(int sCnt)
+{
+   int i, rc, nHelp = (sCnt-1)/minEnts;
+
+// Publish the batch and ask for help
+//
+   if (nHelp > maxHelp) nHelp = maxHelp;
+   sCond.Lock();
+   sNum = sCnt; sNext = 0; sLeft = sCnt;
+   numRef += nHelp;
+   sCond.UnLock();
+   for (i = 0; i < nHelp; i++) Sched->Schedule(new StatJob(this));
+
+// Do our part and wait for the stat calls still in progress
+//
+   StatSome();
+   sCond.Lock();
+   while(sLeft) sCond.Wait();
+   rc = sRC;
+   sCond.UnLock();
+   return rc;
+}
+
+/******************************************************************************/
+/*                             S t a t E r r o r                              */
+/******************************************************************************/
+
+// Send the response for the first failed stat of a batch as the protocol does
+// for a stat request. We cannot wait for a deferred stat in the middle of a
+// listing (no callback was offered) so the client is told to retry later.
+//
+int XrdXrootdDirList::StatError()
+{
+   int ecode = sEcode, rc = sRC;
+
+// Process standard errors
+//
+   if (rc == SFS_ERROR)
+      {SI->errorCnt++;
+       return Response.Send((XErrorCode)XProtocol::mapError(ecode), sEmsg);
+      }
+
+// Process the redirection (error msg is host:port)
+//
+   if (rc == SFS_REDIRECT)
+      {SI->redirCnt++;
+       if (ecode <= 0) ecode = (ecode ? -ecode : Port);
+       if (XrdXrootdMonitor::Redirect())
+           XrdXrootdMonitor::Redirect(monID,sEmsg,ecode,XROOTD_MON_STAT,dirPath);
+       TRACEI(REDIR, Response.ID() <<"redirecting to " <<sEmsg <<':' <<ecode);
+       return Response.Send(kXR_redirect, ecode, sEmsg, strlen(sEmsg));
+      }
+
+// Process the deferal
+//
+   if (rc == SFS_STARTED) rc = (ecode > 0 && ecode < waitTime ? ecode:waitTime);
+   if (rc >= SFS_STALL)
+      {SI->stallCnt++;
+       TRACEI(STALL, Response.ID() <<"stalling client for " <<rc <<" sec");
+       return Response.Send(kXR_wait, rc, sEmsg);
+      }
+
+// Unknown conditions, report it
+//
+   {char buff[64];
+    SI->errorCnt++;
+    sprintf(buff, "Unknown sfs response code %d", rc);
+    return Response.Send(kXR_ServerError, buff);
+   }
+}
+
+/******************************************************************************/
+/*                              S t a t S o m e                               */
+/******************************************************************************/
+
+// Stat entries of the current batch until none are left to claim. Each stat
+// call gets its own error object as the calls may run concurrently.
+//
+void XrdXrootdDirList::StatSome()
+{
+   const char *dSep = (*dirPath && dirPath[strlen(dirPath)-1] == '/' ? "":"/");
+   const char *eText;
+   char pBuff[4096];
+   int i, n, rc;
+
+   sCond.Lock();
+   while(sNext < sNum)
+        {i = sNext++;
+         sCond.UnLock();
+         XrdOucErrInfo myError(Link->ID, monID, clntPV);
+         n = snprintf(pBuff,sizeof(pBuff),"%s%s%s",dirPath,dSep,sTab[i].Name);
+         if (n >= (int)sizeof(pBuff))
+            {myError.setErrInfo(ENAMETOOLONG, "path too long"); rc = SFS_ERROR;}
+            else rc = sfsP->stat(pBuff, &sTab[i].Stat, myError, Client, Opaque);
+         sCond.Lock();
+         if (rc != SFS_OK && sRC == SFS_OK)
+            {eText = myError.getErrText(sEcode);
+             sEmsg = strdup(*eText ? eText : "stat failed");
+             sRC   = rc;
+             sLeft -= (sNum - sNext); sNext = sNum;
+            }
+         if (!--sLeft) sCond.Signal();
+        }
+   sCond.UnLock();
+}
@@ -0,0 +1,153 @@
+#ifndef __XRDXROOTDDIRLIST__
+#define __XRDXROOTDDIRLIST__
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d D i r L i s t . h h                    */
+/*                                                                            */
+/* (c) 2004 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <sys/stat.h>
+
+#include "Xrd/XrdJob.hh"
+#include "XrdSys/XrdSysPthread.hh"
+#include "XrdXrootd/XrdXrootdResponse.hh"
+
+class XrdLink;
+class XrdScheduler;
+class XrdSecEntity;
+class XrdSfsDirectory;
+class XrdSfsFileSystem;
+class XrdXrootdStats;
+
+// The XrdXrootdDirList object sends the listing of an open directory in
+// chunks, optionally with the stat information of each entry. The first
+// chunk is sent by the thread that received the request. Should more chunks
+// follow, the object may be scheduled to send one chunk each time it runs so
+// that a large directory does not tie up a worker thread nor the link for the
+// whole listing. The directory is closed and deleted along with the object.
+//
+// When the file system does not supply the stat information along with each
+// entry, the entries of a chunk are stat'ed as a batch by the thread sending
+// the chunk with the help of a few scheduler jobs. The object is reference
+// counted so that a helper that only runs after the listing ended is harmless.
+
+class XrdXrootdDirList : public XrdJob
+{
+public:
+
+// Alloc() returns a list object for the directory. When stat information is
+//         wanted, the file system is used to stat each entry should the
+//         directory not supply it, in which case the path is the one given
+//         to the file system and the remaining arguments are passed along.
+//
+static XrdXrootdDirList *Alloc(XrdXrootdResponse  &resp,
+                               XrdSfsDirectory    *dP,
+                               const char         *path,
+                               bool                dStat,
+                               XrdSfsFileSystem   *fsP,
+                               const XrdSecEntity *client,
+                               const char         *opaque,
+                               int                 monID,
+                               int                 clientPV);
+
+       void              DoIt();
+
+static void              Init(XrdScheduler *schedP, XrdXrootdStats *siP,
+                              int port) {Sched = schedP; SI = siP; Port = port;}
+
+// Start() sends the first chunk. If more follow and bgOK is true, the rest
+//         is sent in the background and zero is returned. Otherwise, the
+//         listing is completed and the result of the last send is returned.
+//         In either case the object must not be referenced afterwards.
+//
+       int               Start(bool bgOK);
+
+private:
+
+struct StatEnt
+      {const char  *Name;
+       struct stat  Stat;
+      };
+
+class  StatJob : public XrdJob
+{
+public:
+       void              DoIt() {dlP->StatSome(); dlP->Recycle(); delete this;}
+
+                         StatJob(XrdXrootdDirList *lP)
+                                : XrdJob("dirstat"), dlP(lP) {}
+                        ~StatJob() {}
+private:
+XrdXrootdDirList *dlP;
+};
+
+       XrdXrootdDirList(XrdXrootdResponse &resp, XrdSfsDirectory *dP,
+                        const char *path, bool dStat);
+      ~XrdXrootdDirList();
+
+       int               Chunk();
+       void              Recycle();
+       int               StatAll(int sCnt);
+       int               StatError();
+       void              StatSome();
+
+static const char       *TraceID;
+static XrdScheduler     *Sched;
+static XrdXrootdStats   *SI;
+static int               Port;
+
+       XrdXrootdResponse Response;   // Copy of the original response object
+       XrdLink          *Link;       // -> Network link
+       XrdSfsDirectory  *dirP;       // -> Directory being listed
+       char             *dirPath;    // Path of the directory (for tracing)
+       const char       *dName;      // Entry that did not fit the last chunk
+       struct stat       Stat;       // Filled in by the directory if dStat
+       int               numEnt;     // Number of entries sent
+       bool              doStat;     // Send stat information as well
+       bool              leadIn;     // Lead-in entry must still be sent
+       char              eBuff[8192];
+
+// The following are only used when each entry must be stat'ed. Everything
+// after sCond is protected by it.
+//
+       XrdSfsFileSystem   *sfsP;     // -> File system doing the stat calls
+       const XrdSecEntity *Client;   // -> Credentials of the client
+       char               *Opaque;   // -> Opaque information of the request
+       StatEnt            *sTab;     // -> Entries of the current batch
+       char               *nBuff;    // -> Names   of the current batch
+       int                 monID;
+       int                 clntPV;
+       XrdSysCondVar       sCond;
+       char               *sEmsg;    // Message of the first failed stat
+       int                 sEcode;   // Error code of the first failed stat
+       int                 sRC;      // Return code of the first failed stat
+       int                 sNum;     // Number of entries in the batch
+       int                 sNext;    // Next entry to be stat'ed
+       int                 sLeft;    // Entries not yet stat'ed
+       int                 numRef;   // Owner plus helpers not yet done
+};
+#endif
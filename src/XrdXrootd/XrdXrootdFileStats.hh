@@ -30,6 +30,9 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <string.h>
+
+#include "XrdOuc/XrdOucIOVec.hh"
 #include "XrdXrootd/XrdXrootdMonData.hh"
 
 class XrdXrootdFileStats
@@ -49,6 +52,22 @@ struct {double      read;     // sum(read_size[i] **2) i = 1 to Ops.read
         double      write;    // sum(write_size[i]**2) i = 1 to Ops.write
        }            ssq;
 
+// Access pattern data is only allocated when it has to be reported (i.e. by
+// XrdXrootdMonFile::Open()) and is updated by rdPat() and rvPat().
+//
+struct patData
+      {long long     rdNext;      // Offset following the previous read
+       kXR_unt32     rdSeq;       // Sequential read() requests
+       kXR_unt32     rvSeq;       // Sequential readv() segments
+       kXR_unt32     rdSize[16];  // read()  size histogram (log2, 1K to 16M)
+       kXR_unt32     rvSize[16];  // readv() size histogram (log2, 1K to 16M)
+       kXR_unt32     rvSegs[12];  // readv() segment count histogram (log2)
+       int           extNum;      // Number of extents read or -1 if too many
+       long long     extBeg[8];   // Start of each disjoint extent read
+       long long     extEnd[8];   // End   of each disjoint extent read
+       unsigned char pgReg[256];  // HyperLogLog registers of 4K pages read
+      }            *pat;
+
 enum monLevel {monOff = 0, monOn = 1, monOps = 2, monSsq = 3};
 
        void Init()
@@ -58,8 +77,36 @@ enum monLevel {monOff = 0, monOn = 1, monOps = 2, monSsq = 3};
                  ops.rsMin = 0x7fff;
                  ops.rdMin = ops.rvMin = ops.wrMin = 0x7fffffff;
                  ssq.read  = ssq.readv = ssq.write = ssq.rsegs = 0.0;
+                 pat = 0;
                 };
 
+       void patInit()
+                   {if (!pat) pat = new patData;
+                    memset(pat, 0, sizeof(patData));
+                   }
+
+inline void rdPat(long long offs, int rsz)
+                 {if (pat)
+                     {pat->rdSize[szBucket(rsz)]++;
+                      if (offs == pat->rdNext) pat->rdSeq++;
+                      pat->rdNext = offs + rsz;
+                      Touch(offs, rsz);
+                     }
+                 }
+
+inline void rvPat(const XrdOucIOVec *vP, int vnum)
+                 {if (pat)
+                     {int sx = (vnum > 1 ? 31 - __builtin_clz(vnum) : 0);
+                      pat->rvSegs[sx < 11 ? sx : 11]++;
+                      for (int i = 0; i < vnum; i++)
+                          {pat->rvSize[szBucket(vP[i].size)]++;
+                           if (vP[i].offset == pat->rdNext) pat->rvSeq++;
+                           pat->rdNext = vP[i].offset + vP[i].size;
+                           Touch(vP[i].offset, vP[i].size);
+                          }
+                     }
+                 }
+
 inline void rdOps(int rsz)
                  {if (monLvl)
                      {xfr.read += rsz; ops.read++; xfrXeq = 1;
@@ -105,6 +152,52 @@ inline void wrOps(int wsz)
                  }
 
        XrdXrootdFileStats() {Init();}
-      ~XrdXrootdFileStats() {}
+      ~XrdXrootdFileStats() {if (pat) delete pat;}
+
+private:
+
+// Record the range that was read. As long as the reads fall into a few
+// disjoint extents we know exactly how much of the file was read. We also
+// add every page in the range to a sketch that is used when there are more.
+// Each page hashes to a register that keeps the longest run of leading
+// zeroes seen in the rest of the hash.
+//
+       void Touch(long long offs, int len)
+                 {unsigned long long h, pg, pgEnd;
+                  long long oEnd = offs + len;
+                  int i, rank;
+                  if (len <= 0 || offs < 0) return;
+                  pg    = static_cast<unsigned long long>(offs)   >> 12;
+                  pgEnd = static_cast<unsigned long long>(oEnd-1) >> 12;
+                  if (pat->extNum >= 0)
+                     {for (i = 0; i < pat->extNum; )
+                          {if (offs > pat->extEnd[i] || oEnd < pat->extBeg[i])
+                              {i++; continue;}
+                           if (pat->extBeg[i] < offs) offs = pat->extBeg[i];
+                           if (pat->extEnd[i] > oEnd) oEnd = pat->extEnd[i];
+                           pat->extNum--;
+                           pat->extBeg[i] = pat->extBeg[pat->extNum];
+                           pat->extEnd[i] = pat->extEnd[pat->extNum];
+                          }
+                      if (pat->extNum < 8)
+                         {pat->extBeg[pat->extNum]   = offs;
+                          pat->extEnd[pat->extNum++] = oEnd;
+                         } else pat->extNum = -1;
+                     }
+                  for ( ; pg <= pgEnd; pg++)
+                      {h = (pg + 0x9e3779b97f4a7c15ULL);
+                       h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                       h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+                       h =  h ^ (h >> 31);
+                       rank = ((h << 8) ? __builtin_clzll(h << 8) + 1 : 57);
+                       if (rank > pat->pgReg[h >> 56])
+                          pat->pgReg[h >> 56] = static_cast<unsigned char>(rank);
+                      }
+                 }
+
+static int  szBucket(int sz)
+                    {int bx = (sz >= 1024 ? 31 - __builtin_clz(sz) - 9 : 0);
+                     return (bx < 15 ? bx : 15);
+                    }
 };
 #endif
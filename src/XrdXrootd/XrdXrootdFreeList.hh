@@ -0,0 +1,229 @@
+#ifndef __XRDXROOTDFREELIST__
+#define __XRDXROOTDFREELIST__
+/******************************************************************************/
+/*                                                                            */
+/*                  X r d X r o o t d F r e e L i s t . h h                   */
+/*                                                                            */
+/* (c) 2007 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*                            All Rights Reserved                             */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <new>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "XrdSys/XrdSysAtomics.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+/******************************************************************************/
+/*                     X r d X r o o t d F r e e L i s t                      */
+/******************************************************************************/
+
+// The XrdXrootdFreeList template keeps the unused objects of a class that is
+// allocated and recycled at a high rate by many threads. Objects are carved
+// out of slabs that are never freed so that an object is always addressable
+// by a 32-bit index. Each thread keeps a small cache of free objects and
+// exchanges them in batches with a global stack. The stack head holds the
+// index of the top object along with a tag that is bumped on every change so
+// that it can be updated with a single compare and swap without ABA problems.
+// Without atomics the global stack is protected by a mutex instead. A free
+// list must have static storage duration since its thread caches refer to it.
+
+template<class T>
+class XrdXrootdFreeList
+{
+public:
+
+// Pop() returns an unused object or nil if no more can be created. Objects
+//       are constructed once and returned in whatever state they were pushed.
+//
+T               *Pop()
+                    {Cache *cP = getCache();
+                     if (!cP) return popSlow();
+                     if (!cP->First && !popChain(cP, cacheMax/2)) return 0;
+                     Slot *sP = getSlot(cP->First);
+                     cP->First = sP->Next; cP->Num--;
+                     return &(sP->Obj);
+                    }
+
+// Push() makes an object obtained from Pop() available for reuse.
+//
+void             Push(T *objP)
+                     {Slot  *sP = (Slot *)objP;
+                      Cache *cP = getCache();
+                      if (!cP) {pushChain(sP->Index, sP); return;}
+                      sP->Next = cP->First; cP->First = sP->Index;
+                      if (++(cP->Num) > cacheMax) flushCache(cP, cacheMax/2);
+                     }
+
+                 XrdXrootdFreeList(int cmax=32)
+                                  : Head(0), numSlabs(0),
+                                    cacheMax(cmax < 2 ? 2 : cmax)
+                                  {keyOK = !pthread_key_create(&cacheKey,
+                                                               endCache);
+                                  }
+
+                ~XrdXrootdFreeList() {}
+
+private:
+
+// The object must be the first member so that its address is the slot's
+//
+struct Slot  {T                  Obj;
+              unsigned int       Next;   // Index of the next free slot
+              unsigned int       Index;  // Index of this slot (never 0)
+             };
+
+struct Cache {XrdXrootdFreeList *Owner;
+              unsigned int       First;  // Index of the first cached slot
+              int                Num;    // Number of cached slots
+             };
+
+static const unsigned int SlabSize = 64;
+static const unsigned int SlabMax  = 16384;
+
+static void      endCache(void *arg)
+                         {Cache *cP = (Cache *)arg;
+                          if (cP->Num) cP->Owner->flushCache(cP, cP->Num);
+                          free(cP);
+                         }
+
+void             flushCache(Cache *cP, int num)
+                           {Slot *sP = getSlot(cP->First);
+                            unsigned int first = cP->First;
+                            cP->Num -= num;
+                            while(--num) sP = getSlot(sP->Next);
+                            cP->First = sP->Next;
+                            pushChain(first, sP);
+                           }
+
+Cache           *getCache()
+                         {Cache *cP;
+                          if (!keyOK) return 0;
+                          if ((cP = (Cache *)pthread_getspecific(cacheKey)))
+                             return cP;
+                          if (!(cP = (Cache *)malloc(sizeof(Cache)))) return 0;
+                          cP->Owner = this; cP->First = 0; cP->Num = 0;
+                          if (pthread_setspecific(cacheKey, cP))
+                             {free(cP); return 0;}
+                          return cP;
+                         }
+
+inline Slot     *getSlot(unsigned int idx)
+                        {idx--; return &(Slabs[idx/SlabSize][idx%SlabSize]);}
+
+// Add a slab; its first slot goes to the caller and the rest to the stack
+//
+Slot            *newSlab()
+                        {Slot *sP;
+                         unsigned int i, base;
+                         slabMutex.Lock();
+                         if (numSlabs >= SlabMax
+                         || !(sP = (Slot *)malloc(sizeof(Slot)*SlabSize)))
+                            {slabMutex.UnLock(); return 0;}
+                         base = numSlabs*SlabSize + 1;
+                         for (i = 0; i < SlabSize; i++)
+                             {new (&sP[i].Obj) T();
+                              sP[i].Index = base + i;
+                              sP[i].Next  = (i+1 < SlabSize ? base+i+1 : 0);
+                             }
+                         Slabs[numSlabs++] = sP;
+                         slabMutex.UnLock();
+                         pushChain(base+1, &sP[SlabSize-1]);
+                         return sP;
+                        }
+
+// Move up to num slots from the stack to a thread cache. The links of the
+// chain may change under us but they are always valid indices and the chain
+// is only taken when the stack did not change while it was being walked.
+//
+bool             popChain(Cache *cP, unsigned int num)
+                         {unsigned int first, next, n = 1;
+                          Slot *sP = 0;
+#ifdef HAVE_ATOMICS
+                          unsigned long long oldHead, newHead;
+                          do {oldHead = Head;
+                              if (!(first = (unsigned int)oldHead)) break;
+                              sP = getSlot(first);
+                              for (n = 1; n < num && (next = sP->Next); n++)
+                                  sP = getSlot(next);
+                              newHead = (((oldHead>>32)+1)<<32) | sP->Next;
+                             } while(!AtomicCAS(Head, oldHead, newHead));
+#else
+                          headMutex.Lock();
+                          if ((first = (unsigned int)Head))
+                             {sP = getSlot(first);
+                              for (n = 1; n < num && (next = sP->Next); n++)
+                                  sP = getSlot(next);
+                              Head = sP->Next;
+                             }
+                          headMutex.UnLock();
+#endif
+                          if (!first)
+                             {if (!(sP = newSlab())) return false;
+                              first = sP->Index; n = 1;
+                             }
+                          sP->Next = cP->First; cP->First = first; cP->Num += n;
+                          return true;
+                         }
+
+// Used when the thread has no cache; take a single slot from the stack
+//
+T               *popSlow()
+                        {Cache tmp = {this, 0, 0};
+                         if (!popChain(&tmp, 1)) return 0;
+                         return &(getSlot(tmp.First)->Obj);
+                        }
+
+// Push a chain of slots, from the one at index first to the one at lastP
+//
+void             pushChain(unsigned int first, Slot *lastP)
+                          {
+#ifdef HAVE_ATOMICS
+                           unsigned long long oldHead, newHead;
+                           do {oldHead = Head;
+                               lastP->Next = (unsigned int)oldHead;
+                               newHead = (((oldHead>>32)+1)<<32) | first;
+                              } while(!AtomicCAS(Head, oldHead, newHead));
+#else
+                           headMutex.Lock();
+                           lastP->Next = (unsigned int)Head;
+                           Head = first;
+                           headMutex.UnLock();
+#endif
+                          }
+
+volatile unsigned long long Head;    // Tag<<32 | index of the top slot
+#ifndef HAVE_ATOMICS
+XrdSysMutex                 headMutex;
+#endif
+XrdSysMutex                 slabMutex;
+Slot                       *Slabs[SlabMax];
+unsigned int                numSlabs;
+int                         cacheMax;
+pthread_key_t               cacheKey;
+bool                        keyOK;
+};
+#endif
@@ -0,0 +1,219 @@
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d L a t e n c y . c c                    */
+/*                                                                            */
+/* (c) 2004 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "XrdXrootd/XrdXrootdLatency.hh"
+
+/******************************************************************************/
+/*                        S t a t i c   O b j e c t s                         */
+/******************************************************************************/
+
+namespace
+{
+// Names of the requests in request code order, the last one is for the codes
+// that are not valid.
+//
+const char *reqName[] = {"auth",  "query",   "chmod",   "close",   "dirlist",
+                         "getfile","protocol","login",  "mkdir",   "mv",
+                         "open",  "ping",    "putfile", "read",    "rm",
+                         "rmdir", "sync",    "stat",    "set",     "write",
+                         "admin", "prepare", "statx",   "endsess", "bind",
+                         "readv", "verifyw", "locate",  "truncate","other"};
+
+const char reqFmt[] = "<%s><n>%llu</n>"
+    "<wait><p50>%lld</p50><p90>%lld</p90><p99>%lld</p99><p999>%lld</p999>"
+    "<max>%lld</max></wait>"
+    "<svc><p50>%lld</p50><p90>%lld</p90><p99>%lld</p99><p999>%lld</p999>"
+    "<max>%lld</max></svc></%s>";
+}
+  
+/******************************************************************************/
+/*                           C o n s t r u c t o r                            */
+/******************************************************************************/
+  
+XrdXrootdLatency::XrdXrootdLatency() : histFirst(0)
+{
+   Retired = (Hist *)calloc(1, sizeof(Hist));
+   keyOK   = Retired && !pthread_key_create(&histKey, endHist);
+}
+
+/******************************************************************************/
+/*                                 S t a t s                                  */
+/******************************************************************************/
+  
+int XrdXrootdLatency::Stats(char *buff, int blen)
+{
+   static const long long LLMax = 0x7fffffffffffffffLL;
+   Hist *tP, *hP;
+   int i, j, k, rx, len;
+
+// If no buffer, caller wants the maximum size we will generate
+//
+   if (!buff)
+      {char dummy[1024];
+       len = 0;
+       for (rx = 0; rx < numReqs; rx++)
+           len += snprintf(dummy, sizeof(dummy), reqFmt, reqName[rx],
+                           (unsigned long long)LLMax, LLMax, LLMax, LLMax,
+                           LLMax, LLMax, LLMax, LLMax, LLMax, LLMax, LLMax,
+                           reqName[rx]);
+       return len + 12; // <lat></lat>
+      }
+
+// Merge the histograms of all the threads
+//
+   if (!keyOK || !(tP = (Hist *)malloc(sizeof(Hist)))) return 0;
+   histMutex.Lock();
+   memcpy(tP, Retired, sizeof(Hist));
+   for (hP = histFirst; hP; hP = hP->Next)
+       for (i = 0; i < 2; i++)
+           for (j = 0; j < numReqs; j++)
+               {for (k = 0; k < numBkts; k++) tP->Cnt[i][j][k] += hP->Cnt[i][j][k];
+                if (hP->Max[i][j] > tP->Max[i][j]) tP->Max[i][j] = hP->Max[i][j];
+               }
+   histMutex.UnLock();
+
+// Format the requests that were seen
+//
+   len = snprintf(buff, blen, "<lat>");
+   for (rx = 0; rx < numReqs && len < blen; rx++)
+       len += Format(buff+len, blen-len, reqName[rx], tP, rx);
+   if (len < blen) len += snprintf(buff+len, blen-len, "</lat>");
+   free(tP);
+   return (len < blen ? len : blen-1);
+}
+
+/******************************************************************************/
+/*                       P r i v a t e   M e t h o d s                        */
+/******************************************************************************/
+/******************************************************************************/
+/*                             b u c k e t T o p                              */
+/******************************************************************************/
+
+// Return the upper bound of a bucket in microseconds
+  
+long long XrdXrootdLatency::bucketTop(int bx)
+{
+   int lg2;
+
+   if (bx < 4) return bx+1;
+   lg2 = bx/4 + 1;
+   return (static_cast<long long>(4 + bx%4) << (lg2-2)) + (1LL << (lg2-2));
+}
+
+/******************************************************************************/
+/*                               e n d H i s t                                */
+/******************************************************************************/
+
+// Called when a thread exits to fold its histograms into the retired ones
+  
+void XrdXrootdLatency::endHist(void *arg)
+{
+   Hist *hP = (Hist *)arg, *rP;
+   XrdXrootdLatency *lP = hP->Owner;
+   int i, j, k;
+
+   lP->histMutex.Lock();
+   rP = lP->Retired;
+   for (i = 0; i < 2; i++)
+       for (j = 0; j < numReqs; j++)
+           {for (k = 0; k < numBkts; k++) rP->Cnt[i][j][k] += hP->Cnt[i][j][k];
+            if (hP->Max[i][j] > rP->Max[i][j]) rP->Max[i][j] = hP->Max[i][j];
+           }
+   if (hP->Prev) hP->Prev->Next = hP->Next;
+      else lP->histFirst = hP->Next;
+   if (hP->Next) hP->Next->Prev = hP->Prev;
+   lP->histMutex.UnLock();
+   free(hP);
+}
+
+/******************************************************************************/
+/*                                F o r m a t                                 */
+/******************************************************************************/
+  
+int XrdXrootdLatency::Format(char *buff, int blen, const char *name,
+                             Hist *hP, int rx)
+{
+   static const int pNum = 4;
+   static const int pVal[pNum] = {500, 900, 990, 999}; // per thousand
+   unsigned long long num = 0, sum, want;
+   long long pct[2][pNum];
+   int i, k, px;
+
+// Count the requests, skip the ones never seen
+//
+   for (k = 0; k < numBkts; k++) num += hP->Cnt[1][rx][k];
+   if (!num) return 0;
+
+// Compute the percentiles of the wait and service times
+//
+   for (i = 0; i < 2; i++)
+       {sum = 0; px = 0;
+        for (k = 0; k < numBkts && px < pNum; k++)
+            {sum += hP->Cnt[i][rx][k];
+             while(px < pNum)
+                  {want = (num*pVal[px] + 999)/1000;
+                   if (sum < want) break;
+                   pct[i][px++] = bucketTop(k);
+                  }
+            }
+        while(px < pNum) pct[i][px++] = bucketTop(numBkts-1);
+       }
+
+// Format the entry
+//
+   return snprintf(buff, blen, reqFmt, name, num,
+                   pct[0][0], pct[0][1], pct[0][2], pct[0][3], hP->Max[0][rx]/1000,
+                   pct[1][0], pct[1][1], pct[1][2], pct[1][3], hP->Max[1][rx]/1000,
+                   name);
+}
+
+/******************************************************************************/
+/*                               n e w H i s t                                */
+/******************************************************************************/
+  
+XrdXrootdLatency::Hist *XrdXrootdLatency::newHist()
+{
+   Hist *hP;
+
+// Allocate histograms for this thread and make them visible to Stats()
+//
+   if (!keyOK || !(hP = (Hist *)calloc(1, sizeof(Hist)))) return 0;
+   if (pthread_setspecific(histKey, hP)) {free(hP); return 0;}
+   hP->Owner = this;
+   histMutex.Lock();
+   hP->Prev = 0;
+   if ((hP->Next = histFirst)) histFirst->Prev = hP;
+   histFirst = hP;
+   histMutex.UnLock();
+   return hP;
+}
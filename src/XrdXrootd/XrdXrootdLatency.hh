@@ -0,0 +1,117 @@
+#ifndef __XRDXROOTDLATENCY_H__
+#define __XRDXROOTDLATENCY_H__
+/******************************************************************************/
+/*                                                                            */
+/*                   X r d X r o o t d L a t e n c y . h h                    */
+/*                                                                            */
+/* (c) 2004 by the Board of Trustees of the Leland Stanford, Jr., University  */
+/*   Produced by Andrew Hanushevsky for Stanford University under contract    */
+/*              DE-AC02-76-SFO0515 with the Department of Energy              */
+/*                                                                            */
+/* This file is part of the XRootD software suite.                            */
+/*                                                                            */
+/* XRootD is free software: you can redistribute it and/or modify it under    */
+/* the terms of the GNU Lesser General Public License as published by the     */
+/* Free Software Foundation, either version 3 of the License, or (at your     */
+/* option) any later version.                                                 */
+/*                                                                            */
+/* XRootD is distributed in the hope that it will be useful, but WITHOUT      */
+/* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or      */
+/* FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public       */
+/* License for more details.                                                  */
+/*                                                                            */
+/* You should have received a copy of the GNU Lesser General Public License   */
+/* along with XRootD in a file called COPYING.LESSER (LGPL license) and file  */
+/* COPYING (GPL license).  If not, see <http://www.gnu.org/licenses/>.        */
+/*                                                                            */
+/* The copyright holder's institutional names and contributor's names may not */
+/* be used to endorse or promote products derived from this software without  */
+/* specific prior written permission of the institution or contributor.       */
+/******************************************************************************/
+
+#include <pthread.h>
+
+#include "XProtocol/XProtocol.hh"
+#include "XrdSys/XrdSysPthread.hh"
+
+// The XrdXrootdLatency object keeps a latency histogram of the queue wait and
+// the service time of each request code. The queue wait runs from the time
+// the poller found the link ready until the request is dispatched and so
+// includes reading the request. The service time is the time spent in the
+// dispatched request (i.e. asynchronous completions are not included).
+//
+// Histogram buckets are log-linear: four per power of two microseconds, so a
+// reported value is at most 25% above the actual latency. Each thread counts
+// in its own histograms without locking; they are merged when reported.
+
+class XrdXrootdLatency
+{
+public:
+
+// Add() records the wait and service time, in nanoseconds, of a request.
+//
+void     Add(int reqID, long long waitNS, long long svcNS)
+            {Hist *hP = getHist();
+             if (hP) {int rx = reqIndex(reqID);
+                      hP->Cnt[0][rx][bucket(waitNS)]++;
+                      hP->Cnt[1][rx][bucket(svcNS)]++;
+                      if (waitNS > hP->Max[0][rx]) hP->Max[0][rx] = waitNS;
+                      if (svcNS  > hP->Max[1][rx]) hP->Max[1][rx] = svcNS;
+                     }
+            }
+
+// Stats() formats the merged histograms as XML. If buff is nil, the maximum
+//         length of the text is returned.
+//
+int      Stats(char *buff, int blen);
+
+         XrdXrootdLatency();
+        ~XrdXrootdLatency() {}
+
+private:
+
+static const int numBkts = 100;  // 1us to 2**25us (33 seconds) and beyond
+static const int numReqs = 30;   // kXR_auth to kXR_truncate plus others
+
+struct Hist {XrdXrootdLatency  *Owner;
+             Hist              *Next;
+             Hist              *Prev;
+             unsigned long long Cnt[2][numReqs][numBkts];
+             long long          Max[2][numReqs];
+            };
+
+static int  bucket(long long ns)
+                  {unsigned long long us = (ns > 0 ? ns/1000 : 0);
+                   int bx, lg2;
+                   if (us < 4) return static_cast<int>(us);
+                   lg2 = 63 - __builtin_clzll(us);
+                   bx  = (lg2-1)*4 + static_cast<int>((us >> (lg2-2)) & 3);
+                   return (bx < numBkts ? bx : numBkts-1);
+                  }
+
+static long long bucketTop(int bx);
+
+Hist       *getHist()
+                   {Hist *hP;
+                    if ((hP = (Hist *)pthread_getspecific(histKey))) return hP;
+                    return newHist();
+                   }
+
+static void endHist(void *hP);
+
+int         Format(char *buff, int blen, const char *name, Hist *hP, int rx);
+
+Hist       *newHist();
+
+static int  reqIndex(int reqID)
+                    {unsigned int rx = static_cast<unsigned int>(reqID-kXR_auth);
+                     return (rx < numReqs-1 ? static_cast<int>(rx) : numReqs-1);
+                    }
+
+XrdSysMutex histMutex;   // Protects the thread list and the retired counts
+Hist       *histFirst;
+Hist       *Retired;
+pthread_key_t histKey;
+bool        keyOK;
+};
+#endif
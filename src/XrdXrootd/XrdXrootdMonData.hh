@@ -160,6 +160,7 @@ enum  recTval {isClose = 0,   // Record for close
 enum  recFval {forced  =0x01, // If recFlag == isClose close due to disconnect
                hasOPS  =0x02, // If recFlag == isClose MonStatXFR + MonStatOPS
                hasSSQ  =0x04, // If recFlag == isClose XFR + OPS  + MonStatSSQ
+               hasPAT  =0x08, // If recFlag == isClose XFR + OPS [+ SSQ] + PAT
                hasLFN  =0x01, // If recFlag == isOpen  the lfn is present
                hasRW   =0x02  // If recFlag == isOpen  file opened r/w
               };
@@ -239,6 +240,25 @@ XrdXrootdMonDouble  rsegs;    // Sum (all readv segments)**2 (count as a unit)
 XrdXrootdMonDouble  write;    // Sum (all write requests)**2 (size)
 };
 
+// The following access pattern data is collected per file when "pat" is
+// specified. Size histogram bucket 0 counts requests below 1K, bucket i counts
+// requests of at least 2**(i+9) bytes (i.e. 1K, 2K, 4K, ... 16M and larger).
+// Segment histogram bucket i counts readv() requests of at least 2**i segments.
+// A read is sequential if it starts where the previous read or readv segment
+// ended. The number of distinct bytes read is exact when all reads fell into
+// at most 8 disjoint extents. Otherwise, it is estimated from a sketch of the
+// 4K pages that were read (rounded to pages with a standard error of 7%).
+//
+struct XrdXrootdMonStatPAT    // 192 Bytes
+{
+long long           rdTouch;    // Distinct bytes read (see above)
+kXR_unt32           rdSeq;      // Number of sequential read() requests
+kXR_unt32           rvSeq;      // Number of sequential readv() segments
+kXR_unt32           rdSize[16]; // Histogram of read()  request sizes
+kXR_unt32           rvSize[16]; // Histogram of readv() segment sizes
+kXR_unt32           rvSegs[12]; // Histogram of readv() segment counts
+};
+
 // The following transfer data is collected for each open file.
 //
 struct XrdXrootdMonStatXFR
@@ -252,14 +272,17 @@ long long           write;    // Bytes written to file so far
 // The record always contains XrdXrootdMonStatXFR after   XrdXrootdMonFileHdr.
 // If (recFlag & hasOPS) TRUE XrdXrootdMonStatOPS follows XrdXrootdMonStatXFR
 // If (recFlag & hasSSQ) TRUE XrdXrootdMonStatSQV follows XrdXrootdMonStatOPS
+// If (recFlag & hasPAT) TRUE XrdXrootdMonStatPAT is the last item present
 // The XrdXrootdMonStatSSQ information is present only if "ssq" was specified.
+// The XrdXrootdMonStatPAT information is present only if "pat" was specified.
 //
-struct XrdXrootdMonFileCLS    // 32 | 80 | 96 Bytes
+struct XrdXrootdMonFileCLS    // 32 | 80 | 112 | 272 | 304 Bytes
 {
 XrdXrootdMonFileHdr Hdr;      // Always present (recSize has full length)
 XrdXrootdMonStatXFR Xfr;      // Always present
 XrdXrootdMonStatOPS Ops;      // Only   present when (recFlag & hasOPS) is True
 XrdXrootdMonStatSSQ Ssq;      // Only   present when (recFlag & hasSSQ) is True
+XrdXrootdMonStatPAT Pat;      // Only   present when (recFlag & hasPAT) is True
 };
 
 // The following is reported when a user ends a session.
@@ -28,6 +28,7 @@
 /* specific prior written permission of the institution or contributor.       */
 /******************************************************************************/
 
+#include <math.h>
 #include <string.h>
 
 #include "Xrd/XrdScheduler.hh"
@@ -68,6 +69,7 @@ short                XrdXrootdMonFile::trecNLen = 0;
 char                 XrdXrootdMonFile::fsLFN    = 0;
 char                 XrdXrootdMonFile::fsLVL    = 0;
 char                 XrdXrootdMonFile::fsOPS    = 0;
+char                 XrdXrootdMonFile::fsPAT    = 0;
 char                 XrdXrootdMonFile::fsSSQ    = 0;
 char                 XrdXrootdMonFile::fsXFR    = 0;
 char                 XrdXrootdMonFile::crecFlag = 0;
@@ -151,6 +153,24 @@ void XrdXrootdMonFile::Close(XrdXrootdFileStats *fsP, bool isDisc)
        cRec.Ssq.write.dlong = htonll(xval.dlong);
       }
 
+// Record the access pattern if so needed. It is the last item in the record
+// and follows the ops or the sum of squares, whichever is last.
+//
+   if (fsPAT)
+      {XrdXrootdMonStatPAT *pP = (XrdXrootdMonStatPAT *)
+                       ((char *)&cRec + crecSize - sizeof(XrdXrootdMonStatPAT));
+       XrdXrootdFileStats::patData *patP = fsP->pat;
+       int i;
+       if (patP)
+          {pP->rdTouch = htonll(Touched(patP));
+           pP->rdSeq   = htonl(patP->rdSeq);
+           pP->rvSeq   = htonl(patP->rvSeq);
+           for (i = 0; i < 16; i++) pP->rdSize[i] = htonl(patP->rdSize[i]);
+           for (i = 0; i < 16; i++) pP->rvSize[i] = htonl(patP->rvSize[i]);
+           for (i = 0; i < 12; i++) pP->rvSegs[i] = htonl(patP->rvSegs[i]);
+          } else memset(pP, 0, sizeof(XrdXrootdMonStatPAT));
+      }
+
 // Get a pointer to the next slot (the buffer gets locked)
 //
    cP = GetSlot(crecSize);
@@ -175,8 +195,10 @@ void XrdXrootdMonFile::Defaults(int intv, int opts, int xfrcnt)
 //
    fsXFR  = (opts &  XROOTD_MON_FSXFR) != 0;
    fsLFN  = (opts &  XROOTD_MON_FSLFN) != 0;
-   fsOPS  = (opts & (XROOTD_MON_FSOPS  | XROOTD_MON_FSSSQ)) != 0;
+   fsOPS  = (opts & (XROOTD_MON_FSOPS  | XROOTD_MON_FSSSQ
+                   | XROOTD_MON_FSPAT)) != 0;
    fsSSQ  = (opts &  XROOTD_MON_FSSSQ) != 0;
+   fsPAT  = (opts &  XROOTD_MON_FSPAT) != 0;
 
 // Set monitoring level
 //
@@ -359,6 +381,10 @@ bool XrdXrootdMonFile::Init(XrdScheduler *sp, XrdSysError  *errp, int bfsz)
       {crecSize += sizeof(XrdXrootdMonStatSSQ);
        crecFlag |= XrdXrootdMonFileHdr::hasSSQ;
       }
+   if (fsPAT)
+      {crecSize += sizeof(XrdXrootdMonStatPAT);
+       crecFlag |= XrdXrootdMonFileHdr::hasPAT;
+      }
    crecNLen = htons(static_cast<short>(crecSize));
 
 // Preformat the i/o record
@@ -447,6 +473,42 @@ char *XrdXrootdMonFile::GetSlot(int slotSZ)
    return myRec;
 }
 
+/******************************************************************************/
+/* Private:                      T o u c h e d                                */
+/******************************************************************************/
+
+long long XrdXrootdMonFile::Touched(XrdXrootdFileStats::patData *patP)
+{
+   static const int    numReg = 256;
+   static const double alpha  = 0.7213/(1.0 + 1.079/numReg);
+   long long bytes = 0;
+   double est, sum = 0.0;
+   int i, zeroes = 0;
+
+// If the reads fell into a few extents we know exactly what was read
+//
+   if (patP->extNum >= 0)
+      {for (i = 0; i < patP->extNum; i++)
+           bytes += patP->extEnd[i] - patP->extBeg[i];
+       return bytes;
+      }
+
+// Otherwise compute the HyperLogLog estimate of the number of distinct pages
+// read. Use linear counting for small cardinalities where it is more accurate.
+//
+   for (i = 0; i < numReg; i++)
+       {sum += ldexp(1.0, -static_cast<int>(patP->pgReg[i]));
+        if (!patP->pgReg[i]) zeroes++;
+       }
+   est = alpha * numReg * numReg / sum;
+   if (est <= 2.5*numReg && zeroes)
+      est = numReg * log(static_cast<double>(numReg)/zeroes);
+
+// Return the estimated number of bytes (pages are 4K)
+//
+   return static_cast<long long>(est + 0.5) << 12;
+}
+
 /******************************************************************************/
 /*                                  O p e n                                   */
 /******************************************************************************/
@@ -484,6 +546,7 @@ void XrdXrootdMonFile::Open(XrdXrootdFileStats *fsP, const char *Path,
    fsP->MonEnt = (sNum | (i << XrdXrootdMonFMap::fmShft)) & 0xffff;
    fsP->monLvl = fsLVL;
    fsP->xfrXeq = 0;
+   if (fsPAT) fsP->patInit();
 
 // Compute the size of this record
 //
@@ -32,12 +32,12 @@
 
 #include "Xrd/XrdJob.hh"
 #include "XrdSys/XrdSysPthread.hh"
+#include "XrdXrootd/XrdXrootdFileStats.hh"
 #include "XrdXrootd/XrdXrootdMonFMap.hh"
 #include "XrdXrootd/XrdXrootdMonitor.hh"
 
 class XrdScheduler;
 class XrdSysError;
-class XrdXrootdFileStats;
 class XrdXrootdMonHeader;
 class XrdXrootdMonTrace;
   
@@ -67,6 +67,7 @@ static void                 DoXFR();
 static void                 DoXFR(XrdXrootdFileStats *fsP);
 static void                 Flush();
 static char                *GetSlot(int slotSZ);
+static long long            Touched(XrdXrootdFileStats::patData *patP);
                           
 static XrdSysError         *eDest;
 static XrdScheduler        *Sched;
@@ -94,6 +95,7 @@ static short                trecNLen;
 static char                 fsLFN;
 static char                 fsLVL;
 static char                 fsOPS;
+static char                 fsPAT;
 static char                 fsSSQ;
 static char                 fsXFR;
 static char                 crecFlag;
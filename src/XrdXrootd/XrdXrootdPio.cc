@@ -34,9 +34,7 @@
 /*                      S t a t i c   V a r i a b l e s                       */
 /******************************************************************************/
   
-XrdSysMutex        XrdXrootdPio::myMutex;
-XrdXrootdPio      *XrdXrootdPio::Free = 0;
-int                XrdXrootdPio::FreeNum = 0;
+XrdXrootdFreeList<XrdXrootdPio> XrdXrootdPio::Free;
 
 /******************************************************************************/
 /*                                 A l l o c                                  */
@@ -44,22 +42,11 @@ int                XrdXrootdPio::FreeNum = 0;
   
 XrdXrootdPio *XrdXrootdPio::Alloc(int Num)
 {
-   XrdXrootdPio *lqp, *qp=0;
+   XrdXrootdPio *pioP, *qp=0;
 
-
-// Allocate from the free stack
-//
-   myMutex.Lock();
-   if ((qp = Free))
-      {do {FreeNum--; Num--; lqp = Free;}
-          while((Free = Free->Next) && Num);
-       lqp->Next = 0;
-      }
-   myMutex.UnLock();
-
-// Allocate additional if we have not allocated enough
+// Chain together as many objects as we can get from the free list
 //
-   while(Num--) qp = new XrdXrootdPio(qp);
+   while(Num-- && (pioP = Free.Pop())) qp = pioP->Clear(qp);
 
 // All done
 //
@@ -73,13 +60,8 @@ XrdXrootdPio *XrdXrootdPio::Alloc(int Num)
 void XrdXrootdPio::Recycle()
 {
 
-// Check if we can hold on to this or must delete it
-//
-   myMutex.Lock();
-   if (FreeNum >= FreeMax) {myMutex.UnLock(); delete this; return;}
-
-// Clean this up and push the element on the free stack
+// Push the element on the free list. Objects are never deleted as they come
+// out of slabs kept by the free list.
 //
-   Free = Clear(Free); FreeNum++;
-   myMutex.UnLock();
+   Free.Push(this);
 }
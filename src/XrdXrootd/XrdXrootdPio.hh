@@ -31,7 +31,7 @@
 /******************************************************************************/
   
 #include "XProtocol/XPtypes.hh"
-#include "XrdSys/XrdSysPthread.hh"
+#include "XrdXrootd/XrdXrootdFreeList.hh"
 
 class XrdXrootdFile;
 
@@ -70,9 +70,6 @@ inline void               Set(XrdXrootdFile *theFile, long long theOffset,
 
 private:
 
-static const int          FreeMax = 256;
-static XrdSysMutex        myMutex;
-static XrdXrootdPio      *Free;
-static int                FreeNum;
+static XrdXrootdFreeList<XrdXrootdPio> Free;
 };
 #endif
@@ -338,8 +338,10 @@ int XrdXrootdProtocol::Process(XrdLink *lp) // We ignore the argument here
                   else {Resume = 0; return 0;}
       }
 
-// Read the next request header
+// Read the next request header. The request is charged with the time it
+// waited since the poller found the link ready, if that is what happened.
 //
+   reqStart = Link->getReadyTime();
    if ((rc=getData("request",(char *)&Request,sizeof(Request))) != 0) return rc;
 
 // Deserialize the data
@@ -380,10 +382,28 @@ int XrdXrootdProtocol::Process(XrdLink *lp) // We ignore the argument here
 }
 
 /******************************************************************************/
-/*                      p r i v a t e   P r o c e s s 2                       */
+/*                              P r o c e s s 2                               */
 /******************************************************************************/
   
 int XrdXrootdProtocol::Process2()
+{
+   long long tBeg = XrdSysTimer::Nanos();
+   int rc, reqID = Request.header.requestid;
+
+// Dispatch the request and record how long it waited and how long it took
+//
+   rc = ProcessReq();
+   SI->Latency.Add(reqID, (reqStart ? tBeg - reqStart : 0),
+                   XrdSysTimer::Nanos() - tBeg);
+   reqStart = 0;
+   return rc;
+}
+
+/******************************************************************************/
+/*                    p r i v a t e   P r o c e s s R e q                     */
+/******************************************************************************/
+  
+int XrdXrootdProtocol::ProcessReq()
 {
 
 // If the user is not yet logged in, restrict what the user can do
@@ -712,6 +732,7 @@ void XrdXrootdProtocol::Reset()
    myOffset           = 0;
    myIOLen            = 0;
    myStalls           = 0;
+   reqStart           = 0;
    myAioReq           = 0;
    myFile             = 0;
    numReads           = 0;
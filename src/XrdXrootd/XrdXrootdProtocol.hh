@@ -136,7 +136,6 @@ enum RD_func {RD_chmod = 0, RD_chksum,  RD_dirlist, RD_locate, RD_mkdir,
        int   do_CKsum(const char *Path, const char *Opaque);
        int   do_Close();
        int   do_Dirlist();
-       int   do_DirStat(XrdSfsDirectory *dp, char *pbuff, const char *opaque);
        int   do_Endsess();
        int   do_Getfile();
        int   do_Login();
@@ -186,6 +185,7 @@ static int   Config(const char *fn);
        int   fsError(int rc, char opc, XrdOucErrInfo &myError, const char *Path);
        int   getBuff(const int isRead, int Quantum);
        int   getData(const char *dtype, char *buff, int blen);
+       int   ProcessReq();
 static int   mapMode(int mode);
 static void  PidFile();
        void  Reset();
@@ -323,6 +323,7 @@ int                        myEInfo[2];
       };
 int                        myIOLen;
 int                        myStalls;
+long long                  reqStart;     // When the link was polled (or 0)
 
 // Buffer resize control area
 //
@@ -81,7 +81,7 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
    "<sync>%d</sync><getf>%d</getf><putf>%d</putf><misc>%d</misc></ops>"
    "<aio><num>%lld</num><max>%d</max><rej>%lld</rej></aio>"
    "<err>%d</err><rdr>%lld</rdr><dly>%d</dly>"
-   "<lgn><num>%d</num><af>%d</af><au>%d</au><ua>%d</ua></lgn></stats>";
+   "<lgn><num>%d</num><af>%d</af><au>%d</au><ua>%d</ua></lgn>";
 //                                   1 2 3 4 5 6 7 8
    static const long long LLMax = 0x7fffffffffffffffLL;
    static const int       INMax = 0x7fffffff;
@@ -96,7 +96,7 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
                       INMax, INMax,
                       LLMax, INMax, LLMax, INMax, LLMax, INMax,
                       INMax, INMax, INMax, INMax);
-       return len + (fsP ? fsP->getStats(0,0) : 0);
+       return len + Latency.Stats(0,0) + 8 + (fsP ? fsP->getStats(0,0) : 0);
       }
 
 // Format our statistics
@@ -109,6 +109,11 @@ int XrdXrootdStats::Stats(char *buff, int blen, int do_sync)
                   LoginAT, AuthBad, LoginAU, LoginUA);
    statsMutex.UnLock();
 
+// Add the latency histograms (they have their own lock) and close our section
+//
+   len += Latency.Stats(buff+len, blen-len);
+   len += snprintf(buff+len, blen-len, "</stats>");
+
 // Now include filesystem statistics and return
 //
    if (fsP) len += fsP->getStats(buff+len, blen-len);
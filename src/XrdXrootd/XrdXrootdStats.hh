@@ -31,6 +31,7 @@
 
 #include "XrdSys/XrdSysPthread.hh"
 #include "XrdOuc/XrdOucStats.hh"
+#include "XrdXrootd/XrdXrootdLatency.hh"
 
 class XrdSfsFileSystem;
 class XrdStats;
@@ -63,6 +64,8 @@ int              LoginAU;      // Stats: Number of   authenticated logins
 int              LoginUA;      // Stats: Number of unauthenticated logins
 int              AuthBad;      // Stats: Number of authentication failures
 
+XrdXrootdLatency Latency;      // Stats: Request latency histograms
+
 void             setFS(XrdSfsFileSystem *fsp) {fsP = fsp;}
 
 int              Stats(char *buff, int blen, int do_sync=0);
@@ -42,6 +42,7 @@
 #include "Xrd/XrdLink.hh"
 #include "XrdXrootd/XrdXrootdAio.hh"
 #include "XrdXrootd/XrdXrootdCallBack.hh"
+#include "XrdXrootd/XrdXrootdDirList.hh"
 #include "XrdXrootd/XrdXrootdFile.hh"
 #include "XrdXrootd/XrdXrootdFileLock.hh"
 #include "XrdXrootd/XrdXrootdJob.hh"
@@ -469,10 +470,12 @@ int XrdXrootdProtocol::do_Close()
   
 int XrdXrootdProtocol::do_Dirlist()
 {
-   int bleft, rc = 0, dlen, cnt = 0;
-   char *buff, ebuff[4096];
-   const char *opaque, *dname;
+   int rc = 0;
+   char ebuff[4096];
+   const char *opaque;
    XrdSfsDirectory *dp;
+   XrdXrootdDirList *dlP;
+   bool doStat = (Request.dirlist.options[0] & kXR_dstat) != 0;
 
 // Check for static routing
 //
@@ -501,127 +504,15 @@ int XrdXrootdProtocol::do_Dirlist()
        return rc;
       }
 
-// Check if the caller wants stat information as well
-//
-   if (Request.dirlist.options[0] & kXR_dstat)
-      return do_DirStat(dp, ebuff, opaque);
-
-// Start retreiving each entry and place in a local buffer with a trailing new
-// line character (the last entry will have a null byte). If we cannot fit a
-// full entry in the buffer, send what we have with an OKSOFAR and continue.
-// This code depends on the fact that a directory entry will never be longer
-// than sizeof( ebuff)-1; otherwise, an infinite loop will result. No errors
-// are allowed to be reflected at this point.
-//
-  dname = 0;
-  do {buff = ebuff; bleft = sizeof(ebuff);
-      while(dname || (dname = dp->nextEntry()))
-           {dlen = strlen(dname);
-            if (dlen > 2 || dname[0] != '.' || (dlen == 2 && dname[1] != '.'))
-               {if ((bleft -= (dlen+1)) < 0) break;
-                strcpy(buff, dname); buff += dlen; *buff = '\n'; buff++; cnt++;
-               }
-            dname = 0;
-           }
-       if (dname) rc = Response.Send(kXR_oksofar, ebuff, buff-ebuff);
-     } while(!rc && dname);
-
-// Send the ending packet if we actually have one to send
-//
-   if (!rc) 
-      {if (ebuff == buff) rc = Response.Send();
-          else {*(buff-1) = '\0';
-                rc = Response.Send((void *)ebuff, buff-ebuff);
-               }
-      }
-
-// Close the directory
+// The listing is sent by a list object. Should it not fit in one response,
+// the rest is sent in the background unless the link is already quite busy
+// or we are not talking directly to the client. When stat information is
+// wanted and the file system does not supply it along with each entry, the
+// list object stats the entries through the file system in batches.
 //
-   dp->close();
-   delete dp;
-   if (!rc) {TRACEP(FS, "dirlist entries=" <<cnt <<" path=" <<argp->buff);}
-   return rc;
-}
-
-/******************************************************************************/
-/*                            d o _ D i r S t a t                             */
-/******************************************************************************/
-
-int XrdXrootdProtocol::do_DirStat(XrdSfsDirectory *dp, char *pbuff,
-                                                 const char *opaque)
-{
-   XrdOucErrInfo myError(Link->ID, Monitor.Did, clientPV);
-   struct stat Stat;
-   static const int statSz = 80;
-   int bleft, rc = 0, dlen, cnt = 0;
-   char *buff, *dLoc, ebuff[8192];
-   const char *dname;
-
-// Construct the path to the directory as we will be asking for stat calls
-// if the interface does not support autostat.
-//
-   if (dp->autoStat(&Stat) == SFS_OK) dLoc = 0;
-      else {strcpy(pbuff, argp->buff);
-            dlen = strlen(pbuff);
-            if (pbuff[dlen-1] != '/') {pbuff[dlen] = '/'; dlen++;}
-            dLoc = pbuff+dlen;
-           }
-
-// The initial leadin is a "dot" entry to indicate to the client that we
-// support the dstat option (older servers will not do that). It's up to the
-// client to issue individual stat requests in that case.
-//
-   memset(&Stat, 0, sizeof(Stat));
-   strcpy(ebuff, ".\n");
-   buff = ebuff+2; bleft = sizeof(ebuff)-2;
-   dlen = StatGen(Stat, buff);
-   bleft -= (dlen+1); buff += dlen; *buff = '\n'; buff++;
-
-// Start retreiving each entry and place in a local buffer with a trailing new
-// line character (the last entry will have a null byte). If we cannot fit a
-// full entry in the buffer, send what we have with an OKSOFAR and continue.
-// This code depends on the fact that a directory entry will never be longer
-// than sizeof( ebuff)-1; otherwise, an infinite loop will result. No errors
-// are allowed to be reflected at this point.
-//
-  dname = 0;
-  do {while(dname || (dname = dp->nextEntry()))
-           {dlen = strlen(dname);
-            if (dlen > 2 || dname[0] != '.' || (dlen == 2 && dname[1] != '.'))
-               {if ((bleft -= (dlen+1)) < 0 || bleft < statSz) break;
-                strcpy(buff, dname); buff += dlen; *buff = '\n'; buff++; cnt++;
-                if (dLoc)
-                   {strcpy(dLoc, dname);
-                    rc = osFS->stat(pbuff, &Stat, myError, CRED, opaque);
-                    if (rc != SFS_OK)
-                       return fsError(rc, XROOTD_MON_STAT, myError, argp->buff);
-                   }
-                dlen = StatGen(Stat, buff);
-                bleft -= (dlen+1); buff += dlen; *buff = '\n'; buff++;
-               }
-            dname = 0;
-           }
-       if (dname)
-          {rc = Response.Send(kXR_oksofar, ebuff, buff-ebuff);
-           buff = ebuff; bleft = sizeof(ebuff);
-          }
-     } while(!rc && dname);
-
-// Send the ending packet if we actually have one to send
-//
-   if (!rc) 
-      {if (ebuff == buff) rc = Response.Send();
-          else {*(buff-1) = '\0';
-                rc = Response.Send((void *)ebuff, buff-ebuff);
-               }
-      }
-
-// Close the directory
-//
-   dp->close();
-   delete dp;
-   if (!rc) {TRACEP(FS, "dirstat entries=" <<cnt <<" path=" <<argp->buff);}
-   return rc;
+   dlP = XrdXrootdDirList::Alloc(Response, dp, argp->buff, doStat, osFS, CRED,
+                                 opaque, Monitor.Did, clientPV);
+   return dlP->Start(Response.isOurs() && Link->UseCnt() < as_maxperlnk);
 }
 
 /******************************************************************************/
@@ -1779,6 +1670,7 @@ int XrdXrootdProtocol::do_Read()
    if (Monitor.InOut())
       Monitor.Agent->Add_rd(myFile->Stats.FileID, Request.read.rlen,
                                                   Request.read.offset);
+   myFile->Stats.rdPat(myOffset, myIOLen);
 
 // See if an alternate path is required, offload the read
 //
@@ -2016,6 +1908,7 @@ int XrdXrootdProtocol::do_ReadV()
             if (xfrSZ != rdVAmt) break;
             rdVNum = i - rdVBeg; rdVXfr += rdVAmt;
             myFile->Stats.rvOps(rdVXfr, rdVNum);
+            myFile->Stats.rvPat(&rdVec[rdVBeg], rdVNum);
             if (rvMon)
                {Monitor.Agent->Add_rv(myFile->Stats.FileID, htonl(rdVXfr),
                                               htons(rdVNum), rvSeq, vType);
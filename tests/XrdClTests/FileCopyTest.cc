@@ -29,6 +29,8 @@
 #include "XrdCl/XrdClXRootDMsgHandler.hh"
 #include "XrdCl/XrdClUtils.hh"
 #include "XrdCl/XrdClCheckSumManager.hh"
+#include "XrdCl/XrdClCopyProcess.hh"
+#include "XrdCl/XrdClXtremeReader.hh"
 
 #include "XrdCks/XrdCks.hh"
 #include "XrdCks/XrdCksCalc.hh"
@@ -51,6 +53,7 @@ class FileCopyTest: public CppUnit::TestCase
       CPPUNIT_TEST( UploadTest );
       CPPUNIT_TEST( MultiStreamDownloadTest );
       CPPUNIT_TEST( MultiStreamUploadTest );
+      CPPUNIT_TEST( MultiSourceDownloadTest );
     CPPUNIT_TEST_SUITE_END();
     void DownloadTestFunc();
     void UploadTestFunc();
@@ -58,10 +61,37 @@ class FileCopyTest: public CppUnit::TestCase
     void UploadTest();
     void MultiStreamDownloadTest();
     void MultiStreamUploadTest();
+    void MultiSourceDownloadTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( FileCopyTest );
 
+//------------------------------------------------------------------------------
+// Compute the zcrc32 checksum of a local file
+//------------------------------------------------------------------------------
+static std::string LocalCheckSum( const std::string &path )
+{
+  using namespace XrdCl;
+  CheckSumManager *man      = DefaultEnv::GetCheckSumManager();
+  XrdCksCalc      *crc32Sum = man->GetCalculator("zcrc32");
+  CPPUNIT_ASSERT( crc32Sum );
+
+  const uint32_t  MB = 1024*1024;
+  char           *buffer = new char[4*MB];
+  ssize_t         bytesRead;
+  int             fd = -1;
+  CPPUNIT_ASSERT_ERRNO( (fd=open( path.c_str(), O_RDONLY )) > 0 )
+  while( (bytesRead = read( fd, buffer, 4*MB )) > 0 )
+    crc32Sum->Update( buffer, bytesRead );
+  CPPUNIT_ASSERT( bytesRead >= 0 );
+  close( fd );
+  delete [] buffer;
+
+  char crcBuff[9];
+  XrdCksData crc; crc.Set( (const void *)crc32Sum->Final(), 4 ); crc.Get( crcBuff, 9 );
+  return std::string( "zcrc32:" ) + crcBuff;
+}
+
 //------------------------------------------------------------------------------
 // Download test
 //------------------------------------------------------------------------------
@@ -260,3 +290,120 @@ void FileCopyTest::MultiStreamDownloadTest()
   env->PutInt( "SubStreamsPerChannel", 4 );
   DownloadTestFunc();
 }
+
+//------------------------------------------------------------------------------
+// Multi-source download test
+//------------------------------------------------------------------------------
+void FileCopyTest::MultiSourceDownloadTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Initialize
+  //----------------------------------------------------------------------------
+  Env *testEnv = TestEnv::GetEnv();
+
+  std::string address;
+  std::string remoteFile;
+  std::string localFile;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "RemoteFile",    remoteFile ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "LocalFile",     localFile ) );
+
+  std::string targetFile = localFile + ".multisource";
+
+  //----------------------------------------------------------------------------
+  // Copy from as many replicas as can be found, this falls back to a single
+  // source if there is only one replica, so the multi-source reader is
+  // tested separately below
+  //----------------------------------------------------------------------------
+  CopyProcess   process;
+  JobDescriptor job;
+  job.source         = URL( address + "/" + remoteFile );
+  job.target         = URL( "file://" + targetFile );
+  job.force          = true;
+  job.sourceLimit    = 4;
+  job.chunkSize      = 1024*1024;
+  job.checkSumType   = "zcrc32";
+  process.AddJob( &job );
+
+  CPPUNIT_ASSERT_XRDST( process.Prepare() );
+  CPPUNIT_ASSERT_XRDST( process.Run( 0 ) );
+  CPPUNIT_ASSERT( !job.sources.empty() );
+  CPPUNIT_ASSERT( job.sources.size() <= 4 );
+
+  //----------------------------------------------------------------------------
+  // Compute the checksum of what we got and compare with the remote one
+  //----------------------------------------------------------------------------
+  std::string transferSum = LocalCheckSum( targetFile );
+  CPPUNIT_ASSERT( job.sourceCheckSum == transferSum );
+  CPPUNIT_ASSERT( job.targetCheckSum == transferSum );
+  unlink( targetFile.c_str() );
+
+  //----------------------------------------------------------------------------
+  // Find the data server holding the file, the file is then read through
+  // both the redirector and the data server as if they were two replicas
+  //----------------------------------------------------------------------------
+  File      f;
+  StatInfo *stat = 0;
+  CPPUNIT_ASSERT_XRDST( f.Open( address + "/" + remoteFile, OpenFlags::Read ) );
+  CPPUNIT_ASSERT_XRDST( f.Stat( false, stat ) );
+  CPPUNIT_ASSERT( stat );
+  uint64_t    fileSize   = stat->GetSize();
+  std::string dataServer = f.GetDataServer();
+  delete stat;
+  CPPUNIT_ASSERT_XRDST( f.Close() );
+
+  std::vector<URL> replicas;
+  replicas.push_back( URL( address + "/" + remoteFile ) );
+  replicas.push_back( URL( "root://" + dataServer + "/" + remoteFile ) );
+
+  //----------------------------------------------------------------------------
+  // Read the file with small enough blocks for the second source to join
+  // before the first one is done
+  //----------------------------------------------------------------------------
+  XtremeReader *reader = new XtremeReader( replicas, fileSize/32 + 1, 2 );
+  CPPUNIT_ASSERT_XRDST( reader->Initialize() );
+  CPPUNIT_ASSERT( reader->GetSize() == (int64_t)fileSize );
+
+  int fd = -1;
+  CPPUNIT_ASSERT_ERRNO( (fd=open( targetFile.c_str(),
+                                  O_WRONLY|O_CREAT|O_TRUNC, 0644 )) > 0 );
+  uint64_t     totalRead = 0;
+  ChunkInfo    ci;
+  XRootDStatus st;
+  while( (st = reader->GetChunk( ci )).IsOK() && st.code == suContinue )
+  {
+    CPPUNIT_ASSERT( pwrite( fd, ci.buffer, ci.length, ci.offset ) ==
+                    (ssize_t)ci.length );
+    totalRead += ci.length;
+    delete [] (char*)ci.buffer;
+  }
+  CPPUNIT_ASSERT_XRDST( st );
+  close( fd );
+  CPPUNIT_ASSERT( totalRead == fileSize );
+
+  std::vector<XtremeReader::SourceStats> stats;
+  reader->GetStats( stats );
+  reader->Release();
+
+  uint32_t contributors = 0;
+  uint64_t delivered    = 0;
+  CPPUNIT_ASSERT( stats.size() == 2 );
+  for( uint32_t i = 0; i < stats.size(); ++i )
+  {
+    CPPUNIT_ASSERT( !stats[i].failed );
+    if( stats[i].blocks ) ++contributors;
+    delivered += stats[i].bytes;
+  }
+  CPPUNIT_ASSERT( contributors > 1 );
+  CPPUNIT_ASSERT( delivered == fileSize );
+
+  std::string remoteSum;
+  CPPUNIT_ASSERT_XRDST( Utils::GetRemoteCheckSum( remoteSum, "zcrc32",
+                                                  dataServer, remoteFile ) );
+  CPPUNIT_ASSERT( remoteSum == LocalCheckSum( targetFile ) );
+
+  unlink( targetFile.c_str() );
+}
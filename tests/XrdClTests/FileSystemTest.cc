@@ -22,6 +22,7 @@
 #include "CppUnitXrdHelpers.hh"
 
 #include <pthread.h>
+#include <sys/time.h>
 
 #include "TestEnv.hh"
 
@@ -42,6 +43,7 @@ class FileSystemTest: public CppUnit::TestCase
       CPPUNIT_TEST( ChmodTest );
       CPPUNIT_TEST( PingTest );
       CPPUNIT_TEST( StatTest );
+      CPPUNIT_TEST( BulkStatTest );
       CPPUNIT_TEST( StatVFSTest );
       CPPUNIT_TEST( ProtocolTest );
       CPPUNIT_TEST( DeepLocateTest );
@@ -57,6 +59,7 @@ class FileSystemTest: public CppUnit::TestCase
     void ChmodTest();
     void PingTest();
     void StatTest();
+    void BulkStatTest();
     void StatVFSTest();
     void ProtocolTest();
     void DeepLocateTest();
@@ -311,6 +314,56 @@ void FileSystemTest::StatTest()
   delete response;
 }
 
+//------------------------------------------------------------------------------
+// Bulk stat test
+//------------------------------------------------------------------------------
+void FileSystemTest::BulkStatTest()
+{
+  using namespace XrdCl;
+
+  Env *testEnv = TestEnv::GetEnv();
+  Log *log     = TestEnv::GetLog();
+
+  std::string address;
+  std::string remoteFile;
+
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+  CPPUNIT_ASSERT( testEnv->GetString( "RemoteFile",    remoteFile ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  FileSystem               fs( url );
+  std::vector<std::string> paths( 1000, remoteFile );
+  uint16_t                 windows[] = { 1, 16, 64 };
+
+  for( int i = 0; i < 3; ++i )
+  {
+    std::vector<XRootDStatus> status;
+    std::vector<StatInfo*>    info;
+    timeval                   start, end;
+
+    gettimeofday( &start, 0 );
+    CPPUNIT_ASSERT_XRDST( fs.BulkStat( paths, status, info, windows[i] ) );
+    gettimeofday( &end, 0 );
+
+    CPPUNIT_ASSERT( status.size() == paths.size() );
+    CPPUNIT_ASSERT( info.size() == paths.size() );
+    for( uint32_t j = 0; j < info.size(); ++j )
+    {
+      CPPUNIT_ASSERT_XRDST( status[j] );
+      CPPUNIT_ASSERT( info[j] );
+      CPPUNIT_ASSERT( info[j]->GetSize() == 1048576000 );
+      delete info[j];
+    }
+
+    double elapsed = (end.tv_sec - start.tv_sec) +
+                     (end.tv_usec - start.tv_usec) / 1000000.0;
+    log->Debug( UtilityMsg, "Bulk stat of %d paths with window %d: %f s",
+                (int)paths.size(), (int)windows[i], elapsed );
+  }
+}
+
 //------------------------------------------------------------------------------
 // Stat VFS test
 //------------------------------------------------------------------------------
@@ -188,6 +188,20 @@ class MonitorTest: public XrdCl::Monitor
                       i->oTime, i->tTime );
           break;
         }
+
+        //----------------------------------------------------------------------
+        // Got the metadata cache counters
+        //----------------------------------------------------------------------
+        case EvMetaCache:
+        {
+          MetaCacheInfo *i = (MetaCacheInfo*)evData;
+          log->Debug( 2, "Metadata cache: stat hits: %ld, misses: %ld, "
+                      "location hits: %ld, misses: %ld, failures: %ld, "
+                      "paths: %ld", i->statHits, i->statMisses,
+                      i->locationHits, i->locationMisses,
+                      i->locationFailures, i->entries );
+          break;
+        }
       }
     }
 
@@ -23,8 +23,12 @@
 #include <XrdCl/XrdClXRootDTransport.hh>
 #include <XrdCl/XrdClDefaultEnv.hh>
 #include <XrdCl/XrdClSIDManager.hh>
+#include <XrdCl/XrdClConstants.hh>
 
 #include <pthread.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <iostream>
 
 #include "TestEnv.hh"
 #include "CppUnitXrdHelpers.hh"
@@ -42,11 +46,15 @@ class PostMasterTest: public CppUnit::TestCase
       CPPUNIT_TEST( PingIPv6 );
       CPPUNIT_TEST( ThreadingTest );
       CPPUNIT_TEST( MultiIPConnectionTest );
+      CPPUNIT_TEST( PipeliningTest );
+      CPPUNIT_TEST( IdleChannelTest );
     CPPUNIT_TEST_SUITE_END();
     void FunctionalTest();
     void ThreadingTest();
     void PingIPv6();
     void MultiIPConnectionTest();
+    void PipeliningTest();
+    void IdleChannelTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( PostMasterTest );
@@ -372,6 +380,24 @@ namespace
     XRootDTransport::MarshallRequest( m );
     return m;
   }
+
+  //----------------------------------------------------------------------------
+  // Check whether the main stream of a channel is connected
+  //----------------------------------------------------------------------------
+  bool IsConnected( XrdCl::PostMaster &postMaster, const XrdCl::URL &url )
+  {
+    using namespace XrdCl;
+    AnyObject  qryResult;
+    bool      *connected = 0;
+    CPPUNIT_ASSERT_XRDST( postMaster.QueryTransport( url,
+                                                     XRootDQuery::IsConnected,
+                                                     qryResult ) );
+    qryResult.Get( connected );
+    CPPUNIT_ASSERT( connected );
+    bool result = *connected;
+    delete connected;
+    return result;
+  }
 }
 
 
@@ -436,3 +462,192 @@ void PostMasterTest::MultiIPConnectionTest()
   postMaster.Stop();
   postMaster.Finalize();
 }
+
+namespace
+{
+  //----------------------------------------------------------------------------
+  // Count the sent messages
+  //----------------------------------------------------------------------------
+  class PingSentHandler: public XrdCl::OutgoingMsgHandler
+  {
+    public:
+      PingSentHandler(): sent( 0 ), failed( 0 ) {}
+
+      virtual void OnStatusReady( const XrdCl::Message *, XrdCl::Status st )
+      {
+        XrdSysMutexHelper scopedLock( mutex );
+        if( st.IsOK() ) ++sent;
+        else ++failed;
+      }
+
+      XrdSysMutex mutex;
+      int         sent;
+      int         failed;
+  };
+
+  //----------------------------------------------------------------------------
+  // Take all the ping responses
+  //----------------------------------------------------------------------------
+  class PingResponseHandler: public XrdCl::IncomingMsgHandler
+  {
+    public:
+      PingResponseHandler( int expected ):
+        cond( 0 ), left( expected ), bad( 0 ) {}
+
+      virtual uint16_t Examine( XrdCl::Message *msg )
+      {
+        ServerResponse *resp = (ServerResponse *)msg->GetBuffer();
+        XrdSysCondVarHelper scopedLock( cond );
+        if( resp->hdr.status != kXR_ok || msg->GetSize() != 8 )
+          ++bad;
+        if( --left == 0 )
+        {
+          cond.Signal();
+          return Take | RemoveHandler;
+        }
+        return Take;
+      }
+
+      virtual void Process( XrdCl::Message *msg )
+      {
+        delete msg;
+      }
+
+      XrdSysCondVar cond;
+      int           left;
+      int           bad;
+  };
+}
+
+//------------------------------------------------------------------------------
+// Send many small requests back to back and see that they all make it
+//------------------------------------------------------------------------------
+void PostMasterTest::PipeliningTest()
+{
+  using namespace XrdCl;
+
+  Env *testEnv = TestEnv::GetEnv();
+  std::string address;
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+
+  PostMaster postMaster;
+  postMaster.Initialize();
+  postMaster.Start();
+
+  const int             numPings = 10000;
+  URL                   host( address );
+  time_t                expires = ::time(0)+1200;
+  std::vector<Message*> pings;
+  PingSentHandler       sentHandler;
+  PingResponseHandler   respHandler( numPings );
+
+  for( int i = 0; i < numPings; ++i )
+    pings.push_back( CreatePing( i/256, i%256 ) );
+
+  //----------------------------------------------------------------------------
+  // Establish the connection first so that only the requests are timed
+  //----------------------------------------------------------------------------
+  Message   *m = 0;
+  XrdFilter  f( 1, 2 );
+  Message   *p = CreatePing( 1, 2 );
+  CPPUNIT_ASSERT_XRDST( postMaster.Send( host, p, false, expires ) );
+  CPPUNIT_ASSERT_XRDST( postMaster.Receive( host, m, &f, expires ) );
+  delete p;
+  delete m;
+
+  //----------------------------------------------------------------------------
+  // Pipeline the pings
+  //----------------------------------------------------------------------------
+  timeval start, end;
+  ::gettimeofday( &start, 0 );
+
+  CPPUNIT_ASSERT_XRDST( postMaster.Receive( host, &respHandler, expires ) );
+  for( int i = 0; i < numPings; ++i )
+    CPPUNIT_ASSERT_XRDST( postMaster.Send( host, pings[i], &sentHandler,
+                                           false, expires ) );
+
+  respHandler.cond.Lock();
+  while( respHandler.left )
+    respHandler.cond.Wait();
+  respHandler.cond.UnLock();
+
+  ::gettimeofday( &end, 0 );
+  double elapsed = (end.tv_sec-start.tv_sec) +
+                   (end.tv_usec-start.tv_usec)/1000000.0;
+  std::cerr << std::endl << numPings << " pipelined pings in " << elapsed;
+  std::cerr << "s (" << (int)(numPings/elapsed) << " requests/s)" << std::endl;
+
+  CPPUNIT_ASSERT( respHandler.bad == 0 );
+  sentHandler.mutex.Lock();
+  CPPUNIT_ASSERT( sentHandler.sent == numPings );
+  CPPUNIT_ASSERT( sentHandler.failed == 0 );
+  sentHandler.mutex.UnLock();
+
+  //----------------------------------------------------------------------------
+  // Clean up
+  //----------------------------------------------------------------------------
+  postMaster.Stop();
+  postMaster.Finalize();
+
+  for( int i = 0; i < numPings; ++i )
+    delete pings[i];
+}
+
+//------------------------------------------------------------------------------
+// Pre-connect and idle disconnection test
+//------------------------------------------------------------------------------
+void PostMasterTest::IdleChannelTest()
+{
+  using namespace XrdCl;
+
+  Env *env = DefaultEnv::GetEnv();
+  env->PutInt( "TimeoutResolution", 1 );
+  env->PutInt( "DataServerTTL",     2 );
+  env->PutInt( "LoadBalancerTTL",   2 );
+
+  Env *testEnv = TestEnv::GetEnv();
+  std::string address;
+  CPPUNIT_ASSERT( testEnv->GetString( "MainServerURL", address ) );
+
+  PostMaster postMaster;
+  postMaster.Initialize();
+  postMaster.Start();
+
+  URL        host( address );
+  time_t     expires = ::time(0)+1200;
+  XrdFilter  f( 1, 2 );
+  Message   *m = 0;
+  Message   *p = CreatePing( 1, 2 );
+
+  //----------------------------------------------------------------------------
+  // Connect ahead of the request, pre-connecting twice is harmless
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT_XRDST( postMaster.PreConnect( host ) );
+  CPPUNIT_ASSERT_XRDST( postMaster.PreConnect( host ) );
+  CPPUNIT_ASSERT_XRDST( postMaster.Send( host, p, false, expires ) );
+  CPPUNIT_ASSERT_XRDST( postMaster.Receive( host, m, &f, expires ) );
+  delete m;
+  delete p;
+
+  //----------------------------------------------------------------------------
+  // Let the channel be closed for inactivity, the next request has to
+  // reconnect transparently
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( IsConnected( postMaster, host ) );
+  ::sleep( 5 );
+  CPPUNIT_ASSERT( !IsConnected( postMaster, host ) );
+  m = 0;
+  p = CreatePing( 1, 2 );
+  CPPUNIT_ASSERT_XRDST( postMaster.Send( host, p, false, expires ) );
+  CPPUNIT_ASSERT_XRDST( postMaster.Receive( host, m, &f, expires ) );
+  delete m;
+  delete p;
+  CPPUNIT_ASSERT( IsConnected( postMaster, host ) );
+
+  postMaster.Stop();
+  postMaster.Finalize();
+
+  env->PutInt( "TimeoutResolution", DefaultTimeoutResolution );
+  env->PutInt( "DataServerTTL",     DefaultDataServerTTL );
+  env->PutInt( "LoadBalancerTTL",   DefaultLoadBalancerTTL );
+}
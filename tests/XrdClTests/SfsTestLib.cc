@@ -0,0 +1,186 @@
+//------------------------------------------------------------------------------
+// Copyright (c) 2011-2012 by European Organization for Nuclear Research (CERN)
+// Author: Lukasz Janyst <ljanyst@cern.ch>
+//------------------------------------------------------------------------------
+// XRootD is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// XRootD is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with XRootD.  If not, see <http://www.gnu.org/licenses/>.
+//------------------------------------------------------------------------------
+
+#include "XrdSec/XrdSecEntity.hh"
+#include "XrdSfs/XrdSfsAio.hh"
+#include "XrdSfs/XrdSfsNative.hh"
+#include "XrdSys/XrdSysError.hh"
+#include "XrdOuc/XrdOucErrInfo.hh"
+#include "XrdVersion.hh"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+
+XrdVERSIONINFO( XrdSfsGetFileSystem, SfsTest );
+
+//------------------------------------------------------------------------------
+// A file system that has no storage behind it, it is used to measure the
+// overhead of the protocol layer. Every file is 4GB long and reads return
+// the low byte of the file offset of each byte, asynchronous reads complete
+// immediately. Writes are refused.
+//------------------------------------------------------------------------------
+namespace
+{
+  const XrdSfsFileOffset FileSize = 4LL*1024*1024*1024;
+
+  class SfsTestFile: public XrdSfsFile
+  {
+    public:
+      SfsTestFile( char *user, int monid ): XrdSfsFile( user, monid )
+      {
+        pName[0] = 0;
+      }
+
+      virtual ~SfsTestFile() {}
+
+      virtual int open( const char         *fileName,
+                        XrdSfsFileOpenMode  openMode,
+                        mode_t              createMode,
+                        const XrdSecEntity *client = 0,
+                        const char         *opaque = 0 )
+      {
+        if( openMode & (SFS_O_WRONLY | SFS_O_RDWR | SFS_O_CREAT) )
+          return Refuse( EROFS );
+        strncpy( pName, fileName, sizeof( pName )-1 );
+        pName[sizeof( pName )-1] = 0;
+        return SFS_OK;
+      }
+
+      virtual int close() { return SFS_OK; }
+
+      virtual int fctl( const int cmd, const char *args, XrdOucErrInfo &eInfo )
+      {
+        eInfo.setErrInfo( ENOTSUP, "fctl not supported" );
+        return SFS_ERROR;
+      }
+
+      virtual const char *FName() { return pName; }
+
+      virtual int getMmap( void **Addr, off_t &Size )
+      {
+        if( Addr ) *Addr = 0;
+        Size = 0;
+        return SFS_OK;
+      }
+
+      virtual XrdSfsXferSize read( XrdSfsFileOffset offset,
+                                   XrdSfsXferSize   size )
+      {
+        return SFS_OK;
+      }
+
+      virtual XrdSfsXferSize read( XrdSfsFileOffset  offset,
+                                   char             *buffer,
+                                   XrdSfsXferSize    size )
+      {
+        if( offset >= FileSize )
+          return 0;
+        if( size > FileSize - offset )
+          size = FileSize - offset;
+        static char pattern[512];
+        if( !pattern[1] )
+          for( int i = 0; i < 512; ++i )
+            pattern[i] = (char)(i & 0xff);
+        for( XrdSfsXferSize i = 0; i < size; i += 256 )
+        {
+          XrdSfsXferSize n = size - i < 256 ? size - i : 256;
+          memcpy( buffer+i, pattern + ((offset+i) & 0xff), n );
+        }
+        return size;
+      }
+
+      virtual XrdSfsXferSize read( XrdSfsAio *aiop )
+      {
+        aiop->Result = read( aiop->sfsAio.aio_offset,
+                             (char *)aiop->sfsAio.aio_buf,
+                             aiop->sfsAio.aio_nbytes );
+        aiop->doneRead();
+        return SFS_OK;
+      }
+
+      virtual XrdSfsXferSize write( XrdSfsFileOffset  offset,
+                                    const char       *buffer,
+                                    XrdSfsXferSize    size )
+      {
+        return Refuse( EROFS );
+      }
+
+      virtual int write( XrdSfsAio *aiop ) { return Refuse( EROFS ); }
+
+      virtual int stat( struct stat *buf )
+      {
+        memset( buf, 0, sizeof( struct stat ) );
+        buf->st_mode = S_IFREG | 0444;
+        buf->st_size = FileSize;
+        buf->st_ino  = 1;
+        return SFS_OK;
+      }
+
+      virtual int sync() { return SFS_OK; }
+
+      virtual int sync( XrdSfsAio *aiop )
+      {
+        aiop->Result = 0;
+        aiop->doneWrite();
+        return SFS_OK;
+      }
+
+      virtual int truncate( XrdSfsFileOffset fsize ) { return Refuse( EROFS ); }
+
+      virtual int getCXinfo( char cxtype[4], int &cxrsz ) { return cxrsz = 0; }
+
+    private:
+      int Refuse( int ec )
+      {
+        error.setErrInfo( ec, "the test file system is read only" );
+        return SFS_ERROR;
+      }
+
+      char pName[1024];
+  };
+
+  //----------------------------------------------------------------------------
+  // Everything but the files is handled by the native file system
+  //----------------------------------------------------------------------------
+  class SfsTestFS: public XrdSfsNative
+  {
+    public:
+      SfsTestFS( XrdSysError *eDest ): XrdSfsNative( eDest ) {}
+
+      virtual XrdSfsFile *newFile( char *user = 0, int monid = 0 )
+      {
+        return new SfsTestFile( user, monid );
+      }
+  };
+}
+
+//------------------------------------------------------------------------------
+// Plugin entry point
+//------------------------------------------------------------------------------
+extern "C"
+{
+  XrdSfsFileSystem *XrdSfsGetFileSystem( XrdSfsFileSystem *nativeFS,
+                                         XrdSysLogger     *logger,
+                                         const char       *configFn )
+  {
+    static XrdSysError eDest( logger, "SfsTest" );
+    static SfsTestFS   testFS( &eDest );
+    return &testFS;
+  }
+}
@@ -35,6 +35,7 @@ TestEnv::TestEnv()
   PutString( "RemoteFile",       "/data/cb4aacf1-6f28-42f2-b68a-90a73460f424.dat" );
   PutString( "LocalFile",        "/data/testFile.dat" );
   PutString( "MultiIPServerURL", "multiip:1099" );
+  PutString( "AioServerURL",     "localhost:1098" );
 
   ImportString( "MainServerURL",    "XRDTEST_MAINSERVERURL" );
   ImportString( "DiskServerURL",    "XRDTEST_DISKSERVERURL" );
@@ -42,6 +43,7 @@ TestEnv::TestEnv()
   ImportString( "LocalFile",        "XRDTEST_LOCALFILE" );
   ImportString( "RemoteFile",       "XRDTEST_REMOTEFILE" );
   ImportString( "MultiIPServerURL", "XRDTEST_MULTIIPSERVERURL" );
+  ImportString( "AioServerURL",     "XRDTEST_AIOSERVERURL" );
 }
 
 //------------------------------------------------------------------------------
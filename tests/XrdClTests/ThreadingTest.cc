@@ -26,6 +26,9 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <cstdlib>
+#include <sys/time.h>
+#include <iostream>
+#include <sstream>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include "XrdCks/XrdCksData.hh"
@@ -60,6 +63,8 @@ class ThreadingTest: public CppUnit::TestCase
       CPPUNIT_TEST( ReadForkTest );
       CPPUNIT_TEST( MultiStreamReadForkTest );
       CPPUNIT_TEST( MultiStreamReadMonitorTest );
+      CPPUNIT_TEST( AsyncReadBenchmark );
+      CPPUNIT_TEST( SmallReadBenchmark );
     CPPUNIT_TEST_SUITE_END();
     void ReadTestFunc( TransferCallback transferCallback );
     void ReadTest();
@@ -67,6 +72,9 @@ class ThreadingTest: public CppUnit::TestCase
     void ReadForkTest();
     void MultiStreamReadForkTest();
     void MultiStreamReadMonitorTest();
+    void AsyncReadBenchmark();
+    void SmallReadBenchmark();
+    void ReadBenchmark( uint32_t reads, uint32_t size, uint32_t window );
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( ThreadingTest );
@@ -346,3 +354,178 @@ void ThreadingTest::MultiStreamReadMonitorTest()
   env->PutInt( "SubStreamsPerChannel", 4 );
   ReadTestFunc(0);
 }
+
+//------------------------------------------------------------------------------
+// Asynchronous read benchmark helpers
+//------------------------------------------------------------------------------
+namespace
+{
+  struct AioReaderData
+  {
+    AioReaderData(): reads( 0 ), size( 0 ), window( 0 ), inFlight( 0 ),
+      errors( 0 ), cond( 0 ) {}
+    std::string   url;
+    uint32_t      reads;
+    uint32_t      size;
+    uint32_t      window;
+    uint32_t      inFlight;
+    uint32_t      errors;
+    XrdSysCondVar cond;
+  };
+
+  //----------------------------------------------------------------------------
+  // Check the data against the pattern of the test file system and let the
+  // reader issue the next request
+  //----------------------------------------------------------------------------
+  class AioReadHandler: public XrdCl::ResponseHandler
+  {
+    public:
+      AioReadHandler( AioReaderData *data, uint64_t offset, char *buffer ):
+        pData( data ), pOffset( offset ), pBuffer( buffer ) {}
+
+      virtual void HandleResponse( XrdCl::XRootDStatus *status,
+                                   XrdCl::AnyObject    *response )
+      {
+        using namespace XrdCl;
+        bool ok = status->IsOK() && response;
+        if( ok )
+        {
+          ChunkInfo *chunk = 0;
+          response->Get( chunk );
+          ok = chunk && chunk->length == pData->size;
+          for( uint32_t i = 0; ok && i < pData->size; i += 4093 )
+            ok = pBuffer[i] == (char)((pOffset+i) & 0xff);
+        }
+        delete status;
+        delete response;
+        delete [] pBuffer;
+
+        XrdSysCondVarHelper scopedLock( pData->cond );
+        if( !ok ) ++pData->errors;
+        --pData->inFlight;
+        pData->cond.Signal();
+        delete this;
+      }
+
+    private:
+      AioReaderData *pData;
+      uint64_t       pOffset;
+      char          *pBuffer;
+  };
+
+  //----------------------------------------------------------------------------
+  // Keep a window of reads in flight on a file of its own
+  //----------------------------------------------------------------------------
+  void *AioReader( void *arg )
+  {
+    using namespace XrdCl;
+    AioReaderData *data = (AioReaderData*)arg;
+
+    File f;
+    CPPUNIT_ASSERT_XRDST( f.Open( data->url, OpenFlags::Read ) );
+
+    for( uint32_t i = 0; i < data->reads; ++i )
+    {
+      data->cond.Lock();
+      while( data->inFlight >= data->window )
+        data->cond.Wait();
+      ++data->inFlight;
+      data->cond.UnLock();
+
+      uint64_t  offset = (uint64_t)i * data->size;
+      char     *buffer = new char[data->size];
+      CPPUNIT_ASSERT_XRDST( f.Read( offset, data->size, buffer,
+                                 new AioReadHandler( data, offset, buffer ) ) );
+    }
+
+    data->cond.Lock();
+    while( data->inFlight )
+      data->cond.Wait();
+    data->cond.UnLock();
+
+    CPPUNIT_ASSERT_XRDST( f.Close() );
+    return 0;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Read benchmarks, need a server that runs the test file system with
+// asynchronous I/O forced, ie. has the following directives:
+//
+//   xrootd.fslib <path>/libXrdClTestSfs.so
+//   xrootd.async force
+//
+// Every reader connects as a different user so that the server sees as many
+// links as there are readers.
+//------------------------------------------------------------------------------
+void ThreadingTest::ReadBenchmark( uint32_t reads, uint32_t size,
+                                   uint32_t window )
+{
+  using namespace XrdCl;
+
+  Env *testEnv = XrdClTests::TestEnv::GetEnv();
+  std::string address;
+  CPPUNIT_ASSERT( testEnv->GetString( "AioServerURL", address ) );
+
+  URL url( address );
+  CPPUNIT_ASSERT( url.IsValid() );
+
+  const int     numReaders = 32;
+  AioReaderData data[numReaders];
+  pthread_t     thread[numReaders];
+
+  for( int i = 0; i < numReaders; ++i )
+  {
+    std::ostringstream o;
+    o << "root://aio" << i << "@" << url.GetHostId() << "//aiobench/file" << i;
+    data[i].url    = o.str();
+    data[i].reads  = reads;
+    data[i].size   = size;
+    data[i].window = window;
+  }
+
+  timeval start, end;
+  ::gettimeofday( &start, 0 );
+
+  for( int i = 0; i < numReaders; ++i )
+    CPPUNIT_ASSERT_PTHREAD( pthread_create( &(thread[i]), 0,
+                            AioReader, &(data[i]) ) );
+  for( int i = 0; i < numReaders; ++i )
+    CPPUNIT_ASSERT_PTHREAD( pthread_join( thread[i], 0 ) );
+
+  ::gettimeofday( &end, 0 );
+
+  double   elapsed = end.tv_sec - start.tv_sec +
+                     (end.tv_usec - start.tv_usec)/1e6;
+  uint64_t total   = 0;
+  uint64_t bytes   = 0;
+  for( int i = 0; i < numReaders; ++i )
+  {
+    CPPUNIT_ASSERT( data[i].errors == 0 );
+    total += data[i].reads;
+    bytes += (uint64_t)data[i].reads * data[i].size;
+  }
+
+  std::cerr << std::endl << total << " reads of " << size << " bytes by ";
+  std::cerr << numReaders << " readers in " << elapsed << "s (";
+  std::cerr << (int)(total/elapsed) << " reads/s, ";
+  std::cerr << (int)(bytes/elapsed/MB) << " MB/s)" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+// Asynchronous read benchmark, throughput of large reads
+//------------------------------------------------------------------------------
+void ThreadingTest::AsyncReadBenchmark()
+{
+  ReadBenchmark( 2000, 64*1024, 8 );
+}
+
+//------------------------------------------------------------------------------
+// Small read benchmark, one read in flight per reader so that the rate is
+// bound by the per-request cost of kXR_read on the server (eg. the latency
+// accounting); compare the rates of two servers to see the overhead
+//------------------------------------------------------------------------------
+void ThreadingTest::SmallReadBenchmark()
+{
+  ReadBenchmark( 1000, 512, 1 );
+}
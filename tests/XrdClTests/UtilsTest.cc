@@ -22,6 +22,16 @@
 #include "XrdCl/XrdClAnyObject.hh"
 #include "XrdCl/XrdClTaskManager.hh"
 #include "XrdCl/XrdClSIDManager.hh"
+#include "XrdCl/XrdClMessage.hh"
+#include "XrdCl/XrdClMetaCache.hh"
+#include "XrdOuc/XrdOucEnv.hh"
+#include <sys/time.h>
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+#include <pthread.h>
 
 //------------------------------------------------------------------------------
 // Declaration
@@ -34,11 +44,17 @@ class UtilsTest: public CppUnit::TestCase
       CPPUNIT_TEST( AnyTest );
       CPPUNIT_TEST( TaskManagerTest );
       CPPUNIT_TEST( SIDManagerTest );
+      CPPUNIT_TEST( BufferPoolTest );
+      CPPUNIT_TEST( OucEnvTest );
+      CPPUNIT_TEST( MetaCacheTest );
     CPPUNIT_TEST_SUITE_END();
     void URLTest();
     void AnyTest();
     void TaskManagerTest();
     void SIDManagerTest();
+    void BufferPoolTest();
+    void OucEnvTest();
+    void MetaCacheTest();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION( UtilsTest );
@@ -398,3 +414,359 @@ void UtilsTest::SIDManagerTest()
   manager.ReleaseAllTimedOut();
   CPPUNIT_ASSERT( manager.NumberOfTimedOutSIDs() == 0 );
 }
+
+//------------------------------------------------------------------------------
+// Buffer pool test
+//------------------------------------------------------------------------------
+void UtilsTest::BufferPoolTest()
+{
+  using namespace XrdCl;
+
+  //----------------------------------------------------------------------------
+  // Growing and shrinking keeps the content
+  //----------------------------------------------------------------------------
+  Buffer buff( 8 );
+  memcpy( buff.GetBuffer(), "abcdefgh", 8 );
+  char *old = buff.GetBuffer();
+  buff.ReAllocate( 60 );
+  CPPUNIT_ASSERT( buff.GetBuffer() == old );
+  buff.ReAllocate( 5000 );
+  CPPUNIT_ASSERT( buff.GetSize() == 5000 );
+  CPPUNIT_ASSERT( memcmp( buff.GetBuffer(), "abcdefgh", 8 ) == 0 );
+  buff.ReAllocate( 4 );
+  CPPUNIT_ASSERT( buff.ToString() == "abcd" );
+  buff.ReAllocate( 200000 );
+  CPPUNIT_ASSERT( memcmp( buff.GetBuffer(), "abcd", 4 ) == 0 );
+
+  //----------------------------------------------------------------------------
+  // Released memory belongs to malloc, grabbed memory goes back to it
+  //----------------------------------------------------------------------------
+  free( buff.Release() );
+  CPPUNIT_ASSERT( buff.GetSize() == 0 );
+  buff.Grab( (char*)malloc( 100 ), 100 );
+  buff.ReAllocate( 50 );
+  buff.Free();
+
+  //----------------------------------------------------------------------------
+  // Freed messages are reused by the same thread
+  //----------------------------------------------------------------------------
+  BufferPool::Stats before, after;
+  BufferPool::GetStats( before );
+  for( int i = 0; i < 100; ++i )
+  {
+    Message *msg = new Message( 1024 );
+    CPPUNIT_ASSERT( msg->GetBuffer()[1023] == 0 );
+    msg->GetBuffer()[1023] = 1;
+    delete msg;
+  }
+  BufferPool::GetStats( after );
+  CPPUNIT_ASSERT( after.allocations - before.allocations == 200 );
+  CPPUNIT_ASSERT( after.frees - before.frees == 200 );
+  CPPUNIT_ASSERT( after.mallocs - before.mallocs <= 2 );
+
+  //----------------------------------------------------------------------------
+  // The blocks that fit neither in the thread cache nor in the shared pool
+  // are given back to malloc, 64 KB blocks are kept 2 + 64 deep
+  //----------------------------------------------------------------------------
+  const uint32_t numBlocks = 200;
+  char          *blocks[numBlocks];
+  uint32_t       capacity;
+  for( uint32_t i = 0; i < numBlocks; ++i )
+  {
+    blocks[i] = BufferPool::Allocate( 65536, capacity );
+    CPPUNIT_ASSERT( blocks[i] != 0 );
+    CPPUNIT_ASSERT( capacity == 65536 );
+    memset( blocks[i], i, capacity );
+  }
+  for( uint32_t i = 0; i < numBlocks; ++i )
+    BufferPool::Free( blocks[i], capacity );
+
+  BufferPool::GetStats( before );
+  for( uint32_t i = 0; i < numBlocks; ++i )
+    blocks[i] = BufferPool::Allocate( 65536, capacity );
+  BufferPool::GetStats( after );
+  CPPUNIT_ASSERT( after.mallocs - before.mallocs >= numBlocks - 66 );
+  CPPUNIT_ASSERT( after.threadHits + after.poolHits -
+                  before.threadHits - before.poolHits <= 66 );
+  for( uint32_t i = 0; i < numBlocks; ++i )
+    BufferPool::Free( blocks[i], capacity );
+}
+
+//------------------------------------------------------------------------------
+// Look up the variables of an environment shared by several threads
+//------------------------------------------------------------------------------
+static void *OucEnvReader( void *arg )
+{
+  XrdOucEnv *env = (XrdOucEnv*)arg;
+  long       bad = 0;
+  for( int i = 0; i < 10000; ++i )
+  {
+    char *tried = env->Get( "tried" );
+    if( !tried || strcmp( tried, "host3" ) ) ++bad;
+    if( env->GetInt( "oss.asize" ) != 1048576 ) ++bad;
+    if( env->Get( "oss.lcl" ) ) ++bad;
+  }
+  return (void*)bad;
+}
+
+//------------------------------------------------------------------------------
+// Opaque information parsing
+//------------------------------------------------------------------------------
+void UtilsTest::OucEnvTest()
+{
+  //----------------------------------------------------------------------------
+  // Parsing
+  //----------------------------------------------------------------------------
+  const char *cgi = "&&tried=host1,host2&oss.asize=1048576&empty=&=noname"
+                    "&tried=host3&authz=abc%20def";
+  XrdOucEnv env( cgi );
+  int       len;
+  CPPUNIT_ASSERT( std::string( env.Env( len ) ) == cgi+1 );
+  CPPUNIT_ASSERT( len == (int)strlen( cgi+1 ) );
+  CPPUNIT_ASSERT( std::string( env.Get( "tried" ) ) == "host3" );
+  CPPUNIT_ASSERT( std::string( env.Get( "authz" ) ) == "abc%20def" );
+  CPPUNIT_ASSERT( env.GetInt( "oss.asize" ) == 1048576 );
+  CPPUNIT_ASSERT( env.GetInt( "oss.lcl" ) == -999999999 );
+  CPPUNIT_ASSERT( env.Get( "empty" ) == 0 );
+  CPPUNIT_ASSERT( env.Get( "" ) == 0 );
+  CPPUNIT_ASSERT( env.Get( "oss" ) == 0 );
+
+  //----------------------------------------------------------------------------
+  // Looking up variables does not modify the object, so a freshly
+  // constructed one may be shared by several threads
+  //----------------------------------------------------------------------------
+  XrdOucEnv shared( cgi );
+  pthread_t readers[4];
+  for( int i = 0; i < 4; ++i )
+    CPPUNIT_ASSERT( pthread_create( &readers[i], 0, OucEnvReader,
+                                    &shared ) == 0 );
+  for( int i = 0; i < 4; ++i )
+  {
+    void *bad = 0;
+    pthread_join( readers[i], &bad );
+    CPPUNIT_ASSERT( bad == 0 );
+  }
+
+  //----------------------------------------------------------------------------
+  // Setting variables leaves the environment string alone
+  //----------------------------------------------------------------------------
+  env.Put( "tried", "host4" );
+  env.PutInt( "oss.lcl", 1 );
+  env.PutPtr( "UtilsTest*", &env );
+  CPPUNIT_ASSERT( std::string( env.Get( "tried" ) ) == "host4" );
+  CPPUNIT_ASSERT( env.GetInt( "oss.lcl" ) == 1 );
+  CPPUNIT_ASSERT( env.GetPtr( "UtilsTest*" ) == &env );
+  CPPUNIT_ASSERT( std::string( env.Env( len ) ) == cgi+1 );
+
+  //----------------------------------------------------------------------------
+  // Many variables
+  //----------------------------------------------------------------------------
+  XrdOucEnv   empty;
+  std::string big;
+  char        name[32];
+  CPPUNIT_ASSERT( empty.Env( len ) == 0 && len == 0 );
+  for( int i = 0; i < 100; ++i )
+  {
+    snprintf( name, sizeof( name ), "var%d", i );
+    empty.PutInt( name, i );
+    big += std::string( "&" ) + name + "=" + name;
+  }
+  XrdOucEnv bigEnv( big.c_str() );
+  for( int i = 0; i < 100; ++i )
+  {
+    snprintf( name, sizeof( name ), "var%d", i );
+    CPPUNIT_ASSERT( empty.GetInt( name ) == i );
+    CPPUNIT_ASSERT( std::string( bigEnv.Get( name ) ) == name );
+  }
+
+  //----------------------------------------------------------------------------
+  // Time the handling of typical opaque strings: each one is parsed and
+  // queried the way an open would do it
+  //----------------------------------------------------------------------------
+  std::string token( 900, 'x' );
+  for( size_t i = 0; i < token.size(); ++i )
+    token[i] = "abcdefghijKLMNOP0123456789-_"[i % 28];
+
+  std::string opaque[] =
+  {
+    "oss.lcl=1&tried=srv1.example.org,srv2.example.org&triedrc=enoent"
+    "&oss.asize=1048576",
+    "authz=Bearer%20" + token + "&xrd.gsiusrpxy=/tmp/x509up_u1000"
+    "&xrdcl.requuid=4b1c8a52-11f3-4d3e-9bd1-6a2e5d1f7c10"
+    "&xrd.wantprot=gsi,unix",
+    "tpc.key=00a1b2c3d4e5f60718293a4b&tpc.org=user.1234:56@client.example.org"
+    "&tpc.src=root://src.example.org:1094//store/data/file.root&tpc.stage=copy"
+    "&tpc.dst=dst.example.org&tpc.lfn=/store/data/file.root"
+    "&oss.asize=2147483648&tried=srv3.example.org"
+  };
+  const char *query[] = { "tried", "oss.asize", "authz", "tpc.key", "cgroup",
+                          "oss.lcl" };
+  const int   numOpens = 100000;
+
+  for( int k = 0; k < 3; ++k )
+  {
+    timeval start, end;
+    long    found = 0;
+    ::gettimeofday( &start, 0 );
+    for( int i = 0; i < numOpens; ++i )
+    {
+      XrdOucEnv openEnv( opaque[k].c_str() );
+      for( int j = 0; j < 6; ++j )
+        if( openEnv.Get( query[j] ) ) ++found;
+      if( openEnv.GetInt( "oss.asize" ) > 0 ) ++found;
+    }
+    ::gettimeofday( &end, 0 );
+    CPPUNIT_ASSERT( found > 0 );
+    double elapsed = end.tv_sec - start.tv_sec +
+                     (end.tv_usec - start.tv_usec)/1e6;
+    std::cerr << std::endl << opaque[k].size() << " byte opaque string: ";
+    std::cerr << (int)(elapsed*1e9/numOpens) << " ns per open";
+  }
+  std::cerr << std::endl;
+}
+
+//------------------------------------------------------------------------------
+// Metadata cache
+//------------------------------------------------------------------------------
+void UtilsTest::MetaCacheTest()
+{
+  using namespace XrdCl;
+
+  URL         host1( "root://user@host1:1094//data/file1" );
+  URL         host1Path2( "root://user@host1:1094//data/file2" );
+  URL         host2( "root://user@host2:1094//data/file1" );
+  StatInfo    info, *cached;
+  std::string dataServer, loadBalancer;
+  CPPUNIT_ASSERT( info.ParseServerResponse( "123 4096 0 1000" ) );
+
+  //----------------------------------------------------------------------------
+  // The keys ignore the leading slashes, the protocol and the parameters
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( MetaCache::GetKey( host1, "/data/file1" ) ==
+                  "user@host1:1094/data/file1" );
+  CPPUNIT_ASSERT( MetaCache::GetKey( host1, "//data/file1" ) ==
+                  MetaCache::GetKey( host1, "data/file1" ) );
+  CPPUNIT_ASSERT( MetaCache::GetKey( URL( "xroot://user@host1:1094/x?a=b" ),
+                                     "/data/file1" ) ==
+                  MetaCache::GetKey( host1, "/data/file1" ) );
+  CPPUNIT_ASSERT( MetaCache::GetKey( host1, "/" ) == "user@host1:1094/" );
+  CPPUNIT_ASSERT( MetaCache::GetKey( host1, "/data/file1" ) !=
+                  MetaCache::GetKey( host2, "/data/file1" ) );
+  CPPUNIT_ASSERT( MetaCache::GetKey( host1, "/data/file1" ) !=
+                  MetaCache::GetKey( URL( "root://host1:1094//" ),
+                                     "/data/file1" ) );
+
+  //----------------------------------------------------------------------------
+  // Only the redirections without opaque information are remembered, the
+  // message handler adds the host with the redirection CGI and then the
+  // same host without it when it retries the request there
+  //----------------------------------------------------------------------------
+  HostList hosts;
+  CPPUNIT_ASSERT( !MetaCache::GetRedirectTarget( 0, dataServer ) );
+  hosts.push_back( URL( "root://user@host1:1094//data/file1?a=b" ) );
+  CPPUNIT_ASSERT( !MetaCache::GetRedirectTarget( &hosts, dataServer ) );
+  hosts.push_back( URL( "root://server1:1094/" ) );
+  hosts.push_back( URL( "root://server1:1094/" ) );
+  CPPUNIT_ASSERT( MetaCache::GetRedirectTarget( &hosts, dataServer ) );
+  CPPUNIT_ASSERT( dataServer == "root://server1:1094" );
+
+  hosts.resize( 1 );
+  hosts.push_back( URL( "root://server1:1094/" ) );
+  hosts.back().url.SetParams( "authz=token&tpc.key=1" );
+  hosts.push_back( URL( "root://server1:1094/" ) );
+  dataServer.clear();
+  CPPUNIT_ASSERT( !MetaCache::GetRedirectTarget( &hosts, dataServer ) );
+  CPPUNIT_ASSERT( dataServer.empty() );
+  hosts.push_back( URL( "root://server2:1094/" ) );
+  hosts.push_back( URL( "root://server2:1094/" ) );
+  CPPUNIT_ASSERT( !MetaCache::GetRedirectTarget( &hosts, dataServer ) );
+
+  //----------------------------------------------------------------------------
+  // A disabled cache
+  //----------------------------------------------------------------------------
+  MetaCache disabled( 0, 10 );
+  CPPUNIT_ASSERT( !disabled.IsEnabled() );
+
+  //----------------------------------------------------------------------------
+  // Stat information is found under the normalised path
+  //----------------------------------------------------------------------------
+  MetaCache cache( 60, 10 );
+  CPPUNIT_ASSERT( cache.IsEnabled() );
+  CPPUNIT_ASSERT( cache.GetStat( host1, "/data/file1" ) == 0 );
+  cache.PutStat( host1, "//data/file1", info );
+  cached = cache.GetStat( host1, "data/file1" );
+  CPPUNIT_ASSERT( cached );
+  CPPUNIT_ASSERT( cached->GetId() == "123" );
+  CPPUNIT_ASSERT( cached->GetSize() == 4096 );
+  delete cached;
+  CPPUNIT_ASSERT( cache.GetStat( host2, "/data/file1" ) == 0 );
+
+  //----------------------------------------------------------------------------
+  // Locations, a failed one is forgotten but the stat info is kept
+  //----------------------------------------------------------------------------
+  CPPUNIT_ASSERT( !cache.GetLocation( host1, dataServer, loadBalancer ) );
+  cache.PutLocation( host1, "root://server1:1094", "root://lb1:1094" );
+  CPPUNIT_ASSERT( cache.GetLocation( host1, dataServer, loadBalancer ) );
+  CPPUNIT_ASSERT( dataServer == "root://server1:1094" );
+  CPPUNIT_ASSERT( loadBalancer == "root://lb1:1094" );
+  CPPUNIT_ASSERT( !cache.GetLocation( host1Path2, dataServer, loadBalancer ) );
+  cache.LocationFailed( host1 );
+  CPPUNIT_ASSERT( !cache.GetLocation( host1, dataServer, loadBalancer ) );
+  cached = cache.GetStat( host1, "/data/file1" );
+  CPPUNIT_ASSERT( cached );
+  delete cached;
+  cache.LocationFailed( host2 );
+
+  //----------------------------------------------------------------------------
+  // Invalidation drops everything about one path only
+  //----------------------------------------------------------------------------
+  cache.PutLocation( host1, "root://server1:1094", "" );
+  cache.PutStat( host1Path2, "/data/file2", info );
+  cache.PutStat( host2, "/data/file1", info );
+  cache.Invalidate( host1, "data/file1" );
+  CPPUNIT_ASSERT( cache.GetStat( host1, "/data/file1" ) == 0 );
+  CPPUNIT_ASSERT( !cache.GetLocation( host1, dataServer, loadBalancer ) );
+  cached = cache.GetStat( host1, "/data/file2" );
+  CPPUNIT_ASSERT( cached );
+  delete cached;
+  cached = cache.GetStat( host2, "/data/file1" );
+  CPPUNIT_ASSERT( cached );
+  delete cached;
+  cache.Invalidate( host1, "/data/nothing" );
+
+  //----------------------------------------------------------------------------
+  // A full cache is emptied when none of the entries has expired
+  //----------------------------------------------------------------------------
+  MetaCache small( 60, 2 );
+  small.PutStat( host1, "/a", info );
+  small.PutStat( host1, "/b", info );
+  small.PutStat( host1, "/b", info );
+  cached = small.GetStat( host1, "/a" );
+  CPPUNIT_ASSERT( cached );
+  delete cached;
+  small.PutStat( host1, "/c", info );
+  CPPUNIT_ASSERT( small.GetStat( host1, "/a" ) == 0 );
+  CPPUNIT_ASSERT( small.GetStat( host1, "/b" ) == 0 );
+  cached = small.GetStat( host1, "/c" );
+  CPPUNIT_ASSERT( cached );
+  delete cached;
+
+  //----------------------------------------------------------------------------
+  // Entries expire after the TTL, the expired ones make room in a full cache
+  //----------------------------------------------------------------------------
+  MetaCache shortLived( 1, 2 );
+  shortLived.PutStat( host1, "/a", info );
+  shortLived.PutLocation( host1, "root://server1:1094", "" );
+  ::sleep( 2 );
+  CPPUNIT_ASSERT( shortLived.GetStat( host1, "/data/file1" ) == 0 );
+  CPPUNIT_ASSERT( !shortLived.GetLocation( host1, dataServer, loadBalancer ) );
+  shortLived.PutStat( host1, "/b", info );
+  shortLived.PutStat( host1, "/c", info );
+  CPPUNIT_ASSERT( shortLived.GetStat( host1, "/a" ) == 0 );
+  cached = shortLived.GetStat( host1, "/b" );
+  CPPUNIT_ASSERT( cached );
+  delete cached;
+  cached = shortLived.GetStat( host1, "/c" );
+  CPPUNIT_ASSERT( cached );
+  delete cached;
+}